@@ -50,6 +50,7 @@ AC_DEFUN([T8_CHECK_LIBRARIES],
 T8_CHECK_NETCDF([$1])
 T8_CHECK_VTK([$1])
 T8_CHECK_CPPSTD([$1])
+T8_CHECK_OPENMP([$1])
 ])
 
 dnl T8_AS_SUBPACKAGE(PREFIX)
@@ -0,0 +1,34 @@
+dnl T8_CHECK_OPENMP
+dnl Check for OpenMP support
+dnl
+dnl This macro adds the compiler flags for OpenMP to CFLAGS and CXXFLAGS
+dnl if t8code is configured with --enable-openmp.
+dnl OpenMP threads are used to pack and unpack the communication buffers
+dnl of partition and ghost, while all MPI calls are made by a single thread.
+dnl The number of threads is controlled by the OMP_NUM_THREADS variable.
+dnl
+AC_DEFUN([T8_CHECK_OPENMP], [
+
+T8_ARG_ENABLE([openmp],
+  [use OpenMP threads to pack and unpack communication buffers],
+  [OPENMP])
+AC_MSG_CHECKING([for OpenMP])
+if test "x$T8_ENABLE_OPENMP" != xno ; then
+  AC_MSG_RESULT([requested])
+  AC_LANG_PUSH([C])
+  AC_OPENMP
+  AC_LANG_POP([C])
+  AC_LANG_PUSH([C++])
+  AC_OPENMP
+  AC_LANG_POP([C++])
+  if test "x$ac_cv_prog_c_openmp" = xunsupported || \
+     test "x$ac_cv_prog_cxx_openmp" = xunsupported ; then
+    AC_MSG_ERROR([Unable to compile with OpenMP])
+  fi
+  CFLAGS="$CFLAGS $OPENMP_CFLAGS"
+  CXXFLAGS="$CXXFLAGS $OPENMP_CXXFLAGS"
+else
+  AC_MSG_RESULT([not used])
+fi
+
+])
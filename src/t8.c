@@ -24,6 +24,18 @@
 
 static int          t8_package_id = -1;
 
+/* An entry in the pool of duplicated communicators */
+typedef struct
+{
+  sc_MPI_Comm         comm;     /* The duplicated communicator */
+  sc_MPI_Comm         dup;      /* The duplicate */
+  int                 refcount; /* The number of references to the duplicate */
+} t8_comm_pool_entry_t;
+
+/* The pool of duplicated communicators, NULL if empty.
+ * It is not protected by a lock, see t8_comm_pool_dup in t8.h. */
+static sc_array_t  *t8_comm_pool = NULL;
+
 int
 t8_get_package_id (void)
 {
@@ -173,3 +185,82 @@ t8_sc_array_index_locidx (sc_array_t * array, t8_locidx_t it)
 
   return array->array + array->elem_size * (size_t) it;
 }
+
+sc_MPI_Comm
+t8_comm_pool_dup (sc_MPI_Comm comm)
+{
+  t8_comm_pool_entry_t *entry;
+  size_t              ientry;
+  int                 mpiret;
+
+  T8_ASSERT (comm != sc_MPI_COMM_NULL);
+
+  if (t8_comm_pool == NULL) {
+    t8_comm_pool = sc_array_new (sizeof (t8_comm_pool_entry_t));
+  }
+  for (ientry = 0; ientry < t8_comm_pool->elem_count; ientry++) {
+    entry = (t8_comm_pool_entry_t *) sc_array_index (t8_comm_pool, ientry);
+    if (entry->comm == comm || entry->dup == comm) {
+      /* The communicator was already duplicated */
+      entry->refcount++;
+      return entry->dup;
+    }
+  }
+  entry = (t8_comm_pool_entry_t *) sc_array_push (t8_comm_pool);
+  entry->comm = comm;
+  mpiret = sc_MPI_Comm_dup (comm, &entry->dup);
+  SC_CHECK_MPI (mpiret);
+  entry->refcount = 1;
+  return entry->dup;
+}
+
+void
+t8_comm_pool_release (sc_MPI_Comm * comm)
+{
+  t8_comm_pool_entry_t *entry;
+  size_t              ientry, num_entries;
+  int                 mpiret;
+
+  T8_ASSERT (comm != NULL && t8_comm_pool != NULL);
+
+  num_entries = t8_comm_pool->elem_count;
+  for (ientry = 0; ientry < num_entries; ientry++) {
+    entry = (t8_comm_pool_entry_t *) sc_array_index (t8_comm_pool, ientry);
+    if (entry->dup == *comm) {
+      break;
+    }
+  }
+  SC_CHECK_ABORT (ientry < num_entries, "Communicator is not in the pool");
+  T8_ASSERT (entry->refcount > 0);
+  if (--entry->refcount == 0) {
+    mpiret = sc_MPI_Comm_free (&entry->dup);
+    SC_CHECK_MPI (mpiret);
+    /* Move the last entry into the free slot */
+    *entry = *(t8_comm_pool_entry_t *) sc_array_index (t8_comm_pool,
+                                                       num_entries - 1);
+    sc_array_resize (t8_comm_pool, num_entries - 1);
+    if (num_entries == 1) {
+      sc_array_destroy (t8_comm_pool);
+      t8_comm_pool = NULL;
+    }
+  }
+  *comm = sc_MPI_COMM_NULL;
+}
+
+int
+t8_comm_pool_refcount (sc_MPI_Comm comm)
+{
+  t8_comm_pool_entry_t *entry;
+  size_t              ientry;
+
+  if (t8_comm_pool == NULL) {
+    return 0;
+  }
+  for (ientry = 0; ientry < t8_comm_pool->elem_count; ientry++) {
+    entry = (t8_comm_pool_entry_t *) sc_array_index (t8_comm_pool, ientry);
+    if (entry->comm == comm || entry->dup == comm) {
+      return entry->refcount;
+    }
+  }
+  return 0;
+}
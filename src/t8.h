@@ -114,6 +114,16 @@ typedef uint64_t    t8_linearidx_t;
 #define T8_ADD_PADDING(_x) \
   ((T8_PADDING_SIZE - ((_x) %  T8_PADDING_SIZE)) %  T8_PADDING_SIZE)
 
+/** Distribute the iterations of the following for loop among OpenMP threads.
+ * Used to pack and unpack communication buffers in parallel.
+ * The iterations must be independent of each other.
+ * Expands to nothing if t8code is not configured with --enable-openmp. */
+#ifdef T8_ENABLE_OPENMP
+#define T8_OMP_PARALLEL_FOR _Pragma ("omp parallel for schedule (dynamic)")
+#else
+#define T8_OMP_PARALLEL_FOR
+#endif
+
 /** Communication tags used internal to t8code. */
 typedef enum
 {
@@ -122,6 +132,11 @@ typedef enum
   T8_MPI_PARTITION_FOREST,  /**< Used for forest partitioning */
   T8_MPI_GHOST_FOREST,  /**< Used for for ghost layer creation */
   T8_MPI_GHOST_EXC_FOREST,  /**< Used for ghost data exchange */
+  T8_MPI_NEAREST_FOREST,    /**< Used for nearest element queries */
+  T8_MPI_READ_VTU_CMESH,    /**< Used for reading partitioned vtu files */
+  T8_MPI_BOUNDARY_FOREST,   /**< Used for boundary forest construction */
+  T8_MPI_EXTRUDE_FOREST,    /**< Used for extruded forest construction */
+  T8_MPI_VTK_FOREST,        /**< Used for aggregated forest vtk output */
   T8_MPI_TAG_LAST
 }
 t8_MPI_tag_t;
@@ -257,6 +272,40 @@ void               *t8_sc_array_index_topidx (sc_array_t * array,
 void               *t8_sc_array_index_locidx (sc_array_t * array,
                                               t8_locidx_t it);
 
+/** Get a duplicate of a communicator from a reference counted pool.
+ * The first request for a communicator duplicates it. Further requests for
+ * the same communicator or for its duplicate return the same duplicate and
+ * increase its reference count. Thus messages of t8code are kept apart from
+ * the messages of the user, while communicators that are shared by derived
+ * forests are duplicated only once.
+ * \param [in] comm  A communicator or a duplicate returned by this function.
+ * \return           The duplicate of \a comm.
+ * \note This function is collective over \a comm if \a comm is not in the
+ *       pool. All processes must request and release the duplicates of
+ *       \a comm in the same order.
+ * \note The pool is a global and unlocked structure, thus the pool functions
+ *       are not thread-safe. Forests must be created, committed and
+ *       destroyed by one thread at a time, for example outside of
+ *       \ref T8_OMP_PARALLEL_FOR loops.
+ */
+sc_MPI_Comm         t8_comm_pool_dup (sc_MPI_Comm comm);
+
+/** Release a duplicate obtained with \ref t8_comm_pool_dup.
+ * The duplicate is freed when its reference count drops to zero.
+ * \param [in,out] comm  A duplicate of the pool. On output it is set to
+ *                       sc_MPI_COMM_NULL.
+ * \note This function is collective over \a comm if its duplicate is freed.
+ */
+void                t8_comm_pool_release (sc_MPI_Comm * comm);
+
+/** Query the reference count of a duplicate in the pool.
+ * \param [in] comm  A communicator or a duplicate returned by
+ *                   \ref t8_comm_pool_dup.
+ * \return           The number of references to the duplicate of \a comm,
+ *                   zero if \a comm is not in the pool.
+ */
+int                 t8_comm_pool_refcount (sc_MPI_Comm comm);
+
 /* call this at the end of a header file to match T8_EXTERN_C_BEGIN (). */
 T8_EXTERN_C_END ();
 
@@ -115,6 +115,20 @@ int                 t8_cmesh_tree_vertices_negative_volume (t8_eclass_t
                                                             double *vertices,
                                                             int num_vertices);
 
+/** Given a set of vertex coordinates for a tree of a given eclass,
+ * reorder the vertices such that the geometric volume of the tree is positive.
+ * \param [in]  eclass          The eclass of a tree.
+ * \param [in,out] vertices     The coordinates of the tree's vertices.
+ *                              If the volume is negative the vertices are
+ *                              switched on output.
+ * \param [in]  num_vertices    The number of vertices. \a vertices must hold
+ *                              3 * \a num_vertices many doubles.
+ * \return                      True if \a vertices was changed, false if the
+ *                              volume was already positive.
+ */
+int                 t8_cmesh_tree_vertices_correct_negative_volume
+  (t8_eclass_t eclass, double *vertices, int num_vertices);
+
 /* TODO: Currently it is not possible to destroy set_from before
  *       cmesh is destroyed. */
 /** This function sets a cmesh to be derived from.
@@ -378,7 +392,16 @@ void                t8_cmesh_reorder (t8_cmesh_t cmesh, sc_MPI_Comm comm);
  */
 void                t8_cmesh_commit (t8_cmesh_t cmesh, sc_MPI_Comm comm);
 
-/* TODO: Document */
+/** Save a committed cmesh to the files fileprefix_RANK.cmesh.
+ * A replicated cmesh is only written by rank 0.
+ * The only tree attributes that can be saved are the tree vertices and
+ * the physical and boundary tags that \ref t8_cmesh_from_msh_file stores
+ * (see t8_cmesh_readmshfile.h). If a tree has any other attribute, the
+ * cmesh cannot be saved and false is returned.
+ * \param [in] cmesh       A committed cmesh.
+ * \param [in] fileprefix  The prefix of the output files.
+ * \return                 True on success, false on failure.
+ */
 int                 t8_cmesh_save (t8_cmesh_t cmesh, const char *fileprefix);
 
 /* TODO: Document */
@@ -712,6 +712,66 @@ t8_cmesh_tree_vertices_negative_volume (t8_eclass_t eclass,
   return eclass == T8_ECLASS_TET ? sc_prod > 0 : sc_prod < 0;
 }
 
+int
+t8_cmesh_tree_vertices_correct_negative_volume (t8_eclass_t eclass,
+                                                double *vertices,
+                                                int num_vertices)
+{
+  double              temp;
+  int                 num_switches = 0;
+  int                 switch_indices[4] = { 0 };
+  int                 iswitch, i;
+
+  if (!t8_cmesh_tree_vertices_negative_volume (eclass, vertices,
+                                               num_vertices)) {
+    return 0;
+  }
+  /* The volume described is negative. We need to change vertices.
+   * For tets we switch 0 and 3.
+   * For prisms we switch 0 and 3, 1 and 4, 2 and 5.
+   * For hexahedra we switch 0 and 4, 1 and 5, 2 and 6, 3 and 7.
+   * For pyramids we switch 0 and 4 */
+  T8_ASSERT (t8_eclass_to_dimension[eclass] == 3);
+  switch (eclass) {
+  case T8_ECLASS_TET:
+    /* We switch vertex 0 and vertex 3 */
+    num_switches = 1;
+    switch_indices[0] = 3;
+    break;
+  case T8_ECLASS_PRISM:
+    num_switches = 3;
+    switch_indices[0] = 3;
+    switch_indices[1] = 4;
+    switch_indices[2] = 5;
+    break;
+  case T8_ECLASS_HEX:
+    num_switches = 4;
+    switch_indices[0] = 4;
+    switch_indices[1] = 5;
+    switch_indices[2] = 6;
+    switch_indices[3] = 7;
+    break;
+  case T8_ECLASS_PYRAMID:
+    num_switches = 1;
+    switch_indices[0] = 4;
+    break;
+  default:
+    SC_ABORT_NOT_REACHED ();
+  }
+
+  for (iswitch = 0; iswitch < num_switches; ++iswitch) {
+    /* We switch vertex 0 + iswitch and vertex switch_indices[iswitch] */
+    for (i = 0; i < 3; i++) {
+      temp = vertices[3 * iswitch + i];
+      vertices[3 * iswitch + i] = vertices[3 * switch_indices[iswitch] + i];
+      vertices[3 * switch_indices[iswitch] + i] = temp;
+    }
+  }
+  T8_ASSERT (!t8_cmesh_tree_vertices_negative_volume
+             (eclass, vertices, num_vertices));
+  return 1;
+}
+
 #ifdef T8_ENABLE_DEBUG
 /* After a cmesh is committed, check whether all trees in a cmesh do have positive volume.
  * Returns true if all trees have positive volume.
@@ -1453,7 +1513,7 @@ t8_cmesh_reset (t8_cmesh_t * pcmesh)
   }
   else {
     if (cmesh->trees != NULL) {
-      t8_cmesh_trees_destroy (&cmesh->trees);
+      t8_cmesh_trees_unref (&cmesh->trees);
     }
     T8_ASSERT (cmesh->set_from == NULL);
   }
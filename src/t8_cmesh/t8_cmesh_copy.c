@@ -35,9 +35,6 @@
 void
 t8_cmesh_copy (t8_cmesh_t cmesh, t8_cmesh_t cmesh_from, sc_MPI_Comm comm)
 {
-  size_t              num_parts, iz;
-  t8_locidx_t         first_tree, num_trees, first_ghost, num_ghosts;
-
   T8_ASSERT (t8_cmesh_is_initialized (cmesh));
   T8_ASSERT (!cmesh->committed);
   T8_ASSERT (t8_cmesh_is_committed (cmesh_from));
@@ -72,19 +69,10 @@ t8_cmesh_copy (t8_cmesh_t cmesh, t8_cmesh_t cmesh_from, sc_MPI_Comm comm)
           cmesh_from->num_local_trees_per_eclass,
           T8_ECLASS_COUNT * sizeof (t8_locidx_t));
 
-  /* Copy the tree info */
-  num_parts = t8_cmesh_trees_get_numproc (cmesh_from->trees);
-  cmesh->trees = NULL;
-  t8_cmesh_trees_init (&cmesh->trees, num_parts, cmesh_from->num_local_trees,
-                       cmesh_from->num_ghosts);
-  t8_cmesh_trees_copy_toproc (cmesh->trees, cmesh_from->trees,
-                              cmesh_from->num_local_trees,
-                              cmesh_from->num_ghosts);
-  for (iz = 0; iz < num_parts; iz++) {
-    t8_cmesh_trees_get_part_data (cmesh_from->trees, iz, &first_tree,
-                                  &num_trees, &first_ghost, &num_ghosts);
-    t8_cmesh_trees_start_part (cmesh->trees, iz, first_tree, num_trees,
-                               first_ghost, num_ghosts, 0);
-    t8_cmesh_trees_copy_part (cmesh->trees, iz, cmesh_from->trees, iz);
-  }
+  /* Share the tree info. The trees of a committed cmesh are not modified,
+   * thus we only reference them. Whoever needs to modify them must call
+   * t8_cmesh_trees_unshare first. */
+  T8_ASSERT (cmesh->trees == NULL);
+  t8_cmesh_trees_ref (cmesh_from->trees);
+  cmesh->trees = cmesh_from->trees;
 }
@@ -350,14 +350,36 @@ die_node:
   return NULL;
 }
 
+/* This struct stores all information associated to a tree's face.
+ * We need it to find neighbor trees.
+ * We also use it to store the lower dimensional boundary elements of the
+ * file, in which case ltree_id and face_number are not used.
+ */
+typedef struct
+{
+  t8_locidx_t         ltree_id; /* The local id of the tree this face belongs to */
+  int8_t              face_number;      /* The number of that face whitin the tree */
+  int                 num_vertices;     /* The number of vertices of this face. */
+  long               *vertices; /* The indices of these vertices. */
+  int                 physical_tag;     /* The physical tag of a boundary element */
+} t8_msh_file_face_t;
+
 /* fp should be set after the Nodes section, right before the tree section.
  * If vertex_indices is not NULL, it is allocated and will store
  * for each tree the indices of its vertices.
- * They are stored as arrays of long ints. */
+ * They are stored as arrays of long ints.
+ * If tree_tags is not NULL, the physical tag of each tree is pushed to it
+ * as an int.
+ * If boundary_elements is not NULL, each element of dimension dim - 1
+ * is pushed to it as a t8_msh_file_face_t together with its physical tag.
+ * The vertices of these entries are allocated and must be freed by the
+ * caller. */
 int
 t8_cmesh_msh_file_read_eles (t8_cmesh_t cmesh, FILE * fp,
                              sc_hash_t * vertices,
-                             sc_array_t ** vertex_indices, int dim)
+                             sc_array_t ** vertex_indices,
+                             sc_array_t * tree_tags,
+                             sc_array_t * boundary_elements, int dim)
 {
   char               *line = (char *) malloc (1024), *line_modify;
   char                first_word[2048] = "\0";
@@ -368,8 +390,9 @@ t8_cmesh_msh_file_read_eles (t8_cmesh_t cmesh, FILE * fp,
   t8_msh_file_node_t  Node, **found_node;
   long                lnum_trees;
   int                 retval, i;
-  int                 ele_type, num_tags;
-  int                 num_nodes, t8_vertex_num;
+  int                 ele_type, num_tags, physical_tag;
+  int                 num_nodes, t8_vertex_num, ele_dim;
+  t8_msh_file_face_t *Boundary;
   long                node_indices[8], *stored_indices;
   double              tree_vertices[24];
 
@@ -419,8 +442,8 @@ t8_cmesh_msh_file_read_eles (t8_cmesh_t cmesh, FILE * fp,
      * tree_number tree_type Number_tags tag_1 ... tag_n Node_1 ... Node_m
      *
      * We ignore the tree number, read the type and the number of (integer) tags.
-     * We also ignore the tags and after we know the type, we read the
-     * nodes.
+     * Of the tags we only keep the first one, which is the physical tag.
+     * After we know the type, we read the nodes.
      */
     sscanf (line, "%*i %i %i", &ele_type, &num_tags);
     /* Check if the tree type is supported */
@@ -433,17 +456,25 @@ t8_cmesh_msh_file_read_eles (t8_cmesh_t cmesh, FILE * fp,
     /* Continue if tree type is supported */
     eclass = t8_msh_tree_type_to_eclass[ele_type];
     T8_ASSERT (eclass != T8_ECLASS_COUNT);
-    /* Check if the tree is of the correct dimension */
-    if (t8_eclass_to_dimension[eclass] == dim) {
-      /* The tree is of the correct dimension,
-       * add it to the cmesh and read its nodes */
-      t8_cmesh_set_tree_class (cmesh, tree_count, eclass);
+    ele_dim = t8_eclass_to_dimension[eclass];
+    /* Check if the tree is of the correct dimension or a boundary element
+     * that we need to store */
+    if (ele_dim == dim
+        || (ele_dim == dim - 1 && boundary_elements != NULL)) {
       line_modify = line;
       /* Since the tags are stored before the node indices, we need to
        * skip them first. But since the number of them is unknown and the
-       * lenght (in characters) of them, we have to skip one by one. */
+       * lenght (in characters) of them, we have to skip one by one.
+       * On the way, we read the physical tag. Elements without tags
+       * get the physical tag 0. */
+      physical_tag = 0;
       for (i = 0; i < 3 + num_tags; i++) {
         T8_ASSERT (strcmp (line_modify, "\0"));
+        if (i == 3 && sscanf (line_modify, "%i", &physical_tag) != 1) {
+          t8_global_errorf ("Premature end of line while reading tags.\n");
+          t8_debugf ("The line is %s", line);
+          goto die_ele;
+        }
         /* move line_modify to the next word in the line */
         (void) strsep (&line_modify, " ");
       }
@@ -460,6 +491,23 @@ t8_cmesh_msh_file_read_eles (t8_cmesh_t cmesh, FILE * fp,
         /* move line_modify to the next word in the line */
         (void) strsep (&line_modify, " ");
       }
+      if (ele_dim != dim) {
+        /* This is a boundary element. We store its nodes and its tag
+         * and match it against the tree faces later. */
+        Boundary = (t8_msh_file_face_t *) sc_array_push (boundary_elements);
+        Boundary->ltree_id = -1;
+        Boundary->face_number = -1;
+        Boundary->num_vertices = num_nodes;
+        Boundary->vertices = T8_ALLOC (long, num_nodes);
+        memcpy (Boundary->vertices, node_indices, num_nodes * sizeof (long));
+        Boundary->physical_tag = physical_tag;
+        continue;
+      }
+      /* The tree is of the correct dimension, add it to the cmesh */
+      t8_cmesh_set_tree_class (cmesh, tree_count, eclass);
+      if (tree_tags != NULL) {
+        *(int *) sc_array_push (tree_tags) = physical_tag;
+      }
       /* Now the nodes are read and we get their coordinates from
        * the stored nodes */
       for (i = 0; i < num_nodes; i++) {
@@ -472,58 +520,11 @@ t8_cmesh_msh_file_read_eles (t8_cmesh_t cmesh, FILE * fp,
         tree_vertices[3 * t8_vertex_num + 2] = (*found_node)->coordinates[2];
       }
       /* Detect and correct negative volumes */
-      if (t8_cmesh_tree_vertices_negative_volume (eclass, tree_vertices,
-                                                  num_nodes)) {
-        /* The volume described is negative. We need to change vertices.
-         * For tets we switch 0 and 3.
-         * For prisms we switch 0 and 3, 1 and 4, 2 and 5.
-         * For hexahedra we switch 0 and 4, 1 and 5, 2 and 6, 3 and 7.
-         * For pyramids we switch 0 and 4 */
-        double              temp;
-        int                 num_switches = 0;
-        int                 switch_indices[4] = { 0 };
-        int                 iswitch;
-        T8_ASSERT (t8_eclass_to_dimension[eclass] == 3);
-        t8_debugf ("Correcting negative volume of tree %li\n", tree_count);
-        switch (eclass) {
-        case T8_ECLASS_TET:
-          /* We switch vertex 0 and vertex 3 */
-          num_switches = 1;
-          switch_indices[0] = 3;
-          break;
-        case T8_ECLASS_PRISM:
-          num_switches = 3;
-          switch_indices[0] = 3;
-          switch_indices[1] = 4;
-          switch_indices[2] = 5;
-          break;
-        case T8_ECLASS_HEX:
-          num_switches = 4;
-          switch_indices[0] = 4;
-          switch_indices[1] = 5;
-          switch_indices[2] = 6;
-          switch_indices[3] = 7;
-          break;
-        case T8_ECLASS_PYRAMID:
-          num_switches = 1;
-          switch_indices[0] = 4;
-          break;
-        default:
-          SC_ABORT_NOT_REACHED ();
-        }
-
-        for (iswitch = 0; iswitch < num_switches; ++iswitch) {
-          /* We switch vertex 0 + iswitch and vertex switch_indices[iswitch] */
-          for (i = 0; i < 3; i++) {
-            temp = tree_vertices[3 * iswitch + i];
-            tree_vertices[3 * iswitch + i] =
-              tree_vertices[3 * switch_indices[iswitch] + i];
-            tree_vertices[3 * switch_indices[iswitch] + i] = temp;
-          }
-        }
-        T8_ASSERT (!t8_cmesh_tree_vertices_negative_volume
-                   (eclass, tree_vertices, num_nodes));
-      }                         /* End of negative volume handling */
+      if (t8_cmesh_tree_vertices_correct_negative_volume (eclass,
+                                                          tree_vertices,
+                                                          num_nodes)) {
+        t8_debugf ("Corrected negative volume of tree %li\n", tree_count);
+      }
       /* Set the vertices of this tree */
       t8_cmesh_set_tree_vertices (cmesh, tree_count, t8_get_package_id (),
                                   0, tree_vertices, num_nodes);
@@ -552,17 +553,6 @@ die_ele:
   return -1;
 }
 
-/* This struct stores all information associated to a tree's face.
- * We need it to find neighbor trees.
- */
-typedef struct
-{
-  t8_locidx_t         ltree_id; /* The local id of the tree this face belongs to */
-  int8_t              face_number;      /* The number of that face whitin the tree */
-  int                 num_vertices;     /* The number of vertices of this face. */
-  long               *vertices; /* The indices of these vertices. */
-} t8_msh_file_face_t;
-
 /* Hash a face. The hash value is the sum of its vertex indices */
 static unsigned
 t8_msh_file_face_hash (const void *face, const void *data)
@@ -708,12 +698,18 @@ t8_msh_file_face_orientation (t8_msh_file_face_t * Face_a,
  * vertices, find the neighborship relations of each element */
 /* This routine does only find neighbors between local trees.
  * Use with care if cmesh is partitioned. */
+/* If boundary_elements is not NULL, each of its entries that matches a
+ * domain boundary face of a tree writes its physical tag to face_tags,
+ * which stores T8_ECLASS_MAX_FACES entries per tree. */
 static void
 t8_cmesh_msh_file_find_neighbors (t8_cmesh_t cmesh,
-                                  sc_array_t * vertex_indices)
+                                  sc_array_t * vertex_indices,
+                                  sc_array_t * boundary_elements,
+                                  int *face_tags)
 {
   sc_hash_t          *faces;
-  t8_msh_file_face_t *Face, **pNeighbor, *Neighbor;
+  t8_msh_file_face_t *Face, **pNeighbor, *Neighbor, *Boundary;
+  size_t              iboundary;
   sc_mempool_t       *face_mempool;
   t8_gloidx_t         gtree_it;
   t8_gloidx_t         gtree_id, gtree_neighbor;
@@ -802,6 +798,19 @@ t8_cmesh_msh_file_find_neighbors (t8_cmesh_t cmesh,
   }
   /* The remaining faces are domain boundaries */
   sc_hash_foreach (faces, t8_msh_file_face_set_boundary);
+  if (boundary_elements != NULL) {
+    /* Find the boundary face of each boundary element and store its tag */
+    for (iboundary = 0; iboundary < boundary_elements->elem_count;
+         iboundary++) {
+      Boundary = (t8_msh_file_face_t *)
+        sc_array_index (boundary_elements, iboundary);
+      if (sc_hash_lookup (faces, Boundary, (void ***) &pNeighbor)) {
+        Face = *pNeighbor;
+        face_tags[Face->ltree_id * T8_ECLASS_MAX_FACES + Face->face_number]
+          = Boundary->physical_tag;
+      }
+    }
+  }
   /* Free the faces and the hash */
   sc_hash_foreach (faces, t8_msh_file_face_free);
   sc_mempool_destroy (face_mempool);
@@ -809,6 +818,46 @@ t8_cmesh_msh_file_find_neighbors (t8_cmesh_t cmesh,
   t8_debugf ("Done finding tree neighbors.\n");
 }
 
+/* Set the physical tag of each tree and the physical tags of its boundary
+ * faces as tree attributes. Tags that are 0 are not stored.
+ * tree_tags and face_tags must not be freed before the cmesh is committed. */
+static void
+t8_cmesh_msh_file_set_tags (t8_cmesh_t cmesh, sc_array_t * tree_tags,
+                            int *face_tags)
+{
+  t8_gloidx_t         gtree_it;
+  t8_eclass_t         eclass;
+  int                 face_it, num_faces, has_tags;
+  int                *tree_tag, *tree_face_tags;
+  t8_stash_class_struct_t *class_entry;
+
+  for (gtree_it = 0; gtree_it < (t8_gloidx_t) tree_tags->elem_count;
+       gtree_it++) {
+    /* The trees were put into the stash in order of their ids */
+    class_entry = (t8_stash_class_struct_t *)
+      t8_sc_array_index_locidx (&cmesh->stash->classes, gtree_it);
+    T8_ASSERT (class_entry->id == gtree_it);
+    eclass = class_entry->eclass;
+    tree_tag = (int *) t8_sc_array_index_locidx (tree_tags, gtree_it);
+    if (*tree_tag != 0) {
+      t8_cmesh_set_attribute (cmesh, gtree_it, t8_get_package_id (),
+                              T8_CMESH_MSH_PHYSICAL_TAG_KEY, tree_tag,
+                              sizeof (int), 1);
+    }
+    /* Only store the face tags of trees with at least one tagged face */
+    num_faces = t8_eclass_num_faces[eclass];
+    tree_face_tags = face_tags + gtree_it * T8_ECLASS_MAX_FACES;
+    for (face_it = 0, has_tags = 0; face_it < num_faces; face_it++) {
+      has_tags |= tree_face_tags[face_it] != 0;
+    }
+    if (has_tags) {
+      t8_cmesh_set_attribute (cmesh, gtree_it, t8_get_package_id (),
+                              T8_CMESH_MSH_BOUNDARY_TAGS_KEY, tree_face_tags,
+                              num_faces * sizeof (int), 1);
+    }
+  }
+}
+
 t8_cmesh_t
 t8_cmesh_from_msh_file (const char *fileprefix, int partition,
                         sc_MPI_Comm comm, int dim, int main_proc)
@@ -824,6 +873,9 @@ t8_cmesh_from_msh_file (const char *fileprefix, int partition,
   FILE               *file;
   t8_gloidx_t         num_trees, first_tree, last_tree = -1;
   int                 main_proc_read_successful = 0;
+  sc_array_t         *tree_tags = NULL, boundary_elements;
+  t8_msh_file_face_t *Boundary;
+  int                *face_tags = NULL;
 
   mpiret = sc_MPI_Comm_size (comm, &mpisize);
   SC_CHECK_MPI (mpiret);
@@ -876,10 +928,22 @@ t8_cmesh_from_msh_file (const char *fileprefix, int partition,
     }
     /* read nodes from the file */
     vertices = t8_msh_file_read_nodes (file, &num_vertices, &node_mempool);
-    t8_cmesh_msh_file_read_eles (cmesh, file, vertices, &vertex_indices, dim);
+    tree_tags = sc_array_new (sizeof (int));
+    sc_array_init (&boundary_elements, sizeof (t8_msh_file_face_t));
+    t8_cmesh_msh_file_read_eles (cmesh, file, vertices, &vertex_indices,
+                                 tree_tags, &boundary_elements, dim);
     /* close the file and free the memory for the nodes */
     fclose (file);
-    t8_cmesh_msh_file_find_neighbors (cmesh, vertex_indices);
+    face_tags = T8_ALLOC_ZERO (int, T8_ECLASS_MAX_FACES
+                               * tree_tags->elem_count);
+    t8_cmesh_msh_file_find_neighbors (cmesh, vertex_indices,
+                                      &boundary_elements, face_tags);
+    t8_cmesh_msh_file_set_tags (cmesh, tree_tags, face_tags);
+    while (boundary_elements.elem_count > 0) {
+      Boundary = (t8_msh_file_face_t *) sc_array_pop (&boundary_elements);
+      T8_FREE (Boundary->vertices);
+    }
+    sc_array_reset (&boundary_elements);
     if (vertices != NULL) {
       sc_hash_destroy (vertices);
     }
@@ -932,5 +996,36 @@ t8_cmesh_from_msh_file (const char *fileprefix, int partition,
   if (cmesh != NULL) {
     t8_cmesh_commit (cmesh, comm);
   }
+  /* The tags were copied at commit and we can free them now */
+  if (tree_tags != NULL) {
+    sc_array_destroy (tree_tags);
+    T8_FREE (face_tags);
+  }
   return cmesh;
 }
+
+int
+t8_cmesh_msh_get_tree_physical_tag (t8_cmesh_t cmesh, t8_locidx_t ltreeid)
+{
+  int                *tag;
+
+  T8_ASSERT (t8_cmesh_is_committed (cmesh));
+  tag = (int *) t8_cmesh_get_attribute (cmesh, t8_get_package_id (),
+                                        T8_CMESH_MSH_PHYSICAL_TAG_KEY,
+                                        ltreeid);
+  return tag == NULL ? 0 : *tag;
+}
+
+int
+t8_cmesh_msh_get_tree_face_boundary_tag (t8_cmesh_t cmesh,
+                                         t8_locidx_t ltreeid, int face)
+{
+  int                *tags;
+
+  T8_ASSERT (t8_cmesh_is_committed (cmesh));
+  T8_ASSERT (0 <= face && face < T8_ECLASS_MAX_FACES);
+  tags = (int *) t8_cmesh_get_attribute (cmesh, t8_get_package_id (),
+                                         T8_CMESH_MSH_BOUNDARY_TAGS_KEY,
+                                         ltreeid);
+  return tags == NULL ? 0 : tags[face];
+}
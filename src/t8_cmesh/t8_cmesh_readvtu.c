@@ -0,0 +1,1198 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#include <ctype.h>
+#include <t8_eclass.h>
+#include <t8_cmesh_readvtu.h>
+#include <t8_cmesh_vtk.h>
+
+/* The number of vtk cell types that we look up, VTK_PYRAMID has the
+ * largest number of all supported types. */
+#define T8_VTU_NUM_CELL_TYPES 15
+
+/* look-up table to translate the vtk cell type to a t8code tree class.
+ * See also https://vtk.org/doc/nightly/html/vtkCellType_8h.html */
+static const t8_eclass_t t8_vtu_cell_type_to_eclass[T8_VTU_NUM_CELL_TYPES] = {
+  T8_ECLASS_COUNT,              /* 0 VTK_EMPTY_CELL is not valid */
+  T8_ECLASS_VERTEX,             /* 1 VTK_VERTEX */
+  T8_ECLASS_COUNT,              /* 2 VTK_POLY_VERTEX is not supported */
+  T8_ECLASS_LINE,               /* 3 VTK_LINE */
+  T8_ECLASS_COUNT,              /* 4 VTK_POLY_LINE is not supported */
+  T8_ECLASS_TRIANGLE,           /* 5 VTK_TRIANGLE */
+  T8_ECLASS_COUNT,              /* 6 VTK_TRIANGLE_STRIP is not supported */
+  T8_ECLASS_COUNT,              /* 7 VTK_POLYGON is not supported */
+  T8_ECLASS_QUAD,               /* 8 VTK_PIXEL */
+  T8_ECLASS_QUAD,               /* 9 VTK_QUAD */
+  T8_ECLASS_TET,                /* 10 VTK_TETRA */
+  T8_ECLASS_HEX,                /* 11 VTK_VOXEL */
+  T8_ECLASS_HEX,                /* 12 VTK_HEXAHEDRON */
+  T8_ECLASS_PRISM,              /* 13 VTK_WEDGE */
+  T8_ECLASS_PYRAMID             /* 14 VTK_PYRAMID */
+};
+
+/* VTK_PIXEL and VTK_VOXEL number their vertices in the same
+ * order as t8code does for quads and hexes. */
+#define T8_VTU_CELL_TYPE_IS_LEXICOGRAPHIC(type) ((type) == 8 || (type) == 11)
+
+/* The value types of a DataArray */
+typedef enum
+{
+  T8_VTU_INT8,
+  T8_VTU_UINT8,
+  T8_VTU_INT16,
+  T8_VTU_UINT16,
+  T8_VTU_INT32,
+  T8_VTU_UINT32,
+  T8_VTU_INT64,
+  T8_VTU_UINT64,
+  T8_VTU_FLOAT32,
+  T8_VTU_FLOAT64,
+  T8_VTU_NUM_TYPES
+} t8_vtu_type_t;
+
+static const char  *t8_vtu_type_names[T8_VTU_NUM_TYPES] = {
+  "Int8", "UInt8", "Int16", "UInt16", "Int32", "UInt32", "Int64", "UInt64",
+  "Float32", "Float64"
+};
+
+static const size_t t8_vtu_type_sizes[T8_VTU_NUM_TYPES] = {
+  1, 1, 2, 2, 4, 4, 8, 8, 4, 8
+};
+
+/* A vtk xml file that was read into memory */
+typedef struct
+{
+  char               *content;  /* The file content. The xml part is NUL terminated. */
+  size_t              size;     /* The number of bytes in the file. */
+  int                 header_bytes;     /* The size of the binary block headers, 4 or 8 */
+  const char         *appended; /* The start of the appended data or NULL */
+  int                 appended_base64;  /* True if the appended data is base64 encoded */
+  int                 foreign_byte_order;       /* True if the binary data has a different byte order */
+} t8_vtu_file_t;
+
+/* A tree that was read from a piece */
+typedef struct
+{
+  t8_eclass_t         eclass;   /* The class of the tree */
+  double              vertices[3 * T8_ECLASS_MAX_CORNERS];      /* Its vertices in t8code order */
+} t8_vtu_tree_t;
+
+/* A face of a tree, identified by the coordinates of its vertices */
+typedef struct
+{
+  t8_gloidx_t         gtree_id; /* The global id of the tree this face belongs to */
+  int                 rank;     /* The process that owns the tree */
+  int8_t              face_number;      /* The number of that face within the tree */
+  int8_t              eclass;   /* The class of the tree */
+  int8_t              num_vertices;     /* The number of vertices of this face */
+  int8_t              matched;  /* True if we found a neighbor for this face */
+  double              vertices[3 * T8_ECLASS_MAX_CORNERS_2D];   /* The face vertices in face order */
+} t8_vtu_face_t;
+
+/* A face connection from a tree to a neighbor tree */
+typedef struct
+{
+  t8_gloidx_t         gtree_id; /* The global id of the tree */
+  t8_gloidx_t         neighbor_id;      /* The global id of the neighbor tree */
+  int                 face_number;      /* The face of the tree */
+  int                 neighbor_face;    /* The face of the neighbor tree */
+  int                 neighbor_eclass;  /* The class of the neighbor tree */
+  int                 neighbor_rank;    /* The process that owns the neighbor tree */
+  int                 orientation;      /* The orientation of the connection */
+} t8_vtu_join_t;
+
+/* Read a complete file into memory and append a NUL byte.
+ * Return NULL on failure. */
+static char        *
+t8_vtu_read_file (const char *filename, size_t *size)
+{
+  FILE               *file;
+  char               *content;
+  long                file_size;
+
+  file = fopen (filename, "rb");
+  if (file == NULL) {
+    t8_errorf ("Could not open file %s\n", filename);
+    return NULL;
+  }
+  if (fseek (file, 0, SEEK_END) || (file_size = ftell (file)) < 0
+      || fseek (file, 0, SEEK_SET)) {
+    t8_errorf ("Could not determine the size of file %s\n", filename);
+    fclose (file);
+    return NULL;
+  }
+  content = T8_ALLOC (char, file_size + 1);
+  if (fread (content, 1, file_size, file) != (size_t) file_size) {
+    t8_errorf ("Could not read file %s\n", filename);
+    T8_FREE (content);
+    fclose (file);
+    return NULL;
+  }
+  content[file_size] = '\0';
+  fclose (file);
+  *size = file_size;
+  return content;
+}
+
+/* Find the next opening tag with a given name in a NUL terminated string.
+ * Return a pointer to its '<' or NULL if there is no such tag. */
+static const char  *
+t8_vtu_find_tag (const char *pos, const char *name)
+{
+  size_t              len = strlen (name);
+
+  while ((pos = strchr (pos, '<')) != NULL) {
+    pos++;
+    if (!strncmp (pos, name, len) && (isspace (pos[len]) || pos[len] == '>'
+                                      || pos[len] == '/')) {
+      return pos - 1;
+    }
+  }
+  return NULL;
+}
+
+/* Copy the value of an attribute of the tag starting at tag to value,
+ * which holds size bytes.
+ * Return true if the attribute exists and false otherwise. */
+static int
+t8_vtu_tag_attribute (const char *tag, const char *name, char *value,
+                      size_t size)
+{
+  const char         *end, *pos, *start, *stop;
+  size_t              len = strlen (name), num_chars;
+
+  end = strchr (tag, '>');
+  if (end == NULL) {
+    return 0;
+  }
+  for (pos = strstr (tag, name); pos != NULL && pos < end;
+       pos = strstr (pos + len, name)) {
+    if (isspace (pos[-1]) && pos[len] == '='
+        && (pos[len + 1] == '"' || pos[len + 1] == '\'')) {
+      start = pos + len + 2;
+      stop = strchr (start, pos[len + 1]);
+      if (stop == NULL || stop > end) {
+        return 0;
+      }
+      num_chars = SC_MIN ((size_t) (stop - start), size - 1);
+      memcpy (value, start, num_chars);
+      value[num_chars] = '\0';
+      return 1;
+    }
+  }
+  return 0;
+}
+
+/* Return the value of a base64 character or -1 if it is not one. */
+static int
+t8_vtu_base64_value (char c)
+{
+  if ('A' <= c && c <= 'Z') {
+    return c - 'A';
+  }
+  if ('a' <= c && c <= 'z') {
+    return c - 'a' + 26;
+  }
+  if ('0' <= c && c <= '9') {
+    return c - '0' + 52;
+  }
+  if (c == '+') {
+    return 62;
+  }
+  if (c == '/') {
+    return 63;
+  }
+  return -1;
+}
+
+/* Decode at most max_bytes bytes of base64 encoded text.
+ * Each group of four characters is decoded on its own, such that data
+ * that was encoded in several blocks with padding in between is
+ * decoded correctly. Decoding stops at the first character that is
+ * neither base64 nor whitespace.
+ * Return the number of decoded bytes. */
+static size_t
+t8_vtu_base64_decode (const char *text, unsigned char *out,
+                      size_t max_bytes)
+{
+  size_t              count = 0;
+  unsigned long       buffer = 0;
+  int                 num_chars = 0, num_padding = 0, value, ibyte;
+
+  for (; count < max_bytes && *text != '\0'; text++) {
+    if (isspace (*text)) {
+      continue;
+    }
+    if (*text == '=') {
+      value = 0;
+      num_padding++;
+    }
+    else if ((value = t8_vtu_base64_value (*text)) < 0) {
+      break;
+    }
+    buffer = (buffer << 6) | value;
+    if (++num_chars == 4) {
+      for (ibyte = 0; ibyte < 3 - num_padding && count < max_bytes; ibyte++) {
+        out[count++] = (buffer >> (16 - 8 * ibyte)) & 0xff;
+      }
+      buffer = 0;
+      num_chars = num_padding = 0;
+    }
+  }
+  return count;
+}
+
+/* Convert the ivalue-th entry of an array of a given type to double. */
+static double
+t8_vtu_value_to_double (t8_vtu_type_t type, const unsigned char *data,
+                        size_t ivalue)
+{
+  const unsigned char *pos = data + ivalue * t8_vtu_type_sizes[type];
+
+  switch (type) {
+  case T8_VTU_INT8:
+    return *(const int8_t *) pos;
+  case T8_VTU_UINT8:
+    return *(const uint8_t *) pos;
+  case T8_VTU_INT16:
+    {
+      int16_t             value;
+      memcpy (&value, pos, sizeof (value));
+      return value;
+    }
+  case T8_VTU_UINT16:
+    {
+      uint16_t            value;
+      memcpy (&value, pos, sizeof (value));
+      return value;
+    }
+  case T8_VTU_INT32:
+    {
+      int32_t             value;
+      memcpy (&value, pos, sizeof (value));
+      return value;
+    }
+  case T8_VTU_UINT32:
+    {
+      uint32_t            value;
+      memcpy (&value, pos, sizeof (value));
+      return value;
+    }
+  case T8_VTU_INT64:
+    {
+      int64_t             value;
+      memcpy (&value, pos, sizeof (value));
+      return (double) value;
+    }
+  case T8_VTU_UINT64:
+    {
+      uint64_t            value;
+      memcpy (&value, pos, sizeof (value));
+      return (double) value;
+    }
+  case T8_VTU_FLOAT32:
+    {
+      float               value;
+      memcpy (&value, pos, sizeof (value));
+      return value;
+    }
+  case T8_VTU_FLOAT64:
+    {
+      double              value;
+      memcpy (&value, pos, sizeof (value));
+      return value;
+    }
+  default:
+    SC_ABORT_NOT_REACHED ();
+  }
+  return 0;
+}
+
+/* Read the header of a binary block, which stores the number of data bytes. */
+static size_t
+t8_vtu_block_size (const t8_vtu_file_t * file, const unsigned char *header)
+{
+  if (file->header_bytes == 4) {
+    uint32_t            size;
+    memcpy (&size, header, sizeof (size));
+    return size;
+  }
+  else {
+    uint64_t            size;
+    memcpy (&size, header, sizeof (size));
+    return size;
+  }
+}
+
+/* Read num_values values of the DataArray starting at tag and store
+ * them as doubles in values.
+ * Return true on success and false otherwise. */
+static int
+t8_vtu_read_data_array (const t8_vtu_file_t * file, const char *tag,
+                        size_t num_values, double *values)
+{
+  char                attribute[BUFSIZ], *end;
+  const char         *pos;
+  unsigned char      *decoded = NULL;
+  const unsigned char *data;
+  unsigned char       header[8];
+  size_t              ivalue, num_bytes, offset;
+  int                 itype;
+  t8_vtu_type_t       type;
+
+  if (!t8_vtu_tag_attribute (tag, "type", attribute, BUFSIZ)) {
+    t8_errorf ("DataArray without type.\n");
+    return 0;
+  }
+  for (itype = 0; itype < T8_VTU_NUM_TYPES; itype++) {
+    if (!strcmp (attribute, t8_vtu_type_names[itype])) {
+      break;
+    }
+  }
+  if (itype == T8_VTU_NUM_TYPES) {
+    t8_errorf ("Unsupported DataArray type %s.\n", attribute);
+    return 0;
+  }
+  type = (t8_vtu_type_t) itype;
+  num_bytes = num_values * t8_vtu_type_sizes[type];
+  if (!t8_vtu_tag_attribute (tag, "format", attribute, BUFSIZ)) {
+    strcpy (attribute, "ascii");
+  }
+  /* The inline data starts after the tag */
+  pos = strchr (tag, '>') + 1;
+
+  if (!strcmp (attribute, "ascii")) {
+    for (ivalue = 0; ivalue < num_values; ivalue++) {
+      values[ivalue] = strtod (pos, &end);
+      if (end == pos) {
+        t8_errorf ("Premature end of ascii DataArray.\n");
+        return 0;
+      }
+      pos = end;
+    }
+    return 1;
+  }
+  if (file->foreign_byte_order) {
+    t8_errorf ("Binary data with foreign byte order is not supported.\n");
+    return 0;
+  }
+  if (!strcmp (attribute, "appended")) {
+    if (file->appended == NULL
+        || !t8_vtu_tag_attribute (tag, "offset", attribute, BUFSIZ)) {
+      t8_errorf ("Appended DataArray without appended data.\n");
+      return 0;
+    }
+    offset = strtoul (attribute, NULL, 10);
+    pos = file->appended + offset;
+    if (pos >= file->content + file->size) {
+      t8_errorf ("DataArray offset %zu is out of range.\n", offset);
+      return 0;
+    }
+    if (!file->appended_base64) {
+      /* Raw data, a header with the number of bytes followed by the data */
+      if (pos + file->header_bytes > file->content + file->size) {
+        t8_errorf ("Premature end of appended data.\n");
+        return 0;
+      }
+      memcpy (header, pos, file->header_bytes);
+      data = (const unsigned char *) pos + file->header_bytes;
+      if (t8_vtu_block_size (file, header) < num_bytes
+          || (const char *) data + num_bytes > file->content + file->size) {
+        t8_errorf ("Premature end of appended data.\n");
+        return 0;
+      }
+      for (ivalue = 0; ivalue < num_values; ivalue++) {
+        values[ivalue] = t8_vtu_value_to_double (type, data, ivalue);
+      }
+      return 1;
+    }
+  }
+  else if (strcmp (attribute, "binary")) {
+    t8_errorf ("Unsupported DataArray format %s.\n", attribute);
+    return 0;
+  }
+  /* The data is base64 encoded, either inline or appended.
+   * We first decode the header and then the header and the data. */
+  if (t8_vtu_base64_decode (pos, header, file->header_bytes)
+      != (size_t) file->header_bytes
+      || t8_vtu_block_size (file, header) < num_bytes) {
+    t8_errorf ("Invalid header of binary DataArray.\n");
+    return 0;
+  }
+  decoded = T8_ALLOC (unsigned char, file->header_bytes + num_bytes);
+  if (t8_vtu_base64_decode (pos, decoded, file->header_bytes + num_bytes)
+      != file->header_bytes + num_bytes) {
+    t8_errorf ("Premature end of binary DataArray.\n");
+    T8_FREE (decoded);
+    return 0;
+  }
+  for (ivalue = 0; ivalue < num_values; ivalue++) {
+    values[ivalue] =
+      t8_vtu_value_to_double (type, decoded + file->header_bytes, ivalue);
+  }
+  T8_FREE (decoded);
+  return 1;
+}
+
+/* Find the DataArray with a given name between pos and the closing
+ * tag section_end of the enclosing section.
+ * If name is NULL, return the first DataArray. */
+static const char  *
+t8_vtu_find_data_array (const char *pos, const char *section_end,
+                        const char *name)
+{
+  const char         *end = strstr (pos, section_end);
+  char                attribute[BUFSIZ];
+
+  while ((pos = t8_vtu_find_tag (pos, "DataArray")) != NULL
+         && (end == NULL || pos < end)) {
+    if (name == NULL
+        || (t8_vtu_tag_attribute (pos, "Name", attribute, BUFSIZ)
+            && !strcmp (attribute, name))) {
+      return pos;
+    }
+    pos++;
+  }
+  return NULL;
+}
+
+/* Open a vtk xml file of a given type and parse its VTKFile tag.
+ * Return true on success and false otherwise. */
+static int
+t8_vtu_file_open (const char *filename, const char *file_type,
+                  t8_vtu_file_t * file)
+{
+  const char         *tag;
+  char                attribute[BUFSIZ], *marker;
+
+  memset (file, 0, sizeof (*file));
+  file->content = t8_vtu_read_file (filename, &file->size);
+  if (file->content == NULL) {
+    return 0;
+  }
+  /* The appended binary data may contain NUL bytes. We terminate the xml
+   * part of the file at the '_' that marks the start of the data. */
+  tag = strstr (file->content, "<AppendedData");
+  if (tag != NULL) {
+    file->appended_base64 =
+      t8_vtu_tag_attribute (tag, "encoding", attribute, BUFSIZ)
+      && !strcmp (attribute, "base64");
+    marker = strchr (file->content + (tag - file->content), '_');
+    if (marker == NULL) {
+      t8_errorf ("No appended data found in file %s\n", filename);
+      T8_FREE (file->content);
+      return 0;
+    }
+    *marker = '\0';
+    file->appended = marker + 1;
+  }
+  tag = t8_vtu_find_tag (file->content, "VTKFile");
+  if (tag == NULL || !t8_vtu_tag_attribute (tag, "type", attribute, BUFSIZ)
+      || strcmp (attribute, file_type)) {
+    t8_errorf ("File %s is not of type %s\n", filename, file_type);
+    T8_FREE (file->content);
+    return 0;
+  }
+  if (t8_vtu_tag_attribute (tag, "compressor", attribute, BUFSIZ)) {
+    t8_errorf ("Compressed file %s is not supported\n", filename);
+    T8_FREE (file->content);
+    return 0;
+  }
+  if (t8_vtu_tag_attribute (tag, "byte_order", attribute, BUFSIZ)) {
+    /* We do not swap bytes. This only matters for binary data. */
+    const int           one = 1;
+    file->foreign_byte_order = strcmp (attribute, *(const char *) &one ?
+                                       "LittleEndian" : "BigEndian") != 0;
+  }
+  file->header_bytes = 4;
+  if (t8_vtu_tag_attribute (tag, "header_type", attribute, BUFSIZ)
+      && !strcmp (attribute, "UInt64")) {
+    file->header_bytes = 8;
+  }
+  return 1;
+}
+
+/* Read all pieces of a .vtu file and append their cells of dimension
+ * dim to trees.
+ * Return true on success and false otherwise. */
+static int
+t8_vtu_read_pieces (const char *filename, int dim, sc_array_t * trees)
+{
+  t8_vtu_file_t       file;
+  const char         *piece, *tag;
+  char                attribute[BUFSIZ];
+  double             *points = NULL, *connectivity = NULL;
+  double             *offsets = NULL, *types = NULL;
+  size_t              num_points, num_cells, num_connectivity, icell;
+  size_t              first_vertex, ipoint;
+  int                 cell_type, ivertex, num_vertices, t8_vertex;
+  t8_eclass_t         eclass;
+  t8_vtu_tree_t      *tree;
+  int                 success = 0;
+
+  if (!t8_vtu_file_open (filename, "UnstructuredGrid", &file)) {
+    return 0;
+  }
+  for (piece = t8_vtu_find_tag (file.content, "Piece"); piece != NULL;
+       piece = t8_vtu_find_tag (piece + 1, "Piece")) {
+    if (!t8_vtu_tag_attribute (piece, "NumberOfPoints", attribute, BUFSIZ)) {
+      t8_errorf ("Piece without NumberOfPoints in file %s\n", filename);
+      goto die_piece;
+    }
+    num_points = strtoul (attribute, NULL, 10);
+    if (!t8_vtu_tag_attribute (piece, "NumberOfCells", attribute, BUFSIZ)) {
+      t8_errorf ("Piece without NumberOfCells in file %s\n", filename);
+      goto die_piece;
+    }
+    num_cells = strtoul (attribute, NULL, 10);
+    if (num_cells == 0) {
+      continue;
+    }
+    /* Read the point coordinates */
+    points = T8_ALLOC (double, 3 * num_points);
+    tag = t8_vtu_find_tag (piece, "Points");
+    if (tag == NULL || (tag = t8_vtu_find_data_array (tag, "</Points>",
+                                                      NULL)) == NULL
+        || !t8_vtu_read_data_array (&file, tag, 3 * num_points, points)) {
+      t8_errorf ("Could not read the points of file %s\n", filename);
+      goto die_piece;
+    }
+    /* Read the offsets and types of the cells */
+    offsets = T8_ALLOC (double, num_cells);
+    types = T8_ALLOC (double, num_cells);
+    tag = t8_vtu_find_tag (piece, "Cells");
+    if (tag == NULL) {
+      t8_errorf ("Could not find the cells of file %s\n", filename);
+      goto die_piece;
+    }
+    if (!t8_vtu_read_data_array (&file, t8_vtu_find_data_array
+                                 (tag, "</Cells>", "offsets"), num_cells,
+                                 offsets)
+        || !t8_vtu_read_data_array (&file, t8_vtu_find_data_array
+                                    (tag, "</Cells>", "types"), num_cells,
+                                    types)) {
+      t8_errorf ("Could not read the cells of file %s\n", filename);
+      goto die_piece;
+    }
+    /* The last offset is the length of the connectivity array */
+    num_connectivity = (size_t) offsets[num_cells - 1];
+    connectivity = T8_ALLOC (double, num_connectivity);
+    if (!t8_vtu_read_data_array (&file, t8_vtu_find_data_array
+                                 (tag, "</Cells>", "connectivity"),
+                                 num_connectivity, connectivity)) {
+      t8_errorf ("Could not read the connectivity of file %s\n", filename);
+      goto die_piece;
+    }
+    for (icell = 0; icell < num_cells; icell++) {
+      cell_type = (int) types[icell];
+      eclass = 0 <= cell_type && cell_type < T8_VTU_NUM_CELL_TYPES ?
+        t8_vtu_cell_type_to_eclass[cell_type] : T8_ECLASS_COUNT;
+      if (eclass == T8_ECLASS_COUNT) {
+        t8_errorf ("Unsupported cell type %i in file %s\n", cell_type,
+                   filename);
+        goto die_piece;
+      }
+      if (t8_eclass_to_dimension[eclass] != dim) {
+        /* We only read cells of the given dimension */
+        continue;
+      }
+      num_vertices = t8_eclass_num_vertices[eclass];
+      first_vertex = icell == 0 ? 0 : (size_t) offsets[icell - 1];
+      if (first_vertex + num_vertices != (size_t) offsets[icell]) {
+        t8_errorf ("Wrong number of vertices of cell %zu in file %s\n",
+                   icell, filename);
+        goto die_piece;
+      }
+      tree = (t8_vtu_tree_t *) sc_array_push (trees);
+      tree->eclass = eclass;
+      for (ivertex = 0; ivertex < num_vertices; ivertex++) {
+        /* Translate the vtk vertex number to the t8code vertex number */
+        t8_vertex = T8_VTU_CELL_TYPE_IS_LEXICOGRAPHIC (cell_type) ? ivertex
+          : t8_eclass_vtk_corner_number[eclass][ivertex];
+        ipoint = (size_t) connectivity[first_vertex + ivertex];
+        if (ipoint >= num_points) {
+          t8_errorf ("Invalid point %zu of cell %zu in file %s\n", ipoint,
+                     icell, filename);
+          goto die_piece;
+        }
+        memcpy (tree->vertices + 3 * t8_vertex, points + 3 * ipoint,
+                3 * sizeof (double));
+      }
+      t8_cmesh_tree_vertices_correct_negative_volume (eclass, tree->vertices,
+                                                      num_vertices);
+    }
+    T8_FREE (points);
+    T8_FREE (offsets);
+    T8_FREE (types);
+    T8_FREE (connectivity);
+    points = offsets = types = connectivity = NULL;
+  }
+  success = 1;
+die_piece:
+  /* Clean up */
+  T8_FREE (points);
+  T8_FREE (offsets);
+  T8_FREE (types);
+  T8_FREE (connectivity);
+  T8_FREE (file.content);
+  return success;
+}
+
+/* Read the list of pieces of a .pvtu file. If the file is a .vtu file
+ * the list consists of the file itself.
+ * On success the piece file names are stored in an array of char *.
+ * Return NULL on failure. */
+static sc_array_t  *
+t8_vtu_read_piece_list (const char *filename)
+{
+  t8_vtu_file_t       file;
+  const char         *piece, *slash;
+  char                source[BUFSIZ];
+  char               *path;
+  sc_array_t         *pieces;
+  int                 dir_length;
+
+  pieces = sc_array_new (sizeof (char *));
+  if (strlen (filename) > 4
+      && !strcmp (filename + strlen (filename) - 4, ".vtu")) {
+    path = T8_ALLOC (char, strlen (filename) + 1);
+    strcpy (path, filename);
+    *(char **) sc_array_push (pieces) = path;
+    return pieces;
+  }
+  if (!t8_vtu_file_open (filename, "PUnstructuredGrid", &file)) {
+    sc_array_destroy (pieces);
+    return NULL;
+  }
+  /* Piece sources are relative to the directory of the .pvtu file */
+  slash = strrchr (filename, '/');
+  dir_length = slash == NULL ? 0 : (int) (slash - filename) + 1;
+  for (piece = t8_vtu_find_tag (file.content, "Piece"); piece != NULL;
+       piece = t8_vtu_find_tag (piece + 1, "Piece")) {
+    if (!t8_vtu_tag_attribute (piece, "Source", source, BUFSIZ)) {
+      t8_errorf ("Piece without Source in file %s\n", filename);
+      continue;
+    }
+    path = T8_ALLOC (char, dir_length + strlen (source) + 1);
+    snprintf (path, dir_length + strlen (source) + 1, "%.*s%s",
+              source[0] == '/' ? 0 : dir_length, filename, source);
+    *(char **) sc_array_push (pieces) = path;
+  }
+  T8_FREE (file.content);
+  return pieces;
+}
+
+/* Hash the coordinates of a vertex. We use the bit pattern of
+ * the doubles, thus we need to identify -0 and 0. */
+static unsigned
+t8_vtu_vertex_hash (const double *vertex)
+{
+  uint64_t            bits, hash = 0;
+  double              coordinate;
+  int                 i;
+
+  for (i = 0; i < 3; i++) {
+    coordinate = vertex[i] == 0 ? 0 : vertex[i];
+    memcpy (&bits, &coordinate, sizeof (bits));
+    hash = (hash ^ bits) * 0x100000001b3ULL;
+    hash ^= hash >> 29;
+  }
+  return (unsigned) (hash ^ (hash >> 32));
+}
+
+/* Hash a face. The hash value is the sum of its vertex hashes,
+ * such that it does not depend on the order of the vertices. */
+static unsigned
+t8_vtu_face_hash (const void *face, const void *data)
+{
+  const t8_vtu_face_t *Face = (const t8_vtu_face_t *) face;
+  unsigned            hash = 0;
+  int                 iv;
+
+  for (iv = 0; iv < Face->num_vertices; iv++) {
+    hash += t8_vtu_vertex_hash (Face->vertices + 3 * iv);
+  }
+  return hash;
+}
+
+/* Return true if two vertices have the same coordinates */
+static int
+t8_vtu_vertex_equal (const double *vertex_a, const double *vertex_b)
+{
+  return vertex_a[0] == vertex_b[0] && vertex_a[1] == vertex_b[1]
+    && vertex_a[2] == vertex_b[2];
+}
+
+/* Two faces are considered equal if they have the same vertices up
+ * to renumeration. */
+static int
+t8_vtu_face_equal (const void *facea, const void *faceb, const void *data)
+{
+  const t8_vtu_face_t *Face_a = (const t8_vtu_face_t *) facea;
+  const t8_vtu_face_t *Face_b = (const t8_vtu_face_t *) faceb;
+  int                 iv, jv, found;
+
+  if (Face_a->num_vertices != Face_b->num_vertices) {
+    return 0;
+  }
+  for (iv = 0; iv < Face_a->num_vertices; iv++) {
+    found = 0;
+    for (jv = 0; jv < Face_b->num_vertices && !found; jv++) {
+      found = t8_vtu_vertex_equal (Face_a->vertices + 3 * iv,
+                                   Face_b->vertices + 3 * jv);
+    }
+    if (!found) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+/* Given two matching faces compute their orientation.
+ * This follows the convention of the .msh reader: The smaller face is the
+ * one of the smaller tree class, or of the smaller tree id if the classes
+ * are equal. The orientation is the position of the first vertex of
+ * the smaller face in the bigger face. */
+static int
+t8_vtu_face_orientation (const t8_vtu_face_t * Face_a,
+                         const t8_vtu_face_t * Face_b)
+{
+  const t8_vtu_face_t *smaller_Face, *bigger_Face;
+  int                 compare, iv;
+
+  compare = t8_eclass_compare ((t8_eclass_t) Face_a->eclass,
+                               (t8_eclass_t) Face_b->eclass);
+  if (compare > 0 || (compare == 0 && Face_a->gtree_id > Face_b->gtree_id)) {
+    smaller_Face = Face_b;
+    bigger_Face = Face_a;
+  }
+  else {
+    smaller_Face = Face_a;
+    bigger_Face = Face_b;
+  }
+  for (iv = 0; iv < bigger_Face->num_vertices; iv++) {
+    if (t8_vtu_vertex_equal (smaller_Face->vertices,
+                             bigger_Face->vertices + 3 * iv)) {
+      return iv;
+    }
+  }
+  SC_ABORT_NOT_REACHED ();
+  return -1;
+}
+
+/* Fill a join record from Face to Neighbor */
+static void
+t8_vtu_join_fill (t8_vtu_join_t * join, const t8_vtu_face_t * Face,
+                  const t8_vtu_face_t * Neighbor, int orientation)
+{
+  join->gtree_id = Face->gtree_id;
+  join->face_number = Face->face_number;
+  join->neighbor_id = Neighbor->gtree_id;
+  join->neighbor_face = Neighbor->face_number;
+  join->neighbor_eclass = Neighbor->eclass;
+  join->neighbor_rank = Neighbor->rank;
+  join->orientation = orientation;
+}
+
+/* Sort joins by their tree id and then by the process of the neighbor */
+static int
+t8_vtu_join_compare (const void *joina, const void *joinb)
+{
+  const t8_vtu_join_t *join_a = (const t8_vtu_join_t *) joina;
+  const t8_vtu_join_t *join_b = (const t8_vtu_join_t *) joinb;
+
+  if (join_a->gtree_id != join_b->gtree_id) {
+    return join_a->gtree_id < join_b->gtree_id ? -1 : 1;
+  }
+  return join_a->neighbor_rank - join_b->neighbor_rank;
+}
+
+/* Sort joins by the id of their neighbor tree */
+static int
+t8_vtu_join_neighbor_compare (const void *joina, const void *joinb)
+{
+  const t8_vtu_join_t *join_a = (const t8_vtu_join_t *) joina;
+  const t8_vtu_join_t *join_b = (const t8_vtu_join_t *) joinb;
+
+  return join_a->neighbor_id < join_b->neighbor_id ? -1
+    : join_a->neighbor_id != join_b->neighbor_id;
+}
+
+/* Compare two global tree ids */
+static int
+t8_vtu_gloidx_compare (const void *ida, const void *idb)
+{
+  const t8_gloidx_t   id_a = *(const t8_gloidx_t *) ida;
+  const t8_gloidx_t   id_b = *(const t8_gloidx_t *) idb;
+
+  return id_a < id_b ? -1 : id_a != id_b;
+}
+
+/* Send an array of records to each process and receive an array from
+ * each process. The array to this process is copied.
+ * \param [in] comm       The MPI communicator.
+ * \param [in] send       For each process an array of records to send.
+ * \param [in,out] recv   For each process an initialized array with the
+ *                        same element size. On output the received records.
+ */
+static void
+t8_vtu_exchange (sc_MPI_Comm comm, sc_array_t * send, sc_array_t * recv)
+{
+  sc_MPI_Request     *requests;
+  int                *send_counts, *recv_counts;
+  int                 mpirank, mpisize, iproc, num_requests, mpiret;
+
+  mpiret = sc_MPI_Comm_size (comm, &mpisize);
+  SC_CHECK_MPI (mpiret);
+  mpiret = sc_MPI_Comm_rank (comm, &mpirank);
+  SC_CHECK_MPI (mpiret);
+
+  send_counts = T8_ALLOC_ZERO (int, mpisize);
+  recv_counts = T8_ALLOC (int, mpisize);
+  for (iproc = 0; iproc < mpisize; iproc++) {
+    send_counts[iproc] = (int) (send[iproc].elem_count
+                                * send[iproc].elem_size);
+  }
+  mpiret = sc_MPI_Alltoall (send_counts, 1, sc_MPI_INT, recv_counts, 1,
+                            sc_MPI_INT, comm);
+  SC_CHECK_MPI (mpiret);
+
+  sc_array_copy (recv + mpirank, send + mpirank);
+  requests = T8_ALLOC (sc_MPI_Request, 2 * mpisize);
+  num_requests = 0;
+  for (iproc = 0; iproc < mpisize; iproc++) {
+    if (iproc != mpirank && recv_counts[iproc] > 0) {
+      T8_ASSERT (recv_counts[iproc] % recv[iproc].elem_size == 0);
+      sc_array_resize (recv + iproc,
+                       recv_counts[iproc] / recv[iproc].elem_size);
+      mpiret = sc_MPI_Irecv (recv[iproc].array, recv_counts[iproc],
+                             sc_MPI_BYTE, iproc, T8_MPI_READ_VTU_CMESH,
+                             comm, requests + num_requests++);
+      SC_CHECK_MPI (mpiret);
+    }
+  }
+  for (iproc = 0; iproc < mpisize; iproc++) {
+    if (iproc != mpirank && send_counts[iproc] > 0) {
+      mpiret = sc_MPI_Isend (send[iproc].array, send_counts[iproc],
+                             sc_MPI_BYTE, iproc, T8_MPI_READ_VTU_CMESH,
+                             comm, requests + num_requests++);
+      SC_CHECK_MPI (mpiret);
+    }
+  }
+  mpiret = sc_MPI_Waitall (num_requests, requests, sc_MPI_STATUSES_IGNORE);
+  SC_CHECK_MPI (mpiret);
+  T8_FREE (requests);
+  T8_FREE (send_counts);
+  T8_FREE (recv_counts);
+}
+
+/* Find the face neighbors of all local trees and set the face connections
+ * of the local trees and ghost trees in cmesh.
+ * Faces that match within the local trees are joined directly.
+ * Each remaining face is sent to the process given by its hash value,
+ * which matches the faces of different processes and sends the resulting
+ * connections back. Finally, each process sends the face connections of
+ * its trees to those processes that have them as ghosts.
+ * \param [in,out] cmesh      The initialized, not committed cmesh.
+ * \param [in]     trees      The local trees.
+ * \param [in]     first_tree The global id of the first local tree.
+ * \param [in]     comm       The MPI communicator.
+ */
+static void
+t8_cmesh_vtu_find_neighbors (t8_cmesh_t cmesh, sc_array_t * trees,
+                             t8_gloidx_t first_tree, sc_MPI_Comm comm)
+{
+  sc_array_t         *send, *recv;
+  sc_array_t          faces, joins, ghost_ids, ghost_joins;
+  sc_hash_t          *hash;
+  t8_vtu_tree_t      *tree;
+  t8_vtu_face_t      *Face, *Neighbor, **pNeighbor;
+  t8_vtu_join_t      *join, *gjoin;
+  t8_gloidx_t         last_tree;
+  t8_locidx_t         itree;
+  t8_eclass_t         face_class;
+  size_t              iz, jz, kz, num_faces;
+  ssize_t             found;
+  int                 mpirank, mpisize, mpiret, iproc;
+  int                 iface, ivertex, orientation;
+
+  mpiret = sc_MPI_Comm_size (comm, &mpisize);
+  SC_CHECK_MPI (mpiret);
+  mpiret = sc_MPI_Comm_rank (comm, &mpirank);
+  SC_CHECK_MPI (mpiret);
+  last_tree = first_tree + trees->elem_count - 1;
+
+  /* Build all faces of the local trees. */
+  num_faces = 0;
+  for (iz = 0; iz < trees->elem_count; iz++) {
+    tree = (t8_vtu_tree_t *) sc_array_index (trees, iz);
+    num_faces += t8_eclass_num_faces[tree->eclass];
+  }
+  sc_array_init_size (&faces, sizeof (t8_vtu_face_t), num_faces);
+  sc_array_init (&joins, sizeof (t8_vtu_join_t));
+  hash = sc_hash_new (t8_vtu_face_hash, t8_vtu_face_equal, NULL, NULL);
+  num_faces = 0;
+  for (itree = 0; itree < (t8_locidx_t) trees->elem_count; itree++) {
+    tree = (t8_vtu_tree_t *) sc_array_index (trees, itree);
+    for (iface = 0; iface < t8_eclass_num_faces[tree->eclass]; iface++) {
+      Face = (t8_vtu_face_t *) sc_array_index (&faces, num_faces++);
+      face_class = (t8_eclass_t) t8_eclass_face_types[tree->eclass][iface];
+      Face->gtree_id = first_tree + itree;
+      Face->rank = mpirank;
+      Face->face_number = iface;
+      Face->eclass = tree->eclass;
+      Face->num_vertices = t8_eclass_num_vertices[face_class];
+      Face->matched = 0;
+      for (ivertex = 0; ivertex < Face->num_vertices; ivertex++) {
+        memcpy (Face->vertices + 3 * ivertex, tree->vertices +
+                3 * t8_face_vertex_to_tree_vertex[tree->eclass][iface]
+                [ivertex], 3 * sizeof (double));
+      }
+      /* Try to insert the face into the hash */
+      if (!sc_hash_insert_unique (hash, Face, (void ***) &pNeighbor)) {
+        /* The face was already in the hash, we found a local neighbor */
+        Neighbor = *pNeighbor;
+        orientation = t8_vtu_face_orientation (Face, Neighbor);
+        t8_cmesh_set_join (cmesh, Face->gtree_id, Neighbor->gtree_id,
+                           iface, Neighbor->face_number, orientation);
+        /* We remember the connection in both directions */
+        t8_vtu_join_fill ((t8_vtu_join_t *) sc_array_push (&joins), Face,
+                          Neighbor, orientation);
+        t8_vtu_join_fill ((t8_vtu_join_t *) sc_array_push (&joins),
+                          Neighbor, Face, orientation);
+        Face->matched = Neighbor->matched = 1;
+        sc_hash_remove (hash, Neighbor, NULL);
+      }
+    }
+  }
+  sc_hash_destroy (hash);
+
+  /* Send each unmatched face to the process given by its hash value */
+  send = T8_ALLOC (sc_array_t, mpisize);
+  recv = T8_ALLOC (sc_array_t, mpisize);
+  for (iproc = 0; iproc < mpisize; iproc++) {
+    sc_array_init (send + iproc, sizeof (t8_vtu_face_t));
+    sc_array_init (recv + iproc, sizeof (t8_vtu_face_t));
+  }
+  for (iz = 0; iz < faces.elem_count; iz++) {
+    Face = (t8_vtu_face_t *) sc_array_index (&faces, iz);
+    if (!Face->matched) {
+      iproc = t8_vtu_face_hash (Face, NULL) % mpisize;
+      *(t8_vtu_face_t *) sc_array_push (send + iproc) = *Face;
+    }
+  }
+  sc_array_reset (&faces);
+  t8_vtu_exchange (comm, send, recv);
+
+  /* Match the received faces and send the connections back
+   * to the processes owning the trees. */
+  hash = sc_hash_new (t8_vtu_face_hash, t8_vtu_face_equal, NULL, NULL);
+  for (iproc = 0; iproc < mpisize; iproc++) {
+    sc_array_reset (send + iproc);
+    sc_array_init (send + iproc, sizeof (t8_vtu_join_t));
+  }
+  for (iproc = 0; iproc < mpisize; iproc++) {
+    for (iz = 0; iz < recv[iproc].elem_count; iz++) {
+      Face = (t8_vtu_face_t *) sc_array_index (recv + iproc, iz);
+      if (!sc_hash_insert_unique (hash, Face, (void ***) &pNeighbor)) {
+        Neighbor = *pNeighbor;
+        orientation = t8_vtu_face_orientation (Face, Neighbor);
+        t8_vtu_join_fill ((t8_vtu_join_t *)
+                          sc_array_push (send + Face->rank), Face, Neighbor,
+                          orientation);
+        if (Neighbor->rank != Face->rank) {
+          t8_vtu_join_fill ((t8_vtu_join_t *)
+                            sc_array_push (send + Neighbor->rank), Neighbor,
+                            Face, orientation);
+        }
+        sc_hash_remove (hash, Neighbor, NULL);
+      }
+    }
+  }
+  sc_hash_destroy (hash);
+  for (iproc = 0; iproc < mpisize; iproc++) {
+    sc_array_reset (recv + iproc);
+    sc_array_init (recv + iproc, sizeof (t8_vtu_join_t));
+  }
+  t8_vtu_exchange (comm, send, recv);
+
+  /* Set the received connections and the classes of the ghost trees */
+  sc_array_init (&ghost_joins, sizeof (t8_vtu_join_t));
+  for (iproc = 0; iproc < mpisize; iproc++) {
+    for (iz = 0; iz < recv[iproc].elem_count; iz++) {
+      join = (t8_vtu_join_t *) sc_array_index (recv + iproc, iz);
+      T8_ASSERT (first_tree <= join->gtree_id && join->gtree_id <= last_tree);
+      t8_cmesh_set_join (cmesh, join->gtree_id, join->neighbor_id,
+                         join->face_number, join->neighbor_face,
+                         join->orientation);
+      *(t8_vtu_join_t *) sc_array_push (&joins) = *join;
+      if (join->neighbor_id < first_tree || join->neighbor_id > last_tree) {
+        *(t8_vtu_join_t *) sc_array_push (&ghost_joins) = *join;
+      }
+    }
+    sc_array_truncate (recv + iproc);
+  }
+  /* The same ghost may be the neighbor of several faces */
+  sc_array_sort (&ghost_joins, t8_vtu_join_neighbor_compare);
+  sc_array_init (&ghost_ids, sizeof (t8_gloidx_t));
+  for (iz = 0; iz < ghost_joins.elem_count; iz++) {
+    join = (t8_vtu_join_t *) sc_array_index (&ghost_joins, iz);
+    if (iz == 0 || t8_vtu_join_neighbor_compare (join, join - 1)) {
+      t8_cmesh_set_tree_class (cmesh, join->neighbor_id,
+                               (t8_eclass_t) join->neighbor_eclass);
+      *(t8_gloidx_t *) sc_array_push (&ghost_ids) = join->neighbor_id;
+    }
+  }
+  sc_array_reset (&ghost_joins);
+
+  /* Send all connections of a tree to each process that has it as a
+   * ghost, such that the ghosts know their face neighbors. */
+  sc_array_sort (&joins, t8_vtu_join_compare);
+  for (iproc = 0; iproc < mpisize; iproc++) {
+    sc_array_truncate (send + iproc);
+  }
+  for (iz = 0; iz < joins.elem_count; iz = jz) {
+    join = (t8_vtu_join_t *) sc_array_index (&joins, iz);
+    /* The joins of this tree are the entries iz to jz - 1 */
+    for (jz = iz + 1; jz < joins.elem_count && ((t8_vtu_join_t *)
+                                                sc_array_index (&joins,
+                                                                jz))->gtree_id
+         == join->gtree_id; jz++) {
+    }
+    for (kz = iz; kz < jz; kz++) {
+      gjoin = (t8_vtu_join_t *) sc_array_index (&joins, kz);
+      if (gjoin->neighbor_rank == mpirank
+          || (kz > iz && gjoin->neighbor_rank == (gjoin - 1)->neighbor_rank)) {
+        /* Local neighbor or we already sent this tree to the process */
+        continue;
+      }
+      memcpy (sc_array_push_count (send + gjoin->neighbor_rank, jz - iz),
+              join, (jz - iz) * sizeof (t8_vtu_join_t));
+    }
+  }
+  sc_array_reset (&joins);
+  t8_vtu_exchange (comm, send, recv);
+
+  for (iproc = 0; iproc < mpisize; iproc++) {
+    for (iz = 0; iz < recv[iproc].elem_count; iz++) {
+      join = (t8_vtu_join_t *) sc_array_index (recv + iproc, iz);
+      if (first_tree <= join->neighbor_id && join->neighbor_id <= last_tree) {
+        /* We already know the connection to our local tree */
+        continue;
+      }
+      found = sc_array_bsearch (&ghost_ids, &join->neighbor_id,
+                                t8_vtu_gloidx_compare);
+      if (found >= 0 && join->neighbor_id < join->gtree_id) {
+        /* A connection between two ghosts is received from both,
+         * we only set it once. */
+        continue;
+      }
+      t8_cmesh_set_join (cmesh, join->gtree_id, join->neighbor_id,
+                         join->face_number, join->neighbor_face,
+                         join->orientation);
+    }
+    sc_array_reset (send + iproc);
+    sc_array_reset (recv + iproc);
+  }
+  sc_array_reset (&ghost_ids);
+  T8_FREE (send);
+  T8_FREE (recv);
+}
+
+t8_cmesh_t
+t8_cmesh_from_pvtu_file (const char *filename, sc_MPI_Comm comm, int dim)
+{
+  int                 mpirank, mpisize, mpiret;
+  int                 read_successful, all_successful;
+  t8_cmesh_t          cmesh;
+  sc_array_t         *pieces, trees;
+  t8_vtu_tree_t      *tree;
+  t8_gloidx_t         num_local_trees, first_tree, num_trees;
+  size_t              first_piece, end_piece, ipiece, iz;
+
+  T8_ASSERT (0 <= dim && dim <= T8_ECLASS_MAX_DIM);
+  mpiret = sc_MPI_Comm_size (comm, &mpisize);
+  SC_CHECK_MPI (mpiret);
+  mpiret = sc_MPI_Comm_rank (comm, &mpirank);
+  SC_CHECK_MPI (mpiret);
+
+  /* Each process reads a contiguous block of the pieces */
+  sc_array_init (&trees, sizeof (t8_vtu_tree_t));
+  pieces = t8_vtu_read_piece_list (filename);
+  read_successful = pieces != NULL;
+  if (read_successful) {
+    first_piece = (mpirank * pieces->elem_count) / mpisize;
+    end_piece = ((mpirank + 1) * pieces->elem_count) / mpisize;
+    for (ipiece = first_piece; ipiece < end_piece && read_successful;
+         ipiece++) {
+      t8_debugf ("Reading piece %s\n",
+                 *(char **) sc_array_index (pieces, ipiece));
+      read_successful =
+        t8_vtu_read_pieces (*(char **) sc_array_index (pieces, ipiece),
+                            dim, &trees);
+    }
+    for (ipiece = 0; ipiece < pieces->elem_count; ipiece++) {
+      T8_FREE (*(char **) sc_array_index (pieces, ipiece));
+    }
+    sc_array_destroy (pieces);
+  }
+  /* Communicate whether all processes read their pieces successfully. */
+  mpiret = sc_MPI_Allreduce (&read_successful, &all_successful, 1,
+                             sc_MPI_INT, sc_MPI_MIN, comm);
+  SC_CHECK_MPI (mpiret);
+  if (!all_successful) {
+    t8_global_errorf ("Could not read file %s\n", filename);
+    sc_array_reset (&trees);
+    return NULL;
+  }
+
+  /* The trees are numbered in the order of the pieces */
+  num_local_trees = trees.elem_count;
+  mpiret = sc_MPI_Scan (&num_local_trees, &first_tree, 1, T8_MPI_GLOIDX,
+                        sc_MPI_SUM, comm);
+  SC_CHECK_MPI (mpiret);
+  first_tree -= num_local_trees;
+  mpiret = sc_MPI_Allreduce (&num_local_trees, &num_trees, 1, T8_MPI_GLOIDX,
+                             sc_MPI_SUM, comm);
+  SC_CHECK_MPI (mpiret);
+  t8_global_productionf ("Read %lli trees from file %s\n",
+                         (long long) num_trees, filename);
+
+  t8_cmesh_init (&cmesh);
+  /* Setting the dimension by hand is neccessary for partitioned
+   * commit, since there may be processes without any trees. */
+  t8_cmesh_set_dimension (cmesh, dim);
+  for (iz = 0; iz < trees.elem_count; iz++) {
+    tree = (t8_vtu_tree_t *) sc_array_index (&trees, iz);
+    t8_cmesh_set_tree_class (cmesh, first_tree + iz, tree->eclass);
+    /* The vertices are used at commit, thus trees stays alive until then */
+    t8_cmesh_set_tree_vertices (cmesh, first_tree + iz, t8_get_package_id (),
+                                0, tree->vertices,
+                                t8_eclass_num_vertices[tree->eclass]);
+  }
+  t8_cmesh_vtu_find_neighbors (cmesh, &trees, first_tree, comm);
+  t8_cmesh_set_partition_range (cmesh, 3, first_tree,
+                                first_tree + num_local_trees - 1);
+  t8_cmesh_commit (cmesh, comm);
+  sc_array_reset (&trees);
+  return cmesh;
+}
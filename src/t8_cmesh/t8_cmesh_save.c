@@ -33,6 +33,7 @@
 #include <t8_cmesh/t8_cmesh_save.h>
 #include <t8_cmesh/t8_cmesh_partition.h>
 #include <t8_cmesh/t8_cmesh_offset.h>
+#include <t8_cmesh_readmshfile.h>
 
 /* This macro is called to check a condition and if not fulfilled
  * close the file and exit the function */
@@ -171,6 +172,7 @@ t8_cmesh_load_tree_attributes (t8_cmesh_t cmesh, FILE * fp)
   t8_ctree_t          tree;
   int                 att, i, num_vertices, num_faces, iface;
   int                 ret, ttf_entry;
+  int                 tags[T8_ECLASS_MAX_FACES];
   t8_locidx_t        *face_neighbors;
   int8_t             *ttf;
   t8_stash_attribute_struct_t att_struct;
@@ -205,8 +207,8 @@ t8_cmesh_load_tree_attributes (t8_cmesh_t cmesh, FILE * fp)
       ret = fscanf (fp, "id %i\nkey %i\n", &att_struct.package_id,
                     &att_struct.key);
       T8_SAVE_CHECK_CLOSE (ret == 2, fp);
-      /* We currently only support vertices as attributes.
-       * Those have t8 package id and key 0 */
+      /* We currently only support the vertices and the msh tags as
+       * attributes. Those have t8 package id and keys 0, 1 and 2 */
 #if 0
       /* TODO: We cannot check if the attribute package id is t8_get_package_id,
        *       since this id can change from program to program.
@@ -215,8 +217,7 @@ t8_cmesh_load_tree_attributes (t8_cmesh_t cmesh, FILE * fp)
       T8_SAVE_CHECK_CLOSE (att_struct.package_id == t8_get_package_id ()
                            && att_struct.key == 0, fp);
 #endif
-      T8_SAVE_CHECK_CLOSE (att_struct.package_id > 0
-                           && att_struct.key == 0, fp);
+      T8_SAVE_CHECK_CLOSE (att_struct.package_id > 0, fp);
       /* TODO: We set the package id to match the one of t8code manually.
        * See the comment above. */
       att_struct.package_id = t8_get_package_id ();
@@ -224,18 +225,46 @@ t8_cmesh_load_tree_attributes (t8_cmesh_t cmesh, FILE * fp)
       /* read the size of the attribute */
       ret = fscanf (fp, "size %zu\n", &att_struct.attr_size);
       T8_SAVE_CHECK_CLOSE (ret == 1, fp);
-      /* Read the vertices */
-      for (i = 0; i < num_vertices; i++) {
-        ret =
-          fscanf (fp, "%lf %lf %lf\n", vertices + 3 * i, vertices + 3 * i + 1,
-                  vertices + 3 * i + 2);
-        T8_SAVE_CHECK_CLOSE (ret == 3, fp);
+      switch (att_struct.key) {
+      case 0:
+        /* Read the vertices */
+        T8_SAVE_CHECK_CLOSE (att_struct.attr_size ==
+                             3 * num_vertices * sizeof (double), fp);
+        for (i = 0; i < num_vertices; i++) {
+          ret =
+            fscanf (fp, "%lf %lf %lf\n", vertices + 3 * i,
+                    vertices + 3 * i + 1, vertices + 3 * i + 2);
+          T8_SAVE_CHECK_CLOSE (ret == 3, fp);
+        }
+        att_struct.attr_data = vertices;
+        break;
+      case T8_CMESH_MSH_PHYSICAL_TAG_KEY:
+        /* Read the physical tag of the tree */
+        T8_SAVE_CHECK_CLOSE (att_struct.attr_size == sizeof (int), fp);
+        ret = fscanf (fp, "%i\n", tags);
+        T8_SAVE_CHECK_CLOSE (ret == 1, fp);
+        att_struct.attr_data = tags;
+        break;
+      case T8_CMESH_MSH_BOUNDARY_TAGS_KEY:
+        /* Read the boundary tags of the tree faces */
+        T8_SAVE_CHECK_CLOSE (att_struct.attr_size ==
+                             num_faces * sizeof (int), fp);
+        for (iface = 0; iface < num_faces; iface++) {
+          ret = fscanf (fp, "%i", tags + iface);
+          T8_SAVE_CHECK_CLOSE (ret == 1, fp);
+        }
+        ret = fscanf (fp, "\n");
+        T8_SAVE_CHECK_CLOSE (ret == 0, fp);
+        att_struct.attr_data = tags;
+        break;
+      default:
+        T8_SAVE_CHECK_CLOSE (0, fp);
       }
-      att_struct.attr_data = vertices;
       att_struct.is_owned = 0;
       att_struct.id = itree + cmesh->first_tree;
-      /* Now we read the attribute and can add it to the tree */
-      t8_cmesh_trees_add_attribute (cmesh->trees, 0, &att_struct, itree, 0);
+      /* Now we read the attribute and can add it to the tree.
+       * The attributes were saved in the order of their keys. */
+      t8_cmesh_trees_add_attribute (cmesh->trees, 0, &att_struct, itree, att);
     }
   }
   SC_FREE (vertices);
@@ -246,6 +275,7 @@ static int
 t8_cmesh_save_tree_attribute (t8_cmesh_t cmesh, FILE * fp)
 {
   double             *vertices;
+  int                *tags;
   t8_locidx_t         itree;
   t8_ctree_t          tree;
   int                 num_vertices;
@@ -260,8 +290,11 @@ t8_cmesh_save_tree_attribute (t8_cmesh_t cmesh, FILE * fp)
   T8_SAVE_CHECK_CLOSE (ret > 0, fp);
   /* For each tree, write its attribute */
   for (itree = 0; itree < cmesh->num_local_trees; itree++) {
-    /* TODO: Currently we only support storing of the tree vertices as only attribute.
-     *        This attribute has package id t8_get_package_id() and key 0.
+    /* TODO: Currently we only support storing of the tree vertices and the
+     *        physical and boundary tags read from a .msh file.
+     *        These attributes have package id t8_get_package_id() and
+     *        keys 0, T8_CMESH_MSH_PHYSICAL_TAG_KEY and
+     *        T8_CMESH_MSH_BOUNDARY_TAGS_KEY.
      */
     tree = t8_cmesh_trees_get_tree_ext (cmesh->trees, itree, &face_neigh,
                                         &ttf);
@@ -289,10 +322,11 @@ t8_cmesh_save_tree_attribute (t8_cmesh_t cmesh, FILE * fp)
        * coordinates for this tree */
       if (att_size != num_vertices * 3 * sizeof (double)) {
         /* TODO: We currently do not support saving of attributes different
-         * to the tree vertices */
+         * to the tree vertices and the msh tags */
         fclose (fp);
         t8_errorf ("We do not support saving cmeshes with trees that "
-                   "have attributes different to the tree vertices.\n");
+                   "have attributes different to the tree vertices "
+                   "and the msh tags.\n");
         return 0;
       }
       ret = fprintf (fp, "id %i\nkey %i\n", t8_get_package_id (), 0);
@@ -309,10 +343,69 @@ t8_cmesh_save_tree_attribute (t8_cmesh_t cmesh, FILE * fp)
       /* Clear the buffer such that strlen returns 0 */
       buffer[0] = '\0';
     }
+    /* Write the physical tag of the tree if it was read from a .msh file */
+    tags =
+      (int *) t8_cmesh_trees_get_attribute (cmesh->trees, itree,
+                                            t8_get_package_id (),
+                                            T8_CMESH_MSH_PHYSICAL_TAG_KEY,
+                                            &att_size, 0);
+    if (tags != NULL) {
+      T8_SAVE_CHECK_CLOSE (att_size == sizeof (int), fp);
+      ret = fprintf (fp, "id %i\nkey %i\nsize %zd\n%i\n",
+                     t8_get_package_id (), T8_CMESH_MSH_PHYSICAL_TAG_KEY,
+                     sizeof (int), tags[0]);
+      T8_SAVE_CHECK_CLOSE (ret > 0, fp);
+    }
+    /* Write the boundary tags of the tree faces if they were read from
+     * a .msh file */
+    tags =
+      (int *) t8_cmesh_trees_get_attribute (cmesh->trees, itree,
+                                            t8_get_package_id (),
+                                            T8_CMESH_MSH_BOUNDARY_TAGS_KEY,
+                                            &att_size, 0);
+    if (tags != NULL) {
+      T8_SAVE_CHECK_CLOSE (att_size == num_faces * sizeof (int), fp);
+      ret = fprintf (fp, "id %i\nkey %i\nsize %zd\n", t8_get_package_id (),
+                     T8_CMESH_MSH_BOUNDARY_TAGS_KEY, att_size);
+      T8_SAVE_CHECK_CLOSE (ret > 0, fp);
+      for (i = 0; i < num_faces; i++) {
+        ret = fprintf (fp, "%i%s", tags[i], i == num_faces - 1 ? "\n" : " ");
+        T8_SAVE_CHECK_CLOSE (ret > 0, fp);
+      }
+    }
   }
   return 1;
 }
 
+/* Return true if we can save all attributes of a local tree.
+ * These are the tree vertices, which must be present, and the physical
+ * and boundary tags that t8_cmesh_from_msh_file may add. */
+static int
+t8_cmesh_save_tree_attributes_supported (t8_cmesh_t cmesh, t8_locidx_t itree)
+{
+  t8_ctree_t          tree;
+  size_t              att_size;
+  int                 num_supported = 0;
+
+  tree = t8_cmesh_trees_get_tree (cmesh->trees, itree);
+  if (t8_cmesh_trees_get_attribute (cmesh->trees, itree, t8_get_package_id (),
+                                    0, &att_size, 0) == NULL) {
+    return 0;
+  }
+  num_supported++;
+  if (t8_cmesh_trees_get_attribute (cmesh->trees, itree, t8_get_package_id (),
+                                    T8_CMESH_MSH_PHYSICAL_TAG_KEY, &att_size,
+                                    0) != NULL) {
+    num_supported++;
+  }
+  if (t8_cmesh_trees_get_attribute (cmesh->trees, itree, t8_get_package_id (),
+                                    T8_CMESH_MSH_BOUNDARY_TAGS_KEY, &att_size,
+                                    0) != NULL) {
+    num_supported++;
+  }
+  return tree->num_attributes == num_supported;
+}
+
 static int
 t8_cmesh_save_trees (t8_cmesh_t cmesh, FILE * fp)
 {
@@ -335,12 +428,13 @@ t8_cmesh_save_trees (t8_cmesh_t cmesh, FILE * fp)
     tree = t8_cmesh_trees_get_tree (cmesh->trees, itree);
     ret = fprintf (fp, "eclass %i\n", (int) tree->eclass);
     T8_SAVE_CHECK_CLOSE (ret > 0, fp);
-    if (tree->num_attributes != 1) {
+    if (!t8_cmesh_save_tree_attributes_supported (cmesh, itree)) {
       /* TODO: We currently do not support saving of attributes different
-       * to the tree vertices */
+       * to the tree vertices and the msh tags */
       fclose (fp);
       t8_errorf ("We do not support saving cmeshes with trees that "
-                 "have attributes different to the tree vertices.\n");
+                 "have attributes different to the tree vertices "
+                 "and the msh tags.\n");
       return 0;
     }
     ret = fprintf (fp, "num_attributes %i\nSize of attributes %zd\n\n",
@@ -385,17 +479,22 @@ t8_cmesh_load_trees (t8_cmesh_t cmesh, FILE * fp)
 
     /* After adding the tree, we set its face neighbors and face orientation */
     (void) t8_cmesh_trees_get_tree (cmesh->trees, itree);
-    /* Check whether the number of attribute is really 1 */
+    /* Check whether the attributes are the tree vertices and at most
+     * the two msh tag attributes */
     ret =
       fscanf (fp, "num_attributes %i\nSize of attributes %zu\n", &num_atts,
               &att_bytes);
     T8_SAVE_CHECK_CLOSE (ret == 2, fp);
-    T8_SAVE_CHECK_CLOSE (num_atts == 1, fp);
-    T8_SAVE_CHECK_CLOSE (att_bytes == 3 * sizeof (double)
+    T8_SAVE_CHECK_CLOSE (1 <= num_atts && num_atts <= 3, fp);
+    T8_SAVE_CHECK_CLOSE (att_bytes >= 3 * sizeof (double)
                          * t8_eclass_num_vertices[eclass], fp);
-    /* If there really is one attribute it must be the trees vertices and thus
-     * we initialize the tree's attribute accordingly */
-    t8_cmesh_trees_init_attributes (cmesh->trees, itree, 1, att_bytes);
+    T8_SAVE_CHECK_CLOSE (att_bytes <= 3 * sizeof (double)
+                         * t8_eclass_num_vertices[eclass]
+                         + (1 + t8_eclass_num_faces[eclass]) * sizeof (int),
+                         fp);
+    /* We initialize the tree's attributes accordingly, they are read
+     * in t8_cmesh_load_tree_attributes */
+    t8_cmesh_trees_init_attributes (cmesh->trees, itree, num_atts, att_bytes);
   }
   return 1;
 }
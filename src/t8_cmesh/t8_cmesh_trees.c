@@ -88,7 +88,7 @@ t8_cmesh_trees_init (t8_cmesh_trees_t * ptrees, int num_procs,
   trees->ghost_globalid_to_local_id =
     sc_hash_new (t8_cmesh_trees_glo_lo_hash_func,
                  t8_cmesh_trees_glo_lo_hash_equal, NULL, NULL);
-
+  t8_refcount_init (&trees->rc);
 }
 
 void
@@ -1324,5 +1324,76 @@ t8_cmesh_trees_destroy (t8_cmesh_trees_t * ptrees)
   sc_mempool_destroy (trees->global_local_mempool);
 
   T8_FREE (trees);
-  ptrees = NULL;
+  *ptrees = NULL;
+}
+
+void
+t8_cmesh_trees_ref (t8_cmesh_trees_t trees)
+{
+  T8_ASSERT (trees != NULL);
+  t8_refcount_ref (&trees->rc);
+}
+
+void
+t8_cmesh_trees_unref (t8_cmesh_trees_t * ptrees)
+{
+  T8_ASSERT (ptrees != NULL && *ptrees != NULL);
+  if (t8_refcount_unref (&(*ptrees)->rc)) {
+    t8_cmesh_trees_destroy (ptrees);
+  }
+  *ptrees = NULL;
+}
+
+int
+t8_cmesh_trees_is_shared (t8_cmesh_trees_t trees)
+{
+  T8_ASSERT (trees != NULL);
+  return !t8_refcount_is_last (&trees->rc);
+}
+
+void
+t8_cmesh_trees_unshare (t8_cmesh_trees_t * ptrees, t8_locidx_t num_trees,
+                        t8_locidx_t num_ghosts)
+{
+  t8_cmesh_trees_t    trees_src, trees;
+  t8_part_tree_t      part;
+  t8_cghost_t         ghost;
+  t8_locidx_t         first_tree, num_part_trees, first_ghost;
+  t8_locidx_t         num_part_ghosts, ighost;
+  size_t              num_parts, iz;
+
+  T8_ASSERT (ptrees != NULL && *ptrees != NULL);
+  trees_src = *ptrees;
+  if (!t8_cmesh_trees_is_shared (trees_src)) {
+    /* We are the only owner and may modify the trees in place */
+    return;
+  }
+  num_parts = t8_cmesh_trees_get_numproc (trees_src);
+  t8_cmesh_trees_init (&trees, num_parts, num_trees, num_ghosts);
+  t8_cmesh_trees_copy_toproc (trees, trees_src, num_trees, num_ghosts);
+  for (iz = 0; iz < num_parts; iz++) {
+    t8_cmesh_trees_get_part_data (trees_src, iz, &first_tree,
+                                  &num_part_trees, &first_ghost,
+                                  &num_part_ghosts);
+    t8_cmesh_trees_start_part (trees, iz, first_tree, num_part_trees,
+                               first_ghost, num_part_ghosts, 0);
+    t8_cmesh_trees_copy_part (trees, iz, trees_src, iz);
+    /* Rebuild the global id to local id hash for this part's ghosts */
+    part = t8_cmesh_trees_get_part (trees, iz);
+    for (ighost = 0; ighost < num_part_ghosts; ighost++) {
+      t8_trees_glo_lo_hash_t *hash_entry;
+
+      ghost = &((t8_cghost_t) (((t8_ctree_struct_t *) part->first_tree) +
+                               part->num_trees))[ighost];
+      hash_entry = (t8_trees_glo_lo_hash_t *)
+        sc_mempool_alloc (trees->global_local_mempool);
+      hash_entry->global_id = ghost->treeid;
+      hash_entry->local_id = ighost + first_ghost + num_trees;
+      sc_hash_insert_unique (trees->ghost_globalid_to_local_id, hash_entry,
+                             NULL);
+    }
+  }
+  /* Give up our reference to the shared structure */
+  t8_cmesh_trees_unref (&trees_src);
+  *ptrees = trees;
 }
@@ -553,6 +553,37 @@ int                 t8_cmesh_trees_is_equal (t8_cmesh_t cmesh,
  */
 void                t8_cmesh_trees_destroy (t8_cmesh_trees_t * trees);
 
+/** Increase the reference count of a trees structure.
+ * Committed cmeshes that are copies of each other share their trees.
+ * \param [in,out] trees A trees structure.
+ */
+void                t8_cmesh_trees_ref (t8_cmesh_trees_t trees);
+
+/** Decrease the reference count of a trees structure.
+ * If the count reaches zero, the trees are destroyed.
+ * \param [in,out] ptrees Pointer to a trees structure. Set to NULL on output.
+ */
+void                t8_cmesh_trees_unref (t8_cmesh_trees_t * ptrees);
+
+/** Query whether a trees structure is referenced more than once.
+ * \param [in]     trees A trees structure.
+ * \return         True if more than one cmesh holds a reference to \a trees.
+ */
+int                 t8_cmesh_trees_is_shared (t8_cmesh_trees_t trees);
+
+/** Make sure that a trees structure is not shared with another cmesh.
+ * This must be called before the trees of a committed cmesh are modified.
+ * If the trees are shared, they are deep-copied, the reference to the shared
+ * structure is given up and \a ptrees points to the new copy.
+ * Otherwise, nothing happens.
+ * \param [in,out] ptrees     Pointer to a trees structure.
+ * \param [in]     num_trees  The number of local trees in \a ptrees.
+ * \param [in]     num_ghosts The number of ghosts in \a ptrees.
+ */
+void                t8_cmesh_trees_unshare (t8_cmesh_trees_t * ptrees,
+                                            t8_locidx_t num_trees,
+                                            t8_locidx_t num_ghosts);
+
 T8_EXTERN_C_END ();
 
 #endif /* !T8_CMESH_PART_TREE_H */
@@ -235,6 +235,8 @@ typedef struct t8_cmesh_trees
                                                            global_id -> local_id for the ghost trees.
                                                            The local_id is the local ghost id starting at num_local_trees  */
   sc_mempool_t       *global_local_mempool;     /* Memory pool for the entries in the hash table */
+  t8_refcount_t       rc;       /* The reference count of the trees. Committed cmeshes that
+                                   are copies of each other share one trees structure. */
 }
 t8_cmesh_trees_struct_t;
 
@@ -37,6 +37,15 @@
  */
 #define T8_CMESH_SUPPORTED_FILE_VERSION 2
 
+/* The attribute key under which the physical tag of a tree is stored.
+ * The attribute is a single int and only present if the tag is not 0. */
+#define T8_CMESH_MSH_PHYSICAL_TAG_KEY 1
+
+/* The attribute key under which the physical tags of a tree's boundary
+ * faces are stored. The attribute is an int array with one entry per
+ * tree face and only present if at least one face has a tag other than 0. */
+#define T8_CMESH_MSH_BOUNDARY_TAGS_KEY 2
+
 /* put typedefs here */
 
 T8_EXTERN_C_BEGIN ();
@@ -58,11 +67,40 @@ T8_EXTERN_C_BEGIN ();
  *                              read the file and store all the trees alone.
  * \return        A committed cmesh holding the mesh of dimension \a dim in the
  *                specified .msh file.
+ * The physical tag of each element of dimension \a dim is stored at its tree.
+ * Each element of dimension \a dim - 1 that lies on a domain boundary face
+ * of a tree assigns its physical tag to that face.
+ * \see t8_cmesh_msh_get_tree_physical_tag
+ * \see t8_cmesh_msh_get_tree_face_boundary_tag
  */
 t8_cmesh_t
 t8_cmesh_from_msh_file (const char *fileprefix, int partition,
                         sc_MPI_Comm comm, int dim, int master);
 
+/** Return the physical tag of a tree that was read from a .msh file.
+ * \param [in]    cmesh         A committed cmesh.
+ * \param [in]    ltreeid       The local id of a tree or ghost of \a cmesh.
+ * \return        The physical tag of the tree's element in the .msh file.
+ *                0 if the element has no physical tag.
+ */
+int                 t8_cmesh_msh_get_tree_physical_tag (t8_cmesh_t cmesh,
+                                                        t8_locidx_t ltreeid);
+
+/** Return the physical tag of a tree's boundary face that was read from
+ * a .msh file.
+ * \param [in]    cmesh         A committed cmesh.
+ * \param [in]    ltreeid       The local id of a tree or ghost of \a cmesh.
+ * \param [in]    face          A face number of the tree.
+ * \return        The physical tag of the boundary element at \a face in the
+ *                .msh file. 0 if \a face is not a domain boundary or if there
+ *                is no tagged boundary element at it.
+ */
+int                 t8_cmesh_msh_get_tree_face_boundary_tag (t8_cmesh_t
+                                                             cmesh,
+                                                             t8_locidx_t
+                                                             ltreeid,
+                                                             int face);
+
 T8_EXTERN_C_END ();
 
 #endif /* !T8_CMESH_READMSHFILE_H */
@@ -0,0 +1,65 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+/** \file t8_cmesh_readvtu.h
+ * We define functions here that read unstructured grids stored in
+ * VTK's XML formats (.vtu and .pvtu) and construct a cmesh from them.
+ */
+
+#ifndef T8_CMESH_READVTU_H
+#define T8_CMESH_READVTU_H
+
+#include <t8.h>
+#include <t8_eclass.h>
+#include <t8_cmesh.h>
+
+T8_EXTERN_C_BEGIN ();
+
+/** Read a .pvtu or .vtu file and create a partitioned cmesh from it.
+ * The pieces listed in a .pvtu file are distributed in contiguous blocks
+ * among the processes and each process only opens its own pieces.
+ * Thus the complete mesh is never present on a single process.
+ * Each cell of dimension \a dim becomes a tree and the trees are numbered
+ * in the order of the pieces and the cells therein.
+ * Face connections are found by matching the vertex coordinates of the
+ * faces, also between trees of different pieces.
+ * Supported are the cell types vertex, line, triangle, pixel, quad, tet,
+ * voxel, hex, wedge and pyramid in ascii, binary and appended (raw or
+ * base64) encoding without compression.
+ * \param [in]    filename      The name of the .pvtu file. A single .vtu
+ *                              file is read as a mesh with one piece.
+ *                              Relative piece sources are opened relative
+ *                              to the directory of \a filename.
+ * \param [in]    comm          The MPI communicator with which the cmesh is
+ *                              to be committed.
+ * \param [in]    dim           The dimension of the cells to read. Cells of
+ *                              other dimensions are ignored.
+ * \return        A committed and partitioned cmesh holding the cells of
+ *                dimension \a dim. NULL if any process failed to read
+ *                its pieces.
+ */
+t8_cmesh_t          t8_cmesh_from_pvtu_file (const char *filename,
+                                             sc_MPI_Comm comm, int dim);
+
+T8_EXTERN_C_END ();
+
+#endif /* !T8_CMESH_READVTU_H */
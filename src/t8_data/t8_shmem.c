@@ -26,11 +26,12 @@
  */
 
 #include <t8_data/t8_shmem.h>
-
-/* TODO: Think about whether we include a reference counter */
+#include <t8_refcount.h>
 
 typedef struct t8_shmem_array
 {
+  t8_refcount_t       rc;       /* The reference counter. Forests with the same
+                                   partition may share their offset arrays. */
   void               *array;
   size_t              elem_size;
   size_t              elem_count;
@@ -67,6 +68,7 @@ t8_shmem_array_init (t8_shmem_array_t * parray, size_t elem_size,
     t8_shmem_set_type (comm, T8_SHMEM_BEST_TYPE);
   }
   array = *parray = T8_ALLOC_ZERO (t8_shmem_array_struct_t, 1);
+  t8_refcount_init (&array->rc);
   array->array = sc_shmem_malloc (t8_get_package_id (), elem_size, elem_count,
                                   comm);
   array->comm = comm;
@@ -210,12 +212,29 @@ t8_shmem_array_is_equal (t8_shmem_array_t array_a, t8_shmem_array_t array_b)
 }
 
 void
-t8_shmem_array_destroy (t8_shmem_array_t * parray)
+t8_shmem_array_ref (t8_shmem_array_t array)
+{
+  T8_ASSERT (array != NULL);
+  t8_refcount_ref (&array->rc);
+}
+
+void
+t8_shmem_array_unref (t8_shmem_array_t * parray)
 {
   t8_shmem_array_t    array;
   T8_ASSERT (parray != NULL && *parray != NULL);
   array = *parray;
-  sc_shmem_free (t8_get_package_id (), array->array, array->comm);
-  T8_FREE (array);
+  if (t8_refcount_unref (&array->rc)) {
+    sc_shmem_free (t8_get_package_id (), array->array, array->comm);
+    T8_FREE (array);
+  }
   *parray = NULL;
 }
+
+void
+t8_shmem_array_destroy (t8_shmem_array_t * parray)
+{
+  T8_ASSERT (parray != NULL && *parray != NULL);
+  T8_ASSERT (t8_refcount_is_last (&(*parray)->rc));
+  t8_shmem_array_unref (parray);
+}
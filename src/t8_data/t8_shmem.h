@@ -160,8 +160,23 @@ void               *t8_shmem_array_index (t8_shmem_array_t array,
 int                 t8_shmem_array_is_equal (t8_shmem_array_t array_a,
                                              t8_shmem_array_t array_b);
 
-/** Free all memory associated with a t8_shmem_array.
+/** Increase the reference counter of a t8_shmem_array.
+ * \param [in,out]      array   A valid t8_shmem_array.
+ */
+void                t8_shmem_array_ref (t8_shmem_array_t array);
+
+/** Decrease the reference counter of a t8_shmem_array.
+ * If the counter reaches zero, the array is freed.
  * \param [in,out]      parray  On input a pointer to a valid t8_shmem_array.
+ *                      \a parray is set to NULL on return.
+ * \note Since the memory is freed collectively, all processes of the
+ *       array's communicator must drop their last reference together.
+ */
+void                t8_shmem_array_unref (t8_shmem_array_t * parray);
+
+/** Free all memory associated with a t8_shmem_array.
+ * \param [in,out]      parray  On input a pointer to a valid t8_shmem_array
+ *                      with exactly one reference.
  *                      This array is freed and \a parray is set to NULL on return.
  */
 void                t8_shmem_array_destroy (t8_shmem_array_t * parray);
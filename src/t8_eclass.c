@@ -63,6 +63,9 @@ const int    t8_eclass_num_vertices[T8_ECLASS_COUNT] =
 const int t8_eclass_vtk_type[T8_ECLASS_COUNT] =
   { 1, 3, 9, 5, 12, 10, 13, 14};
 
+const int t8_eclass_vtk_lagrange_type[T8_ECLASS_COUNT] =
+  { 1, 68, 70, 69, 72, 71, 73, -1};
+
 const int t8_eclass_vtk_corner_number[T8_ECLASS_COUNT][T8_ECLASS_MAX_CORNERS] =
 {{  0, -1, -1, -1, -1, -1, -1, -1}, /* vertex */
  {  0,  1, -1, -1, -1, -1, -1, -1}, /* line */
@@ -104,6 +104,9 @@ extern const int    t8_eclass_num_vertices[T8_ECLASS_COUNT];
 /** The vtk cell type for the eclass */
 extern const int    t8_eclass_vtk_type[T8_ECLASS_COUNT];
 
+/** The vtk Lagrange cell type for the eclass, -1 if not supported */
+extern const int    t8_eclass_vtk_lagrange_type[T8_ECLASS_COUNT];
+
 /** Map the t8code corner number to the vtk corner number */
 extern const int
      t8_eclass_vtk_corner_number[T8_ECLASS_COUNT][T8_ECLASS_MAX_CORNERS];
@@ -54,6 +54,24 @@ t8_element_level (t8_eclass_scheme_c * ts, const t8_element_t * elem)
   return ts->t8_element_level (elem);
 }
 
+int
+t8_element_level_axis (t8_eclass_scheme_c * ts, const t8_element_t * elem,
+                       int axis)
+{
+  T8_ASSERT (ts != NULL);
+
+  return ts->t8_element_level_axis (elem, axis);
+}
+
+void
+t8_element_set_level_axes (t8_eclass_scheme_c * ts, t8_element_t * elem,
+                           const int *levels)
+{
+  T8_ASSERT (ts != NULL);
+
+  ts->t8_element_set_level_axes (elem, levels);
+}
+
 void
 t8_element_copy (t8_eclass_scheme_c * ts, const t8_element_t * source,
                  t8_element_t * dest)
@@ -57,6 +57,27 @@ t8_eclass_t         t8_element_child_eclass (t8_eclass_scheme_c * ts,
 int                 t8_element_level (t8_eclass_scheme_c * ts,
                                       const t8_element_t * elem);
 
+/** Return the level of a particular element along one coordinate axis.
+ * \param [in] ts             Implementation of a class scheme.
+ * \param [in] elem    The element.
+ * \param [in] axis    An axis, 0 <= \a axis < dimension of the element.
+ * \return             The level of \b elem along \a axis.
+ *                     For isotropic schemes this is the level of \a elem.
+ */
+int                 t8_element_level_axis (t8_eclass_scheme_c * ts,
+                                           const t8_element_t * elem,
+                                           int axis);
+
+/** Set the levels of an element along all coordinate axes.
+ * \param [in] ts             Implementation of a class scheme.
+ * \param [in,out] elem  The element.
+ * \param [in] levels    For each axis of \a elem its new level.
+ *                       The minimum must equal the level of \a elem.
+ */
+void                t8_element_set_level_axes (t8_eclass_scheme_c * ts,
+                                               t8_element_t * elem,
+                                               const int *levels);
+
 /** Copy all entries of \b source to \b dest. \b dest must be an existing
  *  element. No memory is allocated by this function.
 * \param [in] ts             Implementation of a class scheme.
@@ -58,6 +58,35 @@ t8_eclass_scheme::t8_element_size ()
 }
 /* *INDENT-ON* */
 
+/* Default implementation for isotropic schemes */
+int
+t8_eclass_scheme::t8_element_level_axis (const t8_element_t * elem, int axis)
+{
+  T8_ASSERT (0 <= axis && axis < t8_eclass_to_dimension[eclass]);
+
+  return t8_element_level (elem);
+}
+
+void
+t8_eclass_scheme::t8_element_set_level_axes (t8_element_t * elem,
+                                             const int *levels)
+{
+#ifdef T8_ENABLE_DEBUG
+  const int           level = t8_element_level (elem);
+  int                 axis;
+
+  for (axis = 0; axis < t8_eclass_to_dimension[eclass]; ++axis) {
+    T8_ASSERT (levels[axis] == level);
+  }
+#endif
+}
+
+int
+t8_eclass_scheme::t8_element_is_anisotropic (void)
+{
+  return 0;
+}
+
 /* Default implementation for array_index */
 t8_element_t       *
 t8_eclass_scheme::t8_element_array_index (sc_array_t * array, size_t it)
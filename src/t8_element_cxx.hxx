@@ -90,6 +90,36 @@ public:
    */
   virtual int         t8_element_level (const t8_element_t * elem) = 0;
 
+  /** Return the level of a particular element along one coordinate axis.
+   * Anisotropic schemes may refine an element more often along some axes
+   * than along others. The level of the element is the minimum of its
+   * levels along all axes.
+   * We provide a default implementation for isotropic schemes that returns
+   * the level of the element for each axis.
+   * \param [in] elem    The element.
+   * \param [in] axis    An axis, 0 <= \a axis < dimension of the element.
+   * \return             The level of \b elem along \a axis.
+   */
+  virtual int         t8_element_level_axis (const t8_element_t * elem,
+                                             int axis);
+
+  /** Set the levels of an element along all coordinate axes.
+   * The minimum of the levels must equal the level of \a elem.
+   * We provide a default implementation for isotropic schemes that only
+   * accepts levels that all equal the level of the element.
+   * \param [in,out] elem  The element.
+   * \param [in] levels    For each axis of \a elem its new level.
+   */
+  virtual void        t8_element_set_level_axes (t8_element_t * elem,
+                                                 const int *levels);
+
+  /** Query whether elements of this scheme support different levels along
+   * different coordinate axes.
+   * \return             Nonzero if \ref t8_element_set_level_axes accepts
+   *                     levels that differ from each other.
+   */
+  virtual int         t8_element_is_anisotropic (void);
+
   /** Copy all entries of \b source to \b dest. \b dest must be an existing
    *  element. No memory is allocated by this function.
    * \param [in] source The element whose entries will be copied to \b dest.
@@ -83,6 +83,9 @@ T8_EXTERN_C_BEGIN ();
  *
  * If an element is being refined, num_outgoing will be 1 and num_incoming will
  * be the number of children, and vice versa if a family is being coarsened.
+ * If an element of an anisotropic scheme only changes its levels along the
+ * axes, num_outgoing and num_incoming are 1 as for an unchanged element.
+ * Use \ref t8_element_compare on the two elements to tell these cases apart.
  * \see t8_forest_iterate_replace
  */
 typedef void        (*t8_forest_replace_t) (t8_forest_t forest_old,
@@ -94,6 +97,33 @@ typedef void        (*t8_forest_replace_t) (t8_forest_t forest_old,
                                             int num_incoming,
                                             t8_locidx_t first_incoming);
 
+/** Flags for the coordinate axes of an element, to be combined with bitwise or
+ * and passed to \ref T8_ADAPT_REFINE_AXES and \ref T8_ADAPT_COARSEN_AXES. */
+#define T8_ADAPT_AXIS_X 1
+#define T8_ADAPT_AXIS_Y 2
+#define T8_ADAPT_AXIS_Z 4
+
+/** Return value of \ref t8_forest_adapt_t to refine an element of an
+ * anisotropic scheme along the given axes only.
+ * The level of the element along each of these axes increases by one.
+ * If its minimum level along all axes increases, the element is replaced by
+ * its children, otherwise only its levels along the axes change.
+ * The element is kept if a new level exceeds the maximum level.
+ * \param [in] axes  A nonzero combination of T8_ADAPT_AXIS_X, _Y and _Z.
+ */
+#define T8_ADAPT_REFINE_AXES(axes) (2 * (axes))
+
+/** Return value of \ref t8_forest_adapt_t to coarsen an element of an
+ * anisotropic scheme along the given axes only.
+ * The level of the element along each of these axes decreases by one.
+ * If its minimum level along all axes decreases, the family of the element
+ * must have been passed to the callback and is replaced by its parent,
+ * otherwise only the levels of the first element along the axes change.
+ * Else the element is kept.
+ * \param [in] axes  A nonzero combination of T8_ADAPT_AXIS_X, _Y and _Z.
+ */
+#define T8_ADAPT_COARSEN_AXES(axes) (-2 * (axes))
+
 /** Callback function prototype to decide for refining and coarsening.
  * If the \a num_elements equals the number of children then the elements
  * form a family and we decide whether this family should be coarsened
@@ -112,6 +142,12 @@ typedef void        (*t8_forest_replace_t) (t8_forest_t forest_old,
  * \return greater zero if the first entry in \a elements should be refined,
  *         smaller zero if the family \a elements shall be coarsened,
  *         zero else.
+ *         If the scheme of the tree is anisotropic, see
+ *         \ref t8_scheme_new_anisotropic_cxx, even nonzero return values
+ *         refine or coarsen the first element along some axes only,
+ *         see \ref T8_ADAPT_REFINE_AXES and \ref T8_ADAPT_COARSEN_AXES.
+ * \see t8_forest_set_adapt_split_families for the meaning of a negative
+ *      return value for a single element.
  */
 /* TODO: Do we really need the forest argument? Since the forest is not committed yet it
  *       seems dangerous to expose to the user. */
@@ -123,6 +159,43 @@ typedef int         (*t8_forest_adapt_t) (t8_forest_t forest,
                                           int num_elements,
                                           t8_element_t * elements[]);
 
+/** Callback function prototype to compute the target level of an element.
+ * \param [in] forest      the forest to which the new elements belong
+ * \param [in] forest_from the forest that is adapted.
+ * \param [in] which_tree  the local tree containing \a element
+ * \param [in] lelement_id the local element id in \a forest_old in the tree of the current element
+ * \param [in] ts          the eclass scheme of the tree
+ * \param [in] element     the element
+ * \return the level that \a element should have in \a forest.
+ * \see t8_forest_set_adapt_target
+ */
+typedef int         (*t8_forest_adapt_target_t) (t8_forest_t forest,
+                                                 t8_forest_t forest_from,
+                                                 t8_locidx_t which_tree,
+                                                 t8_locidx_t lelement_id,
+                                                 t8_eclass_scheme_c * ts,
+                                                 const t8_element_t *
+                                                 element);
+
+/** Callback function prototype to compute the weight of an element for
+ * partitioning.
+ * \param [in] forest      the forest that is partitioned
+ * \param [in] forest_from the forest whose elements are redistributed.
+ * \param [in] which_tree  the local tree containing \a element
+ * \param [in] lelement_id the local element id in \a forest_from in the tree of the current element
+ * \param [in] ts          the eclass scheme of the tree
+ * \param [in] element     the element of \a forest_from
+ * \return                 the non-negative weight of \a element.
+ * \see t8_forest_set_partition_weight
+ */
+typedef double      (*t8_forest_partition_weight_t) (t8_forest_t forest,
+                                                     t8_forest_t forest_from,
+                                                     t8_locidx_t which_tree,
+                                                     t8_locidx_t lelement_id,
+                                                     t8_eclass_scheme_c * ts,
+                                                     const t8_element_t *
+                                                     element);
+
   /** Create a new forest with reference count one.
  * This forest needs to be specialized with the t8_forest_set_* calls.
  * Currently it is manatory to either call the functions \ref
@@ -169,6 +242,48 @@ int                 t8_forest_is_committed (t8_forest_t forest);
 int                 t8_forest_is_equal (t8_forest_t forest_a,
                                         t8_forest_t forest_b);
 
+/** Check whether two committed forests have the same partition.
+ * That is, each process has the same number of elements, the same first
+ * descendant of its first element and the same first tree in both forests.
+ * The forests must also have the same communicator.
+ * \param [in] forest_a The first forest.
+ * \param [in] forest_b The second forest.
+ * \return              True if \a forest_a and \a forest_b have the same
+ *                      partition.
+ * \note Since the partition information is global, this function is not
+ * collective but returns the same value on each rank.
+ */
+int                 t8_forest_partition_is_equal (t8_forest_t forest_a,
+                                                  t8_forest_t forest_b);
+
+/** Let a forest share the partition metadata of another forest with the
+ * same partition.
+ * The element offsets, tree offsets and first descendants of \a forest
+ * are replaced by references to the ones of \a forest_from.
+ * If both forests have a ghost layer of the same type, are built on the same
+ * cmesh and have the same local elements, the ghost layer is shared as well.
+ * Since the shared objects are reference counted, \a forest and
+ * \a forest_from can be destroyed in any order.
+ * \ref t8_forest_partition_data and \ref t8_forest_ghost_exchange_data
+ * then use the shared offset arrays and ghost layer of all these forests.
+ * The send and receive ranks are still computed from the offsets on each
+ * call. Storing them as an exchange plan that is reused across the forests
+ * is deferred.
+ * \param [in,out] forest     A committed forest.
+ * \param [in]     forest_from A committed forest.
+ * \param [in]     check      If true, it is checked whether the partitions and
+ *                            the elements of both forests are equal.
+ *                            If false, the caller guarantees it and the
+ *                            metadata is shared without checking.
+ * \return                    True if the metadata was shared.
+ *                            False if \a check is true and the partitions
+ *                            of the forests differ.
+ * \note This function is collective over the communicator of \a forest.
+ */
+int                 t8_forest_share_partition (t8_forest_t forest,
+                                               t8_forest_t forest_from,
+                                               int check);
+
 /** Set the cmesh associated to a forest.
  * By default, the forest takes ownership of the cmesh such that it will be
  * destroyed when the forest is destroyed.  To keep ownership of the cmesh,
@@ -182,6 +297,32 @@ int                 t8_forest_is_equal (t8_forest_t forest_a,
 void                t8_forest_set_cmesh (t8_forest_t forest,
                                          t8_cmesh_t cmesh, sc_MPI_Comm comm);
 
+/** Let a forest communicate on a duplicate of its communicator.
+ * The duplicate is taken from a reference counted pool, see
+ * \ref t8_comm_pool_dup. Forests derived from \a forest share this duplicate,
+ * so that the communicator of the user is duplicated only once.
+ * \param [in,out] forest       The forest. Its cmesh and communicator must be set
+ *                              with \ref t8_forest_set_cmesh.
+ * \param [in]     do_dup       If true, the communicator is duplicated on commit.
+ */
+void                t8_forest_set_comm_dup (t8_forest_t forest, int do_dup);
+
+/** Encode the elements in the messages of partition and ghost as compact
+ * keys instead of shipping the raw element data.
+ * Each element is sent as its level and its linear id, delta-encoded within
+ * each tree, and reconstructed with \ref t8_element_set_linear_id on receipt.
+ * This reduces the message sizes at the cost of some computation.
+ * Elements whose linear id does not determine them, such as pyramids and
+ * the elements of anisotropic schemes, are sent as raw data.
+ * If not set, the value is inherited from the forest that \a forest is
+ * derived from, and is false for a new forest.
+ * \param [in,out] forest       The forest.
+ * \param [in]     compact      If true, send compact element keys.
+ *                              Must be the same on all processes.
+ */
+void                t8_forest_set_compact_messages (t8_forest_t forest,
+                                                    int compact);
+
 /** Set the element scheme associated to a forest.
  * By default, the forest takes ownership of the scheme such that it will be
  * destroyed when the forest is destroyed.  To keep ownership of the scheme, call
@@ -245,6 +386,10 @@ void                t8_forest_set_copy (t8_forest_t forest,
  * 1) Adapt 2) Balance 3) Partition
  * \note This setting may not be combined with \ref t8_forest_set_copy and overwrites
  * this setting.
+ * \note If no element changes on any process, \b forest takes over the elements,
+ * partition and ghost layer of \b set_from. Partition and balance are then
+ * skipped if \b set_from already is partitioned and balanced.
+ * \see t8_forest_is_unchanged
  */
 /* TODO: make recursive flag to int specifying the number of recursions? */
 void                t8_forest_set_adapt (t8_forest_t forest,
@@ -252,6 +397,61 @@ void                t8_forest_set_adapt (t8_forest_t forest,
                                          t8_forest_adapt_t adapt_fn,
                                          int recursive);
 
+/** Set a source forest to be adapted to given target levels on commiting.
+ * Each element of \a set_from is given a target level, either by a callback
+ * or by a precomputed array. In a single pass over the elements, an element
+ * with a higher target level is replaced by all its descendants of that
+ * level, which are generated directly from their range of linear ids.
+ * An element with a lower target level is replaced by its ancestor of that
+ * level if the element is the first leaf of the ancestor, all leaves of the
+ * ancestor are local, and all of them have a target level not higher than
+ * the ancestor's level. Otherwise the coarsest ancestor for which this
+ * holds is taken, or the element is kept.
+ * Target levels are clamped to the range from 0 to the maximum level.
+ * The ownership of \b set_from is handled as in \ref t8_forest_set_adapt.
+ * \param [in,out] forest   The forest
+ * \param [in] set_from     The source forest from which \b forest will be adapted.
+ *                          If NULL, a previously (or later) set forest will
+ *                          be taken (\ref t8_forest_set_partition, \ref t8_forest_set_balance).
+ * \param [in] target_fn    If not NULL, the callback returning the target level
+ *                          of each element.
+ * \param [in] target_levels If \a target_fn is NULL, an array with the target
+ *                          level of each local element of \b set_from.
+ *                          It must stay valid until \b forest is committed.
+ * \note This setting can be combined with \ref t8_forest_set_partition and \ref
+ * t8_forest_set_balance, but not with \ref t8_forest_set_adapt_split_families.
+ * The scheme must be isotropic.
+ */
+void                t8_forest_set_adapt_target (t8_forest_t forest,
+                                                const t8_forest_t set_from,
+                                                t8_forest_adapt_target_t
+                                                target_fn,
+                                                const int *target_levels);
+
+/** Allow the coarsening of families whose siblings are split across processes.
+ * By default, the adapt function is only given a family if all of its
+ * siblings are local elements. Thus families that are cut by the partition
+ * boundary are never coarsened.
+ * If this option is set, the adapt function is given each sibling of such a
+ * split family separately with  num_elements = 1.
+ * A negative return value is then a vote for coarsening the family.
+ * The votes are exchanged with the other processes and the family is coarsened
+ * if all of its siblings voted for it. The resulting parent is owned by the
+ * process that owned the first sibling. No repartitioning is required.
+ * Since the adapt function may now return a negative value for a single
+ * element, such a value is treated as 0 for elements that are not part of a
+ * split family.
+ * \param [in,out] forest   The forest. Must be adapted on commit,
+ *                          see \ref t8_forest_set_adapt.
+ * \param [in] split_families If true, families that are split across processes
+ *                          may be coarsened.
+ * \note A split family is coarsened by at most one level per adaptation, also
+ * if the adaptation is recursive.
+ * \note All processes must use the same setting.
+ */
+void                t8_forest_set_adapt_split_families (t8_forest_t forest,
+                                                        int split_families);
+
 /** Set the user data of a forest. This can i.e. be used to pass user defined
  * arguments to the adapt routine.
  * \param [in,out] forest   The forest
@@ -315,6 +515,52 @@ void                t8_forest_set_partition (t8_forest_t forest,
                                              const t8_forest_t set_from,
                                              int set_for_coarsening);
 
+/** Set element weights for the partitioning of a forest.
+ * Instead of the same number of elements, each rank is then assigned
+ * a contiguous range of elements with the same (up to one element) sum of weights.
+ * If the weights of all elements are zero, the elements are distributed evenly.
+ * \param [in, out] forest  The forest.
+ * \param [in]      weight_fn The weight function, called once for each element
+ *                          of the forest that is partitioned.
+ *                          If NULL, each element has the same weight.
+ * \param [in]      weight_data A pointer that \a weight_fn can access with
+ *                          \ref t8_forest_get_partition_weight_data.
+ * \note This setting only has an effect in combination with
+ *       \ref t8_forest_set_partition.
+ * \note All processes must use the same setting.
+ */
+void                t8_forest_set_partition_weight (t8_forest_t forest,
+                                                    t8_forest_partition_weight_t
+                                                    weight_fn,
+                                                    void *weight_data);
+
+/** Return the data pointer passed to \ref t8_forest_set_partition_weight.
+ * \param [in]      forest  The forest.
+ * \return                  The weight data of \a forest.
+ */
+void               *t8_forest_get_partition_weight_data (t8_forest_t forest);
+
+/** Set the capacity of this process for the partitioning of a forest.
+ * Each process is then assigned a share of the elements, or of the sum of
+ * the element weights if \ref t8_forest_set_partition_weight is used,
+ * that is proportional to its capacity. Use this on heterogeneous
+ * hardware to give faster processes more work.
+ * The capacities are relative and need not sum up to one.
+ * If all processes have the same capacity, for example zero, the forest is
+ * partitioned exactly as without capacities.
+ * \param [in, out] forest  The forest.
+ * \param [in]      capacity The non-negative capacity of this process, for example
+ *                          its measured speed, see \ref t8_forest_calibrate_get_capacity.
+ *                          Processes with capacity zero get no elements.
+ *                          If negative, all processes have the same capacity.
+ * \note This setting only has an effect in combination with
+ *       \ref t8_forest_set_partition.
+ * \note The value of \a capacity may differ between processes, but either
+ *       all or no processes must set a non-negative capacity.
+ */
+void                t8_forest_set_partition_capacity (t8_forest_t forest,
+                                                      double capacity);
+
 /** Set a source forest to be balanced during commit.
  * A forest is said to be balanced if each element has face neighbors of level
  * at most +1 or -1 of the element's level.
@@ -410,6 +656,17 @@ t8_locidx_t         t8_forest_get_local_num_elements (t8_forest_t forest);
   */
 t8_gloidx_t         t8_forest_get_global_num_elements (t8_forest_t forest);
 
+/** Query whether a forest was adapted without changing any element.
+ * Such a forest has the same elements as the forest it was adapted from and
+ * references its element offsets, first descendants and ghost layer.
+ * \param [in]  forest    A forest.
+ * \return                True if \a forest was adapted and the adapt
+ *                        callback did not refine or coarsen any element on
+ *                        any process. False otherwise.
+ * \a forest must be committed before calling this function.
+ */
+int                 t8_forest_is_unchanged (t8_forest_t forest);
+
 /** Return the number of ghost elements of a forest.
  * \param [in]      forest      The forest.
  * \return                      The number of ghost elements stored in the ghost
@@ -795,6 +1052,22 @@ t8_eclass_t         t8_forest_element_neighbor_eclass (t8_forest_t forest,
                                                        const t8_element_t *
                                                        elem, int face);
 
+/** Return the boundary tag of an element's face, if it lies on the domain
+ * boundary. The tags are the physical tags of the boundary elements of a
+ * .msh file, see \ref t8_cmesh_from_msh_file.
+ * \param [in]      forest.     A committed forest.
+ * \param [in]      ltreeid.    The local tree in which the element lies.
+ * \param [in]      elem.       An element in the tree \a ltreeid.
+ * \param [in]      face.       A face number of \a elem.
+ * \return                      -1 if \a face is not on the domain boundary.
+ *                              Otherwise the tag of the tree face that
+ *                              contains \a face, 0 if that face has no tag.
+ */
+int                 t8_forest_element_boundary_tag (t8_forest_t forest,
+                                                    t8_locidx_t ltreeid,
+                                                    const t8_element_t *
+                                                    elem, int face);
+
 /** Construct the face neighbor of an element, possibly across tree boundaries.
  * Returns the global tree-id of the tree in which the neighbor element lies in.
  *
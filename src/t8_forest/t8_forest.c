@@ -33,6 +33,10 @@
 #include <t8_cmesh/t8_cmesh_offset.h>
 #include <t8_cmesh/t8_cmesh_trees.h>
 
+/* The number of forests committed on this process so far.
+ * Used to give each committed forest a unique stamp. */
+static int64_t      t8_forest_commit_count = 0;
+
 void
 t8_forest_init (t8_forest_t * pforest)
 {
@@ -54,7 +58,9 @@ t8_forest_init (t8_forest_t * pforest)
   forest->global_num_elements = -1;
   forest->set_adapt_recursive = -1;
   forest->set_balance = -1;
+  forest->set_partition_capacity = -1;
   forest->maxlevel_existing = -1;
+  forest->compact_messages = -1;
 }
 
 int
@@ -130,6 +136,28 @@ t8_forest_set_cmesh (t8_forest_t forest, t8_cmesh_t cmesh, sc_MPI_Comm comm)
   t8_forest_set_mpicomm (forest, comm, do_dup);
 }
 
+void
+t8_forest_set_comm_dup (t8_forest_t forest, int do_dup)
+{
+  T8_ASSERT (forest != NULL);
+  T8_ASSERT (forest->rc.refcount > 0);
+  T8_ASSERT (!forest->committed);
+  T8_ASSERT (forest->mpicomm != sc_MPI_COMM_NULL);
+  T8_ASSERT (forest->set_from == NULL);
+
+  forest->do_dup = do_dup != 0;
+}
+
+void
+t8_forest_set_compact_messages (t8_forest_t forest, int compact)
+{
+  T8_ASSERT (forest != NULL);
+  T8_ASSERT (forest->rc.refcount > 0);
+  T8_ASSERT (!forest->committed);
+
+  forest->compact_messages = compact != 0;
+}
+
 void
 t8_forest_set_scheme (t8_forest_t forest, t8_scheme_cxx_t * scheme)
 {
@@ -178,6 +206,11 @@ t8_forest_set_copy (t8_forest_t forest, const t8_forest_t set_from)
   /* Overwrite any previous setting */
   forest->set_adapt_fn = NULL;
   forest->set_adapt_recursive = -1;
+  forest->set_adapt_split_families = 0;
+  forest->set_adapt_target_fn = NULL;
+  forest->set_adapt_target_levels = NULL;
+  forest->set_partition_weight_fn = NULL;
+  forest->set_partition_capacity = -1;
   forest->set_balance = -1;
   forest->set_for_coarsening = -1;
 }
@@ -209,6 +242,48 @@ t8_forest_set_partition (t8_forest_t forest, const t8_forest_t set_from,
   }
 }
 
+void
+t8_forest_set_partition_weight (t8_forest_t forest,
+                                t8_forest_partition_weight_t weight_fn,
+                                void *weight_data)
+{
+  T8_ASSERT (forest != NULL);
+  T8_ASSERT (forest->rc.refcount > 0);
+  T8_ASSERT (!forest->committed);
+
+  forest->set_partition_weight_fn = weight_fn;
+  forest->set_partition_weight_data = weight_data;
+}
+
+void               *
+t8_forest_get_partition_weight_data (t8_forest_t forest)
+{
+  T8_ASSERT (forest != NULL);
+  T8_ASSERT (forest->rc.refcount > 0);
+
+  return forest->set_partition_weight_data;
+}
+
+void
+t8_forest_set_partition_capacity (t8_forest_t forest, double capacity)
+{
+  T8_ASSERT (forest != NULL);
+  T8_ASSERT (forest->rc.refcount > 0);
+  T8_ASSERT (!forest->committed);
+
+  /* A negative capacity restores the default of equal capacities */
+  forest->set_partition_capacity = capacity;
+}
+
+/* Return true if a partition of forest distributes the elements evenly,
+ * that is without element weights and process capacities. */
+static int
+t8_forest_partition_is_even (t8_forest_t forest)
+{
+  return forest->set_partition_weight_fn == NULL
+    && forest->set_partition_capacity < 0;
+}
+
 void
 t8_forest_set_balance (t8_forest_t forest, const t8_forest_t set_from,
                        int no_repartition)
@@ -303,6 +378,50 @@ t8_forest_set_adapt (t8_forest_t forest, const t8_forest_t set_from,
   }
 }
 
+void
+t8_forest_set_adapt_target (t8_forest_t forest, const t8_forest_t set_from,
+                            t8_forest_adapt_target_t target_fn,
+                            const int *target_levels)
+{
+  T8_ASSERT (forest != NULL);
+  T8_ASSERT (forest->rc.refcount > 0);
+  T8_ASSERT (!forest->committed);
+  T8_ASSERT (forest->mpicomm == sc_MPI_COMM_NULL);
+  T8_ASSERT (forest->cmesh == NULL);
+  T8_ASSERT (forest->scheme_cxx == NULL);
+  T8_ASSERT (forest->set_adapt_fn == NULL);
+  T8_ASSERT (forest->set_adapt_recursive == -1);
+  T8_ASSERT (target_fn != NULL || target_levels != NULL);
+
+  forest->set_adapt_target_fn = target_fn;
+  forest->set_adapt_target_levels = target_fn == NULL ? target_levels : NULL;
+  forest->set_adapt_recursive = 0;
+
+  if (set_from != NULL) {
+    /* If set_from = NULL, we assume a previous forest_from was set */
+    forest->set_from = set_from;
+  }
+
+  /* Add ADAPT to the from_method.
+   * This overwrites T8_FOREST_FROM_COPY */
+  if (forest->from_method == T8_FOREST_FROM_LAST) {
+    forest->from_method = T8_FOREST_FROM_ADAPT;
+  }
+  else {
+    forest->from_method |= T8_FOREST_FROM_ADAPT;
+  }
+}
+
+void
+t8_forest_set_adapt_split_families (t8_forest_t forest, int split_families)
+{
+  T8_ASSERT (forest != NULL);
+  T8_ASSERT (forest->rc.refcount > 0);
+  T8_ASSERT (!forest->committed);
+
+  forest->set_adapt_split_families = split_families != 0;
+}
+
 void
 t8_forest_set_user_data (t8_forest_t forest, void *data)
 {
@@ -357,7 +476,7 @@ t8_forest_commit (t8_forest_t forest)
 {
   int                 mpiret;
   int                 partitioned = 0;
-  sc_MPI_Comm         comm_dup;
+  t8_forest_t         forest_unchanged = NULL;
 
   T8_ASSERT (forest != NULL);
   T8_ASSERT (forest->rc.refcount > 0);
@@ -378,9 +497,7 @@ t8_forest_commit (t8_forest_t forest)
 
     /* dup communicator if requested */
     if (forest->do_dup) {
-      mpiret = sc_MPI_Comm_dup (forest->mpicomm, &comm_dup);
-      SC_CHECK_MPI (mpiret);
-      forest->mpicomm = comm_dup;
+      forest->mpicomm = t8_comm_pool_dup (forest->mpicomm);
     }
     forest->dimension = forest->cmesh->dimension;
 
@@ -394,7 +511,13 @@ t8_forest_commit (t8_forest_t forest)
     T8_ASSERT (forest->set_level <= forest->maxlevel);
     /* populate a new forest with tree and quadrant objects */
     t8_forest_populate (forest);
+    /* A uniform forest is partitioned and balanced */
+    forest->is_partitioned = 1;
+    forest->is_balanced = 1;
     forest->global_num_trees = t8_cmesh_get_num_trees (forest->cmesh);
+    if (forest->compact_messages < 0) {
+      forest->compact_messages = 0;
+    }
   }
   else {                        /* set_from != NULL */
     t8_forest_t         forest_from = forest->set_from; /* temporarily store set_from, since we may overwrite it */
@@ -408,16 +531,19 @@ t8_forest_commit (t8_forest_t forest)
                forest->from_method < T8_FOREST_FROM_LAST);
 
     /* TODO: optimize all this when forest->set_from has reference count one */
-    /* TODO: Get rid of duping the communicator */
-    /* we must prevent the case that set_from frees the source communicator */
+    /* we must prevent the case that set_from frees the source communicator.
+     * The duplicate is shared with set_from via the communicator pool. */
     if (!forest->set_from->do_dup) {
       forest->mpicomm = forest->set_from->mpicomm;
     }
     else {
-      mpiret = sc_MPI_Comm_dup (forest->set_from->mpicomm, &forest->mpicomm);
-      SC_CHECK_MPI (mpiret);
+      forest->mpicomm = t8_comm_pool_dup (forest->set_from->mpicomm);
     }
     forest->do_dup = forest->set_from->do_dup;
+    if (forest->compact_messages < 0) {
+      /* Inherit the message encoding from the source forest */
+      forest->compact_messages = forest->set_from->compact_messages;
+    }
 
     /* Set mpirank and mpisize */
     mpiret = sc_MPI_Comm_size (forest->mpicomm, &forest->mpisize);
@@ -440,12 +566,16 @@ t8_forest_commit (t8_forest_t forest)
       SC_CHECK_ABORT (forest->set_from != NULL,
                       "No forest to copy from was specified.");
       t8_forest_copy_trees (forest, forest->set_from, 1);
+      forest->is_partitioned = forest->set_from->is_partitioned;
+      forest->is_balanced = forest->set_from->is_balanced;
     }
     /* TODO: currently we can only handle copy, adapt, partition, and balance */
 
     /* T8_ASSERT (forest->from_method == T8_FOREST_FROM_COPY); */
     if (forest->from_method & T8_FOREST_FROM_ADAPT) {
-      SC_CHECK_ABORT (forest->set_adapt_fn != NULL,
+      SC_CHECK_ABORT (forest->set_adapt_fn != NULL
+                      || forest->set_adapt_target_fn != NULL
+                      || forest->set_adapt_target_levels != NULL,
                       "No adapt function specified");
       forest->from_method -= T8_FOREST_FROM_ADAPT;
       if (forest->from_method > 0) {
@@ -460,11 +590,22 @@ t8_forest_commit (t8_forest_t forest)
         t8_forest_set_user_data (forest_adapt,
                                  t8_forest_get_user_data (forest));
         /* Construct an intermediate, adapted forest */
-        t8_forest_set_adapt (forest_adapt, forest->set_from,
-                             forest->set_adapt_fn,
-                             forest->set_adapt_recursive);
+        if (forest->set_adapt_fn != NULL) {
+          t8_forest_set_adapt (forest_adapt, forest->set_from,
+                               forest->set_adapt_fn,
+                               forest->set_adapt_recursive);
+        }
+        else {
+          t8_forest_set_adapt_target (forest_adapt, forest->set_from,
+                                      forest->set_adapt_target_fn,
+                                      forest->set_adapt_target_levels);
+        }
+        t8_forest_set_adapt_split_families (forest_adapt,
+                                            forest->set_adapt_split_families);
         /* Set profiling if enabled */
         t8_forest_set_profiling (forest_adapt, forest->profile != NULL);
+        t8_forest_set_compact_messages (forest_adapt,
+                                        forest->compact_messages);
         t8_forest_commit (forest_adapt);
         /* The new forest will be partitioned/balanced from forest_adapt */
         forest->set_from = forest_adapt;
@@ -476,11 +617,44 @@ t8_forest_commit (t8_forest_t forest)
           forest->profile->adapt_runtime =
             forest_adapt->profile->adapt_runtime;
         }
+        if (forest_adapt->is_unchanged) {
+          /* No element changed. We do not partition or balance again
+           * if forest_from already is partitioned or balanced.
+           * A partition with weights or capacities is always repeated,
+           * since these may have changed. */
+          if ((forest->from_method & T8_FOREST_FROM_PARTITION)
+              && forest_adapt->is_partitioned
+              && t8_forest_partition_is_even (forest)) {
+            forest->from_method -= T8_FOREST_FROM_PARTITION;
+          }
+          if ((forest->from_method & T8_FOREST_FROM_BALANCE)
+              && forest_adapt->is_balanced) {
+            forest->from_method -= T8_FOREST_FROM_BALANCE;
+          }
+          if (forest->from_method == 0) {
+            /* Take over the elements of forest_adapt and reference the
+             * partition and ghosts of forest_from at the end of commit */
+            t8_forest_take_trees (forest, forest_adapt);
+            forest->is_unchanged = 1;
+            forest->is_partitioned = forest_adapt->is_partitioned;
+            forest->is_balanced = forest_adapt->is_balanced;
+            forest_unchanged = forest_from;
+            t8_forest_ref (forest_unchanged);
+          }
+        }
       }
       else {
         /* This forest should only be adapted */
         t8_forest_copy_trees (forest, forest->set_from, 0);
         t8_forest_adapt (forest);
+        if (forest->is_unchanged) {
+          /* No element changed. We reference the partition and ghosts
+           * of forest_from at the end of commit */
+          forest->is_partitioned = forest_from->is_partitioned;
+          forest->is_balanced = forest_from->is_balanced;
+          forest_unchanged = forest_from;
+          t8_forest_ref (forest_unchanged);
+        }
       }
     }
     if (forest->from_method & T8_FOREST_FROM_PARTITION) {
@@ -499,8 +673,15 @@ t8_forest_commit (t8_forest_t forest)
         }
         t8_forest_set_partition (forest_partition, forest->set_from,
                                  forest->set_for_coarsening);
+        t8_forest_set_partition_weight (forest_partition,
+                                        forest->set_partition_weight_fn,
+                                        forest->set_partition_weight_data);
+        t8_forest_set_partition_capacity (forest_partition,
+                                          forest->set_partition_capacity);
         /* activate profiling, if this forest has profiling */
         t8_forest_set_profiling (forest_partition, forest->profile != NULL);
+        t8_forest_set_compact_messages (forest_partition,
+                                        forest->compact_messages);
         /* Commit the partitioned forest */
         t8_forest_commit (forest_partition);
         forest->set_from = forest_partition;
@@ -524,6 +705,8 @@ t8_forest_commit (t8_forest_t forest)
         forest->trees = sc_array_new (sizeof (t8_tree_struct_t));
         /* partition the forest */
         t8_forest_partition (forest);
+        forest->is_partitioned = t8_forest_partition_is_even (forest);
+        forest->is_balanced = forest->set_from->is_balanced;
       }
     }
     if (forest->from_method & T8_FOREST_FROM_BALANCE) {
@@ -565,6 +748,7 @@ t8_forest_commit (t8_forest_t forest)
   forest->set_for_coarsening = 0;
   forest->set_from = NULL;
   forest->committed = 1;
+  forest->commit_stamp = ++t8_forest_commit_count;
   t8_debugf ("Committed forest with %li local elements and %lli "
              "global elements.\n\tTree range ist from %lli to %lli.\n",
              (long) forest->local_num_elements,
@@ -579,6 +763,18 @@ t8_forest_commit (t8_forest_t forest)
   T8_ASSERT (forest->tree_offsets == NULL);
   T8_ASSERT (forest->global_first_desc == NULL);
 #else
+  if (forest_unchanged != NULL) {
+    /* No element changed, hence the partition is that of forest_unchanged */
+    T8_ASSERT (forest->tree_offsets == NULL);
+    T8_ASSERT (forest->element_offsets == NULL);
+    T8_ASSERT (forest->global_first_desc == NULL);
+    t8_shmem_array_ref (forest_unchanged->tree_offsets);
+    forest->tree_offsets = forest_unchanged->tree_offsets;
+    t8_shmem_array_ref (forest_unchanged->element_offsets);
+    forest->element_offsets = forest_unchanged->element_offsets;
+    t8_shmem_array_ref (forest_unchanged->global_first_desc);
+    forest->global_first_desc = forest_unchanged->global_first_desc;
+  }
   if (forest->tree_offsets == NULL) {
     /* Compute the tree offset array */
     t8_forest_partition_create_tree_offsets (forest);
@@ -609,7 +805,15 @@ t8_forest_commit (t8_forest_t forest)
 
   if (forest->mpisize > 1) {
     /* Construct a ghost layer, if desired */
-    if (forest->do_ghost) {
+    if (forest->do_ghost && forest_unchanged != NULL
+        && forest_unchanged->ghosts != NULL
+        && forest_unchanged->ghost_type == forest->ghost_type) {
+      /* No element changed and the ghost layer of forest_unchanged
+       * is the ghost layer of this forest */
+      t8_forest_ghost_ref (forest_unchanged->ghosts);
+      forest->ghosts = forest_unchanged->ghosts;
+    }
+    else if (forest->do_ghost) {
       /* TODO: ghost type */
       switch (forest->ghost_algorithm) {
       case 1:
@@ -627,6 +831,38 @@ t8_forest_commit (t8_forest_t forest)
     }
     forest->do_ghost = 0;
   }
+  if (forest_unchanged != NULL) {
+    t8_forest_unref (&forest_unchanged);
+  }
+}
+
+void
+t8_forest_commit_trees (t8_forest_t forest)
+{
+  T8_ASSERT (forest != NULL);
+  T8_ASSERT (forest->rc.refcount > 0);
+  T8_ASSERT (!forest->committed);
+  T8_ASSERT (forest->set_from == NULL);
+  T8_ASSERT (forest->cmesh != NULL && forest->scheme_cxx != NULL);
+  T8_ASSERT (forest->mpicomm != sc_MPI_COMM_NULL);
+  T8_ASSERT (forest->trees != NULL);
+
+  if (forest->compact_messages < 0) {
+    forest->compact_messages = 0;
+  }
+  forest->global_num_trees = t8_cmesh_get_num_trees (forest->cmesh);
+  t8_forest_comm_global_num_elements (forest);
+  t8_forest_compute_elements_offset (forest);
+  t8_forest_compute_desc (forest);
+
+  forest->set_level = 0;
+  forest->committed = 1;
+  forest->commit_stamp = ++t8_forest_commit_count;
+
+  t8_forest_partition_create_tree_offsets (forest);
+  t8_forest_partition_create_offsets (forest);
+  t8_forest_partition_create_first_desc (forest);
+  forest->do_ghost = 0;
 }
 
 t8_locidx_t
@@ -645,6 +881,14 @@ t8_forest_get_global_num_elements (t8_forest_t forest)
   return forest->global_num_elements;
 }
 
+int
+t8_forest_is_unchanged (t8_forest_t forest)
+{
+  T8_ASSERT (t8_forest_is_committed (forest));
+
+  return forest->is_unchanged;
+}
+
 t8_locidx_t
 t8_forest_get_num_ghosts (t8_forest_t forest)
 {
@@ -1374,7 +1618,6 @@ t8_forest_free_trees (t8_forest_t forest)
 static void
 t8_forest_reset (t8_forest_t * pforest)
 {
-  int                 mpiret;
   t8_forest_t         forest;
 
   T8_ASSERT (pforest != NULL);
@@ -1395,8 +1638,7 @@ t8_forest_reset (t8_forest_t * pforest)
   /* undup communicator if necessary */
   if (forest->committed) {
     if (forest->do_dup) {
-      mpiret = sc_MPI_Comm_free (&forest->mpicomm);
-      SC_CHECK_MPI (mpiret);
+      t8_comm_pool_release (&forest->mpicomm);
     }
     t8_forest_free_trees (forest);
   }
@@ -1413,17 +1655,18 @@ t8_forest_reset (t8_forest_t * pforest)
     t8_cmesh_unref (&forest->cmesh);
   }
 
-  /* free the memory of the offset array */
+  /* free the memory of the offset array.
+   * The offset arrays may be shared with forests of the same partition */
   if (forest->element_offsets != NULL) {
-    t8_shmem_array_destroy (&forest->element_offsets);
+    t8_shmem_array_unref (&forest->element_offsets);
   }
   /* free the memory of the global_first_desc array */
   if (forest->global_first_desc != NULL) {
-    t8_shmem_array_destroy (&forest->global_first_desc);
+    t8_shmem_array_unref (&forest->global_first_desc);
   }
   /* free the memory of the tree_offsets array */
   if (forest->tree_offsets != NULL) {
-    t8_shmem_array_destroy (&forest->tree_offsets);
+    t8_shmem_array_unref (&forest->tree_offsets);
   }
   if (forest->profile != NULL) {
     T8_FREE (forest->profile);
@@ -29,6 +29,89 @@
 /* We want to export the whole implementation to be callable from "C" */
 T8_EXTERN_C_BEGIN ();
 
+/* The possible results of refining or coarsening an element of an
+ * anisotropic scheme along some of its axes. */
+typedef enum
+{
+  T8_FOREST_ADAPT_ANISO_KEEP = 0,       /* The element cannot be changed */
+  T8_FOREST_ADAPT_ANISO_IN_PLACE,       /* Only the levels along the axes change */
+  T8_FOREST_ADAPT_ANISO_REFINE, /* The element is replaced by its children */
+  T8_FOREST_ADAPT_ANISO_COARSEN /* The family is replaced by its parent */
+} t8_forest_adapt_aniso_t;
+
+/* Return the axes encoded in a return value of the adapt callback, see
+ * \ref T8_ADAPT_REFINE_AXES.
+ * If the scheme is not anisotropic or the value does not encode any axes,
+ * return 0. */
+static int
+t8_forest_adapt_axes (t8_eclass_scheme_c * ts, int refine)
+{
+  if (refine != 0 && refine % 2 == 0 && ts->t8_element_is_anisotropic ()) {
+    return (refine > 0 ? refine : -refine) / 2;
+  }
+  return 0;
+}
+
+/* Return true if an element has the same level along all axes */
+static int
+t8_forest_adapt_is_isotropic (t8_eclass_scheme_c * ts,
+                              const t8_element_t * element)
+{
+  const int           level = ts->t8_element_level (element);
+  int                 axis;
+
+  for (axis = 0; axis < t8_eclass_to_dimension[ts->eclass]; axis++) {
+    if (ts->t8_element_level_axis (element, axis) != level) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+/* Compute the new levels along the axes of an element that is refined
+ * or coarsened along some axes.
+ * \param [in] forest  The new forest currently in construction.
+ * \param [in] ts      The scheme of the element.
+ * \param [in] element The element.
+ * \param [in] refine  The return value of the adapt callback for \a element.
+ * \param [out] levels On output the new levels of the element along each axis.
+ * \return             How the element changes.
+ *                     If a level exceeds the maximum level or would drop below
+ *                     zero, the element is kept.
+ */
+static              t8_forest_adapt_aniso_t
+t8_forest_adapt_aniso_levels (t8_forest_t forest, t8_eclass_scheme_c * ts,
+                              const t8_element_t * element, int refine,
+                              int levels[3])
+{
+  const int           dim = t8_eclass_to_dimension[ts->eclass];
+  const int           axes = t8_forest_adapt_axes (ts, refine);
+  const int           level = ts->t8_element_level (element);
+  int                 axis, min_level;
+
+  T8_ASSERT (axes != 0);
+  if ((axes & ((1 << dim) - 1)) == 0) {
+    /* None of the axes is an axis of this element */
+    return T8_FOREST_ADAPT_ANISO_KEEP;
+  }
+  min_level = forest->maxlevel;
+  for (axis = 0; axis < dim; axis++) {
+    levels[axis] = ts->t8_element_level_axis (element, axis);
+    if (axes & (1 << axis)) {
+      levels[axis] += refine > 0 ? 1 : -1;
+      if (levels[axis] < 0 || levels[axis] > forest->maxlevel) {
+        return T8_FOREST_ADAPT_ANISO_KEEP;
+      }
+    }
+    min_level = SC_MIN (min_level, levels[axis]);
+  }
+  if (min_level == level) {
+    return T8_FOREST_ADAPT_ANISO_IN_PLACE;
+  }
+  return min_level > level ? T8_FOREST_ADAPT_ANISO_REFINE :
+    T8_FOREST_ADAPT_ANISO_COARSEN;
+}
+
 /* Check the lastly inserted elements of an array for recursive coarsening.
  * The last inserted element must be the last element of a family.
  * \param [in] forest  The new forest currently in construction.
@@ -57,7 +140,8 @@ t8_forest_adapt_coarsen_recursive (t8_forest_t forest, t8_locidx_t ltreeid,
   t8_locidx_t         pos;
   size_t              elements_in_array;
   int                 num_children, i, isfamily;
-  int                 child_id;
+  int                 child_id, refine;
+  int                 levels[3];
   /* el_inserted is the index of the last element in telements plus one.
    * el_coarsen is the index of the first element which could possibly
    * be coarsened. */
@@ -88,15 +172,28 @@ t8_forest_adapt_coarsen_recursive (t8_forest_t forest, t8_locidx_t ltreeid,
         break;
       }
     }
+    if (isfamily && ts->t8_element_is_anisotropic ()) {
+      /* The siblings of an anisotropic family must have the same levels
+       * along all axes. */
+      isfamily = ts->t8_element_is_family (fam);
+    }
     T8_ASSERT (!isfamily || ts->t8_element_is_family (fam));
     if (isfamily
-        && forest->set_adapt_fn (forest, forest->set_from, ltreeid,
-                                 lelement_id, ts, num_children, fam) < 0) {
+        && (refine = forest->set_adapt_fn (forest, forest->set_from, ltreeid,
+                                           lelement_id, ts, num_children,
+                                           fam)) < 0
+        && (t8_forest_adapt_axes (ts, refine) == 0
+            || t8_forest_adapt_aniso_levels (forest, ts, fam[0], refine,
+                                             levels) ==
+            T8_FOREST_ADAPT_ANISO_COARSEN)) {
       /* Coarsen the element */
       *el_inserted -= num_children - 1;
       /* remove num_children - 1 elements from the array */
       T8_ASSERT (elements_in_array == t8_element_array_get_count (telements));
       ts->t8_element_parent (fam[0], fam[0]);
+      if (t8_forest_adapt_axes (ts, refine) != 0) {
+        ts->t8_element_set_level_axes (fam[0], levels);
+      }
       elements_in_array -= num_children - 1;
       t8_element_array_resize (telements, elements_in_array);
       /* Set element to the new constructed parent. Since resizing the array
@@ -136,7 +233,9 @@ t8_forest_adapt_refine_recursive (t8_forest_t forest, t8_locidx_t ltreeid,
 {
   t8_element_t       *insert_el;
   int                 num_children;
-  int                 ci;
+  int                 ci, refine;
+  int                 levels[3];
+  t8_forest_adapt_aniso_t aniso;
 
   if (elem_list->elem_count <= 0) {
     return;
@@ -150,17 +249,37 @@ t8_forest_adapt_refine_recursive (t8_forest_t forest, t8_locidx_t ltreeid,
      */
     el_buffer[0] = (t8_element_t *) sc_list_pop (elem_list);
     num_children = ts->t8_element_num_children (el_buffer[0]);
-    if (forest->set_adapt_fn (forest, forest->set_from, ltreeid, lelement_id,
-                              ts, 1, el_buffer) > 0) {
+    refine = forest->set_adapt_fn (forest, forest->set_from, ltreeid,
+                                   lelement_id, ts, 1, el_buffer);
+    aniso = T8_FOREST_ADAPT_ANISO_KEEP;
+    if (t8_forest_adapt_axes (ts, refine) != 0) {
+      /* We only refine recursively, so we ignore coarsening along axes */
+      if (refine > 0) {
+        aniso = t8_forest_adapt_aniso_levels (forest, ts, el_buffer[0],
+                                              refine, levels);
+      }
+      if (aniso == T8_FOREST_ADAPT_ANISO_IN_PLACE) {
+        /* Change the levels of the element and check it again */
+        ts->t8_element_set_level_axes (el_buffer[0], levels);
+        (void) sc_list_prepend (elem_list, el_buffer[0]);
+        continue;
+      }
+      refine = aniso == T8_FOREST_ADAPT_ANISO_REFINE;
+    }
+    if (refine > 0 && ts->t8_element_level (el_buffer[0]) >= forest->maxlevel) {
+      /* only refine, if we do not exceed the maximum allowed level */
+      refine = 0;
+    }
+    if (refine > 0) {
       /* The element should be refined */
-      if (ts->t8_element_level (el_buffer[0]) < forest->maxlevel) {
-        /* only refine, if we do not exceed the maximum allowed level */
-        /* Create the children and add them to the list */
-        ts->t8_element_new (num_children - 1, el_buffer + 1);
-        ts->t8_element_children (el_buffer[0], num_children, el_buffer);
-        for (ci = num_children - 1; ci >= 0; ci--) {
-          (void) sc_list_prepend (elem_list, el_buffer[ci]);
+      /* Create the children and add them to the list */
+      ts->t8_element_new (num_children - 1, el_buffer + 1);
+      ts->t8_element_children (el_buffer[0], num_children, el_buffer);
+      for (ci = num_children - 1; ci >= 0; ci--) {
+        if (aniso == T8_FOREST_ADAPT_ANISO_REFINE) {
+          ts->t8_element_set_level_axes (el_buffer[ci], levels);
         }
+        (void) sc_list_prepend (elem_list, el_buffer[ci]);
       }
     }
     else {
@@ -174,7 +293,569 @@ t8_forest_adapt_refine_recursive (t8_forest_t forest, t8_locidx_t ltreeid,
   }
 }
 
-/* TODO: optimize this when we own forest_from */
+/* A run of consecutive siblings at the beginning or at the end of the
+ * local elements. If such a run does not contain all siblings of its family,
+ * the family may be split across processes. */
+typedef struct
+{
+  t8_locidx_t         ltreeid;  /**< The local tree of the run, -1 if the run is not part of a split family. */
+  t8_locidx_t         first;    /**< The index of the first sibling of the run in its tree. */
+  t8_locidx_t         count;    /**< The number of siblings in the run. */
+  int                 first_child;      /**< The child id of the first sibling. */
+  int                 level;    /**< The level of the siblings. */
+  int                 num_children;     /**< The number of siblings of the complete family. */
+  int                 coarsen;  /**< 1 if this process inserts the parent of the family,
+                                     -1 if it removes its siblings, 0 if the family is not coarsened. */
+  int                *votes;    /**< The return value of the adapt callback for each sibling. */
+} t8_forest_adapt_split_t;
+
+/* The number of t8_gloidx_t entries that describe one run in the exchange. */
+#define T8_FOREST_ADAPT_SPLIT_RUN 5
+/* The number of t8_gloidx_t entries that each process contributes to the
+ * exchange: The first run, the last run and a flag whether these two runs
+ * are the same and contain all local elements. */
+#define T8_FOREST_ADAPT_SPLIT_RECORD (2 * T8_FOREST_ADAPT_SPLIT_RUN + 1)
+
+/* Compute the run of consecutive siblings at the beginning of the first
+ * or at the end of the last local tree of forest_from.
+ * \param [in] forest_from The forest that is adapted.
+ * \param [in] last        If true, compute the run at the end of the last tree,
+ *                         otherwise at the beginning of the first tree.
+ * \param [out] run        On output the run. The votes are not computed.
+ *                         If the first element is a tree root, the count is 0.
+ */
+static void
+t8_forest_adapt_split_compute_run (t8_forest_t forest_from, int last,
+                                   t8_forest_adapt_split_t * run)
+{
+  t8_tree_t           tree;
+  t8_eclass_scheme_c *ts;
+  t8_element_t       *element;
+  t8_locidx_t         num_elements, index;
+  int                 child_id;
+
+  run->ltreeid = last ? t8_forest_get_num_local_trees (forest_from) - 1 : 0;
+  tree = t8_forest_get_tree (forest_from, run->ltreeid);
+  ts = t8_forest_get_eclass_scheme (forest_from, tree->eclass);
+  num_elements = (t8_locidx_t) t8_element_array_get_count (&tree->elements);
+  index = last ? num_elements - 1 : 0;
+  element = t8_element_array_index_locidx (&tree->elements, index);
+  run->level = ts->t8_element_level (element);
+  run->coarsen = 0;
+  run->votes = NULL;
+  if (run->level == 0) {
+    run->first = index;
+    run->count = 0;
+    run->first_child = 0;
+    run->num_children = 0;
+    return;
+  }
+  run->num_children = ts->t8_element_num_children (element);
+  child_id = ts->t8_element_child_id (element);
+  run->count = 1;
+  /* Add the neighboring elements as long as they are the next siblings */
+  while (run->count < num_elements) {
+    element =
+      t8_element_array_index_locidx (&tree->elements,
+                                     last ? index - run->count :
+                                     index + run->count);
+    if (ts->t8_element_level (element) != run->level
+        || ts->t8_element_child_id (element) !=
+        (last ? child_id - run->count : child_id + run->count)) {
+      break;
+    }
+    run->count++;
+  }
+  run->first = last ? index - run->count + 1 : index;
+  run->first_child = last ? child_id - run->count + 1 : child_id;
+}
+
+/* Pass each sibling of a run separately to the adapt callback and store
+ * the results in run->votes.
+ * Return true if all siblings voted for coarsening. */
+static int
+t8_forest_adapt_split_vote (t8_forest_t forest,
+                            t8_forest_adapt_split_t * run)
+{
+  t8_tree_t           tree;
+  t8_eclass_scheme_c *ts;
+  t8_element_t       *element;
+  t8_locidx_t         ielement;
+  int                 coarsen = 1;
+
+  tree = t8_forest_get_tree (forest->set_from, run->ltreeid);
+  ts = t8_forest_get_eclass_scheme (forest->set_from, tree->eclass);
+  run->votes = T8_ALLOC (int, run->count);
+  for (ielement = 0; ielement < run->count; ielement++) {
+    element = t8_element_array_index_locidx (&tree->elements,
+                                             run->first + ielement);
+    run->votes[ielement] =
+      forest->set_adapt_fn (forest, forest->set_from, run->ltreeid,
+                            run->first + ielement, ts, 1, &element);
+    if (run->votes[ielement] >= 0
+        || t8_forest_adapt_axes (ts, run->votes[ielement]) != 0
+        || (ts->t8_element_is_anisotropic ()
+            && !t8_forest_adapt_is_isotropic (ts, element))) {
+      /* Only isotropic siblings are coarsened isotropically across processes */
+      coarsen = 0;
+    }
+  }
+  return coarsen;
+}
+
+/* Decide whether the split family of one of our runs is coarsened.
+ * Starting at our run, we follow the siblings of the family through the
+ * runs of the neighboring processes until we reach the first and the last
+ * sibling. Since each process can evaluate this from the exchanged records,
+ * all processes that hold siblings of the family come to the same decision.
+ * \param [in] records     The exchanged records of all processes.
+ * \param [in] mpisize     The number of processes.
+ * \param [in] mpirank     This process.
+ * \param [in] last        If true, decide for our last run, otherwise for our first run.
+ * \param [in] num_children The number of siblings of the family.
+ * \return 1 if the family is coarsened and we own the parent, -1 if the family
+ *         is coarsened and another process owns the parent, 0 otherwise.
+ */
+static int
+t8_forest_adapt_split_decide (const t8_gloidx_t * records, int mpisize,
+                              int mpirank, int last, int num_children)
+{
+  const t8_gloidx_t  *run, *other;
+  t8_gloidx_t         first_child, end_child;
+  int                 rank, owner, coarsen;
+
+#define T8_SPLIT_RUN(r, l) \
+  (records + (r) * T8_FOREST_ADAPT_SPLIT_RECORD + (l) * T8_FOREST_ADAPT_SPLIT_RUN)
+#define T8_SPLIT_ALL(r) \
+  records[(r) * T8_FOREST_ADAPT_SPLIT_RECORD + 2 * T8_FOREST_ADAPT_SPLIT_RUN]
+  /* The entries of a run are its global tree id (-1 if the process is empty),
+   * level, first child id, number of siblings and whether all of them voted
+   * for coarsening. */
+  run = T8_SPLIT_RUN (mpirank, last);
+  coarsen = run[4] != 0;
+  /* Search backwards for the first sibling. If a run does not start with the
+   * first sibling it must contain all elements of its process, since otherwise
+   * the previous sibling is no element of the forest. */
+  first_child = run[2];
+  rank = mpirank;
+  if (first_child > 0 && last && !T8_SPLIT_ALL (rank)) {
+    return 0;
+  }
+  while (first_child > 0) {
+    /* Find the previous nonempty process */
+    for (rank--; rank >= 0 && T8_SPLIT_RUN (rank, 1)[0] < 0; rank--) {
+    }
+    if (rank < 0) {
+      return 0;
+    }
+    other = T8_SPLIT_RUN (rank, 1);
+    if (other[0] != run[0] || other[1] != run[1]
+        || other[2] + other[3] != first_child) {
+      return 0;
+    }
+    coarsen = coarsen && other[4] != 0;
+    first_child = other[2];
+    if (first_child > 0 && !T8_SPLIT_ALL (rank)) {
+      return 0;
+    }
+  }
+  owner = rank;
+  /* Search forwards for the last sibling */
+  end_child = run[2] + run[3];
+  rank = mpirank;
+  if (end_child < num_children && !last && !T8_SPLIT_ALL (rank)) {
+    return 0;
+  }
+  while (end_child < num_children) {
+    /* Find the next nonempty process */
+    for (rank++; rank < mpisize && T8_SPLIT_RUN (rank, 0)[0] < 0; rank++) {
+    }
+    if (rank >= mpisize) {
+      return 0;
+    }
+    other = T8_SPLIT_RUN (rank, 0);
+    if (other[0] != run[0] || other[1] != run[1] || other[2] != end_child) {
+      return 0;
+    }
+    coarsen = coarsen && other[4] != 0;
+    end_child += other[3];
+    if (end_child < num_children && !T8_SPLIT_ALL (rank)) {
+      return 0;
+    }
+  }
+#undef T8_SPLIT_RUN
+#undef T8_SPLIT_ALL
+  if (!coarsen) {
+    return 0;
+  }
+  return owner == mpirank ? 1 : -1;
+}
+
+/* Find the families at the beginning and at the end of the local elements
+ * that are split across processes and decide together with the other
+ * processes whether they are coarsened.
+ * \param [in] forest     The forest currently in construction.
+ * \param [out] split     On output split[0] describes the run at the beginning
+ *                        and split[1] the run at the end of the local elements.
+ *                        A run that is not part of a split family has ltreeid -1.
+ *                        If both runs are the same, split[1] has ltreeid -1.
+ *                        The votes of the runs must be freed with T8_FREE.
+ */
+static void
+t8_forest_adapt_split_families (t8_forest_t forest,
+                                t8_forest_adapt_split_t split[2])
+{
+  t8_forest_t         forest_from = forest->set_from;
+  t8_gloidx_t         record[T8_FOREST_ADAPT_SPLIT_RECORD];
+  t8_gloidx_t        *records;
+  t8_locidx_t         num_trees;
+  int                 is_split[2];
+  int                 all, ilast, mpiret;
+
+  num_trees = t8_forest_get_num_local_trees (forest_from);
+  for (ilast = 0; ilast < 2; ilast++) {
+    split[ilast].ltreeid = -1;
+    split[ilast].votes = NULL;
+    is_split[ilast] = 0;
+    record[ilast * T8_FOREST_ADAPT_SPLIT_RUN] = -1;
+  }
+  all = 0;
+  if (forest_from->local_num_elements > 0) {
+    for (ilast = 0; ilast < 2; ilast++) {
+      t8_forest_adapt_split_t *run = split + ilast;
+      t8_gloidx_t        *run_record =
+        record + ilast * T8_FOREST_ADAPT_SPLIT_RUN;
+
+      t8_forest_adapt_split_compute_run (forest_from, ilast, run);
+      /* The first run can only be split if it does not start with the first
+       * sibling and the last run only if it does not end with the last sibling. */
+      is_split[ilast] = run->count > 0
+        && (ilast ? run->first_child + run->count < run->num_children
+            : run->first_child > 0);
+      run_record[0] = t8_forest_global_tree_id (forest_from, run->ltreeid);
+      run_record[1] = run->level;
+      run_record[2] = run->first_child;
+      run_record[3] = run->count;
+      run_record[4] = 0;
+    }
+    all = num_trees == 1
+      && split[0].count == t8_forest_get_tree_num_elements (forest_from, 0);
+    if (all) {
+      /* The first and the last run are the same */
+      is_split[0] = is_split[0] || is_split[1];
+      is_split[1] = 0;
+    }
+    for (ilast = 0; ilast < 2; ilast++) {
+      if (is_split[ilast]) {
+        record[ilast * T8_FOREST_ADAPT_SPLIT_RUN + 4] =
+          t8_forest_adapt_split_vote (forest, split + ilast);
+      }
+    }
+    if (all) {
+      record[T8_FOREST_ADAPT_SPLIT_RUN + 4] = record[4];
+    }
+  }
+  record[2 * T8_FOREST_ADAPT_SPLIT_RUN] = all;
+
+  /* Exchange the runs and votes of all processes */
+  records = T8_ALLOC (t8_gloidx_t,
+                      T8_FOREST_ADAPT_SPLIT_RECORD * forest->mpisize);
+  mpiret = sc_MPI_Allgather (record, T8_FOREST_ADAPT_SPLIT_RECORD,
+                             T8_MPI_GLOIDX, records,
+                             T8_FOREST_ADAPT_SPLIT_RECORD, T8_MPI_GLOIDX,
+                             forest->mpicomm);
+  SC_CHECK_MPI (mpiret);
+
+  for (ilast = 0; ilast < 2; ilast++) {
+    if (is_split[ilast]) {
+      split[ilast].coarsen =
+        t8_forest_adapt_split_decide (records, forest->mpisize,
+                                      forest->mpirank, ilast,
+                                      split[ilast].num_children);
+    }
+    else {
+      split[ilast].ltreeid = -1;
+    }
+  }
+  T8_FREE (records);
+}
+
+/* Return the linear id at the maximum level of the last descendant of an
+ * element. desc is used as buffer. */
+static              t8_linearidx_t
+t8_forest_adapt_last_desc_id (t8_eclass_scheme_c * ts,
+                              const t8_element_t * element,
+                              t8_element_t * desc)
+{
+  const int           maxlevel = ts->t8_element_maxlevel ();
+
+  ts->t8_element_last_descendant (element, desc, maxlevel);
+  return ts->t8_element_get_linear_id (desc, maxlevel);
+}
+
+/* Check whether an ancestor of the element el_considered can replace all
+ * its leaves. This is the case if el_considered is its first leaf, all its
+ * leaves are local and all of them have a target level not higher than
+ * its level.
+ * Return the number of leaves of the ancestor if so and 0 else. */
+static t8_locidx_t
+t8_forest_adapt_target_check (t8_eclass_scheme_c * ts,
+                              t8_element_array_t * telements_from,
+                              t8_locidx_t el_considered,
+                              const int *targets,
+                              const t8_element_t * ancestor,
+                              t8_element_t * desc)
+{
+  const int           level = ts->t8_element_level (ancestor);
+  const int           maxlevel = ts->t8_element_maxlevel ();
+  const t8_locidx_t   num_el_from =
+    (t8_locidx_t) t8_element_array_get_count (telements_from);
+  const t8_element_t *leaf = NULL;
+  t8_linearidx_t      last_id;
+  t8_locidx_t         el;
+
+  last_id = t8_forest_adapt_last_desc_id (ts, ancestor, desc);
+  for (el = el_considered; el < num_el_from; el++) {
+    leaf = t8_element_array_index_locidx (telements_from, el);
+    if (ts->t8_element_get_linear_id (leaf, maxlevel) > last_id) {
+      /* The leaf is not a descendant of the ancestor */
+      break;
+    }
+    if (targets[el] > level) {
+      return 0;
+    }
+  }
+  leaf = t8_element_array_index_locidx (telements_from, el - 1);
+  if (t8_forest_adapt_last_desc_id (ts, leaf, desc) != last_id) {
+    /* Some leaves of the ancestor are not local */
+    return 0;
+  }
+  return el - el_considered;
+}
+
+/* Adapt the elements of a tree to their target levels in one pass.
+ * Return the number of inserted elements. */
+static t8_locidx_t
+t8_forest_adapt_target_tree (t8_forest_t forest, t8_locidx_t ltree_id,
+                             t8_eclass_scheme_c * ts,
+                             t8_element_array_t * telements_from,
+                             t8_element_array_t * telements)
+{
+  const t8_locidx_t   num_el_from =
+    (t8_locidx_t) t8_element_array_get_count (telements_from);
+  const t8_locidx_t   el_offset =
+    t8_forest_get_tree_element_offset (forest->set_from, ltree_id);
+  const t8_element_t *element;
+  t8_element_t       *ancestor, *parent, *desc, *swap;
+  t8_locidx_t         el_considered, el_inserted, num_leaves, num_coarsen;
+  t8_linearidx_t      first_id;
+  t8_gloidx_t         num_desc, idesc;
+  int                *targets, level, target;
+
+  /* Compute the target levels of all elements */
+  targets = T8_ALLOC (int, num_el_from);
+  for (el_considered = 0; el_considered < num_el_from; el_considered++) {
+    element = t8_element_array_index_locidx (telements_from, el_considered);
+    if (forest->set_adapt_target_fn != NULL) {
+      target = forest->set_adapt_target_fn (forest, forest->set_from,
+                                            ltree_id, el_considered, ts,
+                                            element);
+    }
+    else {
+      target = forest->set_adapt_target_levels[el_offset + el_considered];
+    }
+    targets[el_considered] = SC_MAX (0, SC_MIN (target, forest->maxlevel));
+  }
+
+  ts->t8_element_new (1, &ancestor);
+  ts->t8_element_new (1, &parent);
+  ts->t8_element_new (1, &desc);
+  el_considered = 0;
+  el_inserted = 0;
+  while (el_considered < num_el_from) {
+    element = t8_element_array_index_locidx (telements_from, el_considered);
+    level = ts->t8_element_level (element);
+    target = targets[el_considered];
+    if (target > level) {
+      /* Insert all descendants of the target level. They form a range of
+       * linear ids starting at the id of the first descendant. */
+      num_desc = ts->t8_element_count_leafs (element, target);
+      first_id = ts->t8_element_get_linear_id (element, target);
+      (void) t8_element_array_push_count (telements, (size_t) num_desc);
+      for (idesc = 0; idesc < num_desc; idesc++) {
+        ts->t8_element_set_linear_id (t8_element_array_index_locidx
+                                      (telements,
+                                       el_inserted + (t8_locidx_t) idesc),
+                                      target, first_id + idesc);
+      }
+      el_inserted += (t8_locidx_t) num_desc;
+      el_considered++;
+      continue;
+    }
+    /* Walk up the ancestors of which the element is the first leaf as long
+     * as they can replace their leaves. */
+    num_coarsen = 1;
+    ts->t8_element_copy (element, ancestor);
+    while (ts->t8_element_level (ancestor) > target
+           && ts->t8_element_child_id (ancestor) == 0) {
+      ts->t8_element_parent (ancestor, parent);
+      num_leaves = t8_forest_adapt_target_check (ts, telements_from,
+                                                 el_considered, targets,
+                                                 parent, desc);
+      if (num_leaves == 0) {
+        break;
+      }
+      num_coarsen = num_leaves;
+      swap = ancestor;
+      ancestor = parent;
+      parent = swap;
+    }
+    ts->t8_element_copy (ancestor, t8_element_array_push (telements));
+    el_inserted++;
+    el_considered += num_coarsen;
+  }
+  ts->t8_element_destroy (1, &ancestor);
+  ts->t8_element_destroy (1, &parent);
+  ts->t8_element_destroy (1, &desc);
+  T8_FREE (targets);
+  return el_inserted;
+}
+
+/* Mark a tree as changed by adaptation. As long as no element of a tree
+ * changed, the new elements are the first el_inserted elements of the old
+ * tree and we do not store them. When the first element changes, we copy
+ * these elements to the new element array. */
+static void
+t8_forest_adapt_tree_changed (t8_element_array_t * telements,
+                              t8_element_array_t * telements_from,
+                              t8_locidx_t el_inserted, int *tree_changed)
+{
+  if (*tree_changed) {
+    return;
+  }
+  T8_ASSERT (t8_element_array_get_count (telements) == 0);
+  T8_ASSERT ((size_t) el_inserted <=
+             t8_element_array_get_count (telements_from));
+  if (el_inserted > 0) {
+    (void) t8_element_array_push_count (telements, el_inserted);
+    memcpy (t8_element_array_get_data (telements),
+            t8_element_array_get_data (telements_from),
+            el_inserted * t8_element_array_get_size (telements));
+  }
+  *tree_changed = 1;
+}
+
+/* Return the split family run that contains the element el_considered of
+ * the local tree ltree_id, or NULL if the element is not part of one. */
+static t8_forest_adapt_split_t *
+t8_forest_adapt_split_find (t8_forest_adapt_split_t split[2],
+                            t8_locidx_t ltree_id, t8_locidx_t el_considered)
+{
+  t8_forest_adapt_split_t *run = NULL;
+  int                 irun;
+
+  for (irun = 0; irun < 2; irun++) {
+    if (split[irun].ltreeid == ltree_id
+        && split[irun].first <= el_considered
+        && el_considered < split[irun].first + split[irun].count) {
+      run = split + irun;
+    }
+  }
+  return run;
+}
+
+/* Coarsen a family that is split across processes. All its local siblings
+ * are removed and the owner of the family inserts the parent.
+ * Return the number of old elements that were considered. */
+static t8_locidx_t
+t8_forest_adapt_split_coarsen (t8_forest_t forest, t8_locidx_t ltree_id,
+                               t8_locidx_t el_considered,
+                               t8_eclass_scheme_c * ts,
+                               const t8_forest_adapt_split_t * run,
+                               t8_element_array_t * telements,
+                               t8_element_array_t * telements_from,
+                               t8_locidx_t el_coarsen,
+                               t8_locidx_t * el_inserted,
+                               t8_element_t ** el_buffer, int *tree_changed)
+{
+  const size_t        num_children = (size_t) run->num_children;
+  int                 child_id;
+
+  T8_ASSERT (run->coarsen != 0);
+  T8_ASSERT (el_considered == run->first);
+  t8_forest_adapt_tree_changed (telements, telements_from, *el_inserted,
+                                tree_changed);
+  if (run->coarsen > 0) {
+    el_buffer[0] = t8_element_array_push (telements);
+    ts->t8_element_parent (t8_element_array_index_locidx
+                           (telements_from, el_considered), el_buffer[0]);
+    (*el_inserted)++;
+    if (forest->set_adapt_recursive) {
+      child_id = ts->t8_element_child_id (el_buffer[0]);
+      if (child_id > 0 && (size_t) child_id == num_children - 1) {
+        t8_forest_adapt_coarsen_recursive (forest, ltree_id, el_considered,
+                                           ts, telements, el_coarsen,
+                                           el_inserted, el_buffer);
+      }
+    }
+  }
+  return run->count;
+}
+
+/* Remove the first local tree if all of its elements belonged to a split
+ * family that is coarsened and owned by another process. */
+static void
+t8_forest_adapt_split_remove_tree (t8_forest_t forest,
+                                   const t8_forest_adapt_split_t split[2])
+{
+  const t8_locidx_t   num_trees = t8_forest_get_num_local_trees (forest);
+  t8_tree_t           tree;
+
+  if (num_trees == 0
+      || t8_forest_get_tree_element_count (t8_forest_get_tree (forest, 0))
+      > 0) {
+    return;
+  }
+  T8_ASSERT (split[0].coarsen < 0);
+  tree = t8_forest_get_tree (forest, 0);
+  t8_element_array_reset (&tree->elements);
+  memmove (forest->trees->array,
+           forest->trees->array + forest->trees->elem_size,
+           (num_trees - 1) * forest->trees->elem_size);
+  sc_array_resize (forest->trees, num_trees - 1);
+  forest->first_local_tree++;
+  if (num_trees == 1) {
+    /* This process has no more elements */
+    forest->first_local_tree = forest->last_local_tree + 1;
+  }
+}
+
+/* Adapt a tree to the target levels of its elements and mark it as changed.
+ * Return the number of inserted elements and set changed to true if any
+ * element of the tree changed. */
+static t8_locidx_t
+t8_forest_adapt_target (t8_forest_t forest, t8_locidx_t ltree_id,
+                        t8_eclass_scheme_c * ts,
+                        t8_element_array_t * telements_from,
+                        t8_element_array_t * telements, int *tree_changed,
+                        int *changed)
+{
+  const t8_locidx_t   num_el_from =
+    (t8_locidx_t) t8_element_array_get_count (telements_from);
+  t8_locidx_t         el_inserted;
+
+  SC_CHECK_ABORT (!ts->t8_element_is_anisotropic (),
+                  "Target level adaptation needs an isotropic scheme");
+  el_inserted = t8_forest_adapt_target_tree (forest, ltree_id, ts,
+                                             telements_from, telements);
+  *tree_changed = 1;
+  *changed = *changed || el_inserted != num_el_from
+    || memcmp (t8_element_array_get_data (telements),
+               t8_element_array_get_data (telements_from),
+               num_el_from * t8_element_array_get_size (telements));
+  return el_inserted;
+}
+
 void
 t8_forest_adapt (t8_forest_t forest)
 {
@@ -187,6 +868,8 @@ t8_forest_adapt (t8_forest_t forest)
   t8_locidx_t         el_coarsen;
   t8_locidx_t         num_el_from;
   t8_locidx_t         el_offset;
+  t8_gloidx_t         local_counts[2], global_counts[2];
+  t8_element_array_t  swap;
   size_t              num_children, zz;
   t8_tree_t           tree, tree_from;
   t8_eclass_scheme_c *tscheme;
@@ -194,6 +877,11 @@ t8_forest_adapt (t8_forest_t forest)
   int                 refine;
   int                 ci;
   int                 num_elements;
+  int                 refine_axes;
+  int                 levels[3];
+  int                 changed, *tree_changed, steal, mpiret;
+  t8_forest_adapt_aniso_t aniso;
+  t8_forest_adapt_split_t split[2], *run;
 #ifdef T8_ENABLE_DEBUG
   int                 is_family;
 #endif
@@ -201,6 +889,8 @@ t8_forest_adapt (t8_forest_t forest)
   T8_ASSERT (forest != NULL);
   T8_ASSERT (forest->set_from != NULL);
   T8_ASSERT (forest->set_adapt_recursive != -1);
+  T8_ASSERT (forest->set_adapt_fn != NULL
+             || !forest->set_adapt_split_families);
 
   /* if profiling is enabled, measure runtime */
   if (forest->profile != NULL) {
@@ -224,9 +914,19 @@ t8_forest_adapt (t8_forest_t forest)
   if (forest->set_adapt_recursive) {
     refine_list = sc_list_new (NULL);
   }
+  if (forest->set_adapt_split_families && forest->mpisize > 1) {
+    /* Decide for the families that are split across processes */
+    t8_forest_adapt_split_families (forest, split);
+  }
+  else {
+    split[0].ltreeid = split[1].ltreeid = -1;
+    split[0].votes = split[1].votes = NULL;
+  }
   forest->local_num_elements = 0;
   el_offset = 0;
+  changed = 0;
   num_trees = t8_forest_get_num_local_trees (forest);
+  tree_changed = T8_ALLOC_ZERO (int, num_trees);
   /* Iterate over the trees and build the new element arrays for each one. */
   for (ltree_id = 0; ltree_id < num_trees; ltree_id++) {
     /* Get the new and old tree and the new and old element arrays */
@@ -255,8 +955,28 @@ t8_forest_adapt (t8_forest_t forest)
     elements = T8_ALLOC (t8_element_t *, num_children);
     /* Buffer for a family of old elements */
     elements_from = T8_ALLOC (t8_element_t *, num_children);
+    if (forest->set_adapt_fn == NULL) {
+      /* Adapt all elements of this tree to their target levels */
+      el_inserted = t8_forest_adapt_target (forest, ltree_id, tscheme,
+                                            telements_from, telements,
+                                            tree_changed + ltree_id,
+                                            &changed);
+      el_considered = num_el_from;
+    }
     /* We now iterate over all elements in this tree and check them for refinement/coarsening. */
     while (el_considered < num_el_from) {
+      /* Check whether the current element belongs to a split family */
+      run = t8_forest_adapt_split_find (split, ltree_id, el_considered);
+      if (run != NULL && run->coarsen != 0) {
+        /* The split family is coarsened */
+        el_considered +=
+          t8_forest_adapt_split_coarsen (forest, ltree_id, el_considered,
+                                         tscheme, run, telements,
+                                         telements_from, el_coarsen,
+                                         &el_inserted, elements,
+                                         tree_changed + ltree_id);
+        continue;
+      }
 #ifdef T8_ENABLE_DEBUG
       /* Will get set to 0 later if this is not a family */
       is_family = 1;
@@ -276,6 +996,11 @@ t8_forest_adapt (t8_forest_t forest)
           break;
         }
       }
+      if (zz == num_children && tscheme->t8_element_is_anisotropic ()
+          && !tscheme->t8_element_is_family (elements_from)) {
+        /* The siblings have different levels along some axes */
+        zz = 0;
+      }
       if (zz != num_children) {
         /* We are certain that the elements do not form a family.
          * So we will only pass the first element to the adapt callback. */
@@ -290,17 +1015,65 @@ t8_forest_adapt (t8_forest_t forest)
        *                    = 0 if the element should remain as is
        *                    < 0 if we passed a family and it should get coarsened.
        */
-      refine =
-        forest->set_adapt_fn (forest, forest->set_from, ltree_id,
-                              el_considered, tscheme, num_elements,
-                              elements_from);
+      if (run != NULL) {
+        /* The callback already voted for this sibling of a split family */
+        refine = run->votes[el_considered - run->first];
+      }
+      else {
+        refine =
+          forest->set_adapt_fn (forest, forest->set_from, ltree_id,
+                                el_considered, tscheme, num_elements,
+                                elements_from);
+      }
+      aniso = T8_FOREST_ADAPT_ANISO_KEEP;
+      refine_axes = 0;
+      if (t8_forest_adapt_axes (tscheme, refine) != 0) {
+        /* The element is refined or coarsened along some axes only.
+         * We translate this into an isotropic refinement or coarsening
+         * or a change of the element's levels along the axes. */
+        refine_axes = refine > 0;
+        aniso = t8_forest_adapt_aniso_levels (forest, tscheme,
+                                              elements_from[0], refine,
+                                              levels);
+        if (aniso == T8_FOREST_ADAPT_ANISO_COARSEN && num_elements == 1) {
+          aniso = T8_FOREST_ADAPT_ANISO_KEEP;
+        }
+        refine = aniso == T8_FOREST_ADAPT_ANISO_REFINE ? 1 :
+          aniso == T8_FOREST_ADAPT_ANISO_COARSEN ? -1 : 0;
+      }
+      if (forest->set_adapt_split_families && num_elements == 1
+          && refine < 0) {
+        /* A vote for coarsening of an element whose family is not
+         * coarsened. We keep the element. */
+        refine = 0;
+      }
       T8_ASSERT (is_family || refine >= 0);
       if (refine > 0 && tscheme->t8_element_level (elements_from[0]) >=
           forest->maxlevel) {
         /* Only refine an element if it does not exceed the maximum level */
         refine = 0;
       }
-      if (refine > 0) {
+      if (refine != 0 || aniso == T8_FOREST_ADAPT_ANISO_IN_PLACE) {
+        /* The element changes */
+        t8_forest_adapt_tree_changed (telements, telements_from, el_inserted,
+                                      tree_changed + ltree_id);
+      }
+      if (aniso == T8_FOREST_ADAPT_ANISO_IN_PLACE && refine_axes
+          && forest->set_adapt_recursive) {
+        /* The levels of the element along some axes increase and we check
+         * the changed element recursively for further refinement. */
+        tscheme->t8_element_new (1, elements);
+        tscheme->t8_element_copy (elements_from[0], elements[0]);
+        tscheme->t8_element_set_level_axes (elements[0], levels);
+        (void) sc_list_prepend (refine_list, elements[0]);
+        t8_forest_adapt_refine_recursive (forest, ltree_id, el_considered,
+                                          tscheme, refine_list, telements,
+                                          &el_inserted, elements);
+        /* The elements that emerge from a refinement are never coarsened */
+        el_coarsen = el_inserted;
+        el_considered++;
+      }
+      else if (refine > 0) {
         /* The first element is to be refined */
         if (forest->set_adapt_recursive) {
           /* Create the children of this element */
@@ -308,6 +1081,9 @@ t8_forest_adapt (t8_forest_t forest)
           tscheme->t8_element_children (elements_from[0], num_children,
                                         elements);
           for (ci = num_children - 1; ci >= 0; ci--) {
+            if (aniso == T8_FOREST_ADAPT_ANISO_REFINE) {
+              tscheme->t8_element_set_level_axes (elements[ci], levels);
+            }
             /* Prepend the children to the refine_list.
              * These should now be the only elements in the list.
              */
@@ -332,6 +1108,11 @@ t8_forest_adapt (t8_forest_t forest)
           }
           tscheme->t8_element_children (elements_from[0], num_children,
                                         elements);
+          if (aniso == T8_FOREST_ADAPT_ANISO_REFINE) {
+            for (zz = 0; zz < num_children; zz++) {
+              tscheme->t8_element_set_level_axes (elements[zz], levels);
+            }
+          }
           el_inserted += num_children;
         }
         el_considered++;
@@ -343,6 +1124,9 @@ t8_forest_adapt (t8_forest_t forest)
         /* Compute the parent of the current family.
          * This parent is now inserted in telements. */
         tscheme->t8_element_parent (elements_from[0], elements[0]);
+        if (aniso == T8_FOREST_ADAPT_ANISO_COARSEN) {
+          tscheme->t8_element_set_level_axes (elements[0], levels);
+        }
         el_inserted++;
         if (forest->set_adapt_recursive) {
           /* Adaptation is recursive.
@@ -365,8 +1149,20 @@ t8_forest_adapt (t8_forest_t forest)
          * one to be refined.
          * We copy the element to the new element array. */
         T8_ASSERT (refine == 0);
+        if (!tree_changed[ltree_id]) {
+          /* No element of this tree changed so far. The family that ends
+           * with this element was already passed to the callback, hence we
+           * do not check it for recursive coarsening. */
+          el_inserted++;
+          el_considered++;
+          continue;
+        }
         elements[0] = t8_element_array_push (telements);
         tscheme->t8_element_copy (elements_from[0], elements[0]);
+        if (aniso == T8_FOREST_ADAPT_ANISO_IN_PLACE) {
+          /* Only the levels of the element along some axes change */
+          tscheme->t8_element_set_level_axes (elements[0], levels);
+        }
         el_inserted++;
         const int           child_id =
           tscheme->t8_element_child_id (elements[0]);
@@ -389,8 +1185,14 @@ t8_forest_adapt (t8_forest_t forest)
     el_offset += el_inserted;
     /* Add to the new number of local elements. */
     forest->local_num_elements += el_inserted;
-    /* Possibly shrink the telements array to the correct size */
-    t8_element_array_resize (telements, el_inserted);
+    if (tree_changed[ltree_id]) {
+      /* Possibly shrink the telements array to the correct size */
+      t8_element_array_resize (telements, el_inserted);
+      changed = changed || forest->set_adapt_fn != NULL;
+    }
+    else {
+      T8_ASSERT (el_inserted == num_el_from);
+    }
 
     /* clean up */
     T8_FREE (elements);
@@ -400,10 +1202,42 @@ t8_forest_adapt (t8_forest_t forest)
     /* clean up */
     sc_list_destroy (refine_list);
   }
+  T8_FREE (split[0].votes);
+  T8_FREE (split[1].votes);
+  /* The trees in which no element changed take over the elements of the
+   * old trees. If we hold the only reference of forest_from, it is
+   * destroyed after commit and we steal its element arrays. */
+  steal = t8_refcount_is_last (&forest_from->rc);
+  for (ltree_id = 0; ltree_id < num_trees; ltree_id++) {
+    if (tree_changed[ltree_id]) {
+      continue;
+    }
+    telements = &t8_forest_get_tree (forest, ltree_id)->elements;
+    telements_from = &t8_forest_get_tree (forest_from, ltree_id)->elements;
+    if (steal) {
+      swap = *telements;
+      *telements = *telements_from;
+      *telements_from = swap;
+    }
+    else {
+      t8_element_array_copy (telements, telements_from);
+    }
+  }
+  T8_FREE (tree_changed);
+  /* All elements of the first tree may have belonged to a split family
+   * that is owned by another process. */
+  t8_forest_adapt_split_remove_tree (forest, split);
 
   /* We now adapted all local trees */
-  /* Compute the new global number of elements */
-  t8_forest_comm_global_num_elements (forest);
+  /* Compute the new global number of elements and whether any element
+   * changed on any process in one reduction */
+  local_counts[0] = forest->local_num_elements;
+  local_counts[1] = changed;
+  mpiret = sc_MPI_Allreduce (local_counts, global_counts, 2, T8_MPI_GLOIDX,
+                             sc_MPI_SUM, forest->mpicomm);
+  SC_CHECK_MPI (mpiret);
+  forest->global_num_elements = global_counts[0];
+  forest->is_unchanged = global_counts[1] == 0;
   t8_global_productionf ("Done t8_forest_adapt with %lld total elements\n",
                          (long long) forest->global_num_elements);
 
@@ -0,0 +1,231 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#include <t8_forest_adjacency.h>
+#include <t8_forest/t8_forest_types.h>
+#include <t8_forest/t8_forest_partition.h>
+#include <t8_forest/t8_forest_ghost.h>
+#include <t8_data/t8_containers.h>
+#include <t8_element_cxx.hxx>
+
+/* We want to export the whole implementation to be callable from "C" */
+T8_EXTERN_C_BEGIN ();
+
+/* An entry of a row of the graph before it is sorted */
+typedef struct
+{
+  t8_gloidx_t         column;   /* The global id of the neighbor */
+  double              weight;   /* The area of the shared face */
+} t8_forest_csr_entry_t;
+
+static int
+t8_forest_csr_entry_compare (const void *entry_a, const void *entry_b)
+{
+  const t8_forest_csr_entry_t *A = (const t8_forest_csr_entry_t *) entry_a;
+  const t8_forest_csr_entry_t *B = (const t8_forest_csr_entry_t *) entry_b;
+
+  return A->column < B->column ? -1 : A->column != B->column;
+}
+
+/* Compute the global ids of all ghost elements in the order of their
+ * element indices.
+ * The returned array has num_ghosts entries and must be freed with T8_FREE. */
+static t8_gloidx_t *
+t8_forest_csr_ghost_ids (t8_forest_t forest)
+{
+  t8_gloidx_t        *ghost_ids;
+  t8_locidx_t         ighost_tree, ighost, num_ghosts_in_tree, index;
+
+  ghost_ids = T8_ALLOC (t8_gloidx_t, t8_forest_get_num_ghosts (forest));
+  index = 0;
+  for (ighost_tree = 0; ighost_tree < t8_forest_get_num_ghost_trees (forest);
+       ighost_tree++) {
+    num_ghosts_in_tree =
+      t8_forest_ghost_tree_num_elements (forest, ighost_tree);
+    for (ighost = 0; ighost < num_ghosts_in_tree; ighost++) {
+      ghost_ids[index++] =
+        t8_forest_ghost_get_global_element_id (forest, ighost_tree, ighost);
+    }
+  }
+  T8_ASSERT (index == t8_forest_get_num_ghosts (forest));
+  return ghost_ids;
+}
+
+void
+t8_forest_adjacency_csr (t8_forest_t forest, int compute_weights,
+                         t8_forest_csr_t * csr)
+{
+  t8_locidx_t         itree, ielement, num_elements_in_tree, num_local;
+  t8_locidx_t         irow, ientry, num_entries, row_start;
+  t8_locidx_t        *neighbor_indices;
+  t8_gloidx_t         first_element_id, element_id, neighbor_id;
+  t8_gloidx_t        *ghost_ids;
+  t8_element_t       *element, **neighbors;
+  t8_eclass_scheme_c *ts, *neigh_scheme;
+  t8_forest_csr_entry_t *entry, *row_entries;
+  sc_array_t          entries;
+  double             *tree_vertices, face_area;
+  int                 iface, num_faces, ineigh, num_neighbors;
+  int                *dual_faces;
+  int                 create_offsets = 0;
+
+  T8_ASSERT (t8_forest_is_committed (forest));
+  T8_ASSERT (csr != NULL);
+  /* Processes without local elements do not create a ghost layer */
+  SC_CHECK_ABORT (forest->mpisize == 1 || forest->ghosts != NULL
+                  || t8_forest_get_local_num_elements (forest) == 0,
+                  "The adjacency graph of a partitioned forest needs "
+                  "a ghost layer.\n");
+
+  if (forest->element_offsets == NULL) {
+    /* create element offset array if not done already */
+    create_offsets = 1;
+    t8_forest_partition_create_offsets (forest);
+  }
+  num_local = t8_forest_get_local_num_elements (forest);
+  first_element_id = t8_forest_get_first_local_element_id (forest);
+  csr->num_rows = num_local;
+  csr->num_procs = forest->mpisize;
+  csr->row_distribution = T8_ALLOC (t8_gloidx_t, forest->mpisize + 1);
+  memcpy (csr->row_distribution,
+          t8_shmem_array_get_gloidx_array (forest->element_offsets),
+          (forest->mpisize + 1) * sizeof (t8_gloidx_t));
+  csr->row_offsets = T8_ALLOC (t8_locidx_t, num_local + 1);
+  ghost_ids = t8_forest_csr_ghost_ids (forest);
+
+  /* Collect the neighbors of each element. Since a neighbor may be found
+   * across more than one face, we sort the entries of each row and merge
+   * duplicates afterwards. */
+  sc_array_init (&entries, sizeof (t8_forest_csr_entry_t));
+  irow = 0;
+  for (itree = 0; itree < t8_forest_get_num_local_trees (forest); itree++) {
+    ts = t8_forest_get_eclass_scheme (forest,
+                                      t8_forest_get_tree_class (forest,
+                                                                itree));
+    tree_vertices = t8_forest_get_tree_vertices (forest, itree);
+    num_elements_in_tree = t8_forest_get_tree_num_elements (forest, itree);
+    for (ielement = 0; ielement < num_elements_in_tree; ielement++, irow++) {
+      element = t8_forest_get_element_in_tree (forest, itree, ielement);
+      element_id = first_element_id + irow;
+      row_start = (t8_locidx_t) entries.elem_count;
+      csr->row_offsets[irow] = row_start;
+      num_faces = ts->t8_element_num_faces (element);
+      for (iface = 0; iface < num_faces; iface++) {
+        t8_forest_leaf_face_neighbors (forest, itree, element, &neighbors,
+                                       iface, &dual_faces, &num_neighbors,
+                                       &neighbor_indices, &neigh_scheme, 1);
+        if (num_neighbors == 0) {
+          /* This is a boundary face */
+          continue;
+        }
+        face_area = 0;
+        if (compute_weights) {
+          /* If there is more than one neighbor, each of them shares an
+           * equal part of the face. */
+          face_area = t8_forest_element_face_area (forest, itree, element,
+                                                   iface, tree_vertices)
+            / num_neighbors;
+        }
+        for (ineigh = 0; ineigh < num_neighbors; ineigh++) {
+          if (neighbor_indices[ineigh] < num_local) {
+            neighbor_id = first_element_id + neighbor_indices[ineigh];
+          }
+          else {
+            neighbor_id = ghost_ids[neighbor_indices[ineigh] - num_local];
+          }
+          if (neighbor_id == element_id) {
+            /* An element can be its own neighbor for periodic trees */
+            continue;
+          }
+          entry = (t8_forest_csr_entry_t *) sc_array_push (&entries);
+          entry->column = neighbor_id;
+          entry->weight = face_area;
+        }
+        neigh_scheme->t8_element_destroy (num_neighbors, neighbors);
+        T8_FREE (neighbors);
+        T8_FREE (dual_faces);
+        T8_FREE (neighbor_indices);
+      }
+      /* Sort the entries of this row and merge duplicate neighbors */
+      num_entries = (t8_locidx_t) entries.elem_count - row_start;
+      if (num_entries > 1) {
+        row_entries =
+          (t8_forest_csr_entry_t *) t8_sc_array_index_locidx (&entries,
+                                                              row_start);
+        qsort (row_entries, num_entries, sizeof (t8_forest_csr_entry_t),
+               t8_forest_csr_entry_compare);
+        for (ientry = 1, num_neighbors = 1; ientry < num_entries; ientry++) {
+          if (row_entries[ientry].column ==
+              row_entries[num_neighbors - 1].column) {
+            row_entries[num_neighbors - 1].weight +=
+              row_entries[ientry].weight;
+          }
+          else {
+            row_entries[num_neighbors++] = row_entries[ientry];
+          }
+        }
+        sc_array_resize (&entries, row_start + num_neighbors);
+      }
+    }
+  }
+  T8_ASSERT (irow == num_local);
+  num_entries = (t8_locidx_t) entries.elem_count;
+  csr->row_offsets[num_local] = num_entries;
+
+  /* Copy the entries to the output arrays */
+  csr->columns = T8_ALLOC (t8_gloidx_t, num_entries);
+  csr->weights = compute_weights ? T8_ALLOC (double, num_entries) : NULL;
+  for (ientry = 0; ientry < num_entries; ientry++) {
+    entry =
+      (t8_forest_csr_entry_t *) t8_sc_array_index_locidx (&entries, ientry);
+    csr->columns[ientry] = entry->column;
+    if (compute_weights) {
+      csr->weights[ientry] = entry->weight;
+    }
+  }
+
+  /* clean-up */
+  sc_array_reset (&entries);
+  T8_FREE (ghost_ids);
+  if (create_offsets) {
+    /* Free the offset memory, if created */
+    t8_shmem_array_destroy (&forest->element_offsets);
+  }
+}
+
+void
+t8_forest_csr_reset (t8_forest_csr_t * csr)
+{
+  T8_ASSERT (csr != NULL);
+
+  T8_FREE (csr->row_distribution);
+  T8_FREE (csr->row_offsets);
+  T8_FREE (csr->columns);
+  T8_FREE (csr->weights);
+  csr->row_distribution = NULL;
+  csr->row_offsets = NULL;
+  csr->columns = NULL;
+  csr->weights = NULL;
+  csr->num_rows = 0;
+}
+
+T8_EXTERN_C_END ();
@@ -206,6 +206,7 @@ t8_forest_balance (t8_forest_t forest, int repartition)
       t8_forest_set_ghost (forest_temp, 1, T8_GHOST_FACES);
     }
     forest_temp->t8code_data = &done;
+    t8_forest_set_compact_messages (forest_temp, forest->compact_messages);
     /* If profiling is enabled, measure ghost/adapt rumtimes */
     if (forest->profile != NULL) {
       t8_forest_set_profiling (forest_temp, 1);
@@ -254,6 +255,8 @@ t8_forest_balance (t8_forest_t forest, int repartition)
       forest_partition->maxlevel_existing = forest_temp->maxlevel_existing;
       t8_forest_set_partition (forest_partition, forest_temp, 0);
       t8_forest_set_ghost (forest_partition, 1, T8_GHOST_FACES);
+      t8_forest_set_compact_messages (forest_partition,
+                                      forest->compact_messages);
       /* If profiling is enabled, measure partition rumtimes */
       if (forest->profile != NULL) {
         t8_forest_set_profiling (forest_partition, 1);
@@ -283,6 +286,8 @@ t8_forest_balance (t8_forest_t forest, int repartition)
   T8_ASSERT (t8_forest_is_balanced (forest_temp));
   /* Forest_temp is now balanced, we copy its trees and elements to forest */
   t8_forest_copy_trees (forest, forest_temp, 1);
+  forest->is_balanced = 1;
+  forest->is_partitioned = forest_temp->is_partitioned;
   /* TODO: Also copy ghost elements if ghost creation is set */
 
   t8_log_indent_pop ();
@@ -0,0 +1,542 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#include <t8_forest_boundary.h>
+#include <t8_cmesh_vtk.h>
+#include <t8_element_cxx.hxx>
+#include <t8_cmesh/t8_cmesh_types.h>
+#include <t8_forest/t8_forest_types.h>
+#include <t8_forest/t8_forest_private.h>
+
+/* We want to export the whole implementation to be callable from "C" */
+T8_EXTERN_C_BEGIN ();
+
+/* The number of entries in the partition info of a process:
+ * The global ids of the first and last local tree, the number of boundary
+ * elements and the numbers of boundary elements at each face of the first
+ * and of the last local tree. */
+#define T8_BOUNDARY_INFO_SIZE (3 + 2 * T8_ECLASS_MAX_FACES)
+#define T8_BOUNDARY_INFO_FIRST_COUNTS 3
+#define T8_BOUNDARY_INFO_LAST_COUNTS (3 + T8_ECLASS_MAX_FACES)
+
+/* A boundary element together with its position in the boundary forest.
+ * In a record array, the data of the boundary element follows directly
+ * after each record. */
+typedef struct
+{
+  t8_gloidx_t         position; /* The global index in the boundary forest */
+  t8_gloidx_t         stree;    /* The global id of the boundary tree */
+  t8_forest_boundary_face_t volume;     /* The volume element */
+} t8_boundary_record_t;
+
+#define T8_BOUNDARY_RECORD_ELEMENT(record) \
+  ((t8_element_t *) ((char *) (record) + sizeof (t8_boundary_record_t)))
+
+/* Create the coarse mesh of the boundary trees and compute the global id
+ * of the first boundary tree of each tree of cmesh.
+ * \param [in] cmesh        A committed, replicated cmesh.
+ * \param [in] comm         The communicator of the new cmesh.
+ * \param [out] first_stree Array of length the number of trees in cmesh
+ *                          plus one. On output the global id of the first
+ *                          boundary tree of each tree and the number of
+ *                          boundary trees at the end.
+ * \return                  The committed cmesh of the boundary trees.
+ *                          It is empty if cmesh has no boundary faces.
+ */
+static              t8_cmesh_t
+t8_forest_boundary_cmesh (t8_cmesh_t cmesh, sc_MPI_Comm comm,
+                          t8_gloidx_t *first_stree)
+{
+  t8_cmesh_t          scmesh;
+  t8_gloidx_t         num_trees, itree, stree;
+  t8_eclass_t         eclass, face_class;
+  double             *vertices;
+  double              face_vertices[3 * T8_ECLASS_MAX_CORNERS_2D];
+  int                 iface, ivertex, tree_vertex;
+
+  num_trees = t8_cmesh_get_num_trees (cmesh);
+  t8_cmesh_init (&scmesh);
+  for (itree = 0, stree = 0; itree < num_trees; itree++) {
+    first_stree[itree] = stree;
+    eclass = t8_cmesh_get_tree_class (cmesh, (t8_locidx_t) itree);
+    vertices = t8_cmesh_get_tree_vertices (cmesh, (t8_locidx_t) itree);
+    for (iface = 0; iface < t8_eclass_num_faces[eclass]; iface++) {
+      if (!t8_cmesh_tree_face_is_boundary (cmesh, (t8_locidx_t) itree,
+                                           iface)) {
+        continue;
+      }
+      face_class = (t8_eclass_t) t8_eclass_face_types[eclass][iface];
+      t8_cmesh_set_tree_class (scmesh, stree, face_class);
+      if (vertices != NULL) {
+        /* The vertices of the boundary tree are the face vertices */
+        for (ivertex = 0; ivertex < t8_eclass_num_vertices[face_class];
+             ivertex++) {
+          tree_vertex = t8_face_vertex_to_tree_vertex[eclass][iface][ivertex];
+          memcpy (face_vertices + 3 * ivertex, vertices + 3 * tree_vertex,
+                  3 * sizeof (double));
+        }
+        t8_cmesh_set_tree_vertices (scmesh, (t8_locidx_t) stree,
+                                    t8_get_package_id (), 0, face_vertices,
+                                    t8_eclass_num_vertices[face_class]);
+      }
+      stree++;
+    }
+  }
+  first_stree[num_trees] = stree;
+  if (stree == 0) {
+    /* A closed or periodic mesh has no boundary and we create an empty
+     * cmesh. Its dimension cannot be derived from its trees. */
+    t8_cmesh_set_dimension (scmesh, cmesh->dimension - 1);
+  }
+  t8_cmesh_commit (scmesh, comm);
+  return scmesh;
+}
+
+/* Compute the boundary elements of the local elements of forest.
+ * The records are ordered by boundary tree and within each boundary tree
+ * in the order of the volume elements. Since the restriction of the space
+ * filling curve of a tree to one of its faces is the space filling curve
+ * of the face, this is the order of the boundary elements in their tree.
+ * We abort if a scheme violates this.
+ * \param [in] forest      The committed volume forest.
+ * \param [in] first_stree The first boundary tree of each global tree.
+ * \param [in,out] records An initialized array of records, on output the
+ *                         boundary elements of the local elements.
+ * \param [out] counts     For each local tree and each of its faces the
+ *                         number of boundary elements, with
+ *                         T8_ECLASS_MAX_FACES entries per tree.
+ */
+static void
+t8_forest_boundary_collect (t8_forest_t forest,
+                            const t8_gloidx_t *first_stree,
+                            sc_array_t *records, t8_locidx_t *counts)
+{
+  t8_cmesh_t          cmesh = t8_forest_get_cmesh (forest);
+  t8_locidx_t         itree, lctree, ielement, num_elements;
+  t8_locidx_t         element_offset;
+  t8_gloidx_t         stree;
+  t8_eclass_t         tree_class, face_class;
+  t8_eclass_scheme_c *ts, *face_ts;
+  t8_element_t       *element, *face_element;
+  t8_boundary_record_t *record, *prev;
+  int                 iface, eface, num_faces;
+
+  for (itree = 0; itree < t8_forest_get_num_local_trees (forest); itree++) {
+    lctree = t8_forest_ltreeid_to_cmesh_ltreeid (forest, itree);
+    tree_class = t8_forest_get_tree_class (forest, itree);
+    ts = t8_forest_get_eclass_scheme (forest, tree_class);
+    num_elements = t8_forest_get_tree_num_elements (forest, itree);
+    element_offset = t8_forest_get_tree_element_offset (forest, itree);
+    stree = first_stree[t8_forest_global_tree_id (forest, itree)];
+    for (iface = 0; iface < t8_eclass_num_faces[tree_class]; iface++) {
+      if (!t8_cmesh_tree_face_is_boundary (cmesh, lctree, iface)) {
+        continue;
+      }
+      face_class = (t8_eclass_t) t8_eclass_face_types[tree_class][iface];
+      face_ts = t8_forest_get_eclass_scheme (forest, face_class);
+      for (ielement = 0; ielement < num_elements; ielement++) {
+        element = t8_forest_get_element_in_tree (forest, itree, ielement);
+        num_faces = ts->t8_element_num_faces (element);
+        for (eface = 0; eface < num_faces; eface++) {
+          if (!ts->t8_element_is_root_boundary (element, eface)
+              || ts->t8_element_tree_face (element, eface) != iface) {
+            continue;
+          }
+          record = (t8_boundary_record_t *) sc_array_push (records);
+          record->stree = stree;
+          record->volume.volume_rank = forest->mpirank;
+          record->volume.volume_element = element_offset + ielement;
+          record->volume.volume_face = eface;
+          face_element = T8_BOUNDARY_RECORD_ELEMENT (record);
+          face_ts->t8_element_init (1, face_element, 0);
+          ts->t8_element_boundary_face (element, eface, face_element,
+                                        face_ts);
+          if (counts[itree * T8_ECLASS_MAX_FACES + iface] > 0) {
+            /* The positions of the boundary elements in their trees rely
+             * on this order, thus we check it for each scheme. */
+            prev = (t8_boundary_record_t *)
+              sc_array_index (records, records->elem_count - 2);
+            SC_CHECK_ABORT (face_ts->t8_element_compare
+                            (T8_BOUNDARY_RECORD_ELEMENT (prev),
+                             face_element) < 0,
+                            "The order of the elements at a tree face is "
+                            "not the order of the face elements.");
+          }
+          counts[itree * T8_ECLASS_MAX_FACES + iface]++;
+        }
+      }
+      stree++;
+    }
+  }
+}
+
+/* The boundary elements are ordered by boundary tree and within each tree
+ * by process. Compute the shift of the position of the boundary elements of
+ * this process at a face of a tree that is shared with other processes,
+ * compared to the position they would have if all boundary elements of the
+ * processes before this one came first.
+ * \param [in] all_info The partition info of all processes.
+ * \param [in] mpirank  This process.
+ * \param [in] mpisize  The number of processes.
+ * \param [in] gtree    The global id of a local tree.
+ * \param [in] face     A face of \a gtree.
+ * \return              The shift of the position.
+ */
+static              t8_gloidx_t
+t8_forest_boundary_shift (const t8_gloidx_t *all_info, int mpirank,
+                          int mpisize, t8_gloidx_t gtree, int face)
+{
+  const t8_gloidx_t  *info;
+  t8_gloidx_t         shift = 0;
+  int                 iproc, iface;
+
+  /* Boundary elements of previous processes at later faces come after ours */
+  for (iproc = mpirank - 1; iproc >= 0; iproc--) {
+    info = all_info + iproc * T8_BOUNDARY_INFO_SIZE;
+    if (info[0] < 0) {
+      /* This process is empty */
+      continue;
+    }
+    if (info[1] != gtree) {
+      break;
+    }
+    for (iface = face + 1; iface < T8_ECLASS_MAX_FACES; iface++) {
+      shift -= info[T8_BOUNDARY_INFO_LAST_COUNTS + iface];
+    }
+    if (info[0] != gtree) {
+      break;
+    }
+  }
+  /* Boundary elements of later processes at earlier faces come before ours */
+  for (iproc = mpirank + 1; iproc < mpisize; iproc++) {
+    info = all_info + iproc * T8_BOUNDARY_INFO_SIZE;
+    if (info[0] < 0) {
+      continue;
+    }
+    if (info[0] != gtree) {
+      break;
+    }
+    for (iface = 0; iface < face; iface++) {
+      shift += info[T8_BOUNDARY_INFO_FIRST_COUNTS + iface];
+    }
+    if (info[1] != gtree) {
+      break;
+    }
+  }
+  return shift;
+}
+
+/* Send an array of records to each process and receive an array from
+ * each process. The array to this process is copied.
+ * \param [in] comm       The MPI communicator.
+ * \param [in] send       For each process an array of records to send.
+ * \param [in,out] recv   For each process an initialized array with the
+ *                        same element size. On output the received records.
+ */
+static void
+t8_forest_boundary_exchange (sc_MPI_Comm comm, sc_array_t *send,
+                             sc_array_t *recv)
+{
+  sc_MPI_Request     *requests;
+  int                *send_counts, *recv_counts;
+  int                 mpirank, mpisize, iproc, num_requests, mpiret;
+
+  mpiret = sc_MPI_Comm_size (comm, &mpisize);
+  SC_CHECK_MPI (mpiret);
+  mpiret = sc_MPI_Comm_rank (comm, &mpirank);
+  SC_CHECK_MPI (mpiret);
+
+  send_counts = T8_ALLOC_ZERO (int, mpisize);
+  recv_counts = T8_ALLOC (int, mpisize);
+  for (iproc = 0; iproc < mpisize; iproc++) {
+    send_counts[iproc] = (int) (send[iproc].elem_count
+                                * send[iproc].elem_size);
+  }
+  mpiret = sc_MPI_Alltoall (send_counts, 1, sc_MPI_INT, recv_counts, 1,
+                            sc_MPI_INT, comm);
+  SC_CHECK_MPI (mpiret);
+
+  sc_array_copy (recv + mpirank, send + mpirank);
+  requests = T8_ALLOC (sc_MPI_Request, 2 * mpisize);
+  num_requests = 0;
+  for (iproc = 0; iproc < mpisize; iproc++) {
+    if (iproc != mpirank && recv_counts[iproc] > 0) {
+      T8_ASSERT (recv_counts[iproc] % recv[iproc].elem_size == 0);
+      sc_array_resize (recv + iproc,
+                       recv_counts[iproc] / recv[iproc].elem_size);
+      mpiret = sc_MPI_Irecv (recv[iproc].array, recv_counts[iproc],
+                             sc_MPI_BYTE, iproc, T8_MPI_BOUNDARY_FOREST,
+                             comm, requests + num_requests++);
+      SC_CHECK_MPI (mpiret);
+    }
+  }
+  for (iproc = 0; iproc < mpisize; iproc++) {
+    if (iproc != mpirank && send_counts[iproc] > 0) {
+      mpiret = sc_MPI_Isend (send[iproc].array, send_counts[iproc],
+                             sc_MPI_BYTE, iproc, T8_MPI_BOUNDARY_FOREST,
+                             comm, requests + num_requests++);
+      SC_CHECK_MPI (mpiret);
+    }
+  }
+  mpiret = sc_MPI_Waitall (num_requests, requests, sc_MPI_STATUSES_IGNORE);
+  SC_CHECK_MPI (mpiret);
+  T8_FREE (requests);
+  T8_FREE (send_counts);
+  T8_FREE (recv_counts);
+}
+
+/* Create the trees of the boundary forest from its local boundary elements.
+ * \param [in,out] boundary The boundary forest with cmesh and scheme set.
+ * \param [in] records      The local boundary elements in their order.
+ * \param [in,out] face_to_volume If not NULL, on output the volume element
+ *                          of each local boundary element.
+ */
+static void
+t8_forest_boundary_build_trees (t8_forest_t boundary, sc_array_t *records,
+                                sc_array_t *face_to_volume)
+{
+  t8_locidx_t         num_elements, ielement, first_element, ie;
+  t8_gloidx_t         jt;
+  t8_boundary_record_t *record;
+  t8_tree_t           tree;
+  t8_eclass_scheme_c *ts;
+
+  num_elements = (t8_locidx_t) records->elem_count;
+  boundary->local_num_elements = num_elements;
+  if (face_to_volume != NULL) {
+    sc_array_resize (face_to_volume, num_elements);
+  }
+  if (num_elements == 0) {
+    boundary->trees = sc_array_new (sizeof (t8_tree_struct_t));
+    boundary->first_local_tree = 0;
+    boundary->last_local_tree = -1;
+    return;
+  }
+  boundary->first_local_tree =
+    ((t8_boundary_record_t *) sc_array_index (records, 0))->stree;
+  boundary->last_local_tree =
+    ((t8_boundary_record_t *) sc_array_index (records, num_elements - 1))->
+    stree;
+  boundary->trees =
+    sc_array_new_count (sizeof (t8_tree_struct_t),
+                        boundary->last_local_tree -
+                        boundary->first_local_tree + 1);
+  ielement = 0;
+  for (jt = boundary->first_local_tree; jt <= boundary->last_local_tree;
+       jt++) {
+    tree = (t8_tree_t) t8_sc_array_index_locidx (boundary->trees,
+                                                 jt -
+                                                 boundary->first_local_tree);
+    tree->eclass = t8_cmesh_get_tree_class (boundary->cmesh,
+                                            (t8_locidx_t) jt);
+    ts = boundary->scheme_cxx->eclass_schemes[tree->eclass];
+    /* Find the boundary elements of this tree */
+    first_element = ielement;
+    while (ielement < num_elements
+           && ((t8_boundary_record_t *)
+               sc_array_index (records, ielement))->stree == jt) {
+      ielement++;
+    }
+    /* Each boundary tree has at least one element, so the local trees
+     * are contiguous */
+    T8_ASSERT (ielement > first_element);
+    t8_element_array_init_size (&tree->elements, ts,
+                                ielement - first_element);
+    for (ie = first_element; ie < ielement; ie++) {
+      record = (t8_boundary_record_t *) sc_array_index (records, ie);
+      memcpy (t8_element_array_index_locidx (&tree->elements,
+                                             ie - first_element),
+              T8_BOUNDARY_RECORD_ELEMENT (record), ts->t8_element_size ());
+      if (face_to_volume != NULL) {
+        *(t8_forest_boundary_face_t *) sc_array_index (face_to_volume, ie) =
+          record->volume;
+      }
+    }
+  }
+  T8_ASSERT (ielement == num_elements);
+}
+
+t8_forest_t
+t8_forest_new_boundary (t8_forest_t forest, sc_array_t *face_to_volume)
+{
+  t8_forest_t         boundary;
+  t8_cmesh_t          cmesh;
+  t8_gloidx_t        *first_stree, *all_info, *offsets;
+  t8_gloidx_t         info[T8_BOUNDARY_INFO_SIZE];
+  t8_gloidx_t         gtree, position;
+  t8_locidx_t        *counts, num_local_trees, itree, irecord, ie, count;
+  t8_boundary_record_t *record;
+  sc_array_t          records, *send, *recv;
+  size_t              record_size, element_size;
+  int                 eclass, iface, iproc, mpirank, mpisize, mpiret;
+  int                 first, last, mid;
+
+  T8_ASSERT (t8_forest_is_committed (forest));
+  T8_ASSERT (face_to_volume == NULL || face_to_volume->elem_size ==
+             sizeof (t8_forest_boundary_face_t));
+  cmesh = t8_forest_get_cmesh (forest);
+  SC_CHECK_ABORT (!t8_cmesh_is_partitioned (cmesh),
+                  "The boundary forest needs a replicated coarse mesh.");
+  SC_CHECK_ABORT (forest->dimension > 0,
+                  "The boundary forest needs a forest of dimension > 0.");
+  mpirank = forest->mpirank;
+  mpisize = forest->mpisize;
+
+  /* Initialize the boundary forest with the coarse mesh of the boundary
+   * trees and the scheme and communicator of forest */
+  t8_forest_init (&boundary);
+  boundary->mpicomm = forest->do_dup ? t8_comm_pool_dup (forest->mpicomm)
+    : forest->mpicomm;
+  boundary->do_dup = forest->do_dup;
+  boundary->mpirank = mpirank;
+  boundary->mpisize = mpisize;
+  first_stree = T8_ALLOC (t8_gloidx_t, t8_cmesh_get_num_trees (cmesh) + 1);
+  boundary->cmesh =
+    t8_forest_boundary_cmesh (cmesh, boundary->mpicomm, first_stree);
+  t8_scheme_cxx_ref (forest->scheme_cxx);
+  boundary->scheme_cxx = forest->scheme_cxx;
+  boundary->dimension = forest->dimension - 1;
+  if (t8_cmesh_is_empty (boundary->cmesh)) {
+    /* Without trees no element class bounds the level */
+    boundary->maxlevel = forest->maxlevel;
+  }
+  else {
+    t8_forest_compute_maxlevel (boundary);
+  }
+
+  /* A record holds the largest boundary element */
+  element_size = 0;
+  for (eclass = T8_ECLASS_ZERO; eclass < T8_ECLASS_COUNT; eclass++) {
+    if (boundary->cmesh->num_trees_per_eclass[eclass] > 0) {
+      element_size = SC_MAX (element_size,
+                             boundary->scheme_cxx->eclass_schemes[eclass]->
+                             t8_element_size ());
+    }
+  }
+  record_size = sizeof (t8_boundary_record_t) + element_size;
+  record_size = (record_size + sizeof (t8_gloidx_t) - 1)
+    / sizeof (t8_gloidx_t) * sizeof (t8_gloidx_t);
+
+  /* Compute the boundary elements of the local elements */
+  num_local_trees = t8_forest_get_num_local_trees (forest);
+  counts = T8_ALLOC_ZERO (t8_locidx_t,
+                          SC_MAX (num_local_trees, 1) * T8_ECLASS_MAX_FACES);
+  sc_array_init (&records, record_size);
+  t8_forest_boundary_collect (forest, first_stree, &records, counts);
+
+  /* Gather the partition info of all processes */
+  memset (info, 0, sizeof (info));
+  if (num_local_trees > 0) {
+    info[0] = t8_forest_global_tree_id (forest, 0);
+    info[1] = t8_forest_global_tree_id (forest, num_local_trees - 1);
+    for (iface = 0; iface < T8_ECLASS_MAX_FACES; iface++) {
+      info[T8_BOUNDARY_INFO_FIRST_COUNTS + iface] = counts[iface];
+      info[T8_BOUNDARY_INFO_LAST_COUNTS + iface] =
+        counts[(num_local_trees - 1) * T8_ECLASS_MAX_FACES + iface];
+    }
+  }
+  else {
+    info[0] = info[1] = -1;
+  }
+  info[2] = (t8_gloidx_t) records.elem_count;
+  all_info = T8_ALLOC (t8_gloidx_t, mpisize * T8_BOUNDARY_INFO_SIZE);
+  mpiret = sc_MPI_Allgather (info, T8_BOUNDARY_INFO_SIZE, T8_MPI_GLOIDX,
+                             all_info, T8_BOUNDARY_INFO_SIZE, T8_MPI_GLOIDX,
+                             forest->mpicomm);
+  SC_CHECK_MPI (mpiret);
+  /* Each process keeps the number of boundary elements it computed */
+  offsets = T8_ALLOC (t8_gloidx_t, mpisize + 1);
+  offsets[0] = 0;
+  for (iproc = 0; iproc < mpisize; iproc++) {
+    offsets[iproc + 1] = offsets[iproc] + all_info[iproc *
+                                                   T8_BOUNDARY_INFO_SIZE + 2];
+  }
+
+  /* Compute the position of each boundary element and send it to the
+   * process that owns this position */
+  send = T8_ALLOC (sc_array_t, mpisize);
+  recv = T8_ALLOC (sc_array_t, mpisize);
+  for (iproc = 0; iproc < mpisize; iproc++) {
+    sc_array_init (send + iproc, record_size);
+    sc_array_init (recv + iproc, record_size);
+  }
+  irecord = 0;
+  for (itree = 0; itree < num_local_trees; itree++) {
+    gtree = t8_forest_global_tree_id (forest, itree);
+    for (iface = 0; iface < T8_ECLASS_MAX_FACES; iface++) {
+      count = counts[itree * T8_ECLASS_MAX_FACES + iface];
+      if (count == 0) {
+        continue;
+      }
+      position = offsets[mpirank] + irecord;
+      if (itree == 0 || itree == num_local_trees - 1) {
+        position += t8_forest_boundary_shift (all_info, mpirank, mpisize,
+                                              gtree, iface);
+      }
+      for (ie = 0; ie < count; ie++, irecord++, position++) {
+        record = (t8_boundary_record_t *) sc_array_index (&records, irecord);
+        record->position = position;
+        /* Find the last process whose offset is not larger than position */
+        first = 0;
+        last = mpisize - 1;
+        while (first < last) {
+          mid = (first + last + 1) / 2;
+          if (offsets[mid] <= position) {
+            first = mid;
+          }
+          else {
+            last = mid - 1;
+          }
+        }
+        memcpy (sc_array_push (send + first), record, record_size);
+      }
+    }
+  }
+  T8_ASSERT ((size_t) irecord == records.elem_count);
+  t8_forest_boundary_exchange (forest->mpicomm, send, recv);
+
+  /* Order the received boundary elements by their position */
+  for (iproc = 0; iproc < mpisize; iproc++) {
+    for (ie = 0; ie < (t8_locidx_t) recv[iproc].elem_count; ie++) {
+      record = (t8_boundary_record_t *) sc_array_index (recv + iproc, ie);
+      T8_ASSERT (offsets[mpirank] <= record->position
+                 && record->position < offsets[mpirank + 1]);
+      memcpy (sc_array_index (&records, record->position - offsets[mpirank]),
+              record, record_size);
+    }
+    sc_array_reset (send + iproc);
+    sc_array_reset (recv + iproc);
+  }
+  t8_forest_boundary_build_trees (boundary, &records, face_to_volume);
+  t8_forest_commit_trees (boundary);
+
+  sc_array_reset (&records);
+  T8_FREE (send);
+  T8_FREE (recv);
+  T8_FREE (offsets);
+  T8_FREE (all_info);
+  T8_FREE (counts);
+  T8_FREE (first_stree);
+  return boundary;
+}
+
+T8_EXTERN_C_END ();
@@ -0,0 +1,330 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#include <t8_forest_box.h>
+#include <t8_forest/t8_forest_types.h>
+#include <t8_forest/t8_forest_private.h>
+#include <t8_cmesh.h>
+#include <t8_element_cxx.hxx>
+
+/* We want to export the whole implementation to be callable from "C" */
+T8_EXTERN_C_BEGIN ();
+
+/* Append the linear ids first, ..., last - 1 to the intervals and merge
+ * them with the previous interval if it ends at first. */
+static void
+t8_forest_box_push_interval (sc_array_t * intervals, t8_gloidx_t gtreeid,
+                             t8_eclass_t eclass, int level,
+                             t8_linearidx_t first,
+                             t8_linearidx_t last)
+{
+  t8_forest_box_interval_t *interval;
+
+  if (intervals->elem_count > 0) {
+    interval = (t8_forest_box_interval_t *)
+      sc_array_index (intervals, intervals->elem_count - 1);
+    if (interval->gtreeid == gtreeid && interval->level == level
+        && interval->last == first) {
+      interval->last = last;
+      return;
+    }
+  }
+  interval = (t8_forest_box_interval_t *) sc_array_push (intervals);
+  interval->gtreeid = gtreeid;
+  interval->eclass = eclass;
+  interval->level = level;
+  interval->first = first;
+  interval->last = last;
+}
+
+/* Traverse the descendants of element up to the given level and append
+ * the linear ids of those that intersect the box.
+ * If an element lies completely inside the box, all its descendants do
+ * and we append them as one interval. */
+static void
+t8_forest_box_intervals_recursion (t8_eclass_scheme_c * ts,
+                                   const t8_element_t * element, int dim,
+                                   const double box[6], int level,
+                                   t8_gloidx_t gtreeid,
+                                   sc_array_t * intervals)
+{
+  t8_element_t      **children;
+  t8_linearidx_t      first;
+  int                 lower[3], upper[3];
+  int                 idim, inside, num_children, ichild;
+  int                 element_level;
+  double              root_len, elem_lower, elem_upper;
+
+  /* The element spans the reference box between its first and last corner */
+  ts->t8_element_vertex_coords (element, 0, lower);
+  ts->t8_element_vertex_coords (element,
+                                ts->t8_element_num_corners (element) - 1,
+                                upper);
+  root_len = ts->t8_element_root_len (element);
+  inside = 1;
+  for (idim = 0; idim < dim; idim++) {
+    elem_lower = lower[idim] / root_len;
+    elem_upper = upper[idim] / root_len;
+    if (elem_lower > box[3 + idim] || elem_upper < box[idim]) {
+      /* The element does not intersect the box */
+      return;
+    }
+    inside = inside && box[idim] <= elem_lower && elem_upper <= box[3 + idim];
+  }
+
+  element_level = ts->t8_element_level (element);
+  if (inside || element_level == level) {
+    first = ts->t8_element_get_linear_id (element, level);
+    t8_forest_box_push_interval (intervals, gtreeid, ts->eclass, level,
+                                 first,
+                                 first + ((t8_linearidx_t) 1 <<
+                                          (dim * (level - element_level))));
+    return;
+  }
+  num_children = ts->t8_element_num_children (element);
+  children = T8_ALLOC (t8_element_t *, num_children);
+  ts->t8_element_new (num_children, children);
+  ts->t8_element_children (element, num_children, children);
+  for (ichild = 0; ichild < num_children; ichild++) {
+    t8_forest_box_intervals_recursion (ts, children[ichild], dim, box, level,
+                                       gtreeid, intervals);
+  }
+  ts->t8_element_destroy (num_children, children);
+  T8_FREE (children);
+}
+
+/* Decompose a box for a tree of a given class */
+static void
+t8_forest_box_intervals_eclass (t8_forest_t forest, t8_eclass_t eclass,
+                                t8_gloidx_t gtreeid, const double box[6],
+                                int level, sc_array_t * intervals)
+{
+  t8_eclass_scheme_c *ts;
+  t8_element_t       *root;
+
+  SC_CHECK_ABORTF (eclass == T8_ECLASS_LINE || eclass == T8_ECLASS_QUAD
+                   || eclass == T8_ECLASS_HEX,
+                   "Box intervals not implemented for trees of class %s.\n",
+                   t8_eclass_to_string[eclass]);
+  ts = t8_forest_get_eclass_scheme (forest, eclass);
+  SC_CHECK_ABORT (!ts->t8_element_is_anisotropic (),
+                  "Box intervals need an isotropic scheme");
+  T8_ASSERT (0 <= level && level <= ts->t8_element_maxlevel ());
+
+  ts->t8_element_new (1, &root);
+  ts->t8_element_set_linear_id (root, 0, 0);
+  t8_forest_box_intervals_recursion (ts, root, t8_eclass_to_dimension[eclass],
+                                     box, level, gtreeid, intervals);
+  ts->t8_element_destroy (1, &root);
+}
+
+void
+t8_forest_box_intervals (t8_forest_t forest, t8_gloidx_t gtreeid,
+                         const double box[6], int level,
+                         sc_array_t * intervals)
+{
+  t8_cmesh_t          cmesh;
+  t8_locidx_t         ltreeid;
+
+  T8_ASSERT (t8_forest_is_committed (forest));
+  T8_ASSERT (0 <= gtreeid
+             && gtreeid < t8_forest_get_num_global_trees (forest));
+  T8_ASSERT (intervals != NULL
+             && intervals->elem_size == sizeof (t8_forest_box_interval_t));
+
+  cmesh = t8_forest_get_cmesh (forest);
+  ltreeid = t8_cmesh_get_local_id (cmesh, gtreeid);
+  SC_CHECK_ABORT (0 <= ltreeid
+                  && ltreeid < t8_cmesh_get_num_local_trees (cmesh),
+                  "Box intervals need a local tree of the coarse mesh");
+  t8_forest_box_intervals_eclass (forest,
+                                  t8_cmesh_get_tree_class (cmesh, ltreeid),
+                                  gtreeid, box, level, intervals);
+}
+
+void
+t8_forest_box_intervals_physical (t8_forest_t forest, const double box[6],
+                                  int level, sc_array_t * intervals)
+{
+  t8_cmesh_t          cmesh;
+  t8_locidx_t         ltreeid;
+  t8_eclass_t         eclass;
+  double             *vertices, tree_lower, tree_upper;
+  double              reference_box[6];
+  int                 dim, idim, icorner, num_corners, intersects;
+
+  T8_ASSERT (t8_forest_is_committed (forest));
+  T8_ASSERT (intervals != NULL
+             && intervals->elem_size == sizeof (t8_forest_box_interval_t));
+
+  cmesh = t8_forest_get_cmesh (forest);
+  for (ltreeid = 0; ltreeid < t8_cmesh_get_num_local_trees (cmesh);
+       ltreeid++) {
+    eclass = t8_cmesh_get_tree_class (cmesh, ltreeid);
+    vertices = t8_cmesh_get_tree_vertices (cmesh, ltreeid);
+    SC_CHECK_ABORT (vertices != NULL, "Box intervals need tree vertices");
+    dim = t8_eclass_to_dimension[eclass];
+    num_corners = t8_eclass_num_vertices[eclass];
+    /* Corner i of an axis-aligned tree has the upper coordinate along
+     * axis d if and only if bit d of i is set. */
+    for (icorner = 0; icorner < num_corners; icorner++) {
+      for (idim = 0; idim < 3; idim++) {
+        SC_CHECK_ABORT (vertices[3 * icorner + idim] ==
+                        vertices[3 * ((icorner >> idim) & 1
+                                      ? num_corners - 1 : 0) + idim],
+                        "Box intervals need axis-aligned trees");
+      }
+    }
+    /* Map the box to the reference coordinates of the tree */
+    intersects = 1;
+    for (idim = 0; idim < 3 && intersects; idim++) {
+      tree_lower = vertices[idim];
+      tree_upper = vertices[3 * (num_corners - 1) + idim];
+      if (idim >= dim) {
+        intersects = box[idim] <= tree_lower && tree_lower <= box[3 + idim];
+        continue;
+      }
+      SC_CHECK_ABORT (tree_lower < tree_upper,
+                      "Box intervals need axis-aligned trees");
+      reference_box[idim] = (box[idim] - tree_lower)
+        / (tree_upper - tree_lower);
+      reference_box[3 + idim] = (box[3 + idim] - tree_lower)
+        / (tree_upper - tree_lower);
+      intersects = reference_box[idim] <= 1 && reference_box[3 + idim] >= 0;
+    }
+    if (intersects) {
+      t8_forest_box_intervals_eclass (forest, eclass,
+                                      t8_cmesh_get_global_id (cmesh, ltreeid),
+                                      reference_box, level, intervals);
+    }
+  }
+}
+
+/* Compute the linear ids at a given level that a leaf spans.
+ * A leaf finer than the level spans the id of its ancestor. */
+static void
+t8_forest_box_leaf_range (t8_eclass_scheme_c * ts, const t8_element_t * leaf,
+                          int dim, int level, t8_linearidx_t * first,
+                          t8_linearidx_t * last)
+{
+  const int           leaf_level = ts->t8_element_level (leaf);
+
+  *first = ts->t8_element_get_linear_id (leaf, level);
+  *last = *first + (leaf_level < level ? (t8_linearidx_t) 1
+                    << (dim * (level - leaf_level)) : 1);
+}
+
+t8_locidx_t
+t8_forest_box_interval_elements (t8_forest_t forest,
+                                 const t8_forest_box_interval_t * interval,
+                                 t8_locidx_t * ltreeid, t8_locidx_t * first)
+{
+  t8_eclass_scheme_c *ts;
+  t8_linearidx_t      leaf_first, leaf_last;
+  t8_locidx_t         low, high, mid, begin;
+  int                 dim;
+
+  T8_ASSERT (t8_forest_is_committed (forest));
+  T8_ASSERT (interval->first < interval->last);
+
+  *first = 0;
+  *ltreeid = t8_forest_get_local_id (forest, interval->gtreeid);
+  if (*ltreeid < 0) {
+    return 0;
+  }
+  T8_ASSERT (t8_forest_get_tree_class (forest, *ltreeid) == interval->eclass);
+  ts = t8_forest_get_eclass_scheme (forest, interval->eclass);
+  dim = t8_eclass_to_dimension[interval->eclass];
+
+  /* The leaves are sorted, hence their ranges are. We search for the first
+   * leaf that ends after the start of the interval... */
+  low = 0;
+  high = t8_forest_get_tree_num_elements (forest, *ltreeid);
+  while (low < high) {
+    mid = low + (high - low) / 2;
+    t8_forest_box_leaf_range (ts,
+                              t8_forest_get_element_in_tree (forest, *ltreeid,
+                                                             mid),
+                              dim, interval->level, &leaf_first, &leaf_last);
+    if (leaf_last <= interval->first) {
+      low = mid + 1;
+    }
+    else {
+      high = mid;
+    }
+  }
+  begin = low;
+  /* ...and for the first leaf that starts after the end of the interval. */
+  high = t8_forest_get_tree_num_elements (forest, *ltreeid);
+  while (low < high) {
+    mid = low + (high - low) / 2;
+    t8_forest_box_leaf_range (ts,
+                              t8_forest_get_element_in_tree (forest, *ltreeid,
+                                                             mid),
+                              dim, interval->level, &leaf_first, &leaf_last);
+    if (leaf_first < interval->last) {
+      low = mid + 1;
+    }
+    else {
+      high = mid;
+    }
+  }
+  *first = begin;
+  return low - begin;
+}
+
+void
+t8_forest_box_interval_owners (t8_forest_t forest,
+                               const t8_forest_box_interval_t * interval,
+                               int *first_owner, int *last_owner)
+{
+  t8_eclass_scheme_c *ts;
+  t8_element_t       *element, *desc;
+
+  T8_ASSERT (t8_forest_is_committed (forest));
+  T8_ASSERT (interval->first < interval->last);
+  T8_ASSERT (forest->tree_offsets != NULL);
+  T8_ASSERT (forest->global_first_desc != NULL);
+
+  ts = t8_forest_get_eclass_scheme (forest, interval->eclass);
+  ts->t8_element_new (1, &element);
+  ts->t8_element_new (1, &desc);
+  /* The owner of the first element is the owner of its first descendant */
+  ts->t8_element_set_linear_id (element, interval->level, interval->first);
+  *first_owner = t8_forest_element_find_owner (forest, interval->gtreeid,
+                                               element,
+                                               interval->eclass);
+  /* The last element may be split among processes. Its last descendant
+   * is owned by the last of them. */
+  ts->t8_element_set_linear_id (element, interval->level,
+                                interval->last - 1);
+  ts->t8_element_last_descendant (element, desc, forest->maxlevel);
+  *last_owner = t8_forest_element_find_owner_ext (forest, interval->gtreeid,
+                                                  desc, interval->eclass,
+                                                  *first_owner,
+                                                  forest->mpisize - 1,
+                                                  *first_owner, 1);
+  ts->t8_element_destroy (1, &element);
+  ts->t8_element_destroy (1, &desc);
+}
+
+T8_EXTERN_C_END ();
@@ -0,0 +1,399 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#include <t8_forest_calibrate.h>
+#include <t8_forest/t8_forest_types.h>
+#include <t8_element_cxx.hxx>
+
+/* We want to export the whole implementation to be callable from "C" */
+T8_EXTERN_C_BEGIN ();
+
+/* The relative weight of the regularization of the least squares fit.
+ * It keeps the fit well-posed if there are fewer measurements than costs
+ * and pulls the costs of rarely measured categories to the mean cost. */
+#define T8_CALIBRATE_REGULARIZATION 1e-6
+
+/* The minimum cost of an element relative to the mean cost */
+#define T8_CALIBRATE_MIN_COST 1e-3
+
+typedef struct t8_forest_calibrate
+{
+  sc_MPI_Comm         comm;     /* The communicator of the forests */
+  int                 maxlevel; /* The maximum distinguished level */
+  int                 num_categories;   /* The number of user categories */
+  t8_forest_calibrate_category_t category_fn;   /* The user category function */
+  double              forget;   /* The damping factor of previous steps */
+  int                 num_costs;        /* The number of element costs */
+  /* The unknowns of the fit are the element costs and as last entry a
+   * constant per process overhead. */
+  double             *normal_matrix;    /* The matrix of the normal equations */
+  double             *normal_rhs;       /* The right hand side of the normal equations */
+  double              sum_runtime;      /* The sum of all runtimes */
+  double              sum_elements;     /* The sum of all element counts */
+  double             *costs;    /* The fitted cost of each category */
+  double              overhead; /* The fitted overhead per process */
+  /* The damped sums of the predicted and the measured runtimes of
+   * this process. Their ratio is the capacity of this process. */
+  double              local_predicted;
+  double              local_runtime;
+} t8_forest_calibrate_struct_t;
+
+/* Return the index of the cost of an element class, level and category */
+static int
+t8_forest_calibrate_index (t8_forest_calibrate_t calibrate,
+                           t8_eclass_t eclass, int level, int category)
+{
+  T8_ASSERT (0 <= eclass && eclass < T8_ECLASS_COUNT);
+  T8_ASSERT (0 <= level);
+  T8_ASSERT (0 <= category && category < calibrate->num_categories);
+
+  level = SC_MIN (level, calibrate->maxlevel);
+  return (eclass * (calibrate->maxlevel + 1) + level)
+    * calibrate->num_categories + category;
+}
+
+/* Return the cost index of an element of a forest */
+static int
+t8_forest_calibrate_element_index (t8_forest_calibrate_t calibrate,
+                                   t8_forest_t forest, t8_locidx_t ltreeid,
+                                   t8_locidx_t lelement_id,
+                                   t8_eclass_scheme_c * ts,
+                                   const t8_element_t * element)
+{
+  int                 category = 0;
+
+  if (calibrate->category_fn != NULL) {
+    category = calibrate->category_fn (forest, ltreeid, lelement_id, ts,
+                                       element);
+  }
+  return t8_forest_calibrate_index (calibrate, ts->eclass,
+                                    ts->t8_element_level (element),
+                                    category);
+}
+
+t8_forest_calibrate_t
+t8_forest_calibrate_new (sc_MPI_Comm comm, int maxlevel, int num_categories,
+                         t8_forest_calibrate_category_t category_fn,
+                         double forget)
+{
+  t8_forest_calibrate_t calibrate;
+  int                 icost, num_unknowns;
+
+  T8_ASSERT (maxlevel >= 0);
+  T8_ASSERT (num_categories > 0);
+  T8_ASSERT (0 < forget && forget <= 1);
+
+  calibrate = T8_ALLOC_ZERO (t8_forest_calibrate_struct_t, 1);
+  calibrate->comm = comm;
+  calibrate->maxlevel = maxlevel;
+  calibrate->num_categories = num_categories;
+  calibrate->category_fn = category_fn;
+  calibrate->forget = forget;
+  calibrate->num_costs = T8_ECLASS_COUNT * (maxlevel + 1) * num_categories;
+  num_unknowns = calibrate->num_costs + 1;
+  calibrate->normal_matrix = T8_ALLOC_ZERO (double,
+                                            num_unknowns * num_unknowns);
+  calibrate->normal_rhs = T8_ALLOC_ZERO (double, num_unknowns);
+  calibrate->costs = T8_ALLOC (double, calibrate->num_costs);
+  for (icost = 0; icost < calibrate->num_costs; icost++) {
+    calibrate->costs[icost] = 1;
+  }
+  return calibrate;
+}
+
+/* Solve the symmetric positive definite system matrix * x = rhs of size n
+ * with a Cholesky decomposition. matrix and rhs are overwritten and
+ * the solution is stored in rhs. */
+static void
+t8_forest_calibrate_cholesky_solve (double *matrix, double *rhs, int n)
+{
+  int                 i, j, k;
+  double              sum;
+
+  /* Decompose matrix = L L^T, L is stored in the lower triangle */
+  for (j = 0; j < n; j++) {
+    sum = matrix[j * n + j];
+    for (k = 0; k < j; k++) {
+      sum -= matrix[j * n + k] * matrix[j * n + k];
+    }
+    T8_ASSERT (sum > 0);
+    matrix[j * n + j] = sqrt (sum);
+    for (i = j + 1; i < n; i++) {
+      sum = matrix[i * n + j];
+      for (k = 0; k < j; k++) {
+        sum -= matrix[i * n + k] * matrix[j * n + k];
+      }
+      matrix[i * n + j] = sum / matrix[j * n + j];
+    }
+  }
+  /* Solve L y = rhs */
+  for (i = 0; i < n; i++) {
+    sum = rhs[i];
+    for (k = 0; k < i; k++) {
+      sum -= matrix[i * n + k] * rhs[k];
+    }
+    rhs[i] = sum / matrix[i * n + i];
+  }
+  /* Solve L^T x = y */
+  for (i = n - 1; i >= 0; i--) {
+    sum = rhs[i];
+    for (k = i + 1; k < n; k++) {
+      sum -= matrix[k * n + i] * rhs[k];
+    }
+    rhs[i] = sum / matrix[i * n + i];
+  }
+}
+
+/* Fit the costs to the normal equations.
+ * Costs that were never measured do not couple to the other unknowns and
+ * get the mean cost. Thus, we only solve for the measured costs and the
+ * overhead. */
+static void
+t8_forest_calibrate_fit (t8_forest_calibrate_t calibrate)
+{
+  int                 num_unknowns, num_measured, icost, jcost, i, j;
+  int                *measured;
+  double             *matrix, *rhs, mean_cost, trace, lambda;
+
+  if (calibrate->sum_elements <= 0) {
+    /* There are no measurements yet */
+    return;
+  }
+  num_unknowns = calibrate->num_costs + 1;
+  mean_cost = calibrate->sum_runtime / calibrate->sum_elements;
+
+  /* Collect the measured unknowns, the overhead is always measured */
+  measured = T8_ALLOC (int, num_unknowns);
+  num_measured = 0;
+  trace = 0;
+  for (icost = 0; icost < num_unknowns; icost++) {
+    if (icost == calibrate->num_costs
+        || calibrate->normal_matrix[icost * num_unknowns + icost] > 0) {
+      measured[num_measured++] = icost;
+      trace += calibrate->normal_matrix[icost * num_unknowns + icost];
+    }
+    else {
+      calibrate->costs[icost] = mean_cost;
+    }
+  }
+  /* Regularize towards the mean cost and no overhead */
+  lambda = T8_CALIBRATE_REGULARIZATION * trace / num_measured;
+  matrix = T8_ALLOC (double, num_measured * num_measured);
+  rhs = T8_ALLOC (double, num_measured);
+  for (i = 0; i < num_measured; i++) {
+    icost = measured[i];
+    for (j = 0; j < num_measured; j++) {
+      jcost = measured[j];
+      matrix[i * num_measured + j] =
+        calibrate->normal_matrix[icost * num_unknowns + jcost];
+    }
+    matrix[i * num_measured + i] += lambda;
+    rhs[i] = calibrate->normal_rhs[icost];
+    if (icost < calibrate->num_costs) {
+      rhs[i] += lambda * mean_cost;
+    }
+  }
+  t8_forest_calibrate_cholesky_solve (matrix, rhs, num_measured);
+  for (i = 0; i < num_measured; i++) {
+    if (measured[i] < calibrate->num_costs) {
+      /* Elements must not be free */
+      calibrate->costs[measured[i]] =
+        SC_MAX (rhs[i], T8_CALIBRATE_MIN_COST * mean_cost);
+    }
+    else {
+      calibrate->overhead = SC_MAX (rhs[i], 0);
+    }
+  }
+  T8_FREE (measured);
+  T8_FREE (matrix);
+  T8_FREE (rhs);
+}
+
+void
+t8_forest_calibrate_add_step (t8_forest_calibrate_t calibrate,
+                              t8_forest_t forest, double runtime)
+{
+  t8_eclass_scheme_c *ts;
+  t8_element_t       *element;
+  t8_locidx_t         itree, ielement, num_elements;
+  int                 num_unknowns, num_active, icost, i, j, mpiret;
+  int                *local_active, *is_active, *active;
+  double             *counts, *local, *global, predicted;
+  size_t              num_entries;
+
+  T8_ASSERT (calibrate != NULL);
+  T8_ASSERT (t8_forest_is_committed (forest));
+
+  num_unknowns = calibrate->num_costs + 1;
+  /* Count the local elements of each category */
+  counts = T8_ALLOC_ZERO (double, num_unknowns);
+  for (itree = 0; itree < t8_forest_get_num_local_trees (forest); itree++) {
+    ts = t8_forest_get_eclass_scheme (forest,
+                                      t8_forest_get_tree_class (forest,
+                                                                itree));
+    num_elements = t8_forest_get_tree_num_elements (forest, itree);
+    for (ielement = 0; ielement < num_elements; ielement++) {
+      element = t8_forest_get_element_in_tree (forest, itree, ielement);
+      counts[t8_forest_calibrate_element_index (calibrate, forest, itree,
+                                                ielement, ts, element)]++;
+    }
+  }
+  /* Each process has a constant overhead */
+  counts[calibrate->num_costs] = 1;
+
+  /* Only the categories that occur on any process contribute */
+  local_active = T8_ALLOC (int, num_unknowns);
+  is_active = T8_ALLOC (int, num_unknowns);
+  for (icost = 0; icost < num_unknowns; icost++) {
+    local_active[icost] = counts[icost] > 0;
+  }
+  mpiret = sc_MPI_Allreduce (local_active, is_active, num_unknowns,
+                             sc_MPI_INT, sc_MPI_LOR, calibrate->comm);
+  SC_CHECK_MPI (mpiret);
+  active = T8_ALLOC (int, num_unknowns);
+  num_active = 0;
+  for (icost = 0; icost < num_unknowns; icost++) {
+    if (is_active[icost]) {
+      active[num_active++] = icost;
+    }
+  }
+
+  /* Each process contributes one equation counts * costs = runtime.
+   * We sum up the normal equations of all processes together with
+   * the total runtime and number of elements. */
+  num_entries = num_active * num_active + num_active + 2;
+  local = T8_ALLOC (double, num_entries);
+  global = T8_ALLOC (double, num_entries);
+  for (i = 0; i < num_active; i++) {
+    for (j = 0; j < num_active; j++) {
+      local[i * num_active + j] = counts[active[i]] * counts[active[j]];
+    }
+    local[num_active * num_active + i] = counts[active[i]] * runtime;
+  }
+  local[num_entries - 2] = runtime;
+  local[num_entries - 1] = t8_forest_get_local_num_elements (forest);
+  mpiret = sc_MPI_Allreduce (local, global, num_entries, sc_MPI_DOUBLE,
+                             sc_MPI_SUM, calibrate->comm);
+  SC_CHECK_MPI (mpiret);
+
+  /* Damp the previous steps and add this step */
+  for (i = 0; i < num_unknowns * num_unknowns; i++) {
+    calibrate->normal_matrix[i] *= calibrate->forget;
+  }
+  for (i = 0; i < num_unknowns; i++) {
+    calibrate->normal_rhs[i] *= calibrate->forget;
+  }
+  for (i = 0; i < num_active; i++) {
+    for (j = 0; j < num_active; j++) {
+      calibrate->normal_matrix[active[i] * num_unknowns + active[j]] +=
+        global[i * num_active + j];
+    }
+    calibrate->normal_rhs[active[i]] += global[num_active * num_active + i];
+  }
+  calibrate->sum_runtime = calibrate->forget * calibrate->sum_runtime
+    + global[num_entries - 2];
+  calibrate->sum_elements = calibrate->forget * calibrate->sum_elements
+    + global[num_entries - 1];
+
+  T8_FREE (local_active);
+  T8_FREE (is_active);
+  T8_FREE (active);
+  T8_FREE (local);
+  T8_FREE (global);
+
+  /* Each process solves the same system and obtains the same costs */
+  t8_forest_calibrate_fit (calibrate);
+
+  /* Compare the runtime that the fit predicts for this process
+   * with its measured runtime */
+  predicted = calibrate->overhead;
+  for (icost = 0; icost < calibrate->num_costs; icost++) {
+    predicted += counts[icost] * calibrate->costs[icost];
+  }
+  calibrate->local_predicted = calibrate->forget * calibrate->local_predicted
+    + predicted;
+  calibrate->local_runtime = calibrate->forget * calibrate->local_runtime
+    + runtime;
+  T8_FREE (counts);
+}
+
+double
+t8_forest_calibrate_get_cost (t8_forest_calibrate_t calibrate,
+                              t8_eclass_t eclass, int level, int category)
+{
+  T8_ASSERT (calibrate != NULL);
+  return calibrate->costs[t8_forest_calibrate_index (calibrate, eclass, level,
+                                                     category)];
+}
+
+double
+t8_forest_calibrate_get_capacity (t8_forest_calibrate_t calibrate)
+{
+  T8_ASSERT (calibrate != NULL);
+  if (calibrate->local_runtime <= 0 || calibrate->local_predicted <= 0) {
+    /* There are no measurements yet */
+    return 1;
+  }
+  return calibrate->local_predicted / calibrate->local_runtime;
+}
+
+/* The partition weight of an element is its fitted cost */
+static double
+t8_forest_calibrate_weight (t8_forest_t forest, t8_forest_t forest_from,
+                            t8_locidx_t which_tree, t8_locidx_t lelement_id,
+                            t8_eclass_scheme_c * ts,
+                            const t8_element_t * element)
+{
+  t8_forest_calibrate_t calibrate;
+
+  calibrate = (t8_forest_calibrate_t)
+    t8_forest_get_partition_weight_data (forest);
+  T8_ASSERT (calibrate != NULL);
+  return calibrate->costs[t8_forest_calibrate_element_index
+                          (calibrate, forest_from, which_tree, lelement_id,
+                           ts, element)];
+}
+
+void
+t8_forest_calibrate_set_partition_weight (t8_forest_t forest,
+                                          t8_forest_calibrate_t calibrate)
+{
+  T8_ASSERT (calibrate != NULL);
+  t8_forest_set_partition_weight (forest, t8_forest_calibrate_weight,
+                                  calibrate);
+}
+
+void
+t8_forest_calibrate_destroy (t8_forest_calibrate_t * pcalibrate)
+{
+  t8_forest_calibrate_t calibrate;
+
+  T8_ASSERT (pcalibrate != NULL && *pcalibrate != NULL);
+  calibrate = *pcalibrate;
+  T8_FREE (calibrate->normal_matrix);
+  T8_FREE (calibrate->normal_rhs);
+  T8_FREE (calibrate->costs);
+  T8_FREE (calibrate);
+  *pcalibrate = NULL;
+}
+
+T8_EXTERN_C_END ();
@@ -0,0 +1,598 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#include <t8_forest_coloring.h>
+#include <t8_forest_adjacency.h>
+#include <t8_forest/t8_forest_types.h>
+#include <t8_element_cxx.hxx>
+
+/* We want to export the whole implementation to be callable from "C" */
+T8_EXTERN_C_BEGIN ();
+
+/* The face adjacency of the local elements and of the ghost elements that
+ * are adjacent to them. Nodes 0, ..., num_local - 1 are the local elements,
+ * nodes num_local, ..., num_local + num_ghosts - 1 are the ghosts.
+ * The rows of the ghosts only contain local elements. */
+typedef struct
+{
+  t8_locidx_t         num_local;
+  t8_locidx_t         num_ghosts;
+  t8_locidx_t        *offsets;  /* Length num_local + num_ghosts + 1 */
+  t8_locidx_t        *adjacent;
+} t8_forest_coloring_graph_t;
+
+static int
+t8_forest_coloring_gloidx_compare (const void *id_a, const void *id_b)
+{
+  const t8_gloidx_t   A = *(const t8_gloidx_t *) id_a;
+  const t8_gloidx_t   B = *(const t8_gloidx_t *) id_b;
+
+  return A < B ? -1 : A != B;
+}
+
+static void
+t8_forest_coloring_graph_init (t8_forest_t forest,
+                               t8_forest_coloring_graph_t * graph)
+{
+  t8_forest_csr_t     csr;
+  t8_gloidx_t         first_element_id, column, *ghost_ids, *found;
+  t8_locidx_t         num_local, num_entries, num_ghost_entries;
+  t8_locidx_t         irow, ientry, ighost, node, *fill;
+
+  t8_forest_adjacency_csr (forest, 0, &csr);
+  num_local = csr.num_rows;
+  num_entries = csr.row_offsets[num_local];
+  first_element_id = csr.row_distribution[forest->mpirank];
+
+  /* Collect the global ids of the ghost neighbors */
+  ghost_ids = T8_ALLOC (t8_gloidx_t, num_entries);
+  num_ghost_entries = 0;
+  for (ientry = 0; ientry < num_entries; ientry++) {
+    column = csr.columns[ientry];
+    if (column < first_element_id || column >= first_element_id + num_local) {
+      ghost_ids[num_ghost_entries++] = column;
+    }
+  }
+  qsort (ghost_ids, num_ghost_entries, sizeof (t8_gloidx_t),
+         t8_forest_coloring_gloidx_compare);
+  graph->num_ghosts = 0;
+  for (ientry = 0; ientry < num_ghost_entries; ientry++) {
+    if (ientry == 0 || ghost_ids[ientry] != ghost_ids[ientry - 1]) {
+      ghost_ids[graph->num_ghosts++] = ghost_ids[ientry];
+    }
+  }
+  graph->num_local = num_local;
+
+  /* Count the entries of each row */
+  graph->offsets =
+    T8_ALLOC_ZERO (t8_locidx_t, num_local + graph->num_ghosts + 1);
+  graph->adjacent = T8_ALLOC (t8_locidx_t, num_entries + num_ghost_entries);
+  for (irow = 0; irow < num_local; irow++) {
+    for (ientry = csr.row_offsets[irow]; ientry < csr.row_offsets[irow + 1];
+         ientry++) {
+      column = csr.columns[ientry];
+      if (column < first_element_id
+          || column >= first_element_id + num_local) {
+        found = (t8_gloidx_t *) bsearch (&column, ghost_ids,
+                                         graph->num_ghosts,
+                                         sizeof (t8_gloidx_t),
+                                         t8_forest_coloring_gloidx_compare);
+        T8_ASSERT (found != NULL);
+        graph->offsets[num_local + (found - ghost_ids) + 1]++;
+      }
+    }
+    graph->offsets[irow + 1] =
+      csr.row_offsets[irow + 1] - csr.row_offsets[irow];
+  }
+  for (node = 0; node < num_local + graph->num_ghosts; node++) {
+    graph->offsets[node + 1] += graph->offsets[node];
+  }
+  T8_ASSERT (graph->offsets[num_local + graph->num_ghosts] ==
+             num_entries + num_ghost_entries);
+
+  /* Fill the rows. The rows of the local elements keep the order of
+   * the csr graph and the rows of the ghosts are sorted, since we
+   * traverse the local elements in order. */
+  fill = T8_ALLOC (t8_locidx_t, num_local + graph->num_ghosts);
+  memcpy (fill, graph->offsets,
+          (num_local + graph->num_ghosts) * sizeof (t8_locidx_t));
+  for (irow = 0; irow < num_local; irow++) {
+    for (ientry = csr.row_offsets[irow]; ientry < csr.row_offsets[irow + 1];
+         ientry++) {
+      column = csr.columns[ientry];
+      if (column < first_element_id
+          || column >= first_element_id + num_local) {
+        found = (t8_gloidx_t *) bsearch (&column, ghost_ids,
+                                         graph->num_ghosts,
+                                         sizeof (t8_gloidx_t),
+                                         t8_forest_coloring_gloidx_compare);
+        ighost = num_local + (t8_locidx_t) (found - ghost_ids);
+        graph->adjacent[fill[irow]++] = ighost;
+        graph->adjacent[fill[ighost]++] = irow;
+      }
+      else {
+        graph->adjacent[fill[irow]++] =
+          (t8_locidx_t) (column - first_element_id);
+      }
+    }
+  }
+
+  T8_FREE (fill);
+  T8_FREE (ghost_ids);
+  t8_forest_csr_reset (&csr);
+}
+
+static void
+t8_forest_coloring_graph_reset (t8_forest_coloring_graph_t * graph)
+{
+  T8_FREE (graph->offsets);
+  T8_FREE (graph->adjacent);
+}
+
+/* Set marks[c] = stamp for each color c of a unit that conflicts with the
+ * elements of unit. Uncolored units are skipped. */
+static void
+t8_forest_coloring_mark_conflicts (const t8_forest_coloring_graph_t * graph,
+                                   t8_coloring_type_t type,
+                                   t8_locidx_t block_size, t8_locidx_t unit,
+                                   const int *unit_colors, int *marks,
+                                   int stamp)
+{
+  t8_locidx_t         ielement, last_element, ientry, jentry;
+  t8_locidx_t         neighbor, second_neighbor;
+
+  last_element = SC_MIN ((unit + 1) * block_size, graph->num_local);
+  for (ielement = unit * block_size; ielement < last_element; ielement++) {
+    for (ientry = graph->offsets[ielement];
+         ientry < graph->offsets[ielement + 1]; ientry++) {
+      neighbor = graph->adjacent[ientry];
+      if (neighbor < graph->num_local && neighbor / block_size != unit
+          && unit_colors[neighbor / block_size] >= 0) {
+        marks[unit_colors[neighbor / block_size]] = stamp;
+      }
+      if (type == T8_COLORING_FACE_NEIGHBORS) {
+        /* The neighbors of the neighbor, which may be a ghost */
+        for (jentry = graph->offsets[neighbor];
+             jentry < graph->offsets[neighbor + 1]; jentry++) {
+          second_neighbor = graph->adjacent[jentry];
+          if (second_neighbor < graph->num_local
+              && second_neighbor / block_size != unit
+              && unit_colors[second_neighbor / block_size] >= 0) {
+            marks[unit_colors[second_neighbor / block_size]] = stamp;
+          }
+        }
+      }
+    }
+  }
+}
+
+/* Color all units with a negative color greedily in ascending order.
+ * Before, the color of each colored unit that conflicts with a colored unit
+ * of lower index or that is not smaller than num_units is removed. */
+static void
+t8_forest_coloring_greedy (const t8_forest_coloring_graph_t * graph,
+                           t8_coloring_type_t type, t8_locidx_t block_size,
+                           t8_locidx_t num_units, int *unit_colors)
+{
+  t8_locidx_t         iunit;
+  int                *marks, stamp = 0, color;
+
+  /* Since each unit gets the smallest color that is not used by a
+   * conflicting unit, there are at most num_units colors. */
+  marks = T8_ALLOC_ZERO (int, num_units + 1);
+  for (iunit = 0; iunit < num_units; iunit++) {
+    if (unit_colors[iunit] >= num_units) {
+      unit_colors[iunit] = -1;
+    }
+  }
+  for (iunit = 0; iunit < num_units; iunit++) {
+    if (unit_colors[iunit] >= 0) {
+      t8_forest_coloring_mark_conflicts (graph, type, block_size, iunit,
+                                         unit_colors, marks, ++stamp);
+      if (marks[unit_colors[iunit]] == stamp) {
+        unit_colors[iunit] = -1;
+      }
+    }
+  }
+  for (iunit = 0; iunit < num_units; iunit++) {
+    if (unit_colors[iunit] < 0) {
+      t8_forest_coloring_mark_conflicts (graph, type, block_size, iunit,
+                                         unit_colors, marks, ++stamp);
+      for (color = 0; marks[color] == stamp; color++) {
+      }
+      unit_colors[iunit] = color;
+    }
+  }
+  T8_FREE (marks);
+}
+
+/* Store the color of each unit as ranges of elements in the coloring.
+ * Colors that are not used are removed. */
+static void
+t8_forest_coloring_build_ranges (t8_forest_coloring_t * coloring,
+                                 t8_locidx_t num_units,
+                                 const int *unit_colors)
+{
+  t8_locidx_t         iunit, *last_unit, *num_ranges, range;
+  int                 max_colors, color, *color_ids;
+
+  max_colors = 0;
+  for (iunit = 0; iunit < num_units; iunit++) {
+    max_colors = SC_MAX (max_colors, unit_colors[iunit] + 1);
+  }
+  /* Count the ranges of each color. A range ends if the next unit
+   * has a different color. */
+  last_unit = T8_ALLOC (t8_locidx_t, max_colors);
+  num_ranges = T8_ALLOC_ZERO (t8_locidx_t, max_colors);
+  for (color = 0; color < max_colors; color++) {
+    last_unit[color] = -2;
+  }
+  for (iunit = 0; iunit < num_units; iunit++) {
+    color = unit_colors[iunit];
+    if (last_unit[color] != iunit - 1) {
+      num_ranges[color]++;
+    }
+    last_unit[color] = iunit;
+  }
+  /* Renumber the used colors */
+  color_ids = T8_ALLOC (int, max_colors);
+  coloring->num_colors = 0;
+  for (color = 0; color < max_colors; color++) {
+    color_ids[color] = num_ranges[color] > 0 ? coloring->num_colors++ : -1;
+  }
+  coloring->color_offsets = T8_ALLOC (t8_locidx_t, coloring->num_colors + 1);
+  coloring->color_offsets[0] = 0;
+  for (color = 0; color < max_colors; color++) {
+    if (color_ids[color] >= 0) {
+      coloring->color_offsets[color_ids[color] + 1] =
+        coloring->color_offsets[color_ids[color]] + num_ranges[color];
+      /* From now on num_ranges is the position of the next range */
+      num_ranges[color] = coloring->color_offsets[color_ids[color]];
+    }
+    last_unit[color] = -2;
+  }
+  coloring->ranges =
+    T8_ALLOC (t8_locidx_t, 2 * coloring->color_offsets[coloring->num_colors]);
+  for (iunit = 0; iunit < num_units; iunit++) {
+    color = unit_colors[iunit];
+    if (last_unit[color] != iunit - 1) {
+      range = num_ranges[color]++;
+      coloring->ranges[2 * range] = iunit * coloring->block_size;
+    }
+    else {
+      range = num_ranges[color] - 1;
+    }
+    coloring->ranges[2 * range + 1] =
+      SC_MIN ((iunit + 1) * coloring->block_size, coloring->num_elements);
+    last_unit[color] = iunit;
+  }
+
+  T8_FREE (last_unit);
+  T8_FREE (num_ranges);
+  T8_FREE (color_ids);
+}
+
+/* Color the units of a coloring, starting from the given unit colors */
+static void
+t8_forest_coloring_fill (t8_forest_t forest, t8_forest_coloring_t * coloring,
+                         int *unit_colors)
+{
+  t8_forest_coloring_graph_t graph;
+  t8_locidx_t         num_units;
+
+  num_units = (coloring->num_elements + coloring->block_size - 1)
+    / coloring->block_size;
+  t8_forest_coloring_graph_init (forest, &graph);
+  T8_ASSERT (graph.num_local == coloring->num_elements);
+  t8_forest_coloring_greedy (&graph, coloring->type, coloring->block_size,
+                             num_units, unit_colors);
+  t8_forest_coloring_build_ranges (coloring, num_units, unit_colors);
+  t8_forest_coloring_graph_reset (&graph);
+}
+
+/* Compute the local face neighbors of the elements with wave[ielement] equal
+ * to iwave and append them to entries. Ghost neighbors are ignored.
+ * If mark_next is true, the neighbors that have no wave yet get the next one.
+ * \param [in] forest        A committed forest.
+ * \param [in,out] wave      For each local element its wave or 0.
+ * \param [in] iwave         The wave whose rows are computed.
+ * \param [in] mark_next     Whether the neighbors are scheduled for the
+ *                           next wave.
+ * \param [out] row_start    For each element of the wave the position of its
+ *                           row in entries.
+ * \param [out] row_count    For each element of the wave the length of its
+ *                           row.
+ * \param [in,out] entries   Array of t8_locidx_t, the rows are appended.
+ */
+static void
+t8_forest_coloring_rows (t8_forest_t forest, int8_t * wave, int iwave,
+                         int mark_next, t8_locidx_t * row_start,
+                         t8_locidx_t * row_count, sc_array_t * entries)
+{
+  t8_locidx_t         itree, ielement, num_elements_in_tree, irow;
+  t8_locidx_t         num_local, neighbor, *neighbor_indices;
+  t8_element_t       *element, **neighbors;
+  t8_eclass_scheme_c *ts, *neigh_scheme;
+  int                 iface, num_faces, ineigh, num_neighbors;
+  int                *dual_faces;
+
+  num_local = t8_forest_get_local_num_elements (forest);
+  irow = 0;
+  for (itree = 0; itree < t8_forest_get_num_local_trees (forest); itree++) {
+    ts = t8_forest_get_eclass_scheme (forest,
+                                      t8_forest_get_tree_class (forest,
+                                                                itree));
+    num_elements_in_tree = t8_forest_get_tree_num_elements (forest, itree);
+    for (ielement = 0; ielement < num_elements_in_tree; ielement++, irow++) {
+      if (wave[irow] != iwave) {
+        continue;
+      }
+      element = t8_forest_get_element_in_tree (forest, itree, ielement);
+      row_start[irow] = (t8_locidx_t) entries->elem_count;
+      num_faces = ts->t8_element_num_faces (element);
+      for (iface = 0; iface < num_faces; iface++) {
+        t8_forest_leaf_face_neighbors (forest, itree, element, &neighbors,
+                                       iface, &dual_faces, &num_neighbors,
+                                       &neighbor_indices, &neigh_scheme, 1);
+        if (num_neighbors == 0) {
+          /* This is a boundary face */
+          continue;
+        }
+        for (ineigh = 0; ineigh < num_neighbors; ineigh++) {
+          neighbor = neighbor_indices[ineigh];
+          /* An element can be its own neighbor for periodic trees */
+          if (neighbor >= num_local || neighbor == irow) {
+            continue;
+          }
+          *(t8_locidx_t *) sc_array_push (entries) = neighbor;
+          if (mark_next && wave[neighbor] == 0) {
+            wave[neighbor] = iwave + 1;
+          }
+        }
+        neigh_scheme->t8_element_destroy (num_neighbors, neighbors);
+        T8_FREE (neighbors);
+        T8_FREE (dual_faces);
+        T8_FREE (neighbor_indices);
+      }
+      row_count[irow] = (t8_locidx_t) entries->elem_count - row_start[irow];
+    }
+  }
+}
+
+/* Color the elements of a coloring with block size 1 that have a negative
+ * color, without computing the whole adjacency graph.
+ * Two unchanged elements are adjacent in the new forest if and only if they
+ * were adjacent in the old forest. Thus, an element that keeps its color can
+ * only come into conflict through a new common neighbor, which is only
+ * possible for T8_COLORING_FACE_NEIGHBORS. We compute the rows of the
+ * uncolored elements in the first wave. For T8_COLORING_FACE_NEIGHBORS,
+ * their neighbors are checked for conflicts as well, and the conflicts of an
+ * element depend on the rows of its neighbors. Thus, we add the rows of the
+ * neighbors in the second and of their neighbors in the third wave.
+ * Since ghost neighbors are ignored, the forest must not be partitioned
+ * for T8_COLORING_FACE_NEIGHBORS. */
+static void
+t8_forest_coloring_fill_changed (t8_forest_t forest,
+                                 t8_forest_coloring_t * coloring,
+                                 int *colors)
+{
+  t8_forest_coloring_graph_t graph;
+  t8_locidx_t         num_elements, ielement, *row_start, *row_count;
+  sc_array_t          entries;
+  int8_t             *wave;
+  int                 iwave, num_waves;
+
+  T8_ASSERT (coloring->block_size == 1);
+  T8_ASSERT (coloring->type == T8_COLORING_FACES || forest->mpisize == 1);
+  num_elements = coloring->num_elements;
+  num_waves = coloring->type == T8_COLORING_FACE_NEIGHBORS ? 3 : 1;
+  wave = T8_ALLOC_ZERO (int8_t, num_elements);
+  row_start = T8_ALLOC_ZERO (t8_locidx_t, num_elements);
+  row_count = T8_ALLOC_ZERO (t8_locidx_t, num_elements);
+  for (ielement = 0; ielement < num_elements; ielement++) {
+    if (colors[ielement] < 0) {
+      wave[ielement] = 1;
+    }
+  }
+  sc_array_init (&entries, sizeof (t8_locidx_t));
+  for (iwave = 1; iwave <= num_waves; iwave++) {
+    t8_forest_coloring_rows (forest, wave, iwave, iwave < num_waves,
+                             row_start, row_count, &entries);
+  }
+
+  /* Store the rows as a graph without ghosts. The rows of the elements
+   * that were not needed stay empty. */
+  graph.num_local = num_elements;
+  graph.num_ghosts = 0;
+  graph.offsets = T8_ALLOC (t8_locidx_t, num_elements + 1);
+  graph.adjacent = T8_ALLOC (t8_locidx_t, entries.elem_count);
+  graph.offsets[0] = 0;
+  for (ielement = 0; ielement < num_elements; ielement++) {
+    if (row_count[ielement] > 0) {
+      memcpy (graph.adjacent + graph.offsets[ielement],
+              t8_sc_array_index_locidx (&entries, row_start[ielement]),
+              row_count[ielement] * sizeof (t8_locidx_t));
+    }
+    graph.offsets[ielement + 1] =
+      graph.offsets[ielement] + row_count[ielement];
+  }
+  t8_forest_coloring_greedy (&graph, coloring->type, 1, num_elements,
+                             colors);
+  t8_forest_coloring_build_ranges (coloring, num_elements, colors);
+
+  t8_forest_coloring_graph_reset (&graph);
+  sc_array_reset (&entries);
+  T8_FREE (wave);
+  T8_FREE (row_start);
+  T8_FREE (row_count);
+}
+
+void
+t8_forest_coloring_compute (t8_forest_t forest, t8_coloring_type_t type,
+                            t8_locidx_t block_size,
+                            t8_forest_coloring_t * coloring)
+{
+  t8_locidx_t         num_units, iunit;
+  int                *unit_colors;
+
+  T8_ASSERT (t8_forest_is_committed (forest));
+  T8_ASSERT (block_size > 0);
+  T8_ASSERT (coloring != NULL);
+
+  coloring->type = type;
+  coloring->block_size = block_size;
+  coloring->num_elements = t8_forest_get_local_num_elements (forest);
+  num_units = (coloring->num_elements + block_size - 1) / block_size;
+  unit_colors = T8_ALLOC (int, num_units);
+  for (iunit = 0; iunit < num_units; iunit++) {
+    unit_colors[iunit] = -1;
+  }
+  t8_forest_coloring_fill (forest, coloring, unit_colors);
+  T8_FREE (unit_colors);
+  t8_debugf ("Colored %li elements in blocks of %li with %i colors.\n",
+             (long) coloring->num_elements, (long) block_size,
+             coloring->num_colors);
+}
+
+void
+t8_forest_coloring_update (t8_forest_t forest_new, t8_forest_t forest_old,
+                           const t8_forest_coloring_t * coloring_old,
+                           t8_forest_coloring_t * coloring_new)
+{
+  t8_locidx_t         itree, num_local_trees;
+  t8_locidx_t         ielem_new, ielem_old, offset_new, offset_old;
+  t8_locidx_t         elems_per_tree_new, elems_per_tree_old, num_kept = 0;
+  t8_element_t       *elem_new, *elem_old;
+  t8_eclass_scheme_c *ts;
+  int                *colors_old, *colors_new, cmp;
+
+  T8_ASSERT (t8_forest_is_committed (forest_new));
+  T8_ASSERT (t8_forest_is_committed (forest_old));
+  T8_ASSERT (coloring_old != NULL && coloring_new != NULL);
+  T8_ASSERT (coloring_old->num_elements ==
+             t8_forest_get_local_num_elements (forest_old));
+
+  if (coloring_old->block_size > 1) {
+    /* The blocks are not preserved by adaptation */
+    t8_forest_coloring_compute (forest_new, coloring_old->type,
+                                coloring_old->block_size, coloring_new);
+    return;
+  }
+
+  colors_old = T8_ALLOC (int, coloring_old->num_elements);
+  t8_forest_coloring_element_colors (coloring_old, colors_old);
+  coloring_new->type = coloring_old->type;
+  coloring_new->block_size = 1;
+  coloring_new->num_elements = t8_forest_get_local_num_elements (forest_new);
+  colors_new = T8_ALLOC (int, coloring_new->num_elements);
+
+  /* Traverse the elements of both forests in parallel. An element of the
+   * new forest keeps its color if it is also an element of the old forest.
+   * Since the elements of a tree are ordered, we skip the old elements
+   * that come before the current new element. */
+  num_local_trees = t8_forest_get_num_local_trees (forest_new);
+  T8_ASSERT (num_local_trees == t8_forest_get_num_local_trees (forest_old));
+  offset_new = offset_old = 0;
+  for (itree = 0; itree < num_local_trees; itree++) {
+    T8_ASSERT (t8_forest_get_tree_class (forest_new, itree) ==
+               t8_forest_get_tree_class (forest_old, itree));
+    ts = t8_forest_get_eclass_scheme (forest_new,
+                                      t8_forest_get_tree_class (forest_new,
+                                                                itree));
+    elems_per_tree_new = t8_forest_get_tree_num_elements (forest_new, itree);
+    elems_per_tree_old = t8_forest_get_tree_num_elements (forest_old, itree);
+    ielem_old = 0;
+    for (ielem_new = 0; ielem_new < elems_per_tree_new; ielem_new++) {
+      elem_new = t8_forest_get_element_in_tree (forest_new, itree, ielem_new);
+      colors_new[offset_new + ielem_new] = -1;
+      cmp = -1;
+      while (ielem_old < elems_per_tree_old && cmp < 0) {
+        elem_old =
+          t8_forest_get_element_in_tree (forest_old, itree, ielem_old);
+        cmp = ts->t8_element_compare (elem_old, elem_new);
+        if (cmp < 0) {
+          ielem_old++;
+        }
+      }
+      if (cmp == 0) {
+        /* The element did not change */
+        colors_new[offset_new + ielem_new] =
+          colors_old[offset_old + ielem_old];
+        num_kept++;
+        ielem_old++;
+      }
+    }
+    offset_new += elems_per_tree_new;
+    offset_old += elems_per_tree_old;
+  }
+
+  if (coloring_new->type == T8_COLORING_FACE_NEIGHBORS
+      && forest_new->mpisize > 1) {
+    /* A changed ghost can be a new common neighbor of two unchanged local
+     * elements. Only the whole adjacency graph has all local neighbors of
+     * the ghosts, thus we check all elements in t8_forest_coloring_greedy. */
+    t8_forest_coloring_fill (forest_new, coloring_new, colors_new);
+  }
+  else {
+    t8_forest_coloring_fill_changed (forest_new, coloring_new, colors_new);
+  }
+  T8_FREE (colors_old);
+  T8_FREE (colors_new);
+  t8_debugf ("Updated coloring of %li elements with %i colors. "
+             "%li elements were not changed.\n",
+             (long) coloring_new->num_elements, coloring_new->num_colors,
+             (long) num_kept);
+}
+
+void
+t8_forest_coloring_element_colors (const t8_forest_coloring_t * coloring,
+                                   int *colors)
+{
+  t8_locidx_t         irange, ielement;
+  int                 color;
+
+  T8_ASSERT (coloring != NULL);
+  for (color = 0; color < coloring->num_colors; color++) {
+    for (irange = coloring->color_offsets[color];
+         irange < coloring->color_offsets[color + 1]; irange++) {
+      for (ielement = coloring->ranges[2 * irange];
+           ielement < coloring->ranges[2 * irange + 1]; ielement++) {
+        colors[ielement] = color;
+      }
+    }
+  }
+}
+
+void
+t8_forest_coloring_reset (t8_forest_coloring_t * coloring)
+{
+  T8_ASSERT (coloring != NULL);
+
+  T8_FREE (coloring->color_offsets);
+  T8_FREE (coloring->ranges);
+  coloring->color_offsets = NULL;
+  coloring->ranges = NULL;
+  coloring->num_colors = 0;
+  coloring->num_elements = 0;
+}
+
+T8_EXTERN_C_END ();
@@ -33,6 +33,7 @@
 #include <t8_element_cxx.hxx>
 #include <t8_cmesh/t8_cmesh_trees.h>
 #include <t8_cmesh/t8_cmesh_offset.h>
+#include <t8_cmesh_readmshfile.h>
 
 /* We want to export the whole implementation to be callable from "C" */
 T8_EXTERN_C_BEGIN ();
@@ -261,7 +262,7 @@ t8_forest_element_coordinate (t8_forest_t forest, t8_locidx_t ltree_id,
     /* A vertex has exactly one corner, and we already know its coordinates, since they are
      * the same as the trees coordinates. */
     for (i = 0; i < 3; i++) {
-      coordinates[i] = corner_coords[i];
+      coordinates[i] = vertices[i];
     }
     break;
   case T8_ECLASS_LINE:
@@ -1468,6 +1469,28 @@ t8_forest_copy_trees (t8_forest_t forest, t8_forest_t from, int copy_elements)
   }
 }
 
+void
+t8_forest_take_trees (t8_forest_t forest, t8_forest_t from)
+{
+  T8_ASSERT (forest != NULL);
+  T8_ASSERT (from != NULL);
+  T8_ASSERT (!forest->committed);
+  T8_ASSERT (from->committed);
+  T8_ASSERT (forest->trees == NULL);
+
+  if (!t8_refcount_is_last (&from->rc)) {
+    t8_forest_copy_trees (forest, from, 1);
+    return;
+  }
+  /* from is destroyed when forest releases it, we move its trees */
+  forest->trees = from->trees;
+  from->trees = sc_array_new (sizeof (t8_tree_struct_t));
+  forest->first_local_tree = from->first_local_tree;
+  forest->last_local_tree = from->last_local_tree;
+  forest->local_num_elements = from->local_num_elements;
+  forest->global_num_elements = from->global_num_elements;
+}
+
 /* Search for a linear element id (at forest->maxlevel) in a sorted array of
  * elements. If the element does not exist, return the largest index i
  * such that the element at position i has a smaller id than the given one.
@@ -1567,6 +1590,34 @@ t8_forest_element_neighbor_eclass (t8_forest_t forest,
   }
 }
 
+int
+t8_forest_element_boundary_tag (t8_forest_t forest, t8_locidx_t ltreeid,
+                                const t8_element_t * elem, int face)
+{
+  t8_eclass_scheme_c *ts;
+  t8_cmesh_t          cmesh;
+  t8_locidx_t         lctreeid;
+  int                 tree_face;
+
+  T8_ASSERT (t8_forest_is_committed (forest));
+  ts = t8_forest_get_eclass_scheme (forest,
+                                    t8_forest_get_tree_class (forest,
+                                                              ltreeid));
+  if (!ts->t8_element_is_root_boundary (elem, face)) {
+    /* The face lies inside the tree */
+    return -1;
+  }
+  tree_face = ts->t8_element_tree_face (elem, face);
+  cmesh = t8_forest_get_cmesh (forest);
+  lctreeid = t8_forest_ltreeid_to_cmesh_ltreeid (forest, ltreeid);
+  if (!t8_cmesh_tree_face_is_boundary (cmesh, lctreeid, tree_face)) {
+    /* The face lies at an inner tree boundary */
+    return -1;
+  }
+  return t8_cmesh_msh_get_tree_face_boundary_tag (cmesh, lctreeid,
+                                                  tree_face);
+}
+
 t8_gloidx_t
 t8_forest_element_face_neighbor (t8_forest_t forest,
                                  t8_locidx_t ltreeid,
@@ -2955,4 +3006,133 @@ t8_forest_element_has_leaf_desc (t8_forest_t forest, t8_gloidx_t gtreeid,
   return 0;
 }
 
+/* The number of bits by which a linear id at \a level has to be shifted
+ * to obtain the linear id of the first descendant at the maximum level.
+ * Returns -1 if the element class does not have 2^dim children or if the
+ * scheme is anisotropic, since then the linear id does not determine the
+ * levels of an element along its axes. */
+static int
+t8_forest_element_keys_shift (t8_eclass_scheme_c * ts, t8_eclass_t eclass,
+                              int level)
+{
+  if (eclass == T8_ECLASS_PYRAMID || ts->t8_element_is_anisotropic ()) {
+    return -1;
+  }
+  return t8_eclass_to_dimension[eclass] * (ts->t8_element_maxlevel () -
+                                           level);
+}
+
+/* Write an unsigned integer as variable length integer with 7 bits
+ * per byte. If buffer is NULL, only count the bytes. */
+static size_t
+t8_forest_element_keys_write_uint (uint64_t value, char *buffer)
+{
+  size_t              num_bytes = 0;
+
+  do {
+    unsigned char       byte = (unsigned char) (value & 0x7f);
+
+    value >>= 7;
+    if (value != 0) {
+      byte |= 0x80;
+    }
+    if (buffer != NULL) {
+      buffer[num_bytes] = (char) byte;
+    }
+    num_bytes++;
+  } while (value != 0);
+  return num_bytes;
+}
+
+size_t
+t8_forest_element_keys_encode (t8_eclass_scheme_c * ts,
+                               t8_element_array_t * elements,
+                               t8_locidx_t first, t8_locidx_t count,
+                               char *buffer)
+{
+  const t8_element_t *element;
+  t8_locidx_t         ielem;
+  uint64_t            key, prev_key = 0, delta;
+  int64_t             signed_delta;
+  size_t              num_bytes = 0;
+  int                 level, shift;
+
+  T8_ASSERT (first >= 0 && count >= 0);
+  T8_ASSERT ((size_t) (first + count) <=
+             t8_element_array_get_count (elements));
+  if (count == 0) {
+    return 0;
+  }
+  if (t8_forest_element_keys_shift (ts, ts->eclass, 0) < 0) {
+    /* Fall back to the raw element data */
+    num_bytes = count * ts->t8_element_size ();
+    if (buffer != NULL) {
+      memcpy (buffer, t8_element_array_index_locidx (elements, first),
+              num_bytes);
+    }
+    return num_bytes;
+  }
+  for (ielem = first; ielem < first + count; ielem++) {
+    element = t8_element_array_index_locidx (elements, ielem);
+    level = ts->t8_element_level (element);
+    shift = t8_forest_element_keys_shift (ts, ts->eclass, level);
+    key = (uint64_t) ts->t8_element_get_linear_id (element, level) << shift;
+    /* The elements are usually sorted, such that the delta is small and
+     * positive. We zigzag encode it to also support unsorted elements. */
+    signed_delta = (int64_t) (key - prev_key);
+    delta = ((uint64_t) signed_delta << 1) ^ (uint64_t) (signed_delta >> 63);
+    prev_key = key;
+    if (buffer != NULL) {
+      buffer[num_bytes] = (char) level;
+    }
+    num_bytes++;
+    num_bytes += t8_forest_element_keys_write_uint (delta, buffer == NULL ?
+                                                    NULL : buffer +
+                                                    num_bytes);
+  }
+  return num_bytes;
+}
+
+size_t
+t8_forest_element_keys_decode (t8_eclass_scheme_c * ts, const char *buffer,
+                               t8_element_array_t * elements,
+                               t8_locidx_t first, t8_locidx_t count)
+{
+  t8_element_t       *element;
+  t8_locidx_t         ielem;
+  uint64_t            key = 0, delta;
+  size_t              num_bytes = 0;
+  unsigned char       byte;
+  int                 level, shift, bit;
+
+  T8_ASSERT (first >= 0 && count >= 0);
+  T8_ASSERT ((size_t) (first + count) <=
+             t8_element_array_get_count (elements));
+  if (count == 0) {
+    return 0;
+  }
+  if (t8_forest_element_keys_shift (ts, ts->eclass, 0) < 0) {
+    num_bytes = count * ts->t8_element_size ();
+    memcpy (t8_element_array_index_locidx (elements, first), buffer,
+            num_bytes);
+    return num_bytes;
+  }
+  for (ielem = first; ielem < first + count; ielem++) {
+    level = (unsigned char) buffer[num_bytes++];
+    delta = 0;
+    bit = 0;
+    do {
+      byte = (unsigned char) buffer[num_bytes++];
+      delta |= (uint64_t) (byte & 0x7f) << bit;
+      bit += 7;
+    } while (byte & 0x80);
+    /* Undo the zigzag encoding */
+    key += (delta >> 1) ^ (~(delta & 1) + 1);
+    shift = t8_forest_element_keys_shift (ts, ts->eclass, level);
+    element = t8_element_array_index_locidx (elements, ielem);
+    ts->t8_element_set_linear_id (element, level, key >> shift);
+  }
+  return num_bytes;
+}
+
 T8_EXTERN_C_END ();
@@ -0,0 +1,637 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#include <t8_forest_extrude.h>
+#include <t8_cmesh_vtk.h>
+#include <t8_element_cxx.hxx>
+#include <t8_forest/t8_forest_types.h>
+#include <t8_forest/t8_forest_private.h>
+
+/* We want to export the whole implementation to be callable from "C" */
+T8_EXTERN_C_BEGIN ();
+
+/* The number of entries in the partition info of a process:
+ * The global ids of the first and last local tree, the number of elements
+ * in these trees and the number of extruded elements. */
+#define T8_EXTRUDE_INFO_SIZE 5
+
+/* The state of the construction of the extruded elements of one layer tree */
+typedef struct
+{
+  t8_eclass_scheme_c *ts;       /* The scheme of the two dimensional elements */
+  t8_eclass_scheme_c *column_ts;        /* The scheme of the extruded elements */
+  t8_element_array_t *leaves;   /* All two dimensional elements of the tree */
+  t8_gloidx_t         position; /* The global index of the next extruded element */
+  t8_gloidx_t         first_position;   /* The first global index to keep */
+  t8_gloidx_t         end_position;     /* The first global index not to keep */
+  t8_element_array_t *elements; /* The extruded elements that are kept */
+} t8_forest_extrude_context_t;
+
+/* Return the class of the extrusion of a tree class */
+static              t8_eclass_t
+t8_forest_extrude_eclass (t8_eclass_t eclass)
+{
+  switch (eclass) {
+  case T8_ECLASS_TRIANGLE:
+    return T8_ECLASS_PRISM;
+  case T8_ECLASS_QUAD:
+    return T8_ECLASS_HEX;
+  default:
+    SC_ABORT ("Only triangles and quadrilaterals can be extruded.");
+  }
+  return T8_ECLASS_COUNT;
+}
+
+/* Find the face of a tree class that has exactly the given tree vertices */
+static int
+t8_forest_extrude_find_face (t8_eclass_t eclass, const int *vertices,
+                             int num_vertices)
+{
+  int                 iface, iv, jv, found;
+
+  for (iface = 0; iface < t8_eclass_num_faces[eclass]; iface++) {
+    if (t8_eclass_num_vertices[t8_eclass_face_types[eclass][iface]]
+        != num_vertices) {
+      continue;
+    }
+    found = 0;
+    for (iv = 0; iv < num_vertices; iv++) {
+      for (jv = 0; jv < num_vertices; jv++) {
+        if (t8_face_vertex_to_tree_vertex[eclass][iface][jv] == vertices[iv]) {
+          found++;
+          break;
+        }
+      }
+    }
+    if (found == num_vertices) {
+      return iface;
+    }
+  }
+  SC_ABORT_NOT_REACHED ();
+  return -1;
+}
+
+/* Compute the orientation of a connection of face_a of a tree of class
+ * class_a with face_b of a tree of class class_b. The vertices of both
+ * faces are given by keys, such that matching vertices have equal keys.
+ * As in the forest, the orientation is the position of the first vertex of
+ * the smaller face in the bigger face. The smaller face is the face of the
+ * smaller tree class or, for equal classes, the face with smaller number. */
+static int
+t8_forest_extrude_orientation (t8_eclass_t class_a, int face_a,
+                               const int *keys_a, t8_eclass_t class_b,
+                               int face_b, const int *keys_b)
+{
+  const int          *keys_smaller, *keys_bigger;
+  t8_eclass_t         bigger_face_class;
+  int                 compare, iv;
+
+  compare = t8_eclass_compare (class_a, class_b);
+  if (compare > 0 || (compare == 0 && face_a > face_b)) {
+    keys_smaller = keys_b;
+    keys_bigger = keys_a;
+    bigger_face_class = (t8_eclass_t) t8_eclass_face_types[class_a][face_a];
+  }
+  else {
+    keys_smaller = keys_a;
+    keys_bigger = keys_b;
+    bigger_face_class = (t8_eclass_t) t8_eclass_face_types[class_b][face_b];
+  }
+  for (iv = 0; iv < t8_eclass_num_vertices[bigger_face_class]; iv++) {
+    if (keys_bigger[iv] == keys_smaller[0]) {
+      return iv;
+    }
+  }
+  SC_ABORT_NOT_REACHED ();
+  return -1;
+}
+
+/* Compute the face of the extrusion of a tree of class eclass that is the
+ * extrusion of a face of the tree, and the keys of its vertices.
+ * The key of a vertex is 2 * z + k, where z is 0 for the bottom and 1 for
+ * the top vertices and k the position of the vertex in the face of the
+ * tree, exchanged if flip is true. */
+static int
+t8_forest_extrude_side_face (t8_eclass_t eclass, int face, int flip,
+                             int *keys)
+{
+  const t8_eclass_t   column_class = t8_forest_extrude_eclass (eclass);
+  const int           num_vertices = t8_eclass_num_vertices[eclass];
+  int                 vertices[4], side_face, iv, vertex;
+
+  vertices[0] = t8_face_vertex_to_tree_vertex[eclass][face][0];
+  vertices[1] = t8_face_vertex_to_tree_vertex[eclass][face][1];
+  vertices[2] = vertices[0] + num_vertices;
+  vertices[3] = vertices[1] + num_vertices;
+  side_face = t8_forest_extrude_find_face (column_class, vertices, 4);
+  for (iv = 0; iv < 4; iv++) {
+    vertex = t8_face_vertex_to_tree_vertex[column_class][side_face][iv];
+    keys[iv] = 2 * (vertex / num_vertices)
+      + ((vertex % num_vertices == vertices[0] ? 0 : 1) ^ flip);
+  }
+  return side_face;
+}
+
+/* Compute the bottom or top face of the extrusion of a tree of class
+ * eclass and the keys of its vertices, which are the vertices of the tree. */
+static int
+t8_forest_extrude_cap_face (t8_eclass_t eclass, int top, int *keys)
+{
+  const t8_eclass_t   column_class = t8_forest_extrude_eclass (eclass);
+  const int           num_vertices = t8_eclass_num_vertices[eclass];
+  int                 vertices[T8_ECLASS_MAX_CORNERS_2D], cap_face, iv;
+
+  for (iv = 0; iv < num_vertices; iv++) {
+    vertices[iv] = iv + top * num_vertices;
+  }
+  cap_face = t8_forest_extrude_find_face (column_class, vertices,
+                                          num_vertices);
+  for (iv = 0; iv < num_vertices; iv++) {
+    keys[iv] = t8_face_vertex_to_tree_vertex[column_class][cap_face][iv]
+      % num_vertices;
+  }
+  return cap_face;
+}
+
+/* Create the coarse mesh of the extrusion of a replicated cmesh. */
+static              t8_cmesh_t
+t8_forest_extrude_cmesh (t8_cmesh_t cmesh, int num_layers,
+                         const double *layer_z, sc_MPI_Comm comm)
+{
+  t8_cmesh_t          ecmesh;
+  t8_gloidx_t         num_trees, itree, gtree;
+  t8_locidx_t         neigh;
+  t8_eclass_t         eclass, neigh_class;
+  double             *vertices;
+  double              column_vertices[3 * T8_ECLASS_MAX_CORNERS];
+  int                 num_vertices, layer, iv, top, iface, dual_face;
+  int                 orientation, face_a, face_b;
+  int                 keys_a[T8_ECLASS_MAX_CORNERS_2D];
+  int                 keys_b[T8_ECLASS_MAX_CORNERS_2D];
+
+  num_trees = t8_cmesh_get_num_trees (cmesh);
+  t8_cmesh_init (&ecmesh);
+  for (itree = 0; itree < num_trees; itree++) {
+    eclass = t8_cmesh_get_tree_class (cmesh, (t8_locidx_t) itree);
+    num_vertices = t8_eclass_num_vertices[eclass];
+    vertices = t8_cmesh_get_tree_vertices (cmesh, (t8_locidx_t) itree);
+    face_a = t8_forest_extrude_cap_face (eclass, 1, keys_a);
+    face_b = t8_forest_extrude_cap_face (eclass, 0, keys_b);
+    orientation =
+      t8_forest_extrude_orientation (t8_forest_extrude_eclass (eclass),
+                                     face_a, keys_a,
+                                     t8_forest_extrude_eclass (eclass),
+                                     face_b, keys_b);
+    for (layer = 0; layer < num_layers; layer++) {
+      gtree = itree * num_layers + layer;
+      t8_cmesh_set_tree_class (ecmesh, gtree,
+                               t8_forest_extrude_eclass (eclass));
+      if (vertices != NULL) {
+        /* The bottom vertices of the layer, followed by the top vertices */
+        for (top = 0; top < 2; top++) {
+          for (iv = 0; iv < num_vertices; iv++) {
+            memcpy (column_vertices + 3 * (iv + top * num_vertices),
+                    vertices + 3 * iv, 3 * sizeof (double));
+            column_vertices[3 * (iv + top * num_vertices) + 2] +=
+              layer_z != NULL ? layer_z[layer + top]
+              : (double) (layer + top) / num_layers;
+          }
+        }
+        t8_cmesh_set_tree_vertices (ecmesh, (t8_locidx_t) gtree,
+                                    t8_get_package_id (), 0,
+                                    column_vertices, 2 * num_vertices);
+      }
+      if (layer > 0) {
+        /* Connect the top of the layer below to the bottom of this layer */
+        t8_cmesh_set_join (ecmesh, gtree - 1, gtree, face_a, face_b,
+                           orientation);
+      }
+    }
+  }
+  /* Connect the layers of neighboring columns */
+  for (itree = 0; itree < num_trees; itree++) {
+    eclass = t8_cmesh_get_tree_class (cmesh, (t8_locidx_t) itree);
+    for (iface = 0; iface < t8_eclass_num_faces[eclass]; iface++) {
+      if (t8_cmesh_tree_face_is_boundary (cmesh, (t8_locidx_t) itree,
+                                          iface)) {
+        continue;
+      }
+      neigh = t8_cmesh_get_face_neighbor (cmesh, (t8_locidx_t) itree, iface,
+                                          &dual_face, &orientation);
+      T8_ASSERT (neigh >= 0);
+      if (neigh < itree || (neigh == itree && dual_face <= iface)) {
+        /* This connection is set from the other side */
+        continue;
+      }
+      neigh_class = t8_cmesh_get_tree_class (cmesh, neigh);
+      /* The faces of the trees are lines, whose vertices are exchanged
+       * if the orientation is 1 */
+      face_a = t8_forest_extrude_side_face (eclass, iface, 0, keys_a);
+      face_b = t8_forest_extrude_side_face (neigh_class, dual_face,
+                                            orientation, keys_b);
+      orientation =
+        t8_forest_extrude_orientation (t8_forest_extrude_eclass (eclass),
+                                       face_a, keys_a,
+                                       t8_forest_extrude_eclass
+                                       (neigh_class), face_b, keys_b);
+      for (layer = 0; layer < num_layers; layer++) {
+        t8_cmesh_set_join (ecmesh, itree * num_layers + layer,
+                           (t8_gloidx_t) neigh * num_layers + layer,
+                           face_a, face_b, orientation);
+      }
+    }
+  }
+  t8_cmesh_commit (ecmesh, comm);
+  return ecmesh;
+}
+
+/* Return the number of extruded elements in a layer below an extruded
+ * element of a given level, whose projection contains the leaves
+ * [first, last). */
+static              t8_gloidx_t
+t8_forest_extrude_count (t8_eclass_scheme_c *ts, t8_element_array_t *leaves,
+                         size_t first, size_t last, int level)
+{
+  t8_gloidx_t         count = 0;
+  size_t              ileaf;
+
+  for (ileaf = first; ileaf < last; ileaf++) {
+    count += (t8_gloidx_t) 1 <<
+      (ts->t8_element_level (t8_element_array_index_locidx
+                             (leaves, (t8_locidx_t) ileaf)) - level);
+  }
+  return count;
+}
+
+/* Append the extruded elements below an extruded element, whose projection
+ * contains the leaves [first, last), to the elements of the context, in the
+ * order of the space filling curve. Only elements with a position in the
+ * range of the context are appended. The children of an extruded element
+ * are the children of its projection in the lower half, followed by these
+ * children in the upper half. */
+static void
+t8_forest_extrude_recursion (t8_forest_extrude_context_t *context,
+                             const t8_element_t *element, size_t first,
+                             size_t last)
+{
+  t8_eclass_scheme_c *ts = context->ts;
+  t8_element_t       *child, *leaf;
+  t8_gloidx_t         count;
+  size_t              bounds[T8_ECLASS_MAX_CORNERS_2D + 1];
+  int                 level, num_children, ichild, half;
+
+  level = context->column_ts->t8_element_level (element);
+  leaf = t8_element_array_index_locidx (context->leaves, (t8_locidx_t) first);
+  if (last - first == 1 && ts->t8_element_level (leaf) == level) {
+    /* The element is part of the column of this leaf */
+    if (context->first_position <= context->position
+        && context->position < context->end_position) {
+      context->column_ts->t8_element_copy (element,
+                                           t8_element_array_push
+                                           (context->elements));
+    }
+    context->position++;
+    return;
+  }
+  /* Split the leaves by the child of the projection that contains them */
+  num_children = ts->t8_element_num_children (leaf);
+  T8_ASSERT (2 * num_children ==
+             context->column_ts->t8_element_num_children (element));
+  bounds[0] = first;
+  for (ichild = 0; ichild < num_children; ichild++) {
+    bounds[ichild + 1] = bounds[ichild];
+    while (bounds[ichild + 1] < last
+           && ts->t8_element_ancestor_id (t8_element_array_index_locidx
+                                          (context->leaves,
+                                           (t8_locidx_t) bounds[ichild +
+                                                                1]),
+                                          level + 1) == ichild) {
+      bounds[ichild + 1]++;
+    }
+  }
+  T8_ASSERT (bounds[num_children] == last);
+
+  context->column_ts->t8_element_new (1, &child);
+  for (half = 0; half < 2; half++) {
+    for (ichild = 0; ichild < num_children; ichild++) {
+      if (bounds[ichild] == bounds[ichild + 1]) {
+        continue;
+      }
+      count = t8_forest_extrude_count (ts, context->leaves, bounds[ichild],
+                                       bounds[ichild + 1], level + 1);
+      if (context->position + count <= context->first_position
+          || context->position >= context->end_position) {
+        /* No element below this child is kept */
+        context->position += count;
+        continue;
+      }
+      context->column_ts->t8_element_child (element,
+                                            ichild + half * num_children,
+                                            child);
+      t8_forest_extrude_recursion (context, child, bounds[ichild],
+                                   bounds[ichild + 1]);
+    }
+  }
+  context->column_ts->t8_element_destroy (1, &child);
+}
+
+/* Collect all elements of the first and last local tree if these trees
+ * are shared with other processes.
+ * \param [in] forest     The two dimensional forest.
+ * \param [in] all_info   The partition info of all processes.
+ * \param [out] leaves    For the first and the last local tree, if it is
+ *                        shared, all its elements in their order.
+ * \param [out] is_shared For the first and the last local tree, true if
+ *                        it is shared and \a leaves was initialized.
+ *                        If there is only one local tree, it is the first.
+ * \param [out] num_below The number of elements of the first local tree
+ *                        on previous processes.
+ */
+static void
+t8_forest_extrude_shared_leaves (t8_forest_t forest,
+                                 const t8_gloidx_t *all_info,
+                                 t8_element_array_t leaves[2],
+                                 int is_shared[2], t8_locidx_t *num_below)
+{
+  t8_element_array_t *local;
+  t8_locidx_t         num_local_trees, below, above, offset, count;
+  const t8_gloidx_t  *info;
+  t8_gloidx_t         gtree;
+  sc_array_t          requests;
+  size_t              size;
+  int                 ishared, iproc, mpiret;
+
+  is_shared[0] = is_shared[1] = 0;
+  *num_below = 0;
+  num_local_trees = t8_forest_get_num_local_trees (forest);
+  sc_array_init (&requests, sizeof (sc_MPI_Request));
+  for (ishared = 0; ishared < 2 && ishared < num_local_trees; ishared++) {
+    local = t8_forest_get_tree_element_array (forest, ishared == 0 ? 0 :
+                                              num_local_trees - 1);
+    gtree = t8_forest_global_tree_id (forest, ishared == 0 ? 0 :
+                                      num_local_trees - 1);
+    size = t8_element_array_get_size (local);
+    /* Count the elements of this tree on previous and next processes */
+    below = above = 0;
+    for (iproc = forest->mpirank - 1; iproc >= 0; iproc--) {
+      info = all_info + iproc * T8_EXTRUDE_INFO_SIZE;
+      if (info[0] < 0) {
+        /* This process is empty */
+        continue;
+      }
+      if (info[1] != gtree) {
+        break;
+      }
+      below += info[3];
+    }
+    for (iproc = forest->mpirank + 1; iproc < forest->mpisize; iproc++) {
+      info = all_info + iproc * T8_EXTRUDE_INFO_SIZE;
+      if (info[0] < 0) {
+        continue;
+      }
+      if (info[0] != gtree) {
+        break;
+      }
+      above += info[2];
+    }
+    if (below == 0 && above == 0) {
+      continue;
+    }
+    is_shared[ishared] = 1;
+    if (ishared == 0) {
+      *num_below = below;
+    }
+    count = (t8_locidx_t) t8_element_array_get_count (local);
+    t8_element_array_init_size (leaves + ishared,
+                                t8_element_array_get_scheme (local),
+                                below + count + above);
+    memcpy (t8_element_array_index_locidx (leaves + ishared, below),
+            t8_element_array_get_data (local), count * size);
+    /* Receive the elements of the other processes in their order and send
+     * them the local elements */
+    offset = below;
+    for (iproc = forest->mpirank - 1; offset > 0; iproc--) {
+      info = all_info + iproc * T8_EXTRUDE_INFO_SIZE;
+      if (info[0] < 0) {
+        continue;
+      }
+      offset -= (t8_locidx_t) info[3];
+      mpiret = sc_MPI_Irecv (t8_element_array_index_locidx
+                             (leaves + ishared, offset), info[3] * size,
+                             sc_MPI_BYTE, iproc, T8_MPI_EXTRUDE_FOREST,
+                             forest->mpicomm,
+                             (sc_MPI_Request *) sc_array_push (&requests));
+      SC_CHECK_MPI (mpiret);
+      mpiret = sc_MPI_Isend (t8_element_array_get_data (local), count * size,
+                             sc_MPI_BYTE, iproc, T8_MPI_EXTRUDE_FOREST,
+                             forest->mpicomm,
+                             (sc_MPI_Request *) sc_array_push (&requests));
+      SC_CHECK_MPI (mpiret);
+    }
+    offset = below + count;
+    for (iproc = forest->mpirank + 1; offset < below + count + above;
+         iproc++) {
+      info = all_info + iproc * T8_EXTRUDE_INFO_SIZE;
+      if (info[0] < 0) {
+        continue;
+      }
+      mpiret = sc_MPI_Irecv (t8_element_array_index_locidx
+                             (leaves + ishared, offset), info[2] * size,
+                             sc_MPI_BYTE, iproc, T8_MPI_EXTRUDE_FOREST,
+                             forest->mpicomm,
+                             (sc_MPI_Request *) sc_array_push (&requests));
+      SC_CHECK_MPI (mpiret);
+      mpiret = sc_MPI_Isend (t8_element_array_get_data (local), count * size,
+                             sc_MPI_BYTE, iproc, T8_MPI_EXTRUDE_FOREST,
+                             forest->mpicomm,
+                             (sc_MPI_Request *) sc_array_push (&requests));
+      SC_CHECK_MPI (mpiret);
+      offset += (t8_locidx_t) info[2];
+    }
+  }
+  mpiret = sc_MPI_Waitall ((int) requests.elem_count,
+                           (sc_MPI_Request *) requests.array,
+                           sc_MPI_STATUSES_IGNORE);
+  SC_CHECK_MPI (mpiret);
+  sc_array_reset (&requests);
+}
+
+t8_forest_t
+t8_forest_new_extrude (t8_forest_t forest, int num_layers,
+                       const double *layer_z)
+{
+  t8_forest_t         extruded;
+  t8_forest_extrude_context_t context;
+  t8_element_array_t  shared_leaves[2], *leaves;
+  t8_element_t       *root;
+  t8_tree_t           tree;
+  t8_cmesh_t          cmesh;
+  t8_locidx_t         num_local_trees, itree, ielement, num_below;
+  t8_gloidx_t         info[T8_EXTRUDE_INFO_SIZE], *all_info, *offsets;
+  t8_gloidx_t         num_columns, layer_count, position;
+  t8_eclass_t         column_class;
+  int                 is_shared[2], layer, level, iproc, mpiret;
+
+  T8_ASSERT (t8_forest_is_committed (forest));
+  SC_CHECK_ABORT (num_layers > 0, "The number of layers must be positive.");
+  SC_CHECK_ABORT (forest->dimension == 2,
+                  "Only two dimensional forests can be extruded.");
+  cmesh = t8_forest_get_cmesh (forest);
+  SC_CHECK_ABORT (!t8_cmesh_is_partitioned (cmesh),
+                  "Extrusion needs a replicated coarse mesh.");
+
+  /* Initialize the extruded forest with the extruded coarse mesh and
+   * the scheme and communicator of forest */
+  t8_forest_init (&extruded);
+  extruded->mpicomm = forest->do_dup ? t8_comm_pool_dup (forest->mpicomm)
+    : forest->mpicomm;
+  extruded->do_dup = forest->do_dup;
+  extruded->mpirank = forest->mpirank;
+  extruded->mpisize = forest->mpisize;
+  extruded->cmesh = t8_forest_extrude_cmesh (cmesh, num_layers, layer_z,
+                                             extruded->mpicomm);
+  t8_scheme_cxx_ref (forest->scheme_cxx);
+  extruded->scheme_cxx = forest->scheme_cxx;
+  extruded->dimension = 3;
+  t8_forest_compute_maxlevel (extruded);
+
+  /* Count the extruded elements of the local elements */
+  num_local_trees = t8_forest_get_num_local_trees (forest);
+  num_columns = 0;
+  for (itree = 0; itree < num_local_trees; itree++) {
+    leaves = t8_forest_get_tree_element_array (forest, itree);
+    num_columns +=
+      t8_forest_extrude_count (t8_element_array_get_scheme (leaves), leaves,
+                               0, t8_element_array_get_count (leaves), 0);
+    for (ielement = 0; ielement < t8_forest_get_tree_num_elements (forest,
+                                                                   itree);
+         ielement++) {
+      level = t8_element_array_get_scheme (leaves)->t8_element_level
+        (t8_element_array_index_locidx (leaves, ielement));
+      SC_CHECK_ABORT (level <= extruded->maxlevel,
+                      "Element level exceeds the maximum level of the "
+                      "extruded elements.");
+    }
+  }
+
+  /* Gather the partition info of all processes */
+  if (num_local_trees > 0) {
+    info[0] = t8_forest_global_tree_id (forest, 0);
+    info[1] = t8_forest_global_tree_id (forest, num_local_trees - 1);
+    info[2] = t8_forest_get_tree_num_elements (forest, 0);
+    info[3] = t8_forest_get_tree_num_elements (forest, num_local_trees - 1);
+  }
+  else {
+    info[0] = info[1] = -1;
+    info[2] = info[3] = 0;
+  }
+  info[4] = num_columns * num_layers;
+  all_info = T8_ALLOC (t8_gloidx_t, forest->mpisize * T8_EXTRUDE_INFO_SIZE);
+  mpiret = sc_MPI_Allgather (info, T8_EXTRUDE_INFO_SIZE, T8_MPI_GLOIDX,
+                             all_info, T8_EXTRUDE_INFO_SIZE, T8_MPI_GLOIDX,
+                             forest->mpicomm);
+  SC_CHECK_MPI (mpiret);
+  /* Each process keeps the number of elements of its columns */
+  offsets = T8_ALLOC (t8_gloidx_t, forest->mpisize + 1);
+  offsets[0] = 0;
+  for (iproc = 0; iproc < forest->mpisize; iproc++) {
+    offsets[iproc + 1] = offsets[iproc]
+      + all_info[iproc * T8_EXTRUDE_INFO_SIZE + 4];
+  }
+  t8_forest_extrude_shared_leaves (forest, all_info, shared_leaves,
+                                   is_shared, &num_below);
+
+  /* Construct the extruded elements of the local trees. The position
+   * of the first extruded element of the first local tree is the offset
+   * of this process minus the number of extruded elements of this tree
+   * on previous processes. */
+  extruded->trees = sc_array_new (sizeof (t8_tree_struct_t));
+  extruded->first_local_tree = 0;
+  extruded->last_local_tree = -1;
+  extruded->local_num_elements = 0;
+  position = offsets[forest->mpirank];
+  if (is_shared[0]) {
+    position -= num_layers *
+      t8_forest_extrude_count (t8_element_array_get_scheme (shared_leaves),
+                               shared_leaves, 0, num_below, 0);
+  }
+  context.first_position = offsets[forest->mpirank];
+  context.end_position = offsets[forest->mpirank + 1];
+  for (itree = 0; itree < num_local_trees; itree++) {
+    if (itree == 0 && is_shared[0]) {
+      leaves = shared_leaves;
+    }
+    else if (itree == num_local_trees - 1 && itree > 0 && is_shared[1]) {
+      leaves = shared_leaves + 1;
+    }
+    else {
+      leaves = t8_forest_get_tree_element_array (forest, itree);
+    }
+    context.ts = t8_element_array_get_scheme (leaves);
+    column_class = t8_forest_extrude_eclass (context.ts->eclass);
+    context.column_ts = extruded->scheme_cxx->eclass_schemes[column_class];
+    context.leaves = leaves;
+    layer_count = t8_forest_extrude_count (context.ts, leaves, 0,
+                                           t8_element_array_get_count
+                                           (leaves), 0);
+    context.column_ts->t8_element_new (1, &root);
+    context.column_ts->t8_element_set_linear_id (root, 0, 0);
+    for (layer = 0; layer < num_layers; layer++, position += layer_count) {
+      if (position + layer_count <= context.first_position
+          || position >= context.end_position) {
+        /* No element of this layer is kept */
+        continue;
+      }
+      tree = (t8_tree_t) sc_array_push (extruded->trees);
+      tree->eclass = column_class;
+      t8_element_array_init (&tree->elements, context.column_ts);
+      context.elements = &tree->elements;
+      context.position = position;
+      t8_forest_extrude_recursion (&context, root, 0,
+                                   t8_element_array_get_count (leaves));
+      T8_ASSERT (context.position == position + layer_count);
+      T8_ASSERT (t8_element_array_get_count (&tree->elements) > 0);
+      extruded->last_local_tree =
+        t8_forest_global_tree_id (forest, itree) * num_layers + layer;
+      if (extruded->trees->elem_count == 1) {
+        extruded->first_local_tree = extruded->last_local_tree;
+      }
+      extruded->local_num_elements +=
+        t8_element_array_get_count (&tree->elements);
+    }
+    context.column_ts->t8_element_destroy (1, &root);
+  }
+  T8_ASSERT (extruded->local_num_elements ==
+             offsets[forest->mpirank + 1] - offsets[forest->mpirank]);
+  t8_forest_commit_trees (extruded);
+
+  for (itree = 0; itree < 2; itree++) {
+    if (is_shared[itree]) {
+      t8_element_array_reset (shared_leaves + itree);
+    }
+  }
+  T8_FREE (offsets);
+  T8_FREE (all_info);
+  return extruded;
+}
+
+T8_EXTERN_C_END ();
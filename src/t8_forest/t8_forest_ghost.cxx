@@ -50,6 +50,7 @@ typedef struct
   t8_gloidx_t         global_id;        /* global id of the tree */
   t8_locidx_t         element_offset;   /* The count of all ghost elements in all smaller ghost trees */
   t8_element_array_t  elements; /* The ghost elements of that tree */
+  sc_array_t          global_ids;       /* The global element ids of the ghost elements */
   t8_eclass_t         eclass;   /* The trees element class */
 } t8_ghost_tree_t;
 
@@ -414,6 +415,23 @@ t8_element_t
   return t8_element_array_index_locidx (&ghost_tree->elements, lelement);
 }
 
+t8_gloidx_t
+t8_forest_ghost_get_global_element_id (t8_forest_t forest,
+                                       t8_locidx_t lghost_tree,
+                                       t8_locidx_t lelement)
+{
+  t8_ghost_tree_t    *ghost_tree;
+
+  T8_ASSERT (t8_forest_is_committed (forest));
+
+  ghost_tree = t8_forest_ghost_get_tree (forest, lghost_tree);
+  T8_ASSERT (0 <= lelement &&
+             lelement < t8_forest_ghost_tree_num_elements (forest,
+                                                           lghost_tree));
+  return *(t8_gloidx_t *) t8_sc_array_index_locidx (&ghost_tree->global_ids,
+                                                    lelement);
+}
+
 /* Initialize a t8_ghost_remote_tree_t */
 static void
 t8_ghost_init_remote_tree (t8_forest_t forest, t8_gloidx_t gtreeid,
@@ -1208,6 +1226,148 @@ t8_forest_ghost_fill_remote (t8_forest_t forest, t8_forest_ghost_t ghost,
  * must be called to end the communication.
  * Returns an array of mpi_send_info_t, one for each remote rank.
  */
+/* Compute the number of bytes of the ghost message to a remote process.
+ * The message stores the number of remote trees and for each tree
+ * its global id, its element class, the number of elements, the number
+ * of bytes of the elements, the elements and their global ids. */
+static size_t
+t8_forest_ghost_send_count_bytes (t8_forest_t forest,
+                                  t8_ghost_remote_t * remote_entry)
+{
+  sc_array_t         *remote_trees;
+  t8_ghost_remote_tree_t *remote_tree;
+  t8_eclass_scheme_c *ts;
+  size_t              remote_index, num_bytes, element_count, element_bytes;
+
+  /* At first we store the number of remote trees in the buffer */
+  num_bytes = sizeof (size_t);
+  /* add padding before the eclass */
+  num_bytes += T8_ADD_PADDING (num_bytes);
+  remote_trees = &remote_entry->remote_trees;
+  for (remote_index = 0; remote_index < remote_trees->elem_count;
+       remote_index++) {
+    /* Get the next remote tree. */
+    remote_tree = (t8_ghost_remote_tree_t *) sc_array_index (remote_trees,
+                                                             remote_index);
+    /* We will store the global tree id, the element class and the list
+     * of elements in the send_buffer. */
+    num_bytes += sizeof (t8_gloidx_t);
+    /* add padding before the eclass */
+    num_bytes += T8_ADD_PADDING (num_bytes);
+    num_bytes += sizeof (t8_eclass_t);
+    /* add padding before the elements */
+    num_bytes += T8_ADD_PADDING (num_bytes);
+    /* The byte count of the elements */
+    element_count = t8_element_array_get_count (&remote_tree->elements);
+    if (forest->compact_messages) {
+      ts = t8_forest_get_eclass_scheme (forest, remote_tree->eclass);
+      element_bytes =
+        t8_forest_element_keys_encode (ts, &remote_tree->elements, 0,
+                                       element_count, NULL);
+    }
+    else {
+      element_bytes = element_count *
+        t8_element_array_get_size (&remote_tree->elements);
+    }
+    /* We will store the number of elements and their number of bytes */
+    num_bytes += 2 * sizeof (size_t);
+    /* add padding before the elements */
+    num_bytes += T8_ADD_PADDING (num_bytes);
+    num_bytes += element_bytes;
+    /* add padding after the elements */
+    num_bytes += T8_ADD_PADDING (num_bytes);
+    /* The global ids of the elements */
+    num_bytes += element_count * sizeof (t8_gloidx_t);
+  }
+  return num_bytes;
+}
+
+/* Fill the ghost message to a remote process into an allocated buffer.
+ * Returns the number of bytes written. */
+static size_t
+t8_forest_ghost_send_fill_buffer (t8_forest_t forest,
+                                  t8_ghost_remote_t * remote_entry,
+                                  char *current_buffer)
+{
+  sc_array_t         *remote_trees;
+  t8_ghost_remote_tree_t *remote_tree;
+  t8_eclass_scheme_c *ts;
+  size_t              remote_index, bytes_written, element_bytes;
+  size_t              element_count, element_size, element_index;
+  t8_locidx_t         ltreeid;
+  t8_gloidx_t         global_offset, global_id;
+
+  remote_trees = &remote_entry->remote_trees;
+  bytes_written = 0;
+  /* Start with the number of remote trees in the buffer */
+  memcpy (current_buffer + bytes_written, &remote_trees->elem_count,
+          sizeof (size_t));
+  bytes_written += sizeof (size_t);
+  bytes_written += T8_ADD_PADDING (bytes_written);
+  for (remote_index = 0; remote_index < remote_trees->elem_count;
+       remote_index++) {
+    /* Get a pointer to the tree */
+    remote_tree =
+      (t8_ghost_remote_tree_t *) sc_array_index (remote_trees, remote_index);
+    T8_ASSERT (remote_tree->mpirank == remote_entry->remote_rank);
+
+    /* Copy the global tree id */
+    memcpy (current_buffer + bytes_written, &remote_tree->global_id,
+            sizeof (t8_gloidx_t));
+    bytes_written += sizeof (t8_gloidx_t);
+    bytes_written += T8_ADD_PADDING (bytes_written);
+    /* Copy the trees element class */
+    memcpy (current_buffer + bytes_written, &remote_tree->eclass,
+            sizeof (t8_eclass_t));
+    bytes_written += sizeof (t8_eclass_t);
+    bytes_written += T8_ADD_PADDING (bytes_written);
+    /* Store the number of elements in the buffer */
+    element_count = t8_element_array_get_count (&remote_tree->elements);
+    memcpy (current_buffer + bytes_written, &element_count, sizeof (size_t));
+    bytes_written += sizeof (size_t);
+    /* Copy or encode the elements into the send buffer, leaving space
+     * for their byte count */
+    if (forest->compact_messages) {
+      ts = t8_forest_get_eclass_scheme (forest, remote_tree->eclass);
+      element_bytes =
+        t8_forest_element_keys_encode (ts, &remote_tree->elements, 0,
+                                       element_count,
+                                       current_buffer + bytes_written +
+                                       sizeof (size_t) +
+                                       T8_ADD_PADDING (bytes_written +
+                                                       sizeof (size_t)));
+    }
+    else {
+      /* The byte count of the elements */
+      element_size = t8_element_array_get_size (&remote_tree->elements);
+      element_bytes = element_size * element_count;
+      memcpy (current_buffer + bytes_written + sizeof (size_t) +
+              T8_ADD_PADDING (bytes_written + sizeof (size_t)),
+              t8_element_array_get_data (&remote_tree->elements),
+              element_bytes);
+    }
+    /* Store the byte count of the elements */
+    memcpy (current_buffer + bytes_written, &element_bytes, sizeof (size_t));
+    bytes_written += sizeof (size_t);
+    bytes_written += T8_ADD_PADDING (bytes_written);
+    bytes_written += element_bytes;
+    /* add padding after the elements */
+    bytes_written += T8_ADD_PADDING (bytes_written);
+    /* Store the global ids of the elements */
+    ltreeid = t8_forest_get_local_id (forest, remote_tree->global_id);
+    global_offset = t8_forest_get_first_local_element_id (forest)
+      + t8_forest_get_tree_element_offset (forest, ltreeid);
+    for (element_index = 0; element_index < element_count; element_index++) {
+      global_id = global_offset + *(t8_locidx_t *)
+        sc_array_index (&remote_tree->element_indices, element_index);
+      memcpy (current_buffer + bytes_written, &global_id,
+              sizeof (t8_gloidx_t));
+      bytes_written += sizeof (t8_gloidx_t);
+    }
+  }                             /* End tree loop */
+  return bytes_written;
+}
+
 static t8_ghost_mpi_send_info_t *
 t8_forest_ghost_send_start (t8_forest_t forest, t8_forest_ghost_t ghost,
                             sc_MPI_Request ** requests)
@@ -1216,144 +1376,81 @@ t8_forest_ghost_send_start (t8_forest_t forest, t8_forest_ghost_t ghost,
   int                 num_remotes;
   size_t              remote_index;
   t8_ghost_remote_t  *remote_entry;
-  sc_array_t         *remote_trees;
-  t8_ghost_remote_tree_t *remote_tree = NULL;
+  t8_ghost_remote_tree_t *remote_tree;
+  t8_ghost_remote_t **remote_entries;
   t8_ghost_mpi_send_info_t *send_info, *current_send_info;
-  char               *current_buffer;
-  size_t              bytes_written, element_bytes, element_count,
-    element_size;
-#ifdef T8_ENABLE_DEBUG
-  size_t              acc_el_count = 0;
-#endif
   int                 mpiret;
 
   /* Allocate a send_buffer for each remote rank */
   num_remotes = ghost->remote_processes->elem_count;
   send_info = T8_ALLOC (t8_ghost_mpi_send_info_t, num_remotes);
   *requests = T8_ALLOC (sc_MPI_Request, num_remotes);
+  remote_entries = T8_ALLOC (t8_ghost_remote_t *, num_remotes);
 
   /* Loop over all remote processes */
-  for (proc_index = 0; proc_index < (int) ghost->remote_processes->elem_count;
-       proc_index++) {
+  for (proc_index = 0; proc_index < num_remotes; proc_index++) {
     current_send_info = send_info + proc_index;
     /* Get the rank of the current remote process. */
     remote_rank = *(int *) sc_array_index_int (ghost->remote_processes,
                                                proc_index);
-    t8_debugf ("Filling send buffer for process %i\n", remote_rank);
     /* initialize the send_info for the current rank */
     current_send_info->recv_rank = remote_rank;
     current_send_info->num_bytes = 0;
     current_send_info->request = *requests + proc_index;
     /* Lookup the ghost elements for the first tree of this remote */
-    remote_entry = t8_forest_ghost_get_remote (forest, remote_rank);
-    T8_ASSERT (remote_entry->remote_rank == remote_rank);
-    /* Loop over all trees of the remote rank and count the bytes */
-    /* At first we store the number of remote trees in the buffer */
-    current_send_info->num_bytes += sizeof (size_t);
-    /* add padding before the eclass */
-    current_send_info->num_bytes +=
-      T8_ADD_PADDING (current_send_info->num_bytes);
-    /* TODO: put this in a funtion */
-    /* TODO: Use remote_entry to count the number of bytes while inserting
-     *        the remote ghosts. */
-    remote_trees = &remote_entry->remote_trees;
-    for (remote_index = 0; remote_index < remote_trees->elem_count;
-         remote_index++) {
-      /* Get the next remote tree. */
-      remote_tree = (t8_ghost_remote_tree_t *) sc_array_index (remote_trees,
-                                                               remote_index);
-      /* We will store the global tree id, the element class and the list
-       * of elements in the send_buffer. */
-      current_send_info->num_bytes += sizeof (t8_gloidx_t);
-      /* add padding before the eclass */
-      current_send_info->num_bytes +=
-        T8_ADD_PADDING (current_send_info->num_bytes);
-      current_send_info->num_bytes += sizeof (t8_eclass_t);
-      /* add padding before the elements */
-      current_send_info->num_bytes +=
-        T8_ADD_PADDING (current_send_info->num_bytes);
-      /* The byte count of the elements */
-      element_size = t8_element_array_get_size (&remote_tree->elements);
-      element_count = t8_element_array_get_count (&remote_tree->elements);
-      element_bytes = element_size * element_count;
-      /* We will store the number of elements */
-      current_send_info->num_bytes += sizeof (size_t);
-      /* add padding before the elements */
-      current_send_info->num_bytes +=
-        T8_ADD_PADDING (current_send_info->num_bytes);
-      current_send_info->num_bytes += element_bytes;
-      /* add padding after the elements */
-      current_send_info->num_bytes +=
-        T8_ADD_PADDING (current_send_info->num_bytes);
-    }
-
-    /* We now now the number of bytes for our send_buffer and thus
-     * allocate it. */
+    remote_entries[proc_index] =
+      t8_forest_ghost_get_remote (forest, remote_rank);
+    T8_ASSERT (remote_entries[proc_index]->remote_rank == remote_rank);
+  }
+  /* Count the bytes of the messages to all remote processes.
+   * The messages are independent of each other and are counted and filled
+   * in parallel, while the memory allocation and MPI calls are made by
+   * a single thread. */
+  T8_OMP_PARALLEL_FOR
+  for (proc_index = 0; proc_index < num_remotes; proc_index++) {
+    send_info[proc_index].num_bytes =
+      t8_forest_ghost_send_count_bytes (forest, remote_entries[proc_index]);
+  }
+  /* We now now the number of bytes for our send_buffers and thus
+   * allocate them. */
+  for (proc_index = 0; proc_index < num_remotes; proc_index++) {
+    current_send_info = send_info + proc_index;
     current_send_info->buffer = T8_ALLOC_ZERO (char,
                                                current_send_info->num_bytes);
-
-    /* We iterate through the tree again and store the tree info and the elements
-     * into the send_buffer. */
-    current_buffer = current_send_info->buffer;
-    bytes_written = 0;
-    /* Start with the number of remote trees in the buffer */
-    memcpy (current_buffer + bytes_written, &remote_trees->elem_count,
-            sizeof (size_t));
-    bytes_written += sizeof (size_t);
-    bytes_written += T8_ADD_PADDING (bytes_written);
-#ifdef T8_ENABLE_DEBUG
-    acc_el_count = 0;
-#endif
-    for (remote_index = 0; remote_index < remote_trees->elem_count;
-         remote_index++) {
-      /* Get a pointer to the tree */
-      remote_tree =
-        (t8_ghost_remote_tree_t *) sc_array_index (remote_trees,
-                                                   remote_index);
-      T8_ASSERT (remote_tree->mpirank == remote_rank);
-
-      /* Copy the global tree id */
-      memcpy (current_buffer + bytes_written, &remote_tree->global_id,
-              sizeof (t8_gloidx_t));
-      bytes_written += sizeof (t8_gloidx_t);
-      bytes_written += T8_ADD_PADDING (bytes_written);
-      /* Copy the trees element class */
-      memcpy (current_buffer + bytes_written, &remote_tree->eclass,
-              sizeof (t8_eclass_t));
-      bytes_written += sizeof (t8_eclass_t);
-      bytes_written += T8_ADD_PADDING (bytes_written);
-      /* Store the number of elements in the buffer */
-      element_count = t8_element_array_get_count (&remote_tree->elements);
-      memcpy (current_buffer + bytes_written, &element_count,
-              sizeof (size_t));
-      bytes_written += sizeof (size_t);
-      bytes_written += T8_ADD_PADDING (bytes_written);
-      /* The byte count of the elements */
-      element_size = t8_element_array_get_size (&remote_tree->elements);
-      element_bytes = element_size * element_count;
-      /* Copy the elements into the send buffer */
-      memcpy (current_buffer + bytes_written,
-              t8_element_array_get_data (&remote_tree->elements),
-              element_bytes);
-      bytes_written += element_bytes;
-      /* add padding after the elements */
-      bytes_written += T8_ADD_PADDING (bytes_written);
-
-      /* Add to the counter of remote elements. */
-      ghost->num_remote_elements += element_count;
+  }
+  /* Store the tree info and the elements into the send_buffers. */
+  T8_OMP_PARALLEL_FOR
+  for (proc_index = 0; proc_index < num_remotes; proc_index++) {
 #ifdef T8_ENABLE_DEBUG
-      acc_el_count += element_count;
+    size_t              bytes_written =
 #endif
-    }                           /* End tree loop */
+      t8_forest_ghost_send_fill_buffer (forest, remote_entries[proc_index],
+                                        send_info[proc_index].buffer);
+    T8_ASSERT (bytes_written == send_info[proc_index].num_bytes);
+  }
 
-    T8_ASSERT (bytes_written == current_send_info->num_bytes);
+  for (proc_index = 0; proc_index < num_remotes; proc_index++) {
+    current_send_info = send_info + proc_index;
+    remote_rank = current_send_info->recv_rank;
+    remote_entry = remote_entries[proc_index];
+    t8_debugf ("Posting send buffer for process %i\n", remote_rank);
+    /* Add to the counter of remote elements. */
+    for (remote_index = 0;
+         remote_index < remote_entry->remote_trees.elem_count;
+         remote_index++) {
+      remote_tree = (t8_ghost_remote_tree_t *)
+        sc_array_index (&remote_entry->remote_trees, remote_index);
+      ghost->num_remote_elements +=
+        t8_element_array_get_count (&remote_tree->elements);
+    }
     /* We can now post the MPI_Isend for the remote process */
     mpiret =
-      sc_MPI_Isend (current_buffer, bytes_written, sc_MPI_BYTE, remote_rank,
-                    T8_MPI_GHOST_FOREST, forest->mpicomm,
-                    *requests + proc_index);
+      sc_MPI_Isend (current_send_info->buffer, current_send_info->num_bytes,
+                    sc_MPI_BYTE, remote_rank, T8_MPI_GHOST_FOREST,
+                    forest->mpicomm, *requests + proc_index);
     SC_CHECK_MPI (mpiret);
   }                             /* end process loop */
+  T8_FREE (remote_entries);
   return send_info;
 }
 
@@ -1412,8 +1509,8 @@ t8_forest_ghost_receive_message (int recv_rank, sc_MPI_Comm comm,
 /* Parse a message from a remote process and correctly include the received
  * elements in the ghost structure.
  * The message looks like:
- * num_trees | pad | treeid 0 | pad | eclass 0 | pad | num_elems 0 | pad | elements | pad | treeid 1 | ...
- *  size_t   |     |t8_gloidx |     |t8_eclass |     | size_t      |     | t8_element_t |
+ * num_trees | pad | treeid 0 | pad | eclass 0 | pad | num_elems 0 | pad | elements | pad | global ids | treeid 1 | ...
+ *  size_t   |     |t8_gloidx |     |t8_eclass |     | size_t      |     | t8_element_t |     | t8_gloidx  |
  *
  * pad is paddind, see T8_ADD_PADDING
  *
@@ -1438,8 +1535,10 @@ t8_forest_ghost_parse_received_message (t8_forest_t forest,
   t8_ghost_gtree_hash_t *tree_hash, **pfound_tree, *found_tree;
   t8_ghost_tree_t    *ghost_tree;
   t8_eclass_scheme_c *ts;
-  t8_element_t       *element_insert;
   t8_ghost_process_hash_t *process_hash;
+  size_t              element_bytes;
+  size_t             *tree_index, *tree_first_new, *tree_element_pos;
+  size_t             *tree_num_elements;
 #ifdef T8_ENABLE_DEBUG
   int                 added_process;
 #endif
@@ -1449,6 +1548,13 @@ t8_forest_ghost_parse_received_message (t8_forest_t forest,
   num_trees = *(size_t *) recv_buffer;
   bytes_read += sizeof (size_t);
   bytes_read += T8_ADD_PADDING (bytes_read);
+  /* For each received tree, we store the index of the ghost tree, the
+   * index of its first new element, the number of elements and the
+   * position of the elements in recv_buffer. */
+  tree_index = T8_ALLOC (size_t, num_trees);
+  tree_first_new = T8_ALLOC (size_t, num_trees);
+  tree_element_pos = T8_ALLOC (size_t, num_trees);
+  tree_num_elements = T8_ALLOC (size_t, num_trees);
 
   t8_debugf ("Received %li trees from %i (%i bytes)\n",
              (long) num_trees, recv_rank, recv_bytes);
@@ -1475,6 +1581,9 @@ t8_forest_ghost_parse_received_message (t8_forest_t forest,
     /* Add to the counter of ghost elements. */
     ghost->num_ghosts_elements += num_elements;
 
+    bytes_read += sizeof (size_t);
+    /* read the number of bytes of the elements */
+    element_bytes = *(size_t *) (recv_buffer + bytes_read);
     bytes_read += sizeof (size_t);
     bytes_read += T8_ADD_PADDING (bytes_read);
     /* Search for the tree in the ghost_trees array */
@@ -1497,8 +1606,8 @@ t8_forest_ghost_parse_received_message (t8_forest_t forest,
       ghost_tree->eclass = eclass;
       /* Initialize the element array */
       t8_element_array_init_size (&ghost_tree->elements, ts, num_elements);
-      /* pointer to where the elements are to be inserted */
-      element_insert = t8_element_array_get_data (&ghost_tree->elements);
+      sc_array_init_size (&ghost_tree->global_ids, sizeof (t8_gloidx_t),
+                          num_elements);
       /* Compute the element offset of this new tree by adding the offset
        * of the previous tree to the element count of the previous tree. */
       ghost_tree->element_offset = *current_element_offset;
@@ -1523,9 +1632,8 @@ t8_forest_ghost_parse_received_message (t8_forest_t forest,
       /* Grow the elements array of the tree to fit the new elements */
       t8_element_array_resize (&ghost_tree->elements,
                                old_elem_count + num_elements);
-      /* Get a pointer to where the new elements are to be inserted */
-      element_insert = t8_element_array_index_locidx (&ghost_tree->elements,
-                                                      old_elem_count);
+      sc_array_resize (&ghost_tree->global_ids,
+                       old_elem_count + num_elements);
     }
     if (itree == 0) {
       /* We store the index of the first tree and the first element of this
@@ -1533,15 +1641,56 @@ t8_forest_ghost_parse_received_message (t8_forest_t forest,
       first_tree_index = found_tree->index;
       first_element_index = old_elem_count;
     }
-    /* Insert the new elements */
-    memcpy (element_insert, recv_buffer + bytes_read,
-            num_elements * ts->t8_element_size ());
-
-    bytes_read += num_elements * ts->t8_element_size ();
+    T8_ASSERT (forest->compact_messages
+               || element_bytes == num_elements * ts->t8_element_size ());
+    /* Remember where the new elements are inserted and where they are
+     * stored in the message */
+    tree_index[itree] = found_tree->index;
+    tree_first_new[itree] = old_elem_count;
+    tree_num_elements[itree] = num_elements;
+    tree_element_pos[itree] = bytes_read;
+    bytes_read += element_bytes;
     bytes_read += T8_ADD_PADDING (bytes_read);
+    bytes_read += num_elements * sizeof (t8_gloidx_t);
     *current_element_offset += num_elements;
   }
   T8_ASSERT (bytes_read == (size_t) recv_bytes);
+  /* Insert the new elements and their global ids. Since the ghost trees
+   * are allocated, this can be done in parallel. */
+  T8_OMP_PARALLEL_FOR
+  for (itree = 0; itree < num_trees; itree++) {
+    t8_ghost_tree_t    *insert_tree;
+    t8_eclass_scheme_c *insert_ts;
+    size_t              insert_bytes, insert_pos;
+
+    insert_tree = (t8_ghost_tree_t *) sc_array_index (ghost->ghost_trees,
+                                                      tree_index[itree]);
+    insert_ts = insert_tree->elements.scheme;
+    insert_pos = tree_element_pos[itree];
+    if (forest->compact_messages) {
+      insert_bytes =
+        t8_forest_element_keys_decode (insert_ts, recv_buffer + insert_pos,
+                                       &insert_tree->elements,
+                                       tree_first_new[itree],
+                                       tree_num_elements[itree]);
+    }
+    else {
+      insert_bytes = tree_num_elements[itree] * insert_ts->t8_element_size ();
+      memcpy (t8_element_array_index_locidx (&insert_tree->elements,
+                                             tree_first_new[itree]),
+              recv_buffer + insert_pos, insert_bytes);
+    }
+    insert_pos += insert_bytes;
+    insert_pos += T8_ADD_PADDING (insert_pos);
+    /* Insert the global ids of the new elements */
+    memcpy (sc_array_index (&insert_tree->global_ids, tree_first_new[itree]),
+            recv_buffer + insert_pos,
+            tree_num_elements[itree] * sizeof (t8_gloidx_t));
+  }
+  T8_FREE (tree_index);
+  T8_FREE (tree_first_new);
+  T8_FREE (tree_element_pos);
+  T8_FREE (tree_num_elements);
   T8_FREE (recv_buffer);
 
   /* At last we add the receiving rank to the ghosts process_offset hash table */
@@ -2053,47 +2202,25 @@ t8_forest_ghost_remote_first_elem (t8_forest_t forest, int remote)
   return proc_entry->ghost_offset;
 }
 
-/* Fill the send buffer for a ghost data exchange for on remote rank.
- * returns the number of bytes in the buffer. */
-static              size_t
-t8_forest_ghost_exchange_fill_send_buffer (t8_forest_t forest, int remote,
-                                           char **pbuffer,
+/* Fill the send buffer for a ghost data exchange for one remote rank.
+ * The buffer must have space for the data of all elements that are
+ * ghosts of this remote rank. */
+static void
+t8_forest_ghost_exchange_fill_send_buffer (t8_forest_t forest,
+                                           t8_ghost_remote_t * remote_entry,
+                                           char *buffer,
                                            sc_array_t * element_data)
 {
-  char               *buffer;
-  t8_ghost_remote_t   lookup_rank, *remote_entry;
   t8_ghost_remote_tree_t *remote_tree;
-  t8_forest_ghost_t   ghost;
-  size_t              index, element_index, data_size;
-  size_t              elements_inserted, byte_count;
+  size_t              element_index, data_size;
+  size_t              elements_inserted;
   t8_tree_t           local_tree;
-#ifdef T8_ENABLE_DEBUG
-  int                 ret;
-#endif
   t8_locidx_t         itree, ielement, element_pos;
   t8_locidx_t         ltreeid;
   size_t              elem_count;
 
-  ghost = forest->ghosts;
   data_size = element_data->elem_size;
   elements_inserted = 0;
-  lookup_rank.remote_rank = remote;
-
-  /* Lookup the remote entry of this remote process */
-#ifdef T8_ENABLE_DEBUG
-  ret =
-#else
-  (void)
-#endif
-    sc_hash_array_lookup (ghost->remote_ghosts, &lookup_rank, &index);
-  T8_ASSERT (ret != 0);
-  remote_entry =
-    (t8_ghost_remote_t *) sc_array_index (&ghost->remote_ghosts->a, index);
-  T8_ASSERT (remote_entry->remote_rank == remote);
-
-  /* allocate memory for the send buffer */
-  byte_count = data_size * remote_entry->num_elements;
-  buffer = *pbuffer = T8_ALLOC (char, byte_count);
 
   /* We now iterate over the remote trees and their elements to find the
    * local element indices of the remote elements */
@@ -2122,7 +2249,7 @@ t8_forest_ghost_exchange_fill_send_buffer (t8_forest_t forest, int remote,
       elements_inserted++;
     }
   }
-  return byte_count;
+  T8_ASSERT (elements_inserted == (size_t) remote_entry->num_elements);
 }
 
 static t8_ghost_data_exchange_t *
@@ -2137,6 +2264,7 @@ t8_forest_ghost_exchange_begin (t8_forest_t forest, sc_array_t * element_data)
   int                 ret;
 #endif
   char              **send_buffers;
+  t8_ghost_remote_t **remote_entries;
   t8_ghost_process_hash_t lookup_proc, *process_entry, **pfound;
   t8_locidx_t         remote_offset, next_offset;
 
@@ -2159,16 +2287,31 @@ t8_forest_ghost_exchange_begin (t8_forest_t forest, sc_array_t * element_data)
   send_buffers = data_exchange->send_buffers =
     T8_ALLOC (char *, data_exchange->num_remotes);
 
+  remote_entries =
+    T8_ALLOC (t8_ghost_remote_t *, data_exchange->num_remotes);
   for (iremote = 0; iremote < data_exchange->num_remotes; iremote++) {
-    /* Iterate over all remote processes and fill their send buffers */
+    /* Iterate over all remote processes and allocate their send buffers */
     remote_rank =
       *(int *) sc_array_index_int (ghost->remote_processes, iremote);
-    /* Fill the send buffers and compute the number of bytes to send */
+    remote_entries[iremote] =
+      t8_forest_ghost_get_remote (forest, remote_rank);
+    send_buffers[iremote] =
+      T8_ALLOC (char, element_data->elem_size *
+                remote_entries[iremote]->num_elements);
+  }
+  /* Fill the send buffers. They are independent of each other and
+   * are filled in parallel. */
+  T8_OMP_PARALLEL_FOR
+  for (iremote = 0; iremote < data_exchange->num_remotes; iremote++) {
+    t8_forest_ghost_exchange_fill_send_buffer (forest,
+                                               remote_entries[iremote],
+                                               send_buffers[iremote],
+                                               element_data);
+  }
+  for (iremote = 0; iremote < data_exchange->num_remotes; iremote++) {
+    remote_rank = remote_entries[iremote]->remote_rank;
     bytes_to_send =
-      t8_forest_ghost_exchange_fill_send_buffer (forest, remote_rank,
-                                                 send_buffers + iremote,
-                                                 element_data);
-
+      element_data->elem_size * remote_entries[iremote]->num_elements;
     /* Post the asynchronuos send */
     mpiret = sc_MPI_Isend (send_buffers[iremote], bytes_to_send, sc_MPI_BYTE,
                            remote_rank, T8_MPI_GHOST_EXC_FOREST,
@@ -2176,6 +2319,7 @@ t8_forest_ghost_exchange_begin (t8_forest_t forest, sc_array_t * element_data)
                            data_exchange->send_requests + iremote);
     SC_CHECK_MPI (mpiret);
   }
+  T8_FREE (remote_entries);
 
   /* The index in element_data at which the ghost elements start */
   ghost_start = t8_forest_get_local_num_elements (forest);
@@ -2410,6 +2554,7 @@ t8_forest_ghost_reset (t8_forest_ghost_t * pghost)
     ghost_tree = (t8_ghost_tree_t *) sc_array_index (ghost->ghost_trees,
                                                      it_trees);
     t8_element_array_reset (&ghost_tree->elements);
+    sc_array_reset (&ghost_tree->global_ids);
   }
 
   sc_array_destroy (ghost->ghost_trees);
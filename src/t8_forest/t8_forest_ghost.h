@@ -105,6 +105,23 @@ t8_element_t       *t8_forest_ghost_get_element (t8_forest_t forest,
                                                  t8_locidx_t lghost_tree,
                                                  t8_locidx_t lelement);
 
+/** Return the global id of a ghost element.
+ * This is the index of the element in the forest of its owner process,
+ * that is the first local element id of the owner plus the local index
+ * of the element there.
+ * \param [in]  forest    The forest. Ghost layer must exist.
+ * \param [in]  lghost_tree The ghost tree id of a ghost tree.
+ * \param [in]  lelement  The index of a ghost element in the ghost tree.
+ * \return                The global id of the ghost element.
+ * \a forest must be committed before calling this function.
+ */
+t8_gloidx_t         t8_forest_ghost_get_global_element_id (t8_forest_t
+                                                           forest,
+                                                           t8_locidx_t
+                                                           lghost_tree,
+                                                           t8_locidx_t
+                                                           lelement);
+
 /** Return the array of remote ranks.
  * \param [in] forest   A forest with constructed ghost layer.
  * \param [in,out] num_remotes On output the number of remote ranks is stored here.
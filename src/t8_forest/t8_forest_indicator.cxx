@@ -0,0 +1,316 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#include <t8_forest_indicator.h>
+#include <t8_element_cxx.hxx>
+
+/* We want to export the whole implementation to be callable from "C" */
+T8_EXTERN_C_BEGIN ();
+
+/* If the global number of remaining candidates is at most this size,
+ * they are gathered on all processes and selected locally. */
+#define T8_INDICATOR_GATHER_SIZE 4096
+
+/* Reorder values such that values[k] is the value that would be at position
+ * k if values were sorted, all values before are smaller or equal and all
+ * values after are larger or equal. */
+static void
+t8_forest_indicator_nth (double *values, t8_locidx_t num_values,
+                         t8_locidx_t k)
+{
+  t8_locidx_t         lo = 0, hi = num_values - 1, i, j;
+  double              pivot, temp;
+
+  T8_ASSERT (0 <= k && k < num_values);
+  while (lo < hi) {
+    pivot = values[lo + (hi - lo) / 2];
+    i = lo;
+    j = hi;
+    /* Hoare partition */
+    while (i <= j) {
+      while (values[i] < pivot) {
+        i++;
+      }
+      while (values[j] > pivot) {
+        j--;
+      }
+      if (i <= j) {
+        temp = values[i];
+        values[i] = values[j];
+        values[j] = temp;
+        i++;
+        j--;
+      }
+    }
+    /* Now values[lo..j] <= pivot <= values[i..hi] and values between
+     * j and i equal pivot */
+    if (k <= j) {
+      hi = j;
+    }
+    else if (k >= i) {
+      lo = i;
+    }
+    else {
+      return;
+    }
+  }
+}
+
+/* Gather the candidates of all processes and select the k-th smallest */
+static double
+t8_forest_indicator_select_gathered (sc_MPI_Comm comm, double *candidates,
+                                     t8_locidx_t num_candidates,
+                                     t8_gloidx_t global_num_candidates,
+                                     t8_gloidx_t k)
+{
+  int                 mpisize, mpiret, iproc, count;
+  int                *counts, *displs;
+  double             *all_candidates, value;
+
+  mpiret = sc_MPI_Comm_size (comm, &mpisize);
+  SC_CHECK_MPI (mpiret);
+  counts = T8_ALLOC (int, mpisize);
+  displs = T8_ALLOC (int, mpisize);
+  count = num_candidates;
+  mpiret = sc_MPI_Allgather (&count, 1, sc_MPI_INT, counts, 1, sc_MPI_INT,
+                             comm);
+  SC_CHECK_MPI (mpiret);
+  displs[0] = 0;
+  for (iproc = 1; iproc < mpisize; iproc++) {
+    displs[iproc] = displs[iproc - 1] + counts[iproc - 1];
+  }
+  T8_ASSERT (displs[mpisize - 1] + counts[mpisize - 1] ==
+             global_num_candidates);
+  all_candidates = T8_ALLOC (double, global_num_candidates);
+  mpiret = sc_MPI_Allgatherv (candidates, count, sc_MPI_DOUBLE,
+                              all_candidates, counts, displs, sc_MPI_DOUBLE,
+                              comm);
+  SC_CHECK_MPI (mpiret);
+  t8_forest_indicator_nth (all_candidates, global_num_candidates, k);
+  value = all_candidates[k];
+  T8_FREE (all_candidates);
+  T8_FREE (counts);
+  T8_FREE (displs);
+  return value;
+}
+
+/* Compare two (median, count) pairs by their median */
+static int
+t8_forest_indicator_compare_median (const void *a, const void *b)
+{
+  const double        median_a = *(const double *) a;
+  const double        median_b = *(const double *) b;
+
+  return median_a < median_b ? -1 : median_a > median_b;
+}
+
+double
+t8_forest_indicator_select (sc_MPI_Comm comm, const double *values,
+                            t8_locidx_t num_values, t8_gloidx_t k)
+{
+  double             *candidates, *medians, local_median[2], pivot;
+  t8_locidx_t         num_candidates, icand, num_kept;
+  t8_gloidx_t         global_num_candidates, local_counts[2];
+  t8_gloidx_t         global_counts[2], weight;
+  int                 mpisize, mpiret, iproc;
+
+  mpiret = sc_MPI_Comm_size (comm, &mpisize);
+  SC_CHECK_MPI (mpiret);
+  T8_ASSERT (num_values >= 0);
+  T8_ASSERT (k >= 0);
+
+  /* We successively restrict the candidates to the values that can still
+   * be the k-th smallest. In each round, the pivot is the weighted median of
+   * the local medians. Thus, at least a quarter of the candidates is either
+   * smaller or equal or larger or equal than the pivot and is discarded. */
+  candidates = T8_ALLOC (double, SC_MAX (num_values, 1));
+  memcpy (candidates, values, num_values * sizeof (double));
+  num_candidates = num_values;
+  medians = T8_ALLOC (double, 2 * mpisize);
+  for (;;) {
+    local_counts[0] = num_candidates;
+    mpiret = sc_MPI_Allreduce (local_counts, &global_num_candidates, 1,
+                               T8_MPI_GLOIDX, sc_MPI_SUM, comm);
+    SC_CHECK_MPI (mpiret);
+    T8_ASSERT (k < global_num_candidates);
+    if (global_num_candidates <= T8_INDICATOR_GATHER_SIZE) {
+      pivot = t8_forest_indicator_select_gathered (comm, candidates,
+                                                   num_candidates,
+                                                   global_num_candidates, k);
+      break;
+    }
+    /* Compute the local median and gather it with the number of candidates */
+    local_median[0] = 0;
+    local_median[1] = num_candidates;
+    if (num_candidates > 0) {
+      t8_forest_indicator_nth (candidates, num_candidates,
+                               num_candidates / 2);
+      local_median[0] = candidates[num_candidates / 2];
+    }
+    mpiret = sc_MPI_Allgather (local_median, 2, sc_MPI_DOUBLE, medians, 2,
+                               sc_MPI_DOUBLE, comm);
+    SC_CHECK_MPI (mpiret);
+    /* The pivot is the median of the medians weighted by the number
+     * of candidates */
+    qsort (medians, mpisize, 2 * sizeof (double),
+           t8_forest_indicator_compare_median);
+    weight = 0;
+    pivot = 0;
+    for (iproc = 0; iproc < mpisize; iproc++) {
+      weight += (t8_gloidx_t) medians[2 * iproc + 1];
+      if (2 * weight >= global_num_candidates) {
+        pivot = medians[2 * iproc];
+        break;
+      }
+    }
+    /* Count the candidates smaller than and equal to the pivot */
+    local_counts[0] = local_counts[1] = 0;
+    for (icand = 0; icand < num_candidates; icand++) {
+      local_counts[0] += candidates[icand] < pivot;
+      local_counts[1] += candidates[icand] == pivot;
+    }
+    mpiret = sc_MPI_Allreduce (local_counts, global_counts, 2, T8_MPI_GLOIDX,
+                               sc_MPI_SUM, comm);
+    SC_CHECK_MPI (mpiret);
+    if (k >= global_counts[0] && k < global_counts[0] + global_counts[1]) {
+      /* The pivot is the k-th smallest value */
+      break;
+    }
+    /* Keep the candidates on the side of the pivot that contains k */
+    num_kept = 0;
+    if (k < global_counts[0]) {
+      for (icand = 0; icand < num_candidates; icand++) {
+        if (candidates[icand] < pivot) {
+          candidates[num_kept++] = candidates[icand];
+        }
+      }
+    }
+    else {
+      for (icand = 0; icand < num_candidates; icand++) {
+        if (candidates[icand] > pivot) {
+          candidates[num_kept++] = candidates[icand];
+        }
+      }
+      k -= global_counts[0] + global_counts[1];
+    }
+    num_candidates = num_kept;
+  }
+  T8_FREE (candidates);
+  T8_FREE (medians);
+  return pivot;
+}
+
+double
+t8_forest_indicator_quantile (t8_forest_t forest, const double *indicator,
+                              double fraction)
+{
+  t8_gloidx_t         num_elements, k;
+
+  T8_ASSERT (t8_forest_is_committed (forest));
+  T8_ASSERT (0 <= fraction && fraction <= 1);
+
+  num_elements = t8_forest_get_global_num_elements (forest);
+  if (num_elements == 0) {
+    return 0;
+  }
+  /* The k-th smallest value has k + 1 values smaller or equal */
+  k = (t8_gloidx_t) ceil (fraction * num_elements) - 1;
+  k = SC_MAX (0, SC_MIN (k, num_elements - 1));
+  return t8_forest_indicator_select (t8_forest_get_mpicomm (forest),
+                                     indicator,
+                                     t8_forest_get_local_num_elements
+                                     (forest), k);
+}
+
+void
+t8_forest_indicator_markers (t8_forest_t forest, const double *indicator,
+                             double refine_fraction, double coarsen_fraction,
+                             int *markers)
+{
+  t8_gloidx_t         num_elements, num_refine, num_coarsen;
+  t8_locidx_t         num_local_elements, ielement;
+  double              refine_threshold = 0, coarsen_threshold = 0;
+  sc_MPI_Comm         comm;
+
+  T8_ASSERT (t8_forest_is_committed (forest));
+  T8_ASSERT (0 <= refine_fraction && refine_fraction <= 1);
+  T8_ASSERT (0 <= coarsen_fraction && coarsen_fraction <= 1);
+
+  comm = t8_forest_get_mpicomm (forest);
+  num_elements = t8_forest_get_global_num_elements (forest);
+  num_local_elements = t8_forest_get_local_num_elements (forest);
+  num_refine = (t8_gloidx_t) (refine_fraction * num_elements);
+  num_coarsen = (t8_gloidx_t) (coarsen_fraction * num_elements);
+  /* The smallest of the num_refine largest values and the largest of the
+   * num_coarsen smallest values */
+  if (num_refine > 0) {
+    refine_threshold =
+      t8_forest_indicator_select (comm, indicator, num_local_elements,
+                                  num_elements - num_refine);
+  }
+  if (num_coarsen > 0) {
+    coarsen_threshold =
+      t8_forest_indicator_select (comm, indicator, num_local_elements,
+                                  num_coarsen - 1);
+  }
+  for (ielement = 0; ielement < num_local_elements; ielement++) {
+    if (num_refine > 0 && indicator[ielement] >= refine_threshold) {
+      markers[ielement] = 1;
+    }
+    else if (num_coarsen > 0 && indicator[ielement] <= coarsen_threshold) {
+      markers[ielement] = -1;
+    }
+    else {
+      markers[ielement] = 0;
+    }
+  }
+}
+
+int
+t8_forest_indicator_adapt (t8_forest_t forest, t8_forest_t forest_from,
+                           t8_locidx_t which_tree, t8_locidx_t lelement_id,
+                           t8_eclass_scheme_c * ts, int num_elements,
+                           t8_element_t * elements[])
+{
+  const int          *markers;
+  t8_locidx_t         offset;
+  int                 ielement;
+
+  markers = (const int *) t8_forest_get_user_data (forest);
+  T8_ASSERT (markers != NULL);
+  offset = t8_forest_get_tree_element_offset (forest_from, which_tree)
+    + lelement_id;
+  if (num_elements > 1) {
+    /* Coarsen the family if all its members are marked for coarsening */
+    for (ielement = 0; ielement < num_elements; ielement++) {
+      if (markers[offset + ielement] >= 0) {
+        break;
+      }
+    }
+    if (ielement == num_elements) {
+      return -1;
+    }
+  }
+  return markers[offset] > 0;
+}
+
+T8_EXTERN_C_END ();
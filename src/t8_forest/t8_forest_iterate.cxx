@@ -35,6 +35,27 @@ typedef struct
   int                 num_children;
 } t8_forest_child_type_query_t;
 
+/* Return true if two elements have the same isotropic patch.
+ * The traversals construct elements from the nearest common ancestor of
+ * the leaves, which for anisotropic schemes does not know the levels
+ * of each leaf along the axes. Thus we only compare the patches, which
+ * for isotropic schemes are the elements themselves. */
+static int
+t8_forest_iterate_same_patch (t8_eclass_scheme_c * ts,
+                              const t8_element_t * elem1,
+                              const t8_element_t * elem2)
+{
+  int                 level;
+
+  if (!ts->t8_element_is_anisotropic ()) {
+    return !ts->t8_element_compare (elem1, elem2);
+  }
+  level = ts->t8_element_level (elem1);
+  return level == ts->t8_element_level (elem2)
+    && ts->t8_element_get_linear_id (elem1, level)
+    == ts->t8_element_get_linear_id (elem2, level);
+}
+
 /* This is the function that we call in sc_split_array to determine for an
  * element E that is a descendant of an element e, of which of e's children,
  * E is a descendant. */
@@ -113,7 +134,7 @@ t8_forest_iterate_faces (t8_forest_t forest, t8_locidx_t ltreeid,
     /* There is only one leaf left, we check whether it is the same as element
      * and if so call the callback function */
     leaf = t8_element_array_index_locidx (leaf_elements, 0);
-    if (!ts->t8_element_compare (element, leaf)) {
+    if (t8_forest_iterate_same_patch (ts, element, leaf)) {
       /* The element is the leaf, we are at the last stage of the recursion
        * and can call the callback. */
       (void) callback (forest, ltreeid, leaf, face, user_data,
@@ -239,9 +260,12 @@ t8_forest_search_recursion (t8_forest_t forest, t8_locidx_t ltreeid,
                     ts->t8_element_level (leaf),
                     "Search: element level greater than leaf level\n");
     if (ts->t8_element_level (element) == ts->t8_element_level (leaf)) {
-      T8_ASSERT (!ts->t8_element_compare (element, leaf));
-      /* The element is the leaf */
+      T8_ASSERT (t8_forest_iterate_same_patch (ts, element, leaf));
+      /* The element is the leaf. We pass the leaf itself to the callbacks,
+       * since it may store more information than the constructed element,
+       * for example the levels of an anisotropic element. */
       is_leaf = 1;
+      element = leaf;
     }
   }
   /* Call the callback function for the element */
@@ -451,8 +475,10 @@ t8_forest_iterate_replace (t8_forest_t forest_new,
         ielem_old += family_size;
       }
       else {
-        /* elem_new = elem_old */
-        T8_ASSERT (!ts->t8_element_compare (elem_new, elem_old));
+        /* elem_new = elem_old, or for anisotropic schemes elem_new has
+         * the patch of elem_old and possibly different levels along the
+         * axes, which the callback can tell with t8_element_compare. */
+        T8_ASSERT (t8_forest_iterate_same_patch (ts, elem_new, elem_old));
         replace_fn (forest_old, forest_new, itree, ts, 1, ielem_old, 1,
                     ielem_new);
         /* Advance to the next element */
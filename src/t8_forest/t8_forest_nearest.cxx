@@ -0,0 +1,738 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#include <float.h>
+#include <t8_forest_nearest.h>
+#include <t8_forest/t8_forest_types.h>
+#include <t8_forest/t8_forest_iterate.h>
+#include <t8_forest/t8_forest_private.h>
+#include <t8_data/t8_containers.h>
+#include <t8_element_cxx.hxx>
+#include <t8_vec.h>
+
+/* We want to export the whole implementation to be callable from "C" */
+T8_EXTERN_C_BEGIN ();
+
+/* A node in the priority queue of the best-first search.
+ * It is either a subtree of a local tree, given by its root element and
+ * the range of its leaves, or a single leaf. */
+typedef struct
+{
+  double              bound;    /* For a subtree a lower bound of the distance of its leaves,
+                                   for a leaf its distance */
+  t8_locidx_t         ltreeid;  /* The local tree */
+  t8_locidx_t         first;    /* The tree index of the first leaf */
+  t8_locidx_t         count;    /* The number of leaves */
+  t8_element_t       *element;  /* The root of the subtree, NULL for a leaf */
+} t8_forest_nearest_node_t;
+
+/* A query that is sent to another process */
+typedef struct
+{
+  double              point[3]; /* The query point */
+  double              radius;   /* The search radius, negative if unbounded */
+  size_t              index;    /* The index of the point on the sending process */
+} t8_forest_nearest_query_t;
+
+/* A found element that is sent back to the process of the query */
+typedef struct
+{
+  size_t              index;    /* The index of the point on the receiving process */
+  t8_forest_nearest_t found;    /* The found element */
+} t8_forest_nearest_answer_t;
+
+/* The simplices of each element shape by their corners */
+static const int    t8_forest_nearest_quad_triangles[2][3] = {
+  {0, 1, 3}, {0, 3, 2}
+};
+
+static const int    t8_forest_nearest_prism_tets[3][4] = {
+  {0, 1, 2, 3}, {1, 2, 3, 4}, {2, 3, 4, 5}
+};
+
+static const int    t8_forest_nearest_hex_tets[6][4] = {
+  {0, 1, 3, 7}, {0, 1, 5, 7}, {0, 2, 3, 7},
+  {0, 2, 6, 7}, {0, 4, 5, 7}, {0, 4, 6, 7}
+};
+
+static int
+t8_forest_nearest_compare (const void *found_a, const void *found_b)
+{
+  const t8_forest_nearest_t *A = (const t8_forest_nearest_t *) found_a;
+  const t8_forest_nearest_t *B = (const t8_forest_nearest_t *) found_b;
+
+  if (A->distance != B->distance) {
+    return A->distance < B->distance ? -1 : 1;
+  }
+  return A->element_id < B->element_id ? -1 : A->element_id != B->element_id;
+}
+
+/* The distance of a point to the segment from a to b */
+static double
+t8_forest_nearest_segment (const double p[3], const double a[3],
+                           const double b[3])
+{
+  double              ab[3], ap[3], t, length;
+
+  t8_vec_axpyz (a, b, ab, -1);
+  t8_vec_axpyz (a, p, ap, -1);
+  length = t8_vec_dot (ab, ab);
+  t = length > 0 ? t8_vec_dot (ap, ab) / length : 0;
+  t = SC_MAX (0, SC_MIN (1, t));
+  t8_vec_axpy (ab, ap, -t);
+  return t8_vec_norm (ap);
+}
+
+/* The distance of a point to the triangle a, b, c.
+ * We project the point onto the plane of the triangle and check whether
+ * the projection lies inside. Otherwise the nearest point is on an edge. */
+static double
+t8_forest_nearest_triangle (const double p[3], const double a[3],
+                            const double b[3], const double c[3])
+{
+  double              ab[3], ac[3], ap[3], normal[3], cross[3];
+  double              area, dist;
+  const double       *corners[3] = { a, b, c };
+  int                 iedge, inside;
+
+  t8_vec_axpyz (a, b, ab, -1);
+  t8_vec_axpyz (a, c, ac, -1);
+  t8_vec_axpyz (a, p, ap, -1);
+  t8_vec_cross (ab, ac, normal);
+  area = t8_vec_dot (normal, normal);
+  if (area > 0) {
+    /* The projection lies inside if it is on the inner side of each edge */
+    inside = 1;
+    for (iedge = 0; iedge < 3 && inside; iedge++) {
+      double              edge[3], to_p[3];
+
+      t8_vec_axpyz (corners[iedge], corners[(iedge + 1) % 3], edge, -1);
+      t8_vec_axpyz (corners[iedge], p, to_p, -1);
+      t8_vec_cross (edge, to_p, cross);
+      inside = t8_vec_dot (cross, normal) >= 0;
+    }
+    if (inside) {
+      return fabs (t8_vec_dot (ap, normal)) / sqrt (area);
+    }
+  }
+  dist = t8_forest_nearest_segment (p, a, b);
+  dist = SC_MIN (dist, t8_forest_nearest_segment (p, b, c));
+  return SC_MIN (dist, t8_forest_nearest_segment (p, c, a));
+}
+
+/* The distance of a point to the tetrahedron a, b, c, d.
+ * The distance is zero if the point is on the same side of each face as
+ * the opposite corner. Otherwise the nearest point is on a face. */
+static double
+t8_forest_nearest_tet (const double p[3], const double *corners[4])
+{
+  double              edge1[3], edge2[3], normal[3], to_p[3], to_opp[3];
+  double              dist;
+  int                 iface, inside = 1;
+
+  for (iface = 0; iface < 4 && inside; iface++) {
+    const double       *a = corners[(iface + 1) % 4];
+    const double       *b = corners[(iface + 2) % 4];
+    const double       *c = corners[(iface + 3) % 4];
+
+    t8_vec_axpyz (a, b, edge1, -1);
+    t8_vec_axpyz (a, c, edge2, -1);
+    t8_vec_cross (edge1, edge2, normal);
+    t8_vec_axpyz (a, p, to_p, -1);
+    t8_vec_axpyz (a, corners[iface], to_opp, -1);
+    inside = t8_vec_dot (normal, to_p) * t8_vec_dot (normal, to_opp) >= 0;
+  }
+  if (inside) {
+    return 0;
+  }
+  dist = DBL_MAX;
+  for (iface = 0; iface < 4; iface++) {
+    dist = SC_MIN (dist,
+                   t8_forest_nearest_triangle (p, corners[(iface + 1) % 4],
+                                               corners[(iface + 2) % 4],
+                                               corners[(iface + 3) % 4]));
+  }
+  return dist;
+}
+
+double
+t8_forest_element_point_distance (t8_forest_t forest, t8_locidx_t ltreeid,
+                                  const t8_element_t * element,
+                                  const double *tree_vertices,
+                                  const double point[3])
+{
+  t8_eclass_scheme_c *ts;
+  t8_element_shape_t  shape;
+  double              coords[T8_ECLASS_MAX_CORNERS][3];
+  const double       *tet[4];
+  double              dist = DBL_MAX;
+  int                 icorner, isimplex, num_corners;
+
+  ts = t8_forest_get_eclass_scheme (forest,
+                                    t8_forest_get_tree_class (forest,
+                                                              ltreeid));
+  shape = ts->t8_element_shape (element);
+  num_corners = ts->t8_element_num_corners (element);
+  for (icorner = 0; icorner < num_corners; icorner++) {
+    t8_forest_element_coordinate (forest, ltreeid, element, tree_vertices,
+                                  icorner, coords[icorner]);
+  }
+  switch (shape) {
+  case T8_ECLASS_VERTEX:
+    return t8_vec_dist (point, coords[0]);
+  case T8_ECLASS_LINE:
+    return t8_forest_nearest_segment (point, coords[0], coords[1]);
+  case T8_ECLASS_TRIANGLE:
+    return t8_forest_nearest_triangle (point, coords[0], coords[1],
+                                       coords[2]);
+  case T8_ECLASS_QUAD:
+    for (isimplex = 0; isimplex < 2; isimplex++) {
+      const int          *c = t8_forest_nearest_quad_triangles[isimplex];
+      dist = SC_MIN (dist, t8_forest_nearest_triangle (point, coords[c[0]],
+                                                       coords[c[1]],
+                                                       coords[c[2]]));
+    }
+    return dist;
+  case T8_ECLASS_TET:
+    for (icorner = 0; icorner < 4; icorner++) {
+      tet[icorner] = coords[icorner];
+    }
+    return t8_forest_nearest_tet (point, tet);
+  case T8_ECLASS_PRISM:
+    for (isimplex = 0; isimplex < 3 && dist > 0; isimplex++) {
+      for (icorner = 0; icorner < 4; icorner++) {
+        tet[icorner] = coords[t8_forest_nearest_prism_tets[isimplex][icorner]];
+      }
+      dist = SC_MIN (dist, t8_forest_nearest_tet (point, tet));
+    }
+    return dist;
+  case T8_ECLASS_HEX:
+    for (isimplex = 0; isimplex < 6 && dist > 0; isimplex++) {
+      for (icorner = 0; icorner < 4; icorner++) {
+        tet[icorner] = coords[t8_forest_nearest_hex_tets[isimplex][icorner]];
+      }
+      dist = SC_MIN (dist, t8_forest_nearest_tet (point, tet));
+    }
+    return dist;
+  default:
+    SC_ABORTF ("Point distance not implemented for elements of shape %s.\n",
+               t8_eclass_to_string[shape]);
+  }
+  return dist;
+}
+
+/* Compute the bounding box of the corners of an element.
+ * Since the geometry of a tree is d-linear, the box contains the element
+ * and all its descendants. */
+static void
+t8_forest_nearest_element_box (t8_forest_t forest, t8_locidx_t ltreeid,
+                               t8_eclass_scheme_c * ts,
+                               const t8_element_t * element,
+                               const double *tree_vertices, double box[6])
+{
+  double              coords[3];
+  int                 icorner, idim;
+
+  for (idim = 0; idim < 3; idim++) {
+    box[idim] = DBL_MAX;
+    box[3 + idim] = -DBL_MAX;
+  }
+  for (icorner = 0; icorner < ts->t8_element_num_corners (element);
+       icorner++) {
+    t8_forest_element_coordinate (forest, ltreeid, element, tree_vertices,
+                                  icorner, coords);
+    for (idim = 0; idim < 3; idim++) {
+      box[idim] = SC_MIN (box[idim], coords[idim]);
+      box[3 + idim] = SC_MAX (box[3 + idim], coords[idim]);
+    }
+  }
+}
+
+/* The distance of a point to a box. The box must not be empty. */
+static double
+t8_forest_nearest_box_distance (const double box[6], const double point[3])
+{
+  double              diff, dist = 0;
+  int                 idim;
+
+  for (idim = 0; idim < 3; idim++) {
+    diff = SC_MAX (0, SC_MAX (box[idim] - point[idim],
+                              point[idim] - box[3 + idim]));
+    dist += diff * diff;
+  }
+  return sqrt (dist);
+}
+
+/* Compare two nodes of the priority queue. Leaves come before subtrees with
+ * the same bound, so that found elements are reported as early as possible. */
+static int
+t8_forest_nearest_node_less (const t8_forest_nearest_node_t * A,
+                             const t8_forest_nearest_node_t * B)
+{
+  if (A->bound != B->bound) {
+    return A->bound < B->bound;
+  }
+  return A->element == NULL && B->element != NULL;
+}
+
+/* Insert a node into the priority queue, a binary min-heap */
+static void
+t8_forest_nearest_heap_push (sc_array_t * heap,
+                             const t8_forest_nearest_node_t * node)
+{
+  t8_forest_nearest_node_t *nodes;
+  size_t              pos, parent;
+
+  (void) sc_array_push (heap);
+  nodes = (t8_forest_nearest_node_t *) heap->array;
+  pos = heap->elem_count - 1;
+  while (pos > 0) {
+    parent = (pos - 1) / 2;
+    if (!t8_forest_nearest_node_less (node, nodes + parent)) {
+      break;
+    }
+    nodes[pos] = nodes[parent];
+    pos = parent;
+  }
+  nodes[pos] = *node;
+}
+
+/* Remove the node with the smallest bound from the priority queue */
+static void
+t8_forest_nearest_heap_pop (sc_array_t * heap, t8_forest_nearest_node_t * node)
+{
+  t8_forest_nearest_node_t *nodes, last;
+  size_t              pos, child, count;
+
+  T8_ASSERT (heap->elem_count > 0);
+  nodes = (t8_forest_nearest_node_t *) heap->array;
+  *node = nodes[0];
+  count = heap->elem_count - 1;
+  last = nodes[count];
+  pos = 0;
+  while ((child = 2 * pos + 1) < count) {
+    if (child + 1 < count
+        && t8_forest_nearest_node_less (nodes + child + 1, nodes + child)) {
+      child++;
+    }
+    if (!t8_forest_nearest_node_less (nodes + child, &last)) {
+      break;
+    }
+    nodes[pos] = nodes[child];
+    pos = child;
+  }
+  nodes[pos] = last;
+  sc_array_resize (heap, count);
+}
+
+/* Add a subtree of a local tree to the priority queue.
+ * If the subtree is a single leaf, we add the leaf with its distance and
+ * destroy the root element. Otherwise the node takes ownership of it. */
+static void
+t8_forest_nearest_push_subtree (t8_forest_t forest, t8_locidx_t ltreeid,
+                                t8_eclass_scheme_c * ts,
+                                t8_element_t * element, t8_locidx_t first,
+                                t8_locidx_t count, const double point[3],
+                                sc_array_t * heap)
+{
+  t8_forest_nearest_node_t node;
+  const double       *tree_vertices =
+    t8_forest_get_tree_vertices (forest, ltreeid);
+  const t8_element_t *leaf;
+  double              box[6];
+
+  node.ltreeid = ltreeid;
+  node.first = first;
+  node.count = count;
+  leaf = t8_forest_get_element_in_tree (forest, ltreeid, first);
+  if (count == 1
+      && ts->t8_element_level (element) == ts->t8_element_level (leaf)) {
+    /* The subtree is the leaf */
+    node.element = NULL;
+    node.bound = t8_forest_element_point_distance (forest, ltreeid, leaf,
+                                                   tree_vertices, point);
+    ts->t8_element_destroy (1, &element);
+  }
+  else {
+    node.element = element;
+    t8_forest_nearest_element_box (forest, ltreeid, ts, element,
+                                   tree_vertices, box);
+    node.bound = t8_forest_nearest_box_distance (box, point);
+  }
+  t8_forest_nearest_heap_push (heap, &node);
+}
+
+/* Search the local elements for the nearest elements of a point with a
+ * best-first traversal of the trees.
+ * The found elements are appended to found in order of increasing distance.
+ * If k is positive, we stop after the k nearest elements and all elements
+ * with the same distance as the k-th one. If radius is not negative, only
+ * elements within radius are found.
+ * heap is an empty array of nodes that is used as priority queue. */
+static void
+t8_forest_nearest_local (t8_forest_t forest, const double point[3], int k,
+                         double radius, sc_array_t * heap, sc_array_t * found)
+{
+  t8_forest_nearest_node_t node;
+  t8_forest_nearest_t *result;
+  t8_eclass_scheme_c *ts;
+  t8_element_array_t *leaves, subtree_leaves;
+  t8_element_t       *root, **children;
+  t8_locidx_t         ltreeid, num_leaves;
+  t8_gloidx_t         first_element_id;
+  size_t             *offsets;
+  double              kth_distance = DBL_MAX;
+  int                 num_found = 0, num_children, ichild;
+
+  T8_ASSERT (heap->elem_count == 0);
+  first_element_id = t8_forest_get_first_local_element_id (forest);
+  /* Start with the subtree of each tree that contains all its leaves */
+  for (ltreeid = 0; ltreeid < t8_forest_get_num_local_trees (forest);
+       ltreeid++) {
+    num_leaves = t8_forest_get_tree_num_elements (forest, ltreeid);
+    if (num_leaves == 0) {
+      continue;
+    }
+    ts = t8_forest_get_eclass_scheme (forest,
+                                      t8_forest_get_tree_class (forest,
+                                                                ltreeid));
+    ts->t8_element_new (1, &root);
+    ts->t8_element_nca (t8_forest_get_element_in_tree (forest, ltreeid, 0),
+                        t8_forest_get_element_in_tree (forest, ltreeid,
+                                                       num_leaves - 1), root);
+    t8_forest_nearest_push_subtree (forest, ltreeid, ts, root, 0, num_leaves,
+                                    point, heap);
+  }
+
+  while (heap->elem_count > 0) {
+    t8_forest_nearest_heap_pop (heap, &node);
+    ts = t8_forest_get_eclass_scheme (forest,
+                                      t8_forest_get_tree_class (forest,
+                                                                node.ltreeid));
+    if ((radius >= 0 && node.bound > radius)
+        || (num_found >= k && k > 0 && node.bound > kth_distance)) {
+      /* All remaining elements are too far away */
+      if (node.element != NULL) {
+        ts->t8_element_destroy (1, &node.element);
+      }
+      break;
+    }
+    if (node.element == NULL) {
+      /* The next nearest leaf */
+      result = (t8_forest_nearest_t *) sc_array_push (found);
+      result->element_id = first_element_id
+        + t8_forest_get_tree_element_offset (forest, node.ltreeid)
+        + node.first;
+      result->owner = forest->mpirank;
+      result->distance = node.bound;
+      if (++num_found == k) {
+        kth_distance = node.bound;
+      }
+      continue;
+    }
+    /* Split the leaves of the subtree among the children of its root */
+    leaves = t8_forest_get_tree_element_array (forest, node.ltreeid);
+    t8_element_array_init_view (&subtree_leaves, leaves, node.first,
+                                node.count);
+    num_children = ts->t8_element_num_children (node.element);
+    offsets = T8_ALLOC (size_t, num_children + 1);
+    t8_forest_split_array (node.element, &subtree_leaves, offsets);
+    children = T8_ALLOC (t8_element_t *, num_children);
+    ts->t8_element_new (num_children, children);
+    ts->t8_element_children (node.element, num_children, children);
+    for (ichild = 0; ichild < num_children; ichild++) {
+      if (offsets[ichild] < offsets[ichild + 1]) {
+        t8_forest_nearest_push_subtree (forest, node.ltreeid, ts,
+                                        children[ichild],
+                                        node.first + offsets[ichild],
+                                        offsets[ichild + 1] -
+                                        offsets[ichild], point, heap);
+      }
+      else {
+        ts->t8_element_destroy (1, children + ichild);
+      }
+    }
+    ts->t8_element_destroy (1, &node.element);
+    T8_FREE (children);
+    T8_FREE (offsets);
+  }
+  /* Clean up the remaining nodes */
+  while (heap->elem_count > 0) {
+    t8_forest_nearest_heap_pop (heap, &node);
+    if (node.element != NULL) {
+      ts = t8_forest_get_eclass_scheme (forest,
+                                        t8_forest_get_tree_class (forest,
+                                                                  node.ltreeid));
+      ts->t8_element_destroy (1, &node.element);
+    }
+  }
+}
+
+/* Compute the bounding box of the local elements of a forest.
+ * If the process has no elements, the box is empty. */
+static void
+t8_forest_nearest_local_box (t8_forest_t forest, double box[6])
+{
+  t8_eclass_scheme_c *ts;
+  t8_element_t       *root;
+  t8_locidx_t         ltreeid, num_leaves;
+  double              tree_box[6];
+  int                 idim;
+
+  for (idim = 0; idim < 3; idim++) {
+    box[idim] = DBL_MAX;
+    box[3 + idim] = -DBL_MAX;
+  }
+  for (ltreeid = 0; ltreeid < t8_forest_get_num_local_trees (forest);
+       ltreeid++) {
+    num_leaves = t8_forest_get_tree_num_elements (forest, ltreeid);
+    if (num_leaves == 0) {
+      continue;
+    }
+    ts = t8_forest_get_eclass_scheme (forest,
+                                      t8_forest_get_tree_class (forest,
+                                                                ltreeid));
+    ts->t8_element_new (1, &root);
+    ts->t8_element_nca (t8_forest_get_element_in_tree (forest, ltreeid, 0),
+                        t8_forest_get_element_in_tree (forest, ltreeid,
+                                                       num_leaves - 1), root);
+    t8_forest_nearest_element_box (forest, ltreeid, ts, root,
+                                   t8_forest_get_tree_vertices (forest,
+                                                                ltreeid),
+                                   tree_box);
+    for (idim = 0; idim < 3; idim++) {
+      box[idim] = SC_MIN (box[idim], tree_box[idim]);
+      box[3 + idim] = SC_MAX (box[3 + idim], tree_box[3 + idim]);
+    }
+    ts->t8_element_destroy (1, &root);
+  }
+}
+
+/* Send an array of records to each process and receive an array from
+ * each process. The arrays to and from this process stay empty.
+ * \param [in] forest     The forest whose communicator is used.
+ * \param [in] send       For each process an array of records to send.
+ * \param [in,out] recv   For each process an initialized array with the
+ *                        same element size. On output the received records.
+ */
+static void
+t8_forest_nearest_exchange (t8_forest_t forest, sc_array_t * send,
+                            sc_array_t * recv)
+{
+  sc_MPI_Request     *requests;
+  int                *send_counts, *recv_counts;
+  int                 iproc, num_requests, mpiret;
+
+  send_counts = T8_ALLOC_ZERO (int, forest->mpisize);
+  recv_counts = T8_ALLOC (int, forest->mpisize);
+  for (iproc = 0; iproc < forest->mpisize; iproc++) {
+    T8_ASSERT (iproc != forest->mpirank || send[iproc].elem_count == 0);
+    send_counts[iproc] = (int) (send[iproc].elem_count
+                                * send[iproc].elem_size);
+  }
+  mpiret = sc_MPI_Alltoall (send_counts, 1, sc_MPI_INT, recv_counts, 1,
+                            sc_MPI_INT, forest->mpicomm);
+  SC_CHECK_MPI (mpiret);
+
+  requests = T8_ALLOC (sc_MPI_Request, 2 * forest->mpisize);
+  num_requests = 0;
+  for (iproc = 0; iproc < forest->mpisize; iproc++) {
+    if (recv_counts[iproc] > 0) {
+      T8_ASSERT (recv_counts[iproc] % recv[iproc].elem_size == 0);
+      sc_array_resize (recv + iproc,
+                       recv_counts[iproc] / recv[iproc].elem_size);
+      mpiret = sc_MPI_Irecv (recv[iproc].array, recv_counts[iproc],
+                             sc_MPI_BYTE, iproc, T8_MPI_NEAREST_FOREST,
+                             forest->mpicomm, requests + num_requests++);
+      SC_CHECK_MPI (mpiret);
+    }
+  }
+  for (iproc = 0; iproc < forest->mpisize; iproc++) {
+    if (send_counts[iproc] > 0) {
+      mpiret = sc_MPI_Isend (send[iproc].array, send_counts[iproc],
+                             sc_MPI_BYTE, iproc, T8_MPI_NEAREST_FOREST,
+                             forest->mpicomm, requests + num_requests++);
+      SC_CHECK_MPI (mpiret);
+    }
+  }
+  mpiret = sc_MPI_Waitall (num_requests, requests, sc_MPI_STATUSES_IGNORE);
+  SC_CHECK_MPI (mpiret);
+  T8_FREE (requests);
+  T8_FREE (send_counts);
+  T8_FREE (recv_counts);
+}
+
+void
+t8_forest_nearest (t8_forest_t forest, size_t num_points,
+                   const double *points, int k, double radius,
+                   t8_forest_nearest_result_t * result)
+{
+  sc_array_t          heap, *found, *queries_send, *queries_recv;
+  sc_array_t         *answers_send, *answers_recv;
+  sc_array_t          remote_found;
+  t8_forest_nearest_query_t *query;
+  t8_forest_nearest_answer_t *answer;
+  double              box[6], *boxes, bound;
+  size_t              ipoint, iquery, ifound, num_found;
+  int                 iproc, mpiret;
+
+  T8_ASSERT (t8_forest_is_committed (forest));
+  SC_CHECK_ABORT (k > 0 || radius >= 0,
+                  "Nearest element query needs a positive k or a radius");
+  T8_ASSERT (num_points == 0 || points != NULL);
+
+  /* Gather the bounding boxes of the partitions of all processes */
+  t8_forest_nearest_local_box (forest, box);
+  boxes = T8_ALLOC (double, 6 * forest->mpisize);
+  mpiret = sc_MPI_Allgather (box, 6, sc_MPI_DOUBLE, boxes, 6, sc_MPI_DOUBLE,
+                             forest->mpicomm);
+  SC_CHECK_MPI (mpiret);
+
+  sc_array_init (&heap, sizeof (t8_forest_nearest_node_t));
+  found = T8_ALLOC (sc_array_t, num_points);
+  queries_send = T8_ALLOC (sc_array_t, forest->mpisize);
+  queries_recv = T8_ALLOC (sc_array_t, forest->mpisize);
+  answers_send = T8_ALLOC (sc_array_t, forest->mpisize);
+  answers_recv = T8_ALLOC (sc_array_t, forest->mpisize);
+  for (iproc = 0; iproc < forest->mpisize; iproc++) {
+    sc_array_init (queries_send + iproc, sizeof (t8_forest_nearest_query_t));
+    sc_array_init (queries_recv + iproc, sizeof (t8_forest_nearest_query_t));
+    sc_array_init (answers_send + iproc,
+                   sizeof (t8_forest_nearest_answer_t));
+    sc_array_init (answers_recv + iproc,
+                   sizeof (t8_forest_nearest_answer_t));
+  }
+
+  /* Search the local elements first. The distance of the k-th local
+   * element bounds the distance of the remote candidates. */
+  for (ipoint = 0; ipoint < num_points; ipoint++) {
+    const double       *point = points + 3 * ipoint;
+
+    sc_array_init (found + ipoint, sizeof (t8_forest_nearest_t));
+    t8_forest_nearest_local (forest, point, k, radius, &heap, found + ipoint);
+    bound = radius;
+    if (k > 0 && found[ipoint].elem_count >= (size_t) k) {
+      bound = ((t8_forest_nearest_t *)
+               sc_array_index (found + ipoint, k - 1))->distance;
+    }
+    for (iproc = 0; iproc < forest->mpisize; iproc++) {
+      const double       *proc_box = boxes + 6 * iproc;
+
+      if (iproc == forest->mpirank || proc_box[0] > proc_box[3]
+          || (bound >= 0
+              && t8_forest_nearest_box_distance (proc_box, point) > bound)) {
+        /* This process cannot have any candidates */
+        continue;
+      }
+      query = (t8_forest_nearest_query_t *) sc_array_push (queries_send +
+                                                           iproc);
+      query->point[0] = point[0];
+      query->point[1] = point[1];
+      query->point[2] = point[2];
+      query->radius = bound;
+      query->index = ipoint;
+    }
+  }
+  t8_forest_nearest_exchange (forest, queries_send, queries_recv);
+
+  /* Answer the queries of the other processes */
+  sc_array_init (&remote_found, sizeof (t8_forest_nearest_t));
+  for (iproc = 0; iproc < forest->mpisize; iproc++) {
+    for (iquery = 0; iquery < queries_recv[iproc].elem_count; iquery++) {
+      query = (t8_forest_nearest_query_t *)
+        sc_array_index (queries_recv + iproc, iquery);
+      t8_forest_nearest_local (forest, query->point, k, query->radius, &heap,
+                               &remote_found);
+      for (ifound = 0; ifound < remote_found.elem_count; ifound++) {
+        answer = (t8_forest_nearest_answer_t *)
+          sc_array_push (answers_send + iproc);
+        answer->index = query->index;
+        answer->found =
+          *(t8_forest_nearest_t *) sc_array_index (&remote_found, ifound);
+      }
+      sc_array_truncate (&remote_found);
+    }
+  }
+  sc_array_reset (&remote_found);
+  t8_forest_nearest_exchange (forest, answers_send, answers_recv);
+
+  /* Merge the local and the remote candidates of each point */
+  for (iproc = 0; iproc < forest->mpisize; iproc++) {
+    for (ifound = 0; ifound < answers_recv[iproc].elem_count; ifound++) {
+      answer = (t8_forest_nearest_answer_t *)
+        sc_array_index (answers_recv + iproc, ifound);
+      T8_ASSERT (answer->index < num_points);
+      *(t8_forest_nearest_t *) sc_array_push (found + answer->index) =
+        answer->found;
+    }
+  }
+  result->num_points = num_points;
+  result->offsets = T8_ALLOC (size_t, num_points + 1);
+  result->offsets[0] = 0;
+  for (ipoint = 0; ipoint < num_points; ipoint++) {
+    sc_array_sort (found + ipoint, t8_forest_nearest_compare);
+    num_found = found[ipoint].elem_count;
+    if (k > 0) {
+      num_found = SC_MIN (num_found, (size_t) k);
+    }
+    result->offsets[ipoint + 1] = result->offsets[ipoint] + num_found;
+  }
+  result->elements = T8_ALLOC (t8_forest_nearest_t,
+                               result->offsets[num_points]);
+  for (ipoint = 0; ipoint < num_points; ipoint++) {
+    if (result->offsets[ipoint + 1] > result->offsets[ipoint]) {
+      memcpy (result->elements + result->offsets[ipoint],
+              found[ipoint].array,
+              (result->offsets[ipoint + 1] - result->offsets[ipoint])
+              * sizeof (t8_forest_nearest_t));
+    }
+    sc_array_reset (found + ipoint);
+  }
+
+  for (iproc = 0; iproc < forest->mpisize; iproc++) {
+    sc_array_reset (queries_send + iproc);
+    sc_array_reset (queries_recv + iproc);
+    sc_array_reset (answers_send + iproc);
+    sc_array_reset (answers_recv + iproc);
+  }
+  T8_FREE (queries_send);
+  T8_FREE (queries_recv);
+  T8_FREE (answers_send);
+  T8_FREE (answers_recv);
+  T8_FREE (found);
+  T8_FREE (boxes);
+  sc_array_reset (&heap);
+}
+
+void
+t8_forest_nearest_reset (t8_forest_nearest_result_t * result)
+{
+  T8_ASSERT (result != NULL);
+
+  T8_FREE (result->offsets);
+  T8_FREE (result->elements);
+  result->offsets = NULL;
+  result->elements = NULL;
+  result->num_points = 0;
+}
+
+T8_EXTERN_C_END ();
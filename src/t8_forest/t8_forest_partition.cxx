@@ -23,6 +23,7 @@
 #include <t8_forest/t8_forest_partition.h>
 #include <t8_forest/t8_forest_types.h>
 #include <t8_forest/t8_forest_private.h>
+#include <t8_forest/t8_forest_ghost.h>
 #include <t8_forest.h>
 #include <t8_cmesh/t8_cmesh_offset.h>
 #include <t8_element_cxx.hxx>
@@ -38,6 +39,7 @@ typedef struct
   t8_gloidx_t         gtree_id; /* The global id of that tree *//* TODO: we could optimize this out */
   t8_eclass_t         eclass;   /* The element class of that tree */
   t8_locidx_t         num_elements;     /* The number of elements from this tree that were sent */
+  size_t              num_bytes;        /* The number of bytes of these elements in the message */
 } t8_forest_partition_tree_info_t;
 
 /* Given the element offset array and a rank, return the first
@@ -318,15 +320,181 @@ t8_forest_partition_create_tree_offsets (t8_forest_t forest)
   }
 }
 
+/* Gather the capacities of all processes and compute their prefix sums.
+ * On output capacities[p] is the sum of the capacities of the processes
+ * 0 to p - 1 and capacities[mpisize] is the total capacity.
+ * Returns false if all capacities are equal, including the case that all
+ * are zero. Then all processes get the same share and we do not use the
+ * capacities, since their prefix sums may not be exact. */
+static int
+t8_forest_partition_gather_capacities (t8_forest_t forest,
+                                       double *capacities)
+{
+  double              min_capacity, max_capacity;
+  int                 iproc, mpiret;
+
+  T8_ASSERT (forest->set_partition_capacity >= 0);
+  mpiret = sc_MPI_Allgather (&forest->set_partition_capacity, 1,
+                             sc_MPI_DOUBLE, capacities + 1, 1, sc_MPI_DOUBLE,
+                             forest->mpicomm);
+  SC_CHECK_MPI (mpiret);
+  min_capacity = max_capacity = capacities[1];
+  capacities[0] = 0;
+  for (iproc = 0; iproc < forest->mpisize; iproc++) {
+    min_capacity = SC_MIN (min_capacity, capacities[iproc + 1]);
+    max_capacity = SC_MAX (max_capacity, capacities[iproc + 1]);
+    capacities[iproc + 1] += capacities[iproc];
+  }
+  return min_capacity != max_capacity;
+}
+
+/* Calculate the new element_offset for forest from the elements in
+ * forest->set_from, such that each process gets a range of elements
+ * with the same sum of weights.
+ * If capacities is not NULL, each process instead gets the share of the
+ * total weight given by its capacity, see
+ * \ref t8_forest_partition_gather_capacities.
+ * Each process computes the weights of its elements. The process in whose
+ * range of weights the first weight of rank p lies, computes the first element
+ * of rank p.
+ * Returns false without changing the offsets if all weights are zero. */
+static int
+t8_forest_partition_compute_weighted_offset (t8_forest_t forest,
+                                             const double *capacities)
+{
+  t8_forest_t         forest_from;
+  t8_eclass_scheme_c *ts;
+  t8_element_t       *element;
+  t8_locidx_t         itree, ielement, num_trees, num_elements;
+  t8_locidx_t         element_index;
+  t8_gloidx_t        *local_offsets, *new_offsets, first_element_id;
+  double             *weights, *rank_weights, local_weight, total_weight;
+  double              weight_begin, weight_end, target;
+  int                 iproc, mpiret;
+
+  forest_from = forest->set_from;
+  num_elements = t8_forest_get_local_num_elements (forest_from);
+  weights = T8_ALLOC (double, num_elements);
+  /* Compute the weight of each local element */
+  local_weight = 0;
+  element_index = 0;
+  num_trees = t8_forest_get_num_local_trees (forest_from);
+  for (itree = 0; itree < num_trees; itree++) {
+    ts = t8_forest_get_eclass_scheme (forest_from,
+                                      t8_forest_get_tree_class (forest_from,
+                                                                itree));
+    for (ielement = 0;
+         ielement < t8_forest_get_tree_num_elements (forest_from, itree);
+         ielement++, element_index++) {
+      element = t8_forest_get_element_in_tree (forest_from, itree, ielement);
+      weights[element_index] =
+        forest->set_partition_weight_fn (forest, forest_from, itree,
+                                         ielement, ts, element);
+      T8_ASSERT (weights[element_index] >= 0);
+      local_weight += weights[element_index];
+    }
+  }
+  /* Gather the weight of each process and compute the prefix sums.
+   * Since each process sums up in the same order, all processes
+   * agree on the weight ranges. */
+  rank_weights = T8_ALLOC (double, forest->mpisize + 1);
+  mpiret = sc_MPI_Allgather (&local_weight, 1, sc_MPI_DOUBLE,
+                             rank_weights + 1, 1, sc_MPI_DOUBLE,
+                             forest->mpicomm);
+  SC_CHECK_MPI (mpiret);
+  rank_weights[0] = 0;
+  for (iproc = 0; iproc < forest->mpisize; iproc++) {
+    rank_weights[iproc + 1] += rank_weights[iproc];
+  }
+  total_weight = rank_weights[forest->mpisize];
+
+  if (total_weight <= 0) {
+    /* All weights are zero */
+    T8_FREE (weights);
+    T8_FREE (rank_weights);
+    return 0;
+  }
+
+  /* The first element of rank p is the element whose weight range contains
+   * p * total_weight / mpisize. With capacities, it is the element whose
+   * weight range begins closest to the share of the processes before p
+   * of the total capacity times total_weight.
+   * We compute the first elements that lie in our
+   * weight range [rank_weights[rank], rank_weights[rank + 1]).
+   * All other entries are 0 and we combine them with a maximum reduction. */
+  local_offsets = T8_ALLOC_ZERO (t8_gloidx_t, forest->mpisize);
+  first_element_id = t8_forest_get_first_local_element_id (forest_from);
+  weight_begin = rank_weights[forest->mpirank];
+  element_index = 0;
+  for (iproc = 1; iproc < forest->mpisize; iproc++) {
+    if (capacities != NULL) {
+      target = total_weight * (capacities[iproc]
+                               / capacities[forest->mpisize]);
+    }
+    else {
+      target = iproc * (total_weight / forest->mpisize);
+    }
+    if (target >= total_weight) {
+      /* All processes from iproc on have zero capacity and get no elements */
+      local_offsets[iproc] = forest->global_num_elements;
+      continue;
+    }
+    if (target < rank_weights[forest->mpirank]) {
+      continue;
+    }
+    if (target >= rank_weights[forest->mpirank + 1]) {
+      break;
+    }
+    /* Find the element whose weight range contains target.
+     * The range of the last element ends at the agreed end of our range. */
+    for (;;) {
+      T8_ASSERT (element_index < num_elements);
+      weight_end = element_index == num_elements - 1 ?
+        rank_weights[forest->mpirank + 1]
+        : SC_MIN (weight_begin + weights[element_index],
+                  rank_weights[forest->mpirank + 1]);
+      if (target < weight_end) {
+        break;
+      }
+      weight_begin = weight_end;
+      element_index++;
+    }
+    /* With capacities we round to the nearest begin of an element, as
+     * t8_forest_partition_compute_new_offset does without weights */
+    local_offsets[iproc] = first_element_id + element_index
+      + (capacities != NULL && target - weight_begin > weight_end - target);
+  }
+  T8_FREE (weights);
+  T8_FREE (rank_weights);
+
+  /* Collect all first elements */
+  new_offsets = t8_shmem_array_get_gloidx_array (forest->element_offsets);
+  mpiret = sc_MPI_Allreduce (local_offsets, new_offsets, forest->mpisize,
+                             T8_MPI_GLOIDX, sc_MPI_MAX, forest->mpicomm);
+  SC_CHECK_MPI (mpiret);
+  T8_FREE (local_offsets);
+  t8_shmem_array_set_gloidx (forest->element_offsets, forest->mpisize,
+                             forest->global_num_elements);
+#ifdef T8_ENABLE_DEBUG
+  for (iproc = 0; iproc < forest->mpisize; iproc++) {
+    T8_ASSERT (new_offsets[iproc] <= new_offsets[iproc + 1]);
+  }
+#endif
+  return 1;
+}
+
 /* Calculate the new element_offset for forest from
- * the element in forest->set_from assuming a partition without
- * element weights */
+ * the element in forest->set_from. Without element weights and capacities,
+ * each process gets the same number of elements (maybe +1).
+ * With capacities, the number of elements of each process is proportional
+ * to its capacity. */
 static void
 t8_forest_partition_compute_new_offset (t8_forest_t forest)
 {
   t8_forest_t         forest_from;
   sc_MPI_Comm         comm;
   t8_gloidx_t         new_first_element_id;
+  double             *capacities = NULL;
   int                 i, mpiret, mpisize;
 
   T8_ASSERT (t8_forest_is_initialized (forest));
@@ -341,22 +509,48 @@ t8_forest_partition_compute_new_offset (t8_forest_t forest)
   /* Initialize the shmem array */
   t8_shmem_array_init (&forest->element_offsets, sizeof (t8_gloidx_t),
                        forest->mpisize + 1, comm);
+  if (forest->set_partition_capacity >= 0) {
+    capacities = T8_ALLOC (double, forest->mpisize + 1);
+    if (!t8_forest_partition_gather_capacities (forest, capacities)) {
+      /* All capacities are equal, we partition as without capacities */
+      T8_FREE (capacities);
+      capacities = NULL;
+    }
+  }
+  if (forest->set_partition_weight_fn != NULL
+      && t8_forest_partition_compute_weighted_offset (forest, capacities)) {
+    /* The offsets were computed from the element weights */
+    T8_FREE (capacities);
+    return;
+  }
   mpiret = sc_MPI_Comm_size (comm, &mpisize);
   SC_CHECK_MPI (mpiret);
 
   for (i = 0; i < mpisize; i++) {
     /* Calculate the first element index for each process. We convert to doubles to
      * prevent overflow */
-    new_first_element_id =
-      (((double) i *
-        (long double) forest_from->global_num_elements) / (double) mpisize);
-    T8_ASSERT (0 <= new_first_element_id &&
-               new_first_element_id < forest_from->global_num_elements);
+    if (capacities != NULL) {
+      /* Processes with zero capacity get no elements. We round to the
+       * nearest element, such that exact shares are not cut off. */
+      new_first_element_id = (t8_gloidx_t)
+        (forest_from->global_num_elements
+         * ((long double) capacities[i] / capacities[mpisize]) + 0.5);
+      T8_ASSERT (0 <= new_first_element_id &&
+                 new_first_element_id <= forest_from->global_num_elements);
+    }
+    else {
+      new_first_element_id =
+        (((double) i *
+          (long double) forest_from->global_num_elements) / (double) mpisize);
+      T8_ASSERT (0 <= new_first_element_id &&
+                 new_first_element_id < forest_from->global_num_elements);
+    }
     t8_shmem_array_set_gloidx (forest->element_offsets, i,
                                new_first_element_id);
   }
   t8_shmem_array_set_gloidx (forest->element_offsets, forest->mpisize,
                              forest->global_num_elements);
+  T8_FREE (capacities);
 }
 
 /* Find the owner of a given element.
@@ -495,6 +689,8 @@ t8_forest_partition_tree_first_last_el (t8_tree_t tree,
  *                              we would send elements from to the next process.
  * \param [in]  first_element_send The local id of the first element that we need to send.
  * \param [in]  last_element_send The local id of the last element that we need to send.
+ * \param [in]  compact         If true, the elements are encoded as compact keys,
+ *                              see \ref t8_forest_element_keys_encode.
  */
 /* The send buffer will look like this:
  *
@@ -507,7 +703,7 @@ t8_forest_partition_fill_buffer (t8_forest_t forest_from,
                                  char **send_buffer, int *buffer_alloc,
                                  t8_locidx_t * current_tree,
                                  t8_locidx_t first_element_send,
-                                 t8_locidx_t last_element_send)
+                                 t8_locidx_t last_element_send, int compact)
 {
   t8_locidx_t         num_elements_send;
   t8_tree_t           tree;
@@ -517,13 +713,25 @@ t8_forest_partition_fill_buffer (t8_forest_t forest_from,
   int                 last_element_is_last_tree_element = 0;
   t8_forest_partition_tree_info_t *tree_info;
   t8_locidx_t        *pnum_trees_send;
-  void               *pfirst_element;
   size_t              elem_size;
+  size_t             *tree_bytes, *tree_pos;
+  t8_locidx_t        *tree_first_element, *tree_num_elements;
+  t8_eclass_scheme_c *ts;
 
   current_element = first_element_send;
   tree_id = *current_tree;
   element_alloc = 0;
   num_trees_send = 0;
+  /* For each tree that we send from, we store the index of its first element
+   * that we send, the number of elements, and the number of bytes and
+   * position of its elements in the buffer. There are at most as many such
+   * trees as local trees starting from current_tree. */
+  num_trees_send = forest_from->trees->elem_count - *current_tree;
+  tree_first_element = T8_ALLOC (t8_locidx_t, num_trees_send);
+  tree_num_elements = T8_ALLOC (t8_locidx_t, num_trees_send);
+  tree_bytes = T8_ALLOC (size_t, num_trees_send);
+  tree_pos = T8_ALLOC (size_t, num_trees_send);
+  num_trees_send = 0;
   /* At first we calculate the number of bytes that fit in the buffer */
   while (current_element <= last_element_send) {
     /* Get the first tree that we send elements from */
@@ -541,8 +749,20 @@ t8_forest_partition_fill_buffer (t8_forest_t forest_from,
     /* We now know how many elements this tree will send */
     num_elements_send = last_tree_element - first_tree_element + 1;
     T8_ASSERT (num_elements_send > 0);
-    elem_size = t8_element_array_get_size (&tree->elements);
-    element_alloc += num_elements_send * elem_size;
+    tree_first_element[num_trees_send] = first_tree_element;
+    tree_num_elements[num_trees_send] = num_elements_send;
+    if (compact) {
+      ts = t8_forest_get_eclass_scheme (forest_from, tree->eclass);
+      tree_bytes[num_trees_send] =
+        t8_forest_element_keys_encode (ts, &tree->elements,
+                                       first_tree_element, num_elements_send,
+                                       NULL);
+    }
+    else {
+      elem_size = t8_element_array_get_size (&tree->elements);
+      tree_bytes[num_trees_send] = num_elements_send * elem_size;
+    }
+    element_alloc += tree_bytes[num_trees_send];
     current_element += num_elements_send;
     num_trees_send++;
     tree_id++;
@@ -570,38 +790,50 @@ t8_forest_partition_fill_buffer (t8_forest_t forest_from,
   pnum_trees_send = (t8_locidx_t *) * send_buffer;
   *pnum_trees_send = num_trees_send;
   for (tree_id = 0; tree_id < num_trees_send; tree_id++) {
-    /* Get the first tree that we send elements from */
     tree = t8_forest_get_tree (forest_from, tree_id + *current_tree);
-    (void)
-      t8_forest_partition_tree_first_last_el (tree, tree_id + *current_tree,
-                                              first_element_send,
-                                              last_element_send,
-                                              *current_tree,
-                                              &first_tree_element,
-                                              &last_tree_element);
-    /* We now know how many elements this tree will send */
-
-    num_elements_send = last_tree_element - first_tree_element + 1;
-
-    T8_ASSERT (num_elements_send > 0);
     /* Get the tree info struct for this tree and fill it */
     tree_info = (t8_forest_partition_tree_info_t *)
       (*send_buffer + tree_info_pos);
     tree_info->eclass = tree->eclass;
     tree_info->gtree_id = tree_id + *current_tree +
       forest_from->first_local_tree;
-    tree_info->num_elements = num_elements_send;
+    tree_info->num_elements = tree_num_elements[tree_id];
+    tree_info->num_bytes = tree_bytes[tree_id];
     tree_info_pos += sizeof (t8_forest_partition_tree_info_t);
-    /* We can now fill the send buffer with all elements of that tree */
-    pfirst_element =
-      t8_element_array_index_locidx (&tree->elements, first_tree_element);
-    elem_size = t8_element_array_get_size (&tree->elements);
-    memcpy (*send_buffer + element_pos, pfirst_element,
-            num_elements_send * elem_size);
-    element_pos += num_elements_send * elem_size;
+    /* Store where this tree's elements start in the buffer */
+    tree_pos[tree_id] = element_pos;
+    element_pos += tree_bytes[tree_id];
+  }
+  T8_ASSERT (element_pos == byte_alloc);
+  /* We can now fill the send buffer with all elements of the trees.
+   * Since the position of each tree's elements is known, this can be
+   * done in parallel. */
+  T8_OMP_PARALLEL_FOR
+  for (tree_id = 0; tree_id < num_trees_send; tree_id++) {
+    t8_tree_t           send_tree;
+    t8_eclass_scheme_c *send_ts;
+
+    send_tree = t8_forest_get_tree (forest_from, tree_id + *current_tree);
+    if (compact) {
+      send_ts = t8_forest_get_eclass_scheme (forest_from, send_tree->eclass);
+      (void) t8_forest_element_keys_encode (send_ts, &send_tree->elements,
+                                            tree_first_element[tree_id],
+                                            tree_num_elements[tree_id],
+                                            *send_buffer + tree_pos[tree_id]);
+    }
+    else {
+      memcpy (*send_buffer + tree_pos[tree_id],
+              t8_element_array_index_locidx (&send_tree->elements,
+                                             tree_first_element[tree_id]),
+              tree_bytes[tree_id]);
+    }
   }
   *current_tree += num_trees_send - 1 + last_element_is_last_tree_element;
   *buffer_alloc = byte_alloc;
+  T8_FREE (tree_first_element);
+  T8_FREE (tree_num_elements);
+  T8_FREE (tree_bytes);
+  T8_FREE (tree_pos);
   t8_debugf ("Post send of %i trees\n", num_trees_send);
 }
 
@@ -746,7 +978,8 @@ t8_forest_partition_sendloop (t8_forest_t forest, const int send_first,
         t8_forest_partition_fill_buffer (forest_from,
                                          buffer, &buffer_alloc,
                                          &current_tree, first_element_send,
-                                         last_element_send);
+                                         last_element_send,
+                                         forest->compact_messages);
       }
       else {
         T8_ASSERT (send_data);
@@ -893,8 +1126,8 @@ t8_forest_partition_recv_message (t8_forest_t forest, sc_MPI_Comm comm,
   size_t              tree_cursor, element_cursor;
   t8_forest_partition_tree_info_t *tree_info;
   t8_tree_t           tree, last_tree;
-  size_t              element_size;
-  void               *first_new_element;
+  t8_locidx_t        *tree_index, *tree_first_new;
+  size_t             *tree_element_pos;
   t8_eclass_scheme_c *eclass_scheme;
 
   if (proc != forest->mpirank) {
@@ -936,10 +1169,20 @@ t8_forest_partition_recv_message (t8_forest_t forest, sc_MPI_Comm comm,
     /* In last_local_tree we keep track of the latest tree we received */
     forest->last_local_tree = tree_info->gtree_id - 1;
   }
+  /* For each received tree, we store the local index of the tree in the
+   * forest, the index of its first new element and the position of
+   * its elements in recv_buffer. */
+  tree_index = T8_ALLOC (t8_locidx_t, num_trees);
+  tree_first_new = T8_ALLOC (t8_locidx_t, num_trees);
+  tree_element_pos = T8_ALLOC (size_t, num_trees);
   num_elements_recv = 0;
+  /* At first we add the new trees to the forest and allocate the
+   * elements. */
   for (itree = 0; itree < num_trees; itree++) {
     num_elements_recv += tree_info->num_elements;
     T8_ASSERT (tree_info->gtree_id >= forest->last_local_tree);
+    eclass_scheme =
+      t8_forest_get_eclass_scheme (forest->set_from, tree_info->eclass);
     if (tree_info->gtree_id > forest->last_local_tree) {
       /* We will insert a new tree in the forest */
       tree = (t8_tree_t) sc_array_push (forest->trees);
@@ -962,18 +1205,11 @@ t8_forest_partition_recv_message (t8_forest_t forest, sc_MPI_Comm comm,
         tree->elements_offset = 0;
       }
       /* Done calculating the element offset */
-      /* Get the size of an element of the tree */
-      eclass_scheme =
-        t8_forest_get_eclass_scheme (forest->set_from, tree->eclass);
-      element_size = eclass_scheme->t8_element_size ();
-      /* initialize the elements array and copy the elements from the receive buffer */
-      T8_ASSERT (element_cursor + tree_info->num_elements * element_size <=
-                 (size_t) recv_bytes);
       t8_debugf ("[H} init array for tree %i\n", itree);
-      t8_element_array_init_copy (&tree->elements, eclass_scheme,
-                                  (t8_element_t *) (recv_buffer +
-                                                    element_cursor),
+      /* initialize the elements array */
+      t8_element_array_init_size (&tree->elements, eclass_scheme,
                                   tree_info->num_elements);
+      old_num_elements = 0;
 #if 0
       /* Debugging output */
       t8_debugf ("receive %li elements for tree %lli\n",
@@ -996,34 +1232,59 @@ t8_forest_partition_recv_message (t8_forest_t forest, sc_MPI_Comm comm,
       new_num_elements = old_num_elements + tree_info->num_elements;
       /* Enlarge the elements array */
       t8_element_array_resize (&tree->elements, new_num_elements);
-      first_new_element = t8_element_array_index_locidx (&tree->elements,
-                                                         old_num_elements);
 #if 0
       /* Debugging output */
       t8_debugf ("receive %li elements for tree %lli\n",
                  (long) tree_info->num_elements,
                  (long long) tree_info->gtree_id);
 #endif
-      /* Get the size of an element of the tree */
-      eclass_scheme =
-        t8_forest_get_eclass_scheme (forest->set_from, tree->eclass);
-      element_size = eclass_scheme->t8_element_size ();
-      T8_ASSERT (element_size == t8_element_array_get_size (&tree->elements));
-      /* Copy the elements from the receive buffer to the elements array */
-      memcpy (first_new_element, recv_buffer + element_cursor,
-              tree_info->num_elements * element_size);
     }
+    T8_ASSERT (forest->compact_messages
+               || tree_info->num_bytes ==
+               tree_info->num_elements * eclass_scheme->t8_element_size ());
+    T8_ASSERT (element_cursor + tree_info->num_bytes <= (size_t) recv_bytes);
+    tree_index[itree] = forest->trees->elem_count - 1;
+    tree_first_new[itree] = old_num_elements;
+    tree_element_pos[itree] = element_cursor;
 
     /* compute the new number of local elements */
     forest->local_num_elements += tree_info->num_elements;
     /* Set the new last local tree */
     forest->last_local_tree = tree_info->gtree_id;
     /* advance the element cursor */
-    element_cursor += element_size * tree_info->num_elements;
+    element_cursor += tree_info->num_bytes;
     /* Advance to the next tree_info entry in the recv buffer */
     tree_cursor += sizeof (t8_forest_partition_tree_info_t);
     tree_info += 1;
   }
+  /* Now we copy or decode the elements from the receive buffer.
+   * Since all trees are allocated, this can be done in parallel. */
+  tree_info -= num_trees;
+  T8_OMP_PARALLEL_FOR
+  for (itree = 0; itree < num_trees; itree++) {
+    t8_tree_t           recv_tree;
+    t8_eclass_scheme_c *recv_ts;
+
+    recv_tree = t8_forest_get_tree (forest, tree_index[itree]);
+    if (forest->compact_messages) {
+      recv_ts =
+        t8_forest_get_eclass_scheme (forest->set_from, recv_tree->eclass);
+      (void) t8_forest_element_keys_decode (recv_ts, recv_buffer +
+                                            tree_element_pos[itree],
+                                            &recv_tree->elements,
+                                            tree_first_new[itree],
+                                            tree_info[itree].num_elements);
+    }
+    else {
+      memcpy (t8_element_array_index_locidx (&recv_tree->elements,
+                                             tree_first_new[itree]),
+              recv_buffer + tree_element_pos[itree],
+              tree_info[itree].num_bytes);
+    }
+  }
+  T8_FREE (tree_index);
+  T8_FREE (tree_first_new);
+  T8_FREE (tree_element_pos);
 
   if (proc != forest->mpirank) {
     T8_FREE (recv_buffer);
@@ -1293,4 +1554,96 @@ t8_forest_partition_data (t8_forest_t forest_from, t8_forest_t forest_to,
   t8_global_productionf ("Done forest partition data.\n");
 }
 
+int
+t8_forest_partition_is_equal (t8_forest_t forest_a, t8_forest_t forest_b)
+{
+  T8_ASSERT (t8_forest_is_committed (forest_a));
+  T8_ASSERT (t8_forest_is_committed (forest_b));
+
+  if (forest_a->maxlevel != forest_b->maxlevel) {
+    /* The first descendants are not comparable */
+    return 0;
+  }
+  /* The offset arrays are gathered and hence identical on all processes.
+   * Comparing them locally gives the same result on each process.
+   * t8_shmem_array_is_equal also compares the communicators. */
+  return t8_shmem_array_is_equal (forest_a->element_offsets,
+                                  forest_b->element_offsets)
+    && t8_shmem_array_is_equal (forest_a->tree_offsets,
+                                forest_b->tree_offsets)
+    && t8_shmem_array_is_equal (forest_a->global_first_desc,
+                                forest_b->global_first_desc);
+}
+
+/* Replace the shmem array *parray by a reference to array_from */
+static void
+t8_forest_share_shmem_array (t8_shmem_array_t * parray,
+                             t8_shmem_array_t array_from)
+{
+  T8_ASSERT (array_from != NULL);
+  if (*parray == array_from) {
+    /* The array is already shared */
+    return;
+  }
+  t8_shmem_array_ref (array_from);
+  if (*parray != NULL) {
+    t8_shmem_array_unref (parray);
+  }
+  *parray = array_from;
+}
+
+int
+t8_forest_share_partition (t8_forest_t forest, t8_forest_t forest_from,
+                           int check)
+{
+  int                 share_ghosts, all_share_ghosts, mpiret;
+
+  T8_ASSERT (t8_forest_is_committed (forest));
+  T8_ASSERT (t8_forest_is_committed (forest_from));
+  /* The offset arrays are created at commit */
+  T8_ASSERT (forest_from->element_offsets != NULL);
+  T8_ASSERT (forest_from->tree_offsets != NULL);
+  T8_ASSERT (forest_from->global_first_desc != NULL);
+
+  if (check) {
+    if (!t8_forest_partition_is_equal (forest, forest_from)) {
+      return 0;
+    }
+  }
+  T8_ASSERT (t8_forest_partition_is_equal (forest, forest_from));
+
+  /* Share the partition metadata. The send and receive ranges of
+   * t8_forest_partition_data are computed from these offsets on each call,
+   * reusing them as an exchange plan is not implemented yet. */
+  t8_forest_share_shmem_array (&forest->element_offsets,
+                               forest_from->element_offsets);
+  t8_forest_share_shmem_array (&forest->tree_offsets,
+                               forest_from->tree_offsets);
+  t8_forest_share_shmem_array (&forest->global_first_desc,
+                               forest_from->global_first_desc);
+
+  /* Share the ghost layer if it describes the same elements */
+  share_ghosts = forest->ghosts != NULL && forest_from->ghosts != NULL
+    && forest->ghosts != forest_from->ghosts
+    && forest->ghost_type == forest_from->ghost_type
+    && forest->cmesh == forest_from->cmesh;
+  if (share_ghosts && check) {
+    share_ghosts = t8_forest_is_equal (forest, forest_from);
+  }
+  /* All processes have to agree on sharing the ghosts */
+  mpiret = sc_MPI_Allreduce (&share_ghosts, &all_share_ghosts, 1,
+                             sc_MPI_INT, sc_MPI_LAND, forest->mpicomm);
+  SC_CHECK_MPI (mpiret);
+  if (all_share_ghosts) {
+    T8_ASSERT (t8_forest_is_equal (forest, forest_from));
+    t8_forest_ghost_ref (forest_from->ghosts);
+    t8_forest_ghost_unref (&forest->ghosts);
+    forest->ghosts = forest_from->ghosts;
+  }
+  t8_debugf ("Forest %p shares the partition%s of forest %p.\n",
+             (void *) forest, all_share_ghosts ? " and ghosts" : "",
+             (void *) forest_from);
+  return 1;
+}
+
 T8_EXTERN_C_END ();
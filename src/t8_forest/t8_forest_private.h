@@ -44,6 +44,12 @@ void                t8_forest_compute_desc (t8_forest_t forest);
  * of the coarse mesh. */
 void                t8_forest_populate (t8_forest_t forest);
 
+/* Commit a forest whose trees were filled by an algorithm other than
+ * \ref t8_forest_commit. The cmesh, scheme, communicator with rank and size,
+ * dimension, maxlevel, the trees array, the local tree range and the
+ * number of local elements must be set. The forest gets no ghost layer. */
+void                t8_forest_commit_trees (t8_forest_t forest);
+
 /** Return the eclass scheme of a given element class associated to a forest.
  * This function does not check whether the given forest is committed, use with
  * caution and only if you are sure that the eclass_scheme was set.
@@ -107,6 +113,12 @@ void                t8_forest_copy_trees (t8_forest_t forest,
                                           t8_forest_t from,
                                           int copy_elements);
 
+/* Set the trees and elements of forest to those of from.
+ * If forest holds the only reference of from, the trees are moved and from
+ * keeps no trees. Otherwise they are copied. */
+void                t8_forest_take_trees (t8_forest_t forest,
+                                          t8_forest_t from);
+
 /** Given the local id of a tree in a forest, return the coarse tree of the
  * cmesh that corresponds to this tree, also return the neighbor information of
  * the tree.
@@ -434,6 +446,42 @@ int                 t8_forest_element_has_leaf_desc (t8_forest_t forest,
                                                      element,
                                                      t8_eclass_scheme_c * ts);
 
+/** Encode a range of elements of one tree as compact keys.
+ * Each element is stored as its level and the linear id of its first
+ * descendant at the scheme's maximum level, delta-encoded with respect to
+ * the previous element and written as a variable length integer.
+ * For element classes whose linear ids are not based on 2^dim children
+ * (pyramids), the elements are copied verbatim.
+ * \param [in]  ts        The eclass scheme of the elements.
+ * \param [in]  elements  The elements of a tree.
+ * \param [in]  first     The index of the first element to encode.
+ * \param [in]  count     The number of elements to encode.
+ * \param [out] buffer    If not NULL, the keys are written here.
+ * \return                The number of bytes of the encoded elements.
+ */
+size_t              t8_forest_element_keys_encode (t8_eclass_scheme_c * ts,
+                                                   t8_element_array_t *
+                                                   elements,
+                                                   t8_locidx_t first,
+                                                   t8_locidx_t count,
+                                                   char *buffer);
+
+/** Decode elements that were encoded with \ref t8_forest_element_keys_encode.
+ * \param [in]  ts        The eclass scheme of the elements.
+ * \param [in]  buffer    The encoded elements.
+ * \param [in,out] elements An element array with at least \a first + \a count
+ *                        entries.
+ * \param [in]  first     The index of the first element to decode into.
+ * \param [in]  count     The number of encoded elements.
+ * \return                The number of bytes read from \a buffer.
+ */
+size_t              t8_forest_element_keys_decode (t8_eclass_scheme_c * ts,
+                                                   const char *buffer,
+                                                   t8_element_array_t *
+                                                   elements,
+                                                   t8_locidx_t first,
+                                                   t8_locidx_t count);
+
 T8_EXTERN_C_END ();
 
 #endif /* !T8_FOREST_PRIVATE_H! */
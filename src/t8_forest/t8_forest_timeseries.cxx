@@ -0,0 +1,460 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#include <t8_forest_timeseries.h>
+#include <t8_element_cxx.hxx>
+#include "t8_forest_types.h"
+
+/* We want to export the whole implementation to be callable from "C" */
+T8_EXTERN_C_BEGIN ();
+
+/* The XDMF cell type of each eclass in a topology of type "Mixed".
+ * Vertices and lines are stored as polyvertex and polyline and need
+ * an additional entry with their number of nodes. */
+static const int    t8_forest_xdmf_type[T8_ECLASS_COUNT] =
+  { 1, 2, 5, 4, 9, 6, 8, 7 };
+
+/* The number of values per element in an XDMF mixed topology array,
+ * that is the cell type, the node count for polyvertices and polylines,
+ * and the node indices. */
+static const int    t8_forest_xdmf_topology_entries[T8_ECLASS_COUNT] =
+  { 3, 4, 5, 4, 9, 5, 7, 6 };
+
+/* The number of values stored per element in each step file */
+#define T8_FOREST_TIMESERIES_NUM_VALUES(_type) \
+  ((_type) == T8_VTK_SCALAR ? 1 : 3)
+
+typedef struct t8_forest_timeseries
+{
+  char                fileprefix[BUFSIZ];       /**< The prefix of all output files. */
+  int                 num_steps;                /**< The number of written steps. */
+  int                 num_geometries;           /**< The number of written geometries. */
+  int64_t             geometry_stamp;           /**< The commit stamp of the forest of the current geometry. */
+  int                 mpisize;                  /**< The size of the communicator. Set at the first step. */
+  int                 mpirank;                  /**< Our rank in the communicator. Set at the first step. */
+  t8_locidx_t        *counts;                   /**< On rank 0: For each process the number of elements,
+                                                     points and topology entries of the current geometry. */
+  FILE               *xmffile;                  /**< On rank 0: The open .xmf file. */
+  long                xmf_end;                  /**< On rank 0: The position in \a xmffile at which
+                                                     the next step is written. */
+} t8_forest_timeseries_struct_t;
+
+t8_forest_timeseries_t
+t8_forest_timeseries_new (const char *fileprefix)
+{
+  t8_forest_timeseries_t series;
+  int                 sreturn;
+
+  T8_ASSERT (fileprefix != NULL);
+  series = T8_ALLOC_ZERO (t8_forest_timeseries_struct_t, 1);
+  sreturn = snprintf (series->fileprefix, BUFSIZ, "%s", fileprefix);
+  if (sreturn >= BUFSIZ) {
+    /* Note: gcc >= 7.1 prints a warning if we
+     * do not check the return value of snprintf. */
+    t8_debugf ("Warning: Truncated time series file prefix to '%s'\n",
+               series->fileprefix);
+  }
+  series->geometry_stamp = -1;
+  series->mpisize = -1;
+  return series;
+}
+
+/* Return the last part of the file prefix, such that the heavy data
+ * files can be referenced relative to the location of the .xmf file. */
+static const char  *
+t8_forest_timeseries_basename (t8_forest_timeseries_t series)
+{
+  const char         *slash;
+
+  slash = strrchr (series->fileprefix, '/');
+  return slash == NULL ? series->fileprefix : slash + 1;
+}
+
+/* Write the points and the mixed topology of the local elements to
+ * an open binary file. The points of each element are written separately,
+ * as in the .vtu output.
+ * Returns true on success and zero otherwise. */
+static int
+t8_forest_timeseries_write_geometry (t8_forest_t forest, FILE * binfile)
+{
+  t8_locidx_t         itree, num_local_trees;
+  t8_locidx_t         ielement, num_elements;
+  t8_locidx_t         node_id;
+  t8_locidx_t         topology[T8_ECLASS_MAX_CORNERS + 2];
+  t8_tree_t           tree;
+  t8_eclass_t         eclass;
+  t8_element_t       *element;
+  double             *tree_vertices, coordinates[3];
+  int                 ivertex, num_vertices, itopo;
+  size_t              num_written;
+
+  num_local_trees = t8_forest_get_num_local_trees (forest);
+  /* Write all point coordinates */
+  for (itree = 0; itree < num_local_trees; itree++) {
+    tree = t8_forest_get_tree (forest, itree);
+    eclass = tree->eclass;
+    SC_CHECK_ABORT (eclass != T8_ECLASS_PYRAMID,
+                    "Pyramids are not supported in time series output");
+    num_vertices = t8_eclass_num_vertices[eclass];
+    tree_vertices = t8_forest_get_tree_vertices (forest, itree);
+    num_elements = t8_forest_get_tree_num_elements (forest, itree);
+    for (ielement = 0; ielement < num_elements; ielement++) {
+      element = t8_forest_get_element_in_tree (forest, itree, ielement);
+      for (ivertex = 0; ivertex < num_vertices; ivertex++) {
+        t8_forest_element_coordinate (forest, itree, element, tree_vertices,
+                                      t8_eclass_vtk_corner_number[eclass]
+                                      [ivertex], coordinates);
+        num_written = fwrite (coordinates, sizeof (double), 3, binfile);
+        if (num_written != 3) {
+          return 0;
+        }
+      }
+    }
+  }
+  /* Write the topology. Since the points are not shared between
+   * elements, the node indices are just counted up. */
+  for (itree = 0, node_id = 0; itree < num_local_trees; itree++) {
+    eclass = t8_forest_get_tree_class (forest, itree);
+    num_vertices = t8_eclass_num_vertices[eclass];
+    num_elements = t8_forest_get_tree_num_elements (forest, itree);
+    for (ielement = 0; ielement < num_elements; ielement++) {
+      itopo = 0;
+      topology[itopo++] = t8_forest_xdmf_type[eclass];
+      if (eclass == T8_ECLASS_VERTEX || eclass == T8_ECLASS_LINE) {
+        topology[itopo++] = num_vertices;
+      }
+      for (ivertex = 0; ivertex < num_vertices; ivertex++) {
+        topology[itopo++] = node_id++;
+      }
+      T8_ASSERT (itopo == t8_forest_xdmf_topology_entries[eclass]);
+      num_written = fwrite (topology, sizeof (t8_locidx_t), itopo, binfile);
+      if (num_written != (size_t) itopo) {
+        return 0;
+      }
+    }
+  }
+  return 1;
+}
+
+/* Compute the number of local points and topology entries of a forest */
+static void
+t8_forest_timeseries_count (t8_forest_t forest, t8_locidx_t * num_points,
+                            t8_locidx_t * topology_length)
+{
+  t8_locidx_t         itree, num_elements;
+  t8_eclass_t         eclass;
+
+  *num_points = 0;
+  *topology_length = 0;
+  for (itree = 0; itree < t8_forest_get_num_local_trees (forest); itree++) {
+    eclass = t8_forest_get_tree_class (forest, itree);
+    num_elements = t8_forest_get_tree_num_elements (forest, itree);
+    *num_points += num_elements * t8_eclass_num_vertices[eclass];
+    *topology_length +=
+      num_elements * t8_forest_xdmf_topology_entries[eclass];
+  }
+}
+
+/* Write the description of the current step to the .xmf file and
+ * finish the file with the closing tags. Only called on rank 0.
+ * Returns true on success and zero otherwise. */
+static int
+t8_forest_timeseries_write_xmf (t8_forest_timeseries_t series, double time,
+                                int num_data, t8_vtk_data_field_t * data)
+{
+  FILE               *xmffile = series->xmffile;
+  const char         *base = t8_forest_timeseries_basename (series);
+  t8_locidx_t         num_elements, num_points, topology_length;
+  long long           seek;
+  int                 iproc, idata;
+  int                 freturn;
+
+  T8_ASSERT (series->mpirank == 0);
+  T8_ASSERT (xmffile != NULL);
+
+  /* Overwrite the closing tags of the previous step */
+  if (fseek (xmffile, series->xmf_end, SEEK_SET)) {
+    return 0;
+  }
+  fprintf (xmffile,
+           "      <Grid Name=\"step_%04d\" GridType=\"Collection\""
+           " CollectionType=\"Spatial\">\n"
+           "        <Time Value=\"%.16g\"/>\n", series->num_steps, time);
+  for (iproc = 0; iproc < series->mpisize; iproc++) {
+    num_elements = series->counts[3 * iproc];
+    num_points = series->counts[3 * iproc + 1];
+    topology_length = series->counts[3 * iproc + 2];
+    if (num_elements == 0) {
+      /* Empty processes do not write any files */
+      continue;
+    }
+    fprintf (xmffile,
+             "        <Grid Name=\"rank_%04d\" GridType=\"Uniform\">\n"
+             "          <Topology TopologyType=\"Mixed\""
+             " NumberOfElements=\"%lld\">\n"
+             "            <DataItem Dimensions=\"%lld\" NumberType=\"Int\""
+             " Precision=\"%d\" Format=\"Binary\" Endian=\"Native\""
+             " Seek=\"%lld\">%s_geometry_%04d_%04d.bin</DataItem>\n"
+             "          </Topology>\n"
+             "          <Geometry GeometryType=\"XYZ\">\n"
+             "            <DataItem Dimensions=\"%lld 3\" NumberType=\"Float\""
+             " Precision=\"%d\" Format=\"Binary\" Endian=\"Native\">"
+             "%s_geometry_%04d_%04d.bin</DataItem>\n"
+             "          </Geometry>\n", iproc,
+             (long long) num_elements, (long long) topology_length,
+             (int) sizeof (t8_locidx_t),
+             (long long) num_points * 3 * (long long) sizeof (double), base,
+             series->num_geometries - 1, iproc, (long long) num_points,
+             (int) sizeof (double), base, series->num_geometries - 1, iproc);
+    for (idata = 0, seek = 0; idata < num_data; idata++) {
+      if (data[idata].type == T8_VTK_SCALAR) {
+        fprintf (xmffile,
+                 "          <Attribute Name=\"%s\" AttributeType=\"Scalar\""
+                 " Center=\"Cell\">\n"
+                 "            <DataItem Dimensions=\"%lld\"",
+                 data[idata].description, (long long) num_elements);
+      }
+      else {
+        T8_ASSERT (data[idata].type == T8_VTK_VECTOR);
+        fprintf (xmffile,
+                 "          <Attribute Name=\"%s\" AttributeType=\"Vector\""
+                 " Center=\"Cell\">\n"
+                 "            <DataItem Dimensions=\"%lld 3\"",
+                 data[idata].description, (long long) num_elements);
+      }
+      fprintf (xmffile, " NumberType=\"Float\" Precision=\"%d\""
+               " Format=\"Binary\" Endian=\"Native\" Seek=\"%lld\">"
+               "%s_step_%04d_%04d.bin</DataItem>\n"
+               "          </Attribute>\n", (int) sizeof (double), seek,
+               base, series->num_steps, iproc);
+      seek += (long long) num_elements *
+        T8_FOREST_TIMESERIES_NUM_VALUES (data[idata].type) * sizeof (double);
+    }
+    fprintf (xmffile, "        </Grid>\n");
+  }
+  fprintf (xmffile, "      </Grid>\n");
+  /* Remember where to continue with the next step */
+  series->xmf_end = ftell (xmffile);
+  /* Close all open tags, such that the file is valid after each step */
+  freturn = fprintf (xmffile, "    </Grid>\n  </Domain>\n</Xdmf>\n");
+  if (freturn <= 0 || series->xmf_end < 0 || ferror (xmffile)) {
+    return 0;
+  }
+  return fflush (xmffile) == 0;
+}
+
+/* Open the .xmf file and write its header. Only called on rank 0.
+ * Returns true on success and zero otherwise. */
+static int
+t8_forest_timeseries_open_xmf (t8_forest_timeseries_t series)
+{
+  char                xmffilename[BUFSIZ];
+  int                 freturn;
+
+  T8_ASSERT (series->mpirank == 0);
+  freturn = snprintf (xmffilename, BUFSIZ, "%s.xmf", series->fileprefix);
+  if (freturn >= BUFSIZ) {
+    t8_errorf ("Error when writing xmf file. Filename too long.\n");
+    return 0;
+  }
+  series->xmffile = fopen (xmffilename, "w");
+  if (series->xmffile == NULL) {
+    t8_errorf ("Error when opening file %s\n", xmffilename);
+    return 0;
+  }
+  freturn = fprintf (series->xmffile, "<?xml version=\"1.0\" ?>\n"
+                     "<!DOCTYPE Xdmf SYSTEM \"Xdmf.dtd\" []>\n"
+                     "<Xdmf Version=\"3.0\">\n" "  <Domain>\n"
+                     "    <Grid Name=\"TimeSeries\" GridType=\"Collection\""
+                     " CollectionType=\"Temporal\">\n");
+  if (freturn <= 0) {
+    return 0;
+  }
+  series->xmf_end = ftell (series->xmffile);
+  return series->xmf_end >= 0;
+}
+
+/* Open a binary heavy data file of this process for writing.
+ * Returns NULL on failure. */
+static FILE        *
+t8_forest_timeseries_open_bin (t8_forest_timeseries_t series,
+                               const char *kind, int index)
+{
+  char                binfilename[BUFSIZ];
+  FILE               *binfile;
+  int                 freturn;
+
+  freturn = snprintf (binfilename, BUFSIZ, "%s_%s_%04d_%04d.bin",
+                      series->fileprefix, kind, index, series->mpirank);
+  if (freturn >= BUFSIZ) {
+    t8_errorf ("Error when writing time series. Filename too long.\n");
+    return NULL;
+  }
+  binfile = fopen (binfilename, "wb");
+  if (binfile == NULL) {
+    t8_errorf ("Error when opening file %s\n", binfilename);
+  }
+  return binfile;
+}
+
+int
+t8_forest_timeseries_write_step (t8_forest_timeseries_t series,
+                                 t8_forest_t forest, double time,
+                                 int num_data, t8_vtk_data_field_t * data)
+{
+  FILE               *binfile = NULL;
+  t8_locidx_t         local_counts[3];
+  t8_locidx_t         num_elements;
+  size_t              num_values;
+  int                 new_geometry, geometry_changed;
+  int                 idata, mpiret;
+
+  T8_ASSERT (series != NULL);
+  T8_ASSERT (t8_forest_is_committed (forest));
+  T8_ASSERT (num_data == 0 || data != NULL);
+
+  if (series->mpisize < 0) {
+    series->mpisize = forest->mpisize;
+    series->mpirank = forest->mpirank;
+    if (series->mpirank == 0) {
+      series->counts = T8_ALLOC (t8_locidx_t, 3 * series->mpisize);
+    }
+  }
+  SC_CHECK_ABORT (series->mpisize == forest->mpisize,
+                  "All forests of a time series must use the same number"
+                  " of processes.");
+  T8_ASSERT (series->mpirank == forest->mpirank);
+
+  /* The forest may have changed on some processes only, for example
+   * if it was repartitioned. We need to rewrite the geometry if it
+   * changed anywhere. */
+  new_geometry = forest->commit_stamp != series->geometry_stamp;
+  mpiret = sc_MPI_Allreduce (&new_geometry, &geometry_changed, 1, sc_MPI_INT,
+                             sc_MPI_MAX, forest->mpicomm);
+  SC_CHECK_MPI (mpiret);
+  num_elements = t8_forest_get_local_num_elements (forest);
+
+  if (geometry_changed) {
+    /* Rank 0 needs to know the sizes of all heavy data files
+     * to describe them in the .xmf file. */
+    local_counts[0] = num_elements;
+    t8_forest_timeseries_count (forest, local_counts + 1, local_counts + 2);
+    mpiret = sc_MPI_Gather (local_counts, 3, T8_MPI_LOCIDX, series->counts,
+                            3, T8_MPI_LOCIDX, 0, forest->mpicomm);
+    SC_CHECK_MPI (mpiret);
+    series->geometry_stamp = forest->commit_stamp;
+    series->num_geometries++;
+
+    /* Write the points and topology of this forest once. */
+    if (num_elements > 0) {
+      binfile = t8_forest_timeseries_open_bin (series, "geometry",
+                                               series->num_geometries - 1);
+      if (binfile == NULL) {
+        goto t8_forest_timeseries_failure;
+      }
+      if (!t8_forest_timeseries_write_geometry (forest, binfile)) {
+        goto t8_forest_timeseries_failure;
+      }
+      if (fclose (binfile)) {
+        binfile = NULL;
+        goto t8_forest_timeseries_failure;
+      }
+      binfile = NULL;
+    }
+    t8_debugf ("Wrote time series geometry %i\n", series->num_geometries - 1);
+  }
+
+  /* Write the data fields of this step */
+  if (num_elements > 0 && num_data > 0) {
+    binfile = t8_forest_timeseries_open_bin (series, "step",
+                                             series->num_steps);
+    if (binfile == NULL) {
+      goto t8_forest_timeseries_failure;
+    }
+    for (idata = 0; idata < num_data; idata++) {
+      num_values = (size_t) num_elements *
+        T8_FOREST_TIMESERIES_NUM_VALUES (data[idata].type);
+      if (fwrite (data[idata].data, sizeof (double), num_values, binfile)
+          != num_values) {
+        goto t8_forest_timeseries_failure;
+      }
+    }
+    if (fclose (binfile)) {
+      binfile = NULL;
+      goto t8_forest_timeseries_failure;
+    }
+    binfile = NULL;
+  }
+
+  if (series->mpirank == 0) {
+    if (series->xmffile == NULL && !t8_forest_timeseries_open_xmf (series)) {
+      goto t8_forest_timeseries_failure;
+    }
+    if (!t8_forest_timeseries_write_xmf (series, time, num_data, data)) {
+      goto t8_forest_timeseries_failure;
+    }
+  }
+  series->num_steps++;
+  return 1;
+t8_forest_timeseries_failure:
+  if (binfile != NULL) {
+    fclose (binfile);
+  }
+  t8_errorf ("Error when writing time series step %i.\n", series->num_steps);
+  series->num_steps++;
+  return 0;
+}
+
+int
+t8_forest_timeseries_get_num_steps (t8_forest_timeseries_t series)
+{
+  T8_ASSERT (series != NULL);
+  return series->num_steps;
+}
+
+int
+t8_forest_timeseries_get_num_geometries (t8_forest_timeseries_t series)
+{
+  T8_ASSERT (series != NULL);
+  return series->num_geometries;
+}
+
+void
+t8_forest_timeseries_destroy (t8_forest_timeseries_t * pseries)
+{
+  t8_forest_timeseries_t series;
+
+  T8_ASSERT (pseries != NULL);
+  series = *pseries;
+  T8_ASSERT (series != NULL);
+  if (series->xmffile != NULL) {
+    if (fclose (series->xmffile)) {
+      t8_errorf ("Error when closing time series file %s.xmf\n",
+                 series->fileprefix);
+    }
+  }
+  T8_FREE (series->counts);
+  T8_FREE (series);
+  *pseries = NULL;
+}
+
+T8_EXTERN_C_END ();
@@ -89,6 +89,20 @@ typedef struct t8_forest
                                              is set to T8_FOREST_FROM_ADAPT. */
   int                 set_adapt_recursive; /**< Flag to decide whether coarsen and refine
                                                 are carried out recursive */
+  t8_forest_adapt_target_t set_adapt_target_fn; /**< Target level function. Called when \b from_method
+                                                   is set to T8_FOREST_FROM_ADAPT.
+                                                   See \ref t8_forest_set_adapt_target. */
+  const int          *set_adapt_target_levels; /**< Target level of each element of \b set_from,
+                                                    if \a set_adapt_target_fn is NULL. */
+  int                 set_adapt_split_families; /**< Flag to decide whether families that are split
+                                                     across processes may be coarsened.
+                                                     See \ref t8_forest_set_adapt_split_families. */
+  t8_forest_partition_weight_t set_partition_weight_fn; /**< Element weights for partition.
+                                                     See \ref t8_forest_set_partition_weight. */
+  void               *set_partition_weight_data; /**< Data for \b set_partition_weight_fn. */
+  double              set_partition_capacity;   /**< The capacity of this process for partition.
+                                                     Negative if not set.
+                                                     See \ref t8_forest_set_partition_capacity. */
   int                 set_balance;      /**< Flag to decide whether to forest will be balance in \ref t8_forest_commit.
                                              See \ref t8_forest_set_balance.
                                              If 0, no balance. If 1 balance with repartitioning, if 2 balance without
@@ -97,10 +111,25 @@ typedef struct t8_forest
   t8_ghost_type_t     ghost_type;       /**< If a ghost layer will be created, the type of neighbors that count as ghost. */
   int                 ghost_algorithm;  /**< Controls the algorithm used for ghost. 1 = balanced only. 2 = also unbalanced
                                              3 = top-down search and unbalanced. */
+  int                 compact_messages; /**< If true, elements in partition and ghost messages are encoded
+                                             as (level, linear id) keys. -1 if not set, in which case
+                                             the value of \b set_from is used.
+                                             \see t8_forest_set_compact_messages */
   void               *user_data;        /**< Pointer for arbitrary user data. \see t8_forest_set_user_data. */
   void                (*user_function) ();/**< Pointer for arbitrary user function. \see t8_forest_set_user_function. */
   void               *t8code_data;      /**< Pointer for arbitrary data that is used internally. */
   int                 committed;        /**< \ref t8_forest_commit called? */
+  int                 is_unchanged;     /**< True if the forest was adapted and no element changed on any process.
+                                             \see t8_forest_is_unchanged */
+  int                 is_partitioned;   /**< True if the elements were distributed evenly by partition
+                                             without weights and capacities or by uniform construction.
+                                             An unchanged adaptation of such a forest is not partitioned again. */
+  int                 is_balanced;      /**< True if the forest is known to be balanced, since it was
+                                             balanced or constructed uniform. An unchanged adaptation of such a
+                                             forest is not balanced again. */
+  int64_t             commit_stamp;     /**< Process local number that is unique for each committed forest.
+                                             Used to detect whether output of a forest was already written.
+                                             \see t8_forest_timeseries.h */
   int                 mpisize;          /**< Number of MPI processes. */
   int                 mpirank;          /**< Number of this MPI process. */
 
@@ -125,6 +125,18 @@ typedef int         (*t8_forest_vtk_cell_data_kernel) (t8_forest_t forest,
                                                        T8_VTK_KERNEL_MODUS
                                                        modus);
 
+/* The data needed to write the elements as vtk Lagrange cells */
+typedef struct
+{
+  int                 order;    /* The polynomial order of the cells */
+  int                 num_nodes[T8_ECLASS_COUNT];       /* The number of nodes per cell for each eclass */
+  double             *ref_nodes[T8_ECLASS_COUNT];       /* For each eclass the reference coordinates of the
+                                                           nodes in vtk ordering, NULL if not computed */
+  t8_locidx_t         node_count;       /* The number of nodes already traversed
+                                           by the current kernel */
+  double             *values;   /* The nodal values of the current data field */
+} t8_forest_vtk_lagrange_t;
+
 void
 t8_forest_write_vtk_via_API (t8_forest_t forest, const char *fileprefix)
 {
@@ -323,7 +335,8 @@ t8_forest_write_vtk_via_API (t8_forest_t forest, const char *fileprefix)
 }
 
 static              t8_locidx_t
-t8_forest_num_points (t8_forest_t forest, int count_ghosts)
+t8_forest_num_points (t8_forest_t forest, int count_ghosts,
+                      const t8_forest_vtk_lagrange_t * lagrange)
 {
   t8_locidx_t         itree, num_points, num_ghosts;
   t8_tree_t           tree;
@@ -333,6 +346,12 @@ t8_forest_num_points (t8_forest_t forest, int count_ghosts)
   for (itree = 0; itree < (t8_locidx_t) forest->trees->elem_count; itree++) {
     /* Get the tree that stores the elements */
     tree = (t8_tree_t) t8_sc_array_index_topidx (forest->trees, itree);
+    if (lagrange != NULL) {
+      /* Each element has the nodes of its Lagrange cell */
+      num_points += lagrange->num_nodes[tree->eclass] *
+        t8_element_array_get_count (&tree->elements);
+      continue;
+    }
     /* TODO: This will cause problems when pyramids are introduced. */
     num_points += t8_eclass_num_vertices[tree->eclass] *
       t8_element_array_get_count (&tree->elements);
@@ -719,8 +738,11 @@ t8_forest_vtk_cells_treeid_kernel (t8_forest_t forest,
   if (modus == T8_VTK_KERNEL_EXECUTE) {
     long long           tree_id;
     if (is_ghost) {
-      /* For ghost elements we write -1 as the tree is */
-      tree_id = -1;
+      /* For ghost elements the global id of the ghost tree */
+      tree_id = (long long) t8_forest_ghost_get_global_treeid (forest,
+                                                               ltree_id -
+                                                               t8_forest_get_num_local_trees
+                                                               (forest));
     }
     else {
       /* Otherwise the global tree id */
@@ -748,7 +770,13 @@ t8_forest_vtk_cells_elementid_kernel (t8_forest_t forest,
                (long long) t8_forest_get_first_local_element_id (forest));
     }
     else {
-      fprintf (vtufile, "%lli ", (long long) -1);
+      /* For ghost elements the global id that they have on their owner */
+      fprintf (vtufile, "%lli ",
+               (long long) t8_forest_ghost_get_global_element_id (forest,
+                                                                  ltree_id -
+                                                                  t8_forest_get_num_local_trees
+                                                                  (forest),
+                                                                  element_index));
     }
     *columns += 1;
   }
@@ -894,6 +922,652 @@ t8_forest_vtk_vertices_vector_kernel (t8_forest_t forest,
   return 1;
 }
 
+int
+t8_forest_vtk_lagrange_num_nodes (t8_eclass_t eclass, int order)
+{
+  T8_ASSERT (order >= 1);
+  switch (eclass) {
+  case T8_ECLASS_VERTEX:
+    return 1;
+  case T8_ECLASS_LINE:
+    return order + 1;
+  case T8_ECLASS_QUAD:
+    return (order + 1) * (order + 1);
+  case T8_ECLASS_TRIANGLE:
+    return (order + 1) * (order + 2) / 2;
+  case T8_ECLASS_HEX:
+    return (order + 1) * (order + 1) * (order + 1);
+  case T8_ECLASS_TET:
+    return (order + 1) * (order + 2) * (order + 3) / 6;
+  case T8_ECLASS_PRISM:
+    return (order + 1) * (order + 1) * (order + 2) / 2;
+  default:
+    SC_ABORT ("Lagrange cells are not supported for pyramids.");
+  }
+  return 0;
+}
+
+/* Compute the vtk index of the node (i, j) of a Lagrange quadrilateral
+ * of order \a order. Corners first, then the edges 0-1, 1-2, 3-2, 0-3,
+ * then the interior nodes with i running fastest. */
+static int
+t8_forest_vtk_lagrange_quad_index (int i, int j, int order)
+{
+  const int           ibdy = (i == 0 || i == order);
+  const int           jbdy = (j == 0 || j == order);
+  int                 offset;
+
+  if (ibdy && jbdy) {
+    /* corner node */
+    return (i ? (j ? 2 : 1) : (j ? 3 : 0));
+  }
+  offset = 4;
+  if (jbdy) {
+    /* node on an edge in i direction */
+    return offset + (i - 1) + (j ? 2 * (order - 1) : 0);
+  }
+  if (ibdy) {
+    /* node on an edge in j direction */
+    return offset + (j - 1) + (i ? order - 1 : 3 * (order - 1));
+  }
+  offset += 4 * (order - 1);
+  return offset + (i - 1) + (order - 1) * (j - 1);
+}
+
+/* Compute the vtk index of the node (i, j, k) of a Lagrange hexahedron
+ * of order \a order. Corners first, then the edges of the bottom and the top
+ * face as for quadrilaterals, then the edges in k direction, then the
+ * interior nodes of the faces with normal in i, j and k direction and
+ * last the interior nodes with i running fastest. */
+static int
+t8_forest_vtk_lagrange_hex_index (int i, int j, int k, int order)
+{
+  const int           ibdy = (i == 0 || i == order);
+  const int           jbdy = (j == 0 || j == order);
+  const int           kbdy = (k == 0 || k == order);
+  const int           nbdy = ibdy + jbdy + kbdy;
+  const int           om1 = order - 1;
+  int                 offset;
+
+  if (nbdy == 3) {
+    /* corner node */
+    return (i ? (j ? 2 : 1) : (j ? 3 : 0)) + (k ? 4 : 0);
+  }
+  offset = 8;
+  if (nbdy == 2) {
+    /* edge node */
+    if (!ibdy) {
+      return offset + (i - 1) + (j ? 2 * om1 : 0) + (k ? 4 * om1 : 0);
+    }
+    if (!jbdy) {
+      return offset + (j - 1) + (i ? om1 : 3 * om1) + (k ? 4 * om1 : 0);
+    }
+    offset += 8 * om1;
+    return offset + (k - 1) + om1 * (i ? (j ? 3 : 1) : (j ? 2 : 0));
+  }
+  offset += 12 * om1;
+  if (nbdy == 1) {
+    /* face node */
+    if (ibdy) {
+      return offset + (j - 1) + om1 * (k - 1) + (i ? om1 * om1 : 0);
+    }
+    offset += 2 * om1 * om1;
+    if (jbdy) {
+      return offset + (i - 1) + om1 * (k - 1) + (j ? om1 * om1 : 0);
+    }
+    offset += 2 * om1 * om1;
+    return offset + (i - 1) + om1 * (j - 1) + (k ? om1 * om1 : 0);
+  }
+  /* interior node */
+  offset += 6 * om1 * om1;
+  return offset + (i - 1) + om1 * ((j - 1) + om1 * (k - 1));
+}
+
+/* Compute the vtk index of the node (i, j, k) with i + j <= order of a
+ * Lagrange wedge of order \a order. Corners first, then the edges of the
+ * bottom and the top triangle, then the edges in k direction, then the
+ * interior nodes of the two triangles, then the interior nodes of the
+ * three quadrilateral faces and last the interior nodes.
+ * Interior nodes of triangles are numbered row by row. */
+static int
+t8_forest_vtk_lagrange_wedge_index (int i, int j, int k, int order)
+{
+  const int           ibdy = (i == 0);
+  const int           jbdy = (j == 0);
+  const int           ijbdy = (i + j == order);
+  const int           kbdy = (k == 0 || k == order);
+  const int           nbdy = ibdy + jbdy + ijbdy + kbdy;
+  const int           om1 = order - 1;
+  /* Number of interior nodes of a triangle and a quadrilateral face */
+  const int           ntri = (order - 2) * om1 / 2;
+  const int           nquad = om1 * om1;
+  int                 offset;
+  int                 tri_offset;
+
+  T8_ASSERT (i + j <= order);
+  if (nbdy == 3) {
+    /* corner node */
+    return (ibdy && jbdy ? 0 : (jbdy && ijbdy ? 1 : 2)) + (k ? 3 : 0);
+  }
+  offset = 6;
+  if (nbdy == 2) {
+    /* edge node */
+    if (!kbdy) {
+      offset += 6 * om1;
+      return offset + (k - 1) + (ibdy && jbdy ? 0 : (jbdy && ijbdy ? 1 : 2))
+        * om1;
+    }
+    offset += (k ? 3 * om1 : 0);
+    if (jbdy) {
+      return offset + i - 1;
+    }
+    offset += om1;
+    if (ijbdy) {
+      return offset + j - 1;
+    }
+    offset += om1;
+    return offset + order - j - 1;
+  }
+  offset += 9 * om1;
+  /* The row wise index of (i, j) among the interior triangle nodes */
+  tri_offset = ntri - (order - j - 1) * (order - j) / 2 + i - 1;
+  if (nbdy == 1) {
+    /* face node */
+    if (kbdy) {
+      return offset + (k ? ntri : 0) + tri_offset;
+    }
+    offset += 2 * ntri;
+    if (jbdy) {
+      return offset + (i - 1) + om1 * (k - 1);
+    }
+    offset += nquad;
+    if (ijbdy) {
+      return offset + (order - i - 1) + om1 * (k - 1);
+    }
+    offset += nquad;
+    return offset + (j - 1) + om1 * (k - 1);
+  }
+  /* interior node */
+  offset += 2 * ntri + 3 * nquad;
+  return offset + tri_offset + ntri * (k - 1);
+}
+
+/* Compute the reference coordinates of the nodes of a Lagrange triangle
+ * (dim = 2) or tetrahedron (dim = 3) of order \a order with the given corners.
+ * The nodes are appended to \a nodes in vtk ordering starting at index
+ * \a inode, which is increased accordingly. These are the corners, the edges
+ * 0-1, 1-2, 2-0 (and 0-3, 1-3, 2-3), the faces 0-1-3, 1-2-3, 2-0-3, 0-2-1
+ * for tetrahedra, and last the interior nodes as a simplex of lower order. */
+static void
+t8_forest_vtk_lagrange_simplex_nodes (int dim, int order,
+                                      double corners[4][3], double *nodes,
+                                      int *inode)
+{
+  const int           edges[6][2] = { {0, 1}, {1, 2}, {2, 0},
+  {0, 3}, {1, 3}, {2, 3}
+  };
+  const int           faces[4][3] = { {0, 1, 3}, {1, 2, 3}, {2, 0, 3},
+  {0, 2, 1}
+  };
+  double              sub_corners[4][3];
+  int                 icorner, jcorner, iedge, iface, inode_edge, idim;
+  const int           num_corners = dim + 1;
+  const int           num_edges = dim == 2 ? 3 : 6;
+
+  if (order == 0) {
+    /* A simplex of order 0 consists of its first corner only */
+    memcpy (nodes + 3 * (*inode)++, corners[0], 3 * sizeof (double));
+    return;
+  }
+  for (icorner = 0; icorner < num_corners; icorner++) {
+    memcpy (nodes + 3 * (*inode)++, corners[icorner], 3 * sizeof (double));
+  }
+  for (iedge = 0; iedge < num_edges; iedge++) {
+    for (inode_edge = 1; inode_edge < order; inode_edge++, (*inode)++) {
+      for (idim = 0; idim < 3; idim++) {
+        nodes[3 * *inode + idim] = corners[edges[iedge][0]][idim]
+          + inode_edge / (double) order * (corners[edges[iedge][1]][idim]
+                                           - corners[edges[iedge][0]][idim]);
+      }
+    }
+  }
+  if (dim == 3 && order >= 3) {
+    /* The interior nodes of each face form a triangle of order - 3 */
+    for (iface = 0; iface < 4; iface++) {
+      for (icorner = 0; icorner < 3; icorner++) {
+        for (idim = 0; idim < 3; idim++) {
+          sub_corners[icorner][idim] = corners[faces[iface][icorner]][idim];
+          for (jcorner = 0; jcorner < 3; jcorner++) {
+            sub_corners[icorner][idim] +=
+              (corners[faces[iface][jcorner]][idim]
+               - corners[faces[iface][icorner]][idim]) / order;
+          }
+        }
+      }
+      t8_forest_vtk_lagrange_simplex_nodes (2, order - 3, sub_corners, nodes,
+                                            inode);
+    }
+  }
+  if (order > dim) {
+    /* The interior nodes form a simplex of order - dim - 1 */
+    for (icorner = 0; icorner < num_corners; icorner++) {
+      for (idim = 0; idim < 3; idim++) {
+        sub_corners[icorner][idim] = corners[icorner][idim];
+        for (jcorner = 0; jcorner < num_corners; jcorner++) {
+          sub_corners[icorner][idim] +=
+            (corners[jcorner][idim] - corners[icorner][idim]) / order;
+        }
+      }
+    }
+    t8_forest_vtk_lagrange_simplex_nodes (dim, order - dim - 1, sub_corners,
+                                          nodes, inode);
+  }
+}
+
+/* Compute the coordinates of the nodes of a Lagrange cell of class \a eclass
+ * and order \a order in the vtk reference cell.
+ * \a nodes must have space for 3 * t8_forest_vtk_lagrange_num_nodes doubles. */
+static void
+t8_forest_vtk_lagrange_reference_nodes (t8_eclass_t eclass, int order,
+                                        double *nodes)
+{
+  double              corners[4][3] = { {0, 0, 0}, {1, 0, 0}, {0, 1, 0},
+  {0, 0, 1}
+  };
+  int                 i, j, k, index, inode = 0;
+
+  switch (eclass) {
+  case T8_ECLASS_VERTEX:
+    nodes[0] = nodes[1] = nodes[2] = 0;
+    break;
+  case T8_ECLASS_LINE:
+    for (i = 0; i <= order; i++) {
+      index = i == 0 ? 0 : (i == order ? 1 : i + 1);
+      nodes[3 * index] = i / (double) order;
+      nodes[3 * index + 1] = nodes[3 * index + 2] = 0;
+    }
+    break;
+  case T8_ECLASS_QUAD:
+    for (j = 0; j <= order; j++) {
+      for (i = 0; i <= order; i++) {
+        index = t8_forest_vtk_lagrange_quad_index (i, j, order);
+        nodes[3 * index] = i / (double) order;
+        nodes[3 * index + 1] = j / (double) order;
+        nodes[3 * index + 2] = 0;
+      }
+    }
+    break;
+  case T8_ECLASS_HEX:
+    for (k = 0; k <= order; k++) {
+      for (j = 0; j <= order; j++) {
+        for (i = 0; i <= order; i++) {
+          index = t8_forest_vtk_lagrange_hex_index (i, j, k, order);
+          nodes[3 * index] = i / (double) order;
+          nodes[3 * index + 1] = j / (double) order;
+          nodes[3 * index + 2] = k / (double) order;
+        }
+      }
+    }
+    break;
+  case T8_ECLASS_PRISM:
+    for (k = 0; k <= order; k++) {
+      for (j = 0; j <= order; j++) {
+        for (i = 0; i + j <= order; i++) {
+          index = t8_forest_vtk_lagrange_wedge_index (i, j, k, order);
+          nodes[3 * index] = i / (double) order;
+          nodes[3 * index + 1] = j / (double) order;
+          nodes[3 * index + 2] = k / (double) order;
+        }
+      }
+    }
+    break;
+  case T8_ECLASS_TRIANGLE:
+    t8_forest_vtk_lagrange_simplex_nodes (2, order, corners, nodes, &inode);
+    T8_ASSERT (inode == t8_forest_vtk_lagrange_num_nodes (eclass, order));
+    break;
+  case T8_ECLASS_TET:
+    t8_forest_vtk_lagrange_simplex_nodes (3, order, corners, nodes, &inode);
+    T8_ASSERT (inode == t8_forest_vtk_lagrange_num_nodes (eclass, order));
+    break;
+  default:
+    SC_ABORT ("Lagrange cells are not supported for pyramids.");
+  }
+}
+
+/* Map the reference coordinates of \a num_nodes nodes into an element.
+ * The element's corners are interpolated with the (multi-)linear shape
+ * functions of its class. Since the trees are (multi-)linear, this is
+ * exact with respect to the tree geometry. */
+static void
+t8_forest_vtk_lagrange_map_nodes (t8_forest_t forest, t8_locidx_t ltree_id,
+                                  const t8_element_t * element,
+                                  const double *tree_vertices,
+                                  t8_eclass_t eclass, int num_nodes,
+                                  const double *ref_nodes,
+                                  double *coordinates)
+{
+  double              corner_coords[T8_ECLASS_MAX_CORNERS][3];
+  double              weights[T8_ECLASS_MAX_CORNERS];
+  const double       *ref;
+  double              u, v, w;
+  int                 num_corners, icorner, inode, idim;
+
+  if (eclass == T8_ECLASS_VERTEX) {
+    /* A vertex element is its tree's vertex */
+    T8_ASSERT (num_nodes == 1);
+    memcpy (coordinates, tree_vertices, 3 * sizeof (double));
+    return;
+  }
+  /* Compute the element's corners in vtk ordering */
+  num_corners = t8_eclass_num_vertices[eclass];
+  for (icorner = 0; icorner < num_corners; icorner++) {
+    t8_forest_element_coordinate (forest, ltree_id, element, tree_vertices,
+                                  t8_eclass_vtk_corner_number[eclass]
+                                  [icorner], corner_coords[icorner]);
+  }
+  for (inode = 0; inode < num_nodes; inode++) {
+    ref = ref_nodes + 3 * inode;
+    u = ref[0];
+    v = ref[1];
+    w = ref[2];
+    switch (eclass) {
+    case T8_ECLASS_LINE:
+      weights[0] = 1 - u;
+      weights[1] = u;
+      break;
+    case T8_ECLASS_TRIANGLE:
+      weights[0] = 1 - u - v;
+      weights[1] = u;
+      weights[2] = v;
+      break;
+    case T8_ECLASS_TET:
+      weights[0] = 1 - u - v - w;
+      weights[1] = u;
+      weights[2] = v;
+      weights[3] = w;
+      break;
+    case T8_ECLASS_PRISM:
+      weights[0] = (1 - u - v) * (1 - w);
+      weights[1] = u * (1 - w);
+      weights[2] = v * (1 - w);
+      weights[3] = (1 - u - v) * w;
+      weights[4] = u * w;
+      weights[5] = v * w;
+      break;
+    case T8_ECLASS_QUAD:
+    case T8_ECLASS_HEX:
+      weights[0] = (1 - u) * (1 - v);
+      weights[1] = u * (1 - v);
+      weights[2] = u * v;
+      weights[3] = (1 - u) * v;
+      if (eclass == T8_ECLASS_HEX) {
+        for (icorner = 0; icorner < 4; icorner++) {
+          weights[icorner + 4] = weights[icorner] * w;
+          weights[icorner] *= 1 - w;
+        }
+      }
+      break;
+    default:
+      SC_ABORT ("Lagrange cells are not supported for pyramids.");
+    }
+    for (idim = 0; idim < 3; idim++) {
+      coordinates[3 * inode + idim] = 0;
+      for (icorner = 0; icorner < num_corners; icorner++) {
+        coordinates[3 * inode + idim] +=
+          weights[icorner] * corner_coords[icorner][idim];
+      }
+    }
+  }
+}
+
+void
+t8_forest_vtk_lagrange_node_coordinates (t8_forest_t forest,
+                                         t8_locidx_t ltreeid,
+                                         const t8_element_t * element,
+                                         int order, double *coordinates)
+{
+  t8_eclass_t         eclass;
+  double             *ref_nodes;
+  int                 num_nodes;
+
+  T8_ASSERT (t8_forest_is_committed (forest));
+  T8_ASSERT (0 <= ltreeid
+             && ltreeid < t8_forest_get_num_local_trees (forest));
+  T8_ASSERT (order >= 1);
+
+  eclass = t8_forest_get_tree_class (forest, ltreeid);
+  num_nodes = t8_forest_vtk_lagrange_num_nodes (eclass, order);
+  ref_nodes = T8_ALLOC (double, 3 * num_nodes);
+  t8_forest_vtk_lagrange_reference_nodes (eclass, order, ref_nodes);
+  t8_forest_vtk_lagrange_map_nodes (forest, ltreeid, element,
+                                    t8_forest_get_tree_vertices (forest,
+                                                                 ltreeid),
+                                    eclass, num_nodes, ref_nodes,
+                                    coordinates);
+  T8_FREE (ref_nodes);
+}
+
+/* The Lagrange cell version of the vertices kernel.
+ * Writes the coordinates of all nodes of an element. */
+static int
+t8_forest_vtk_lagrange_vertices_kernel (t8_forest_t forest,
+                                        t8_locidx_t ltree_id,
+                                        t8_tree_t tree,
+                                        t8_locidx_t element_index,
+                                        t8_element_t * element,
+                                        t8_eclass_scheme_c * ts,
+                                        int is_ghost,
+                                        FILE * vtufile, int *columns,
+                                        void **data,
+                                        T8_VTK_KERNEL_MODUS modus)
+{
+  t8_forest_vtk_lagrange_t *lagrange;
+  double             *coordinates;
+  int                 num_nodes, inode;
+  int                 freturn;
+
+  if (modus != T8_VTK_KERNEL_EXECUTE) {
+    return 1;
+  }
+  T8_ASSERT (!is_ghost);
+  lagrange = (t8_forest_vtk_lagrange_t *) * data;
+  num_nodes = lagrange->num_nodes[ts->eclass];
+  coordinates = T8_ALLOC (double, 3 * num_nodes);
+  t8_forest_vtk_lagrange_map_nodes (forest, ltree_id, element,
+                                    t8_forest_get_tree_vertices (forest,
+                                                                 ltree_id),
+                                    ts->eclass, num_nodes,
+                                    lagrange->ref_nodes[ts->eclass],
+                                    coordinates);
+  for (inode = 0; inode < num_nodes; inode++) {
+#ifdef T8_VTK_DOUBLES
+    freturn = fprintf (vtufile, "          %24.16e %24.16e %24.16e\n",
+                       coordinates[3 * inode], coordinates[3 * inode + 1],
+                       coordinates[3 * inode + 2]);
+#else
+    freturn = fprintf (vtufile, "          %16.8e %16.8e %16.8e\n",
+                       coordinates[3 * inode], coordinates[3 * inode + 1],
+                       coordinates[3 * inode + 2]);
+#endif
+    if (freturn <= 0) {
+      T8_FREE (coordinates);
+      return 0;
+    }
+  }
+  T8_FREE (coordinates);
+  /* We switch of the colum control of the surrounding function
+   * by keeping the columns value constant. */
+  *columns = 1;
+  return 1;
+}
+
+/* The Lagrange cell version of the connectivity kernel */
+static int
+t8_forest_vtk_lagrange_connectivity_kernel (t8_forest_t forest,
+                                            t8_locidx_t ltree_id,
+                                            t8_tree_t tree,
+                                            t8_locidx_t element_index,
+                                            t8_element_t * element,
+                                            t8_eclass_scheme_c * ts,
+                                            int is_ghost,
+                                            FILE * vtufile, int *columns,
+                                            void **data,
+                                            T8_VTK_KERNEL_MODUS modus)
+{
+  t8_forest_vtk_lagrange_t *lagrange;
+  int                 num_nodes, inode;
+  int                 freturn;
+
+  lagrange = (t8_forest_vtk_lagrange_t *) * data;
+  if (modus == T8_VTK_KERNEL_INIT) {
+    /* Start counting the nodes */
+    lagrange->node_count = 0;
+    return 1;
+  }
+  else if (modus == T8_VTK_KERNEL_CLEANUP) {
+    return 1;
+  }
+  num_nodes = lagrange->num_nodes[ts->eclass];
+  for (inode = 0; inode < num_nodes; inode++, lagrange->node_count++) {
+    freturn = fprintf (vtufile, " %ld", (long) lagrange->node_count);
+    if (freturn <= 0) {
+      return 0;
+    }
+  }
+  *columns += num_nodes;
+  return 1;
+}
+
+/* The Lagrange cell version of the offset kernel */
+static int
+t8_forest_vtk_lagrange_offset_kernel (t8_forest_t forest,
+                                      t8_locidx_t ltree_id,
+                                      t8_tree_t tree,
+                                      t8_locidx_t element_index,
+                                      t8_element_t * element,
+                                      t8_eclass_scheme_c * ts,
+                                      int is_ghost,
+                                      FILE * vtufile, int *columns,
+                                      void **data, T8_VTK_KERNEL_MODUS modus)
+{
+  t8_forest_vtk_lagrange_t *lagrange;
+  int                 freturn;
+
+  lagrange = (t8_forest_vtk_lagrange_t *) * data;
+  if (modus == T8_VTK_KERNEL_INIT) {
+    /* Start counting the nodes */
+    lagrange->node_count = 0;
+    return 1;
+  }
+  else if (modus == T8_VTK_KERNEL_CLEANUP) {
+    return 1;
+  }
+  lagrange->node_count += lagrange->num_nodes[ts->eclass];
+  freturn = fprintf (vtufile, " %lld", (long long) lagrange->node_count);
+  if (freturn <= 0) {
+    return 0;
+  }
+  *columns += 1;
+  return 1;
+}
+
+/* The Lagrange cell version of the type kernel */
+static int
+t8_forest_vtk_lagrange_type_kernel (t8_forest_t forest, t8_locidx_t ltree_id,
+                                    t8_tree_t tree,
+                                    t8_locidx_t element_index,
+                                    t8_element_t * element,
+                                    t8_eclass_scheme_c * ts,
+                                    int is_ghost,
+                                    FILE * vtufile, int *columns,
+                                    void **data, T8_VTK_KERNEL_MODUS modus)
+{
+  int                 freturn;
+  if (modus == T8_VTK_KERNEL_EXECUTE) {
+    T8_ASSERT (t8_eclass_vtk_lagrange_type[ts->eclass] >= 0);
+    freturn =
+      fprintf (vtufile, " %d", t8_eclass_vtk_lagrange_type[ts->eclass]);
+    if (freturn <= 0) {
+      return 0;
+    }
+    *columns += 1;
+  }
+  return 1;
+}
+
+/* Write the nodal values of a scalar or vector data field for the
+ * nodes of an element. */
+static int
+t8_forest_vtk_lagrange_values_kernel (t8_forest_t forest,
+                                      t8_locidx_t ltree_id,
+                                      t8_tree_t tree,
+                                      t8_locidx_t element_index,
+                                      t8_element_t * element,
+                                      t8_eclass_scheme_c * ts,
+                                      int is_ghost,
+                                      FILE * vtufile, int *columns,
+                                      void **data, T8_VTK_KERNEL_MODUS modus,
+                                      int dim)
+{
+  t8_forest_vtk_lagrange_t *lagrange;
+  int                 num_nodes, ivalue;
+  const double       *values;
+
+  lagrange = (t8_forest_vtk_lagrange_t *) * data;
+  if (modus == T8_VTK_KERNEL_INIT) {
+    /* Start counting the nodes */
+    lagrange->node_count = 0;
+    return 1;
+  }
+  else if (modus == T8_VTK_KERNEL_CLEANUP) {
+    return 1;
+  }
+  num_nodes = lagrange->num_nodes[ts->eclass];
+  values = lagrange->values + dim * lagrange->node_count;
+  for (ivalue = 0; ivalue < dim * num_nodes; ivalue++) {
+    if (fprintf (vtufile, "%g ", values[ivalue]) <= 0) {
+      return 0;
+    }
+  }
+  lagrange->node_count += num_nodes;
+  *columns += dim * num_nodes;
+  return 1;
+}
+
+static int
+t8_forest_vtk_lagrange_scalar_kernel (t8_forest_t forest,
+                                      t8_locidx_t ltree_id,
+                                      t8_tree_t tree,
+                                      t8_locidx_t element_index,
+                                      t8_element_t * element,
+                                      t8_eclass_scheme_c * ts,
+                                      int is_ghost,
+                                      FILE * vtufile, int *columns,
+                                      void **data, T8_VTK_KERNEL_MODUS modus)
+{
+  return t8_forest_vtk_lagrange_values_kernel (forest, ltree_id, tree,
+                                               element_index, element, ts,
+                                               is_ghost, vtufile, columns,
+                                               data, modus, 1);
+}
+
+static int
+t8_forest_vtk_lagrange_vector_kernel (t8_forest_t forest,
+                                      t8_locidx_t ltree_id,
+                                      t8_tree_t tree,
+                                      t8_locidx_t element_index,
+                                      t8_element_t * element,
+                                      t8_eclass_scheme_c * ts,
+                                      int is_ghost,
+                                      FILE * vtufile, int *columns,
+                                      void **data, T8_VTK_KERNEL_MODUS modus)
+{
+  return t8_forest_vtk_lagrange_values_kernel (forest, ltree_id, tree,
+                                               element_index, element, ts,
+                                               is_ghost, vtufile, columns,
+                                               data, modus, 3);
+}
+
 /* Iterate over all cells and write cell data to the file using
  * the cell_data_kernel as callback */
 static int
@@ -1038,6 +1712,8 @@ t8_forest_vtk_write_cell_data (t8_forest_t forest, FILE * vtufile,
 }
 
 /* Write the cell data to an open file stream.
+ * If lagrange is not NULL, the elements are written as Lagrange cells
+ * and the user defined data is not written as cell data.
  * Returns true on success and zero otherwise.
  * After completion the file will remain open, whether writing
  * cells was successful or not. */
@@ -1047,13 +1723,30 @@ t8_forest_vtk_write_cells (t8_forest_t forest, FILE * vtufile,
                            int write_mpirank,
                            int write_level, int write_element_id,
                            int write_ghosts, int num_data,
-                           t8_vtk_data_field_t * data)
+                           t8_vtk_data_field_t * data,
+                           t8_forest_vtk_lagrange_t * lagrange)
 {
   int                 freturn;
   int                 idata;
+  t8_forest_vtk_cell_data_kernel connectivity_kernel, offset_kernel;
+  t8_forest_vtk_cell_data_kernel type_kernel;
 
   T8_ASSERT (t8_forest_is_committed (forest));
   T8_ASSERT (vtufile != NULL);
+  T8_ASSERT (lagrange == NULL || !write_ghosts);
+
+  if (lagrange != NULL) {
+    connectivity_kernel = t8_forest_vtk_lagrange_connectivity_kernel;
+    offset_kernel = t8_forest_vtk_lagrange_offset_kernel;
+    type_kernel = t8_forest_vtk_lagrange_type_kernel;
+    /* The user defined data is written as point data only */
+    num_data = 0;
+  }
+  else {
+    connectivity_kernel = t8_forest_vtk_cells_connectivity_kernel;
+    offset_kernel = t8_forest_vtk_cells_offset_kernel;
+    type_kernel = t8_forest_vtk_cells_type_kernel;
+  }
 
   freturn = fprintf (vtufile, "      <Cells>\n");
   if (freturn <= 0) {
@@ -1064,8 +1757,8 @@ t8_forest_vtk_write_cells (t8_forest_t forest, FILE * vtufile,
    * Thus for each tree we write the indices of its corner vertices. */
   freturn = t8_forest_vtk_write_cell_data (forest, vtufile, "connectivity",
                                            T8_VTK_LOCIDX, "", 8,
-                                           t8_forest_vtk_cells_connectivity_kernel,
-                                           write_ghosts, NULL);
+                                           connectivity_kernel,
+                                           write_ghosts, lagrange);
   if (!freturn) {
     goto t8_forest_vtk_cell_failure;
   }
@@ -1079,8 +1772,8 @@ t8_forest_vtk_write_cells (t8_forest_t forest, FILE * vtufile,
    * and indices 4,5,6 to the indices of the triangle. */
   freturn = t8_forest_vtk_write_cell_data (forest, vtufile, "offsets",
                                            T8_VTK_LOCIDX, "", 8,
-                                           t8_forest_vtk_cells_offset_kernel,
-                                           write_ghosts, NULL);
+                                           offset_kernel, write_ghosts,
+                                           lagrange);
   if (!freturn) {
     goto t8_forest_vtk_cell_failure;
   }
@@ -1090,8 +1783,7 @@ t8_forest_vtk_write_cells (t8_forest_t forest, FILE * vtufile,
    * square/triangle/tet etc. */
 
   freturn = t8_forest_vtk_write_cell_data (forest, vtufile, "types",
-                                           "Int32", "", 8,
-                                           t8_forest_vtk_cells_type_kernel,
+                                           "Int32", "", 8, type_kernel,
                                            write_ghosts, NULL);
 
   if (!freturn) {
@@ -1205,13 +1897,16 @@ t8_forest_vtk_cell_failure:
 }
 
 /* Write the cell data to an open file stream.
+ * If lagrange is not NULL, the nodes of the Lagrange cells are written
+ * and the user defined data is interpreted as nodal values.
  * Returns true on success and zero otherwise.
  * After completion the file will remain open, whether writing
  * cells was successful or not. */
 static int
 t8_forest_vtk_write_points (t8_forest_t forest, FILE * vtufile,
                             int write_ghosts,
-                            int num_data, t8_vtk_data_field_t * data)
+                            int num_data, t8_vtk_data_field_t * data,
+                            t8_forest_vtk_lagrange_t * lagrange)
 {
   int                 freturn;
   int                 sreturn;
@@ -1231,8 +1926,11 @@ t8_forest_vtk_write_points (t8_forest_t forest, FILE * vtufile,
                                            T8_VTK_FLOAT_NAME,
                                            "NumberOfComponents=\"3\"",
                                            8,
+                                           lagrange != NULL ?
+                                           t8_forest_vtk_lagrange_vertices_kernel
+                                           :
                                            t8_forest_vtk_cells_vertices_kernel,
-                                           write_ghosts, NULL);
+                                           write_ghosts, lagrange);
   if (!freturn) {
     goto t8_forest_vtk_cell_failure;
   }
@@ -1242,6 +1940,46 @@ t8_forest_vtk_write_points (t8_forest_t forest, FILE * vtufile,
   }
   /* Done writing vertex coordinates */
 
+  if (lagrange != NULL) {
+    /* Write the user defined nodal values */
+    if (num_data > 0) {
+      freturn = fprintf (vtufile, "      <PointData>\n");
+      if (freturn <= 0) {
+        goto t8_forest_vtk_cell_failure;
+      }
+      for (idata = 0; idata < num_data; idata++) {
+        lagrange->values = data[idata].data;
+        if (data[idata].type == T8_VTK_SCALAR) {
+          freturn =
+            t8_forest_vtk_write_cell_data (forest, vtufile,
+                                           data[idata].description,
+                                           T8_VTK_FLOAT_NAME, "", 8,
+                                           t8_forest_vtk_lagrange_scalar_kernel,
+                                           0, lagrange);
+        }
+        else {
+          T8_ASSERT (data[idata].type == T8_VTK_VECTOR);
+          freturn =
+            t8_forest_vtk_write_cell_data (forest, vtufile,
+                                           data[idata].description,
+                                           T8_VTK_FLOAT_NAME,
+                                           "NumberOfComponents=\"3\"", 8,
+                                           t8_forest_vtk_lagrange_vector_kernel,
+                                           0, lagrange);
+        }
+        lagrange->values = NULL;
+        if (!freturn) {
+          goto t8_forest_vtk_cell_failure;
+        }
+      }
+      freturn = fprintf (vtufile, "      </PointData>\n");
+      if (freturn <= 0) {
+        goto t8_forest_vtk_cell_failure;
+      }
+    }
+    return 1;
+  }
+
   /* Write the user defined data fields per element */
   if (num_data > 0) {
     freturn = fprintf (vtufile, "      <PointData>\n");
@@ -1303,53 +2041,292 @@ t8_forest_vtk_cell_failure:
   return 0;
 }
 
-int
-t8_forest_vtk_write_file (t8_forest_t forest, const char *fileprefix,
-                          int write_treeid,
-                          int write_mpirank,
+/* Write the xml header of a .vtu file to an open file stream.
+ * Returns true on success and zero otherwise. */
+static int
+t8_forest_vtk_write_header (FILE * vtufile)
+{
+  int                 freturn;
+
+  /* Write the header information in the .vtu file.
+   * xml type, Unstructured grid and number of points and elements. */
+  freturn = fprintf (vtufile, "<?xml version=\"1.0\"?>\n");
+  if (freturn <= 0) {
+    return 0;
+  }
+  freturn =
+    fprintf (vtufile, "<VTKFile type=\"UnstructuredGrid\" version=\"0.1\"");
+  if (freturn <= 0) {
+    return 0;
+  }
+#ifdef SC_IS_BIGENDIAN
+  freturn = fprintf (vtufile, " byte_order=\"BigEndian\">\n");
+#else
+  freturn = fprintf (vtufile, " byte_order=\"LittleEndian\">\n");
+#endif
+  if (freturn <= 0) {
+    return 0;
+  }
+  freturn = fprintf (vtufile, "  <UnstructuredGrid>\n");
+  return freturn > 0;
+}
+
+/* Write the piece of this process, that are its points and cells,
+ * to an open file stream.
+ * Returns true on success and zero otherwise. */
+static int
+t8_forest_vtk_write_piece (t8_forest_t forest, FILE * vtufile,
+                           int write_treeid, int write_mpirank,
+                           int write_level, int write_element_id,
+                           int write_ghosts, int num_data,
+                           t8_vtk_data_field_t * data,
+                           t8_forest_vtk_lagrange_t * lagrange)
+{
+  t8_locidx_t         num_elements, num_points;
+  int                 freturn;
+
+  /* The local number of elements */
+  num_elements = t8_forest_get_local_num_elements (forest);
+  if (write_ghosts) {
+    num_elements += t8_forest_get_num_ghosts (forest);
+  }
+  /* The local number of points, counted with multiplicity */
+  num_points = t8_forest_num_points (forest, write_ghosts, lagrange);
+
+  freturn = fprintf (vtufile,
+                     "    <Piece NumberOfPoints=\"%lld\" NumberOfCells=\"%lld\">\n",
+                     (long long) num_points, (long long) num_elements);
+  if (freturn <= 0) {
+    return 0;
+  }
+
+  /* write the point data */
+  if (!t8_forest_vtk_write_points
+      (forest, vtufile, write_ghosts, num_data, data, lagrange)) {
+    /* writings points was not succesful */
+    return 0;
+  }
+  /* write the cell data */
+  if (!t8_forest_vtk_write_cells
+      (forest, vtufile, write_treeid, write_mpirank, write_level,
+       write_element_id, write_ghosts, num_data, data, lagrange)) {
+    /* Writing cells was not successful */
+    return 0;
+  }
+
+  freturn = fprintf (vtufile, "    </Piece>\n");
+  return freturn > 0;
+}
+
+/* For the aggregated output the processes are divided into num_files
+ * groups of consecutive ranks. Each group writes one .vtu file that
+ * contains one piece per process of the group.
+ * Return the first rank of the group \a group. */
+static int
+t8_forest_vtk_group_first_rank (int group, int num_files, int mpisize)
+{
+  return (int) (((t8_gloidx_t) group * mpisize) / num_files);
+}
+
+/* Return the group of the aggregated output that \a rank belongs to. */
+static int
+t8_forest_vtk_group_of_rank (int rank, int num_files, int mpisize)
+{
+  return (int) (((t8_gloidx_t) (rank + 1) * num_files - 1) / mpisize);
+}
+
+/* Write the piece of this process to a buffer allocated with malloc.
+ * Returns true on success and zero otherwise. */
+static int
+t8_forest_vtk_write_piece_buffer (t8_forest_t forest, char **buffer,
+                                  size_t *num_bytes, int write_treeid,
+                                  int write_mpirank, int write_level,
+                                  int write_element_id, int write_ghosts,
+                                  int num_data, t8_vtk_data_field_t * data,
+                                  t8_forest_vtk_lagrange_t * lagrange)
+{
+  FILE               *memfile;
+  int                 success;
+#ifndef T8_HAVE_OPEN_MEMSTREAM
+  long                file_size;
+#endif
+
+  *buffer = NULL;
+  *num_bytes = 0;
+#ifdef T8_HAVE_OPEN_MEMSTREAM
+  memfile = open_memstream (buffer, num_bytes);
+#else
+  /* Without memory streams we write to a temporary file and read it back */
+  memfile = tmpfile ();
+#endif
+  success = memfile != NULL
+    && t8_forest_vtk_write_piece (forest, memfile, write_treeid,
+                                  write_mpirank, write_level,
+                                  write_element_id, write_ghosts, num_data,
+                                  data, lagrange);
+#ifndef T8_HAVE_OPEN_MEMSTREAM
+  if (success) {
+    file_size = ftell (memfile);
+    success = file_size >= 0 && fseek (memfile, 0, SEEK_SET) == 0;
+  }
+  if (success) {
+    *num_bytes = (size_t) file_size;
+    /* We allocate at least one byte, such that the buffer is never NULL */
+    *buffer = (char *) malloc (SC_MAX (*num_bytes, (size_t) 1));
+    success = *buffer != NULL
+      && fread (*buffer, 1, *num_bytes, memfile) == *num_bytes;
+  }
+#endif
+  if (memfile != NULL && fclose (memfile) != 0) {
+    success = 0;
+  }
+  return success;
+}
+
+/* Write the piece of this process to a buffer and send it to the first
+ * process of its group, which writes it to the group's file.
+ * If writing the piece fails, an empty message is sent.
+ * Returns true on success and zero otherwise. */
+static int
+t8_forest_vtk_send_piece (t8_forest_t forest, int group_first,
+                          int write_treeid, int write_mpirank,
                           int write_level, int write_element_id,
-                          int write_ghosts,
-                          int num_data, t8_vtk_data_field_t * data)
+                          int write_ghosts, int num_data,
+                          t8_vtk_data_field_t * data,
+                          t8_forest_vtk_lagrange_t * lagrange)
+{
+  char               *buffer;
+  size_t              num_bytes;
+  int                 success, mpiret;
+
+  success = t8_forest_vtk_write_piece_buffer (forest, &buffer, &num_bytes,
+                                              write_treeid, write_mpirank,
+                                              write_level, write_element_id,
+                                              write_ghosts, num_data, data,
+                                              lagrange);
+  if (num_bytes > INT_MAX) {
+    t8_errorf ("Error when writing vtk file. Piece exceeds %i bytes.\n",
+               INT_MAX);
+    success = 0;
+  }
+  if (!success) {
+    num_bytes = 0;
+  }
+  mpiret = sc_MPI_Send (buffer, (int) num_bytes, sc_MPI_BYTE, group_first,
+                        T8_MPI_VTK_FOREST, forest->mpicomm);
+  SC_CHECK_MPI (mpiret);
+  /* The buffer was allocated by open_memstream or malloc */
+  free (buffer);
+  return success;
+}
+
+/* Receive the pieces of the other processes of this process' group
+ * in rank order and append them to an open file stream.
+ * If vtufile is NULL, the pieces are received but not written.
+ * Returns true on success and zero otherwise. */
+static int
+t8_forest_vtk_receive_pieces (t8_forest_t forest, FILE * vtufile,
+                              int group_last)
+{
+  sc_MPI_Status       status;
+  char               *buffer;
+  int                 iproc, num_bytes, mpiret;
+  int                 success = vtufile != NULL;
+
+  for (iproc = forest->mpirank + 1; iproc <= group_last; iproc++) {
+    mpiret = sc_MPI_Probe (iproc, T8_MPI_VTK_FOREST, forest->mpicomm,
+                           &status);
+    SC_CHECK_MPI (mpiret);
+    mpiret = sc_MPI_Get_count (&status, sc_MPI_BYTE, &num_bytes);
+    SC_CHECK_MPI (mpiret);
+    buffer = T8_ALLOC (char, num_bytes);
+    mpiret = sc_MPI_Recv (buffer, num_bytes, sc_MPI_BYTE, iproc,
+                          T8_MPI_VTK_FOREST, forest->mpicomm,
+                          sc_MPI_STATUS_IGNORE);
+    SC_CHECK_MPI (mpiret);
+    if (num_bytes == 0) {
+      /* Process iproc failed to write its piece */
+      t8_errorf ("Error when writing vtk file. Process %i sent no piece.\n",
+                 iproc);
+      success = 0;
+    }
+    if (success && fwrite (buffer, 1, num_bytes, vtufile)
+        != (size_t) num_bytes) {
+      success = 0;
+    }
+    T8_FREE (buffer);
+  }
+  return success;
+}
+
+/* Write the forest in .pvtu file format with num_files .vtu files.
+ * If num_files equals the number of processes, each process writes
+ * its own file. Otherwise, the processes are grouped and the first process
+ * of each group writes the pieces of its group to one file.
+ * If lagrange is not NULL, the elements are written as Lagrange cells
+ * and the user defined data is interpreted as nodal values.
+ * Returns true on success and zero otherwise. */
+static int
+t8_forest_vtk_write_file_internal (t8_forest_t forest,
+                                   const char *fileprefix, int num_files,
+                                   int write_treeid,
+                                   int write_mpirank, int write_level,
+                                   int write_element_id, int write_ghosts,
+                                   int num_data, t8_vtk_data_field_t * data,
+                                   t8_forest_vtk_lagrange_t * lagrange)
 {
   FILE               *vtufile = NULL;
-  t8_locidx_t         num_elements, num_points;
   char                vtufilename[BUFSIZ];
   int                 freturn;
+  int                 group, group_first, group_last;
+  int                 received = 0;
 
   T8_ASSERT (forest != NULL);
   T8_ASSERT (t8_forest_is_committed (forest));
   T8_ASSERT (fileprefix != NULL);
+  T8_ASSERT (1 <= num_files && num_files <= forest->mpisize);
   if (forest->ghosts == NULL || forest->ghosts->num_ghosts_elements == 0) {
     /* Never write ghost elements if there aren't any */
     write_ghosts = 0;
   }
   T8_ASSERT (forest->ghosts != NULL || !write_ghosts);
+  T8_ASSERT (lagrange == NULL || !write_ghosts);
 
   /* Currently we only support output in ascii format, not binary */
   T8_ASSERT (T8_VTK_ASCII == 1);
 
+  /* The group of this process and its first and last rank */
+  group = t8_forest_vtk_group_of_rank (forest->mpirank, num_files,
+                                       forest->mpisize);
+  group_first = t8_forest_vtk_group_first_rank (group, num_files,
+                                                forest->mpisize);
+  group_last = t8_forest_vtk_group_first_rank (group + 1, num_files,
+                                               forest->mpisize) - 1;
+  T8_ASSERT (group_first <= forest->mpirank
+             && forest->mpirank <= group_last);
+
+  if (forest->mpirank != group_first) {
+    /* The first process of our group writes our piece.
+     * If each process writes its own file, we never get here. */
+    T8_ASSERT (num_files < forest->mpisize);
+    return t8_forest_vtk_send_piece (forest, group_first, write_treeid,
+                                     write_mpirank, write_level,
+                                     write_element_id, write_ghosts,
+                                     num_data, data, lagrange);
+  }
+
   /* process 0 creates the .pvtu file */
   if (forest->mpirank == 0) {
-    if (t8_write_pvtu
-        (fileprefix, forest->mpisize, write_treeid, write_mpirank,
+    if ((lagrange != NULL ? t8_write_pvtu_nodal : t8_write_pvtu)
+        (fileprefix, num_files, write_treeid, write_mpirank,
          write_level, write_element_id, num_data, data)) {
       t8_errorf ("Error when writing file %s.pvtu\n", fileprefix);
       goto t8_forest_vtk_failure;
     }
   }
 
-  /* The local number of elements */
-  num_elements = t8_forest_get_local_num_elements (forest);
-  if (write_ghosts) {
-    num_elements += t8_forest_get_num_ghosts (forest);
-  }
-  /* The local number of points, counted with multiplicity */
-  num_points = t8_forest_num_points (forest, write_ghosts);
-
-  /* The filename for this processes file */
-  freturn =
-    snprintf (vtufilename, BUFSIZ, "%s_%04d.vtu", fileprefix,
-              forest->mpirank);
+  /* The filename for this group's file */
+  freturn = snprintf (vtufilename, BUFSIZ, "%s_%04d.vtu", fileprefix, group);
   if (freturn >= BUFSIZ) {
     t8_errorf ("Error when writing vtu file. Filename too long.\n");
     goto t8_forest_vtk_failure;
@@ -1361,52 +2338,22 @@ t8_forest_vtk_write_file (t8_forest_t forest, const char *fileprefix,
     t8_errorf ("Error when opening file %s\n", vtufilename);
     goto t8_forest_vtk_failure;
   }
-  /* Write the header information in the .vtu file.
-   * xml type, Unstructured grid and number of points and elements. */
-  freturn = fprintf (vtufile, "<?xml version=\"1.0\"?>\n");
-  if (freturn <= 0) {
-    goto t8_forest_vtk_failure;
-  }
-  freturn =
-    fprintf (vtufile, "<VTKFile type=\"UnstructuredGrid\" version=\"0.1\"");
-  if (freturn <= 0) {
-    goto t8_forest_vtk_failure;
-  }
-#ifdef SC_IS_BIGENDIAN
-  freturn = fprintf (vtufile, " byte_order=\"BigEndian\">\n");
-#else
-  freturn = fprintf (vtufile, " byte_order=\"LittleEndian\">\n");
-#endif
-  if (freturn <= 0) {
-    goto t8_forest_vtk_failure;
-  }
-  freturn = fprintf (vtufile, "  <UnstructuredGrid>\n");
-  if (freturn <= 0) {
+  if (!t8_forest_vtk_write_header (vtufile)) {
     goto t8_forest_vtk_failure;
   }
-  freturn = fprintf (vtufile,
-                     "    <Piece NumberOfPoints=\"%lld\" NumberOfCells=\"%lld\">\n",
-                     (long long) num_points, (long long) num_elements);
-  if (freturn <= 0) {
-    goto t8_forest_vtk_failure;
-  }
-
-  /* write the point data */
-  if (!t8_forest_vtk_write_points
-      (forest, vtufile, write_ghosts, num_data, data)) {
-    /* writings points was not succesful */
+  /* Write our piece followed by the pieces of the other processes
+   * of the group */
+  if (!t8_forest_vtk_write_piece
+      (forest, vtufile, write_treeid, write_mpirank, write_level,
+       write_element_id, write_ghosts, num_data, data, lagrange)) {
     goto t8_forest_vtk_failure;
   }
-  /* write the cell data */
-  if (!t8_forest_vtk_write_cells
-      (forest, vtufile, write_treeid, write_mpirank, write_level,
-       write_element_id, write_ghosts, num_data, data)) {
-    /* Writing cells was not successful */
+  received = 1;
+  if (!t8_forest_vtk_receive_pieces (forest, vtufile, group_last)) {
     goto t8_forest_vtk_failure;
   }
 
-  freturn = fprintf (vtufile, "    </Piece>\n"
-                     "  </UnstructuredGrid>\n" "</VTKFile>\n");
+  freturn = fprintf (vtufile, "  </UnstructuredGrid>\n" "</VTKFile>\n");
   if (freturn <= 0) {
     goto t8_forest_vtk_failure;
   }
@@ -1424,6 +2371,11 @@ t8_forest_vtk_write_file (t8_forest_t forest, const char *fileprefix,
   /* Writing was successful */
   return 1;
 t8_forest_vtk_failure:
+  if (!received) {
+    /* The other processes of the group wait for their pieces to be
+     * received */
+    t8_forest_vtk_receive_pieces (forest, NULL, group_last);
+  }
   if (vtufile != NULL) {
     fclose (vtufile);
   }
@@ -1431,4 +2383,85 @@ t8_forest_vtk_failure:
   return 0;
 }
 
+int
+t8_forest_vtk_write_file (t8_forest_t forest, const char *fileprefix,
+                          int write_treeid,
+                          int write_mpirank,
+                          int write_level, int write_element_id,
+                          int write_ghosts,
+                          int num_data, t8_vtk_data_field_t * data)
+{
+  return t8_forest_vtk_write_file_internal (forest, fileprefix,
+                                            forest->mpisize, write_treeid,
+                                            write_mpirank, write_level,
+                                            write_element_id, write_ghosts,
+                                            num_data, data, NULL);
+}
+
+int
+t8_forest_vtk_write_file_aggregated (t8_forest_t forest,
+                                     const char *fileprefix, int num_files,
+                                     int write_treeid, int write_mpirank,
+                                     int write_level, int write_element_id,
+                                     int write_ghosts, int num_data,
+                                     t8_vtk_data_field_t * data)
+{
+  T8_ASSERT (forest != NULL);
+  T8_ASSERT (t8_forest_is_committed (forest));
+  SC_CHECK_ABORT (num_files >= 1,
+                  "The number of vtk files must be positive.");
+  return t8_forest_vtk_write_file_internal (forest, fileprefix,
+                                            SC_MIN (num_files,
+                                                    forest->mpisize),
+                                            write_treeid, write_mpirank,
+                                            write_level, write_element_id,
+                                            write_ghosts, num_data, data,
+                                            NULL);
+}
+
+int
+t8_forest_vtk_write_file_lagrange (t8_forest_t forest,
+                                   const char *fileprefix, int order,
+                                   int write_treeid, int write_mpirank,
+                                   int write_level, int write_element_id,
+                                   int num_data, t8_vtk_data_field_t * data)
+{
+  t8_forest_vtk_lagrange_t lagrange;
+  t8_locidx_t         itree, num_local_trees;
+  t8_eclass_t         eclass;
+  int                 iclass, result;
+
+  T8_ASSERT (forest != NULL);
+  T8_ASSERT (t8_forest_is_committed (forest));
+  SC_CHECK_ABORT (order >= 1, "The order of Lagrange cells must be positive");
+
+  memset (&lagrange, 0, sizeof (lagrange));
+  lagrange.order = order;
+  /* Compute the reference nodes for each element class of the local trees */
+  num_local_trees = t8_forest_get_num_local_trees (forest);
+  for (itree = 0; itree < num_local_trees; itree++) {
+    eclass = t8_forest_get_tree_class (forest, itree);
+    SC_CHECK_ABORT (t8_eclass_vtk_lagrange_type[eclass] >= 0,
+                    "Lagrange cells are not supported for pyramids.");
+    if (lagrange.ref_nodes[eclass] == NULL) {
+      lagrange.num_nodes[eclass] =
+        t8_forest_vtk_lagrange_num_nodes (eclass, order);
+      lagrange.ref_nodes[eclass] =
+        T8_ALLOC (double, 3 * lagrange.num_nodes[eclass]);
+      t8_forest_vtk_lagrange_reference_nodes (eclass, order,
+                                              lagrange.ref_nodes[eclass]);
+    }
+  }
+
+  result = t8_forest_vtk_write_file_internal (forest, fileprefix,
+                                              forest->mpisize, write_treeid,
+                                              write_mpirank, write_level,
+                                              write_element_id, 0, num_data,
+                                              data, &lagrange);
+  for (iclass = 0; iclass < T8_ECLASS_COUNT; iclass++) {
+    T8_FREE (lagrange.ref_nodes[iclass]);
+  }
+  return result;
+}
+
 T8_EXTERN_C_END ();
@@ -0,0 +1,83 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+/** file t8_forest_adjacency.h
+ * Export the face adjacency graph of the elements of a forest in
+ * distributed compressed sparse row (CSR) format.
+ * Each process stores the rows of its local elements. The columns are the
+ * global ids of the face neighbors, including ghost elements.
+ * The arrays use the same layout as the distributed graphs of ParMETIS
+ * (vtxdist, xadj, adjncy, adjwgt), and the row offsets together with the
+ * columns can be used to preallocate a distributed sparse matrix.
+ */
+
+#ifndef T8_FOREST_ADJACENCY_H
+#define T8_FOREST_ADJACENCY_H
+
+#include <t8_forest.h>
+
+/** The local part of a distributed adjacency graph in CSR format. */
+typedef struct
+{
+  t8_locidx_t         num_rows;  /**< The number of local rows, i.e. local elements. */
+  int                 num_procs; /**< The number of processes. */
+  t8_gloidx_t        *row_distribution; /**< Array of length \a num_procs + 1. The global id of
+                                              the first row of each process. */
+  t8_locidx_t        *row_offsets; /**< Array of length \a num_rows + 1. The columns of local
+                                        row i are at positions row_offsets[i], ...,
+                                        row_offsets[i + 1] - 1 of \a columns. */
+  t8_gloidx_t        *columns;  /**< The global ids of the neighbors of each row,
+                                     sorted in ascending order within a row. */
+  double             *weights;  /**< If not NULL, for each entry in \a columns the area of
+                                     the face shared by the two elements. */
+} t8_forest_csr_t;
+
+T8_EXTERN_C_BEGIN ();
+
+/** Compute the face adjacency graph of the local elements of a forest.
+ * Two elements are adjacent if they share a face or a part of a face.
+ * An element is never adjacent to itself, and each neighbor appears once
+ * per row, even if it is a neighbor across several faces.
+ * This function is collective over the communicator of \a forest.
+ * \param [in]  forest    A committed and balanced forest. If it is partitioned
+ *                        over more than one process, it must have a ghost layer.
+ * \param [in]  compute_weights If true, the weight of each entry is the area of
+ *                        the face shared by the two elements.
+ *                        If a face of an element touches several smaller neighbors,
+ *                        its area is split evenly among them, which is exact
+ *                        for trees with linear geometry.
+ * \param [out] csr       On output the local part of the graph.
+ *                        Must be freed with \ref t8_forest_csr_reset.
+ */
+void                t8_forest_adjacency_csr (t8_forest_t forest,
+                                             int compute_weights,
+                                             t8_forest_csr_t * csr);
+
+/** Free the memory of a CSR graph.
+ * \param [in,out] csr    A graph that was filled with \ref t8_forest_adjacency_csr.
+ *                        On output all pointers are set to NULL.
+ */
+void                t8_forest_csr_reset (t8_forest_csr_t * csr);
+
+T8_EXTERN_C_END ();
+
+#endif /* !T8_FOREST_ADJACENCY_H */
@@ -0,0 +1,82 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+/** file t8_forest_boundary.h
+ * Construct a forest of the boundary faces of a forest.
+ * The boundary forest has one tree for each face of a coarse tree that lies
+ * on the domain boundary and one element for each face of a leaf element that
+ * lies on such a tree face. Its dimension is one less than the dimension of
+ * the volume forest. Along with the boundary forest a map from each boundary
+ * element to its volume element is computed, such that data can be
+ * transferred between the two forests.
+ */
+
+#ifndef T8_FOREST_BOUNDARY_H
+#define T8_FOREST_BOUNDARY_H
+
+#include <t8_forest.h>
+
+T8_EXTERN_C_BEGIN ();
+
+/** The volume element of an element in a boundary forest. */
+typedef struct t8_forest_boundary_face
+{
+  int                 volume_rank;      /**< The process that owns the volume element. */
+  t8_locidx_t         volume_element;   /**< The local index of the volume element on
+                                             \a volume_rank, counted over all local trees. */
+  int                 volume_face;      /**< The face of the volume element that is the
+                                             boundary element. */
+} t8_forest_boundary_face_t;
+
+/** Construct the forest of the boundary faces of a forest.
+ * The coarse mesh of the boundary forest has one tree for each pair of a
+ * coarse tree of \a forest and one of its faces at the domain boundary.
+ * These trees are ordered by the global tree id of the coarse tree and then by
+ * the face number. Their eclass is the class of the face and their vertices
+ * are the face vertices of the coarse tree, if the coarse tree has vertices.
+ * The boundary trees are not connected to each other.
+ * The elements of a boundary tree are the boundary faces, see
+ * \ref t8_element_boundary_face, of the leaf elements of \a forest that lie
+ * on the corresponding tree face.
+ * The boundary forest is partitioned such that each process owns as many
+ * boundary elements as it computed from its local elements of \a forest.
+ * If the coarse mesh has no boundary faces, for example if it is closed or
+ * periodic, the boundary forest has no trees and no elements.
+ * \param [in] forest     A committed forest. Its coarse mesh must not be
+ *                        partitioned. \a forest is not modified and keeps its
+ *                        reference.
+ * \param [in,out] face_to_volume If not NULL, an array with element size
+ *                        sizeof (t8_forest_boundary_face_t). On output it is
+ *                        resized to the number of local elements of the
+ *                        boundary forest and holds the volume element of each
+ *                        local boundary element, in the order of the local
+ *                        elements.
+ * \return                The committed boundary forest. It uses the same
+ *                        scheme and communicator as \a forest.
+ * \note This function is collective.
+ */
+t8_forest_t         t8_forest_new_boundary (t8_forest_t forest,
+                                            sc_array_t * face_to_volume);
+
+T8_EXTERN_C_END ();
+
+#endif /* !T8_FOREST_BOUNDARY_H */
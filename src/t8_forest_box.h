@@ -0,0 +1,122 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+/** file t8_forest_box.h
+ * Decompose axis-aligned boxes into intervals of the space-filling curve.
+ * For trees of class line, quad and hex the elements of a given level that
+ * intersect a box form a union of intervals of linear ids. We compute a
+ * minimal list of such intervals and use it to find the matching leaves
+ * with a binary search in each tree and the owner processes of an interval
+ * from the partition of the forest.
+ */
+
+#ifndef T8_FOREST_BOX_H
+#define T8_FOREST_BOX_H
+
+#include <t8_forest.h>
+
+/** An interval of linear ids of the elements of a given level in a tree. */
+typedef struct
+{
+  t8_gloidx_t         gtreeid;  /**< The global id of the tree. */
+  t8_eclass_t         eclass;   /**< The element class of the tree. */
+  int                 level;    /**< The refinement level of the linear ids. */
+  t8_linearidx_t      first;    /**< The first linear id of the interval. */
+  t8_linearidx_t      last;     /**< One past the last linear id of the interval. */
+} t8_forest_box_interval_t;
+
+T8_EXTERN_C_BEGIN ();
+
+/** Decompose a box in the reference coordinates of a tree into intervals
+ * of linear ids. The intervals contain exactly the elements of level
+ * \a level whose closure intersects the closed box.
+ * Adjacent intervals are merged, so that the list is minimal.
+ * The tree must be of class line, quad or hex with an isotropic scheme.
+ * \param [in]      forest    A committed forest.
+ * \param [in]      gtreeid   The global id of a tree of \a forest. The tree
+ *                            must be a local tree of the coarse mesh.
+ * \param [in]      box       The lower corner in entries 0, 1, 2 and the upper
+ *                            corner in entries 3, 4, 5 of the box in reference
+ *                            coordinates of the tree. Coordinates above the
+ *                            dimension of the tree are ignored.
+ * \param [in]      level     The level of the linear ids.
+ * \param [in,out]  intervals An array of \ref t8_forest_box_interval_t.
+ *                            The intervals are appended in order of their
+ *                            linear ids.
+ */
+void                t8_forest_box_intervals (t8_forest_t forest,
+                                             t8_gloidx_t gtreeid,
+                                             const double box[6], int level,
+                                             sc_array_t * intervals);
+
+/** Decompose a box in physical coordinates into intervals of linear ids.
+ * Every tree of the coarse mesh whose vertices are available on this
+ * process is considered. For a replicated coarse mesh these are all trees.
+ * The geometry of each such tree must be an axis-aligned box whose
+ * reference axes coincide with the coordinate axes, as for brick meshes.
+ * \param [in]      forest    A committed forest.
+ * \param [in]      box       The lower corner in entries 0, 1, 2 and the upper
+ *                            corner in entries 3, 4, 5 of the box.
+ * \param [in]      level     The level of the linear ids.
+ * \param [in,out]  intervals An array of \ref t8_forest_box_interval_t.
+ *                            The intervals are appended in order of the
+ *                            local trees of the coarse mesh and their linear ids.
+ */
+void                t8_forest_box_intervals_physical (t8_forest_t forest,
+                                                      const double box[6],
+                                                      int level,
+                                                      sc_array_t * intervals);
+
+/** Find the local leaves that overlap an interval.
+ * \param [in]      forest    A committed forest.
+ * \param [in]      interval  An interval of a tree of \a forest.
+ * \param [out]     ltreeid   The local id of the tree of \a interval, or
+ *                            a negative number if the tree is not local.
+ * \param [out]     first     The index in the tree of the first overlapping leaf.
+ * \return                    The number of overlapping leaves. They are stored
+ *                            consecutively in the tree starting at \a first.
+ */
+t8_locidx_t         t8_forest_box_interval_elements (t8_forest_t forest,
+                                                     const
+                                                     t8_forest_box_interval_t
+                                                     * interval,
+                                                     t8_locidx_t * ltreeid,
+                                                     t8_locidx_t * first);
+
+/** Compute the range of processes that own the leaves of an interval.
+ * \param [in]      forest    A committed forest.
+ * \param [in]      interval  An interval of a tree of \a forest.
+ * \param [out]     first_owner The process owning the first element of \a interval.
+ * \param [out]     last_owner  The process owning the last element of \a interval.
+ * \note Every leaf overlapping \a interval is owned by a process between
+ *       \a first_owner and \a last_owner. Processes in between may be empty.
+ */
+void                t8_forest_box_interval_owners (t8_forest_t forest,
+                                                   const
+                                                   t8_forest_box_interval_t *
+                                                   interval,
+                                                   int *first_owner,
+                                                   int *last_owner);
+
+T8_EXTERN_C_END ();
+
+#endif /* !T8_FOREST_BOX_H */
@@ -0,0 +1,140 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+/** file t8_forest_calibrate.h
+ * Calibration of partition weights from measured runtimes.
+ * The cost of an element is modeled by a constant per element class,
+ * refinement level and user defined category. After each step, every process
+ * reports its measured runtime. The costs are fitted with a regularized least
+ * squares fit of the runtimes against the number of elements of each category
+ * on each process. The fitted costs can be used as element weights for
+ * the partition, see \ref t8_forest_calibrate_set_partition_weight.
+ * Processes that are slower or faster than predicted by the fit get a
+ * capacity for the partition, see \ref t8_forest_calibrate_get_capacity.
+ */
+
+#ifndef T8_FOREST_CALIBRATE_H
+#define T8_FOREST_CALIBRATE_H
+
+#include <t8_forest.h>
+
+/** Opaque pointer to a calibration. */
+typedef struct t8_forest_calibrate *t8_forest_calibrate_t;
+
+/** Callback function prototype to compute the user category of an element.
+ * \param [in] forest      the forest of the element
+ * \param [in] which_tree  the local tree containing \a element
+ * \param [in] lelement_id the local element id in the tree of \a element
+ * \param [in] ts          the eclass scheme of the tree
+ * \param [in] element     the element
+ * \return                 the category of \a element,
+ *                         between 0 and num_categories - 1.
+ * \see t8_forest_calibrate_new
+ */
+typedef int         (*t8_forest_calibrate_category_t) (t8_forest_t forest,
+                                                       t8_locidx_t which_tree,
+                                                       t8_locidx_t
+                                                       lelement_id,
+                                                       t8_eclass_scheme_c *
+                                                       ts,
+                                                       const t8_element_t *
+                                                       element);
+
+T8_EXTERN_C_BEGIN ();
+
+/** Create a new calibration.
+ * All costs are initialized to 1.
+ * \param [in] comm           The MPI communicator of the forests.
+ * \param [in] maxlevel       The maximum level to distinguish. Elements
+ *                            with a higher level share the costs of \a maxlevel.
+ * \param [in] num_categories The number of user categories.
+ * \param [in] category_fn    The function computing an element's category.
+ *                            If NULL, all elements are in category 0.
+ * \param [in] forget         A factor in (0, 1] with which all previous
+ *                            measurements are damped when a new step is added.
+ *                            1 gives all steps the same importance, smaller values
+ *                            let the costs follow changes of the solver faster.
+ * \return                    The new calibration.
+ */
+t8_forest_calibrate_t t8_forest_calibrate_new (sc_MPI_Comm comm,
+                                               int maxlevel,
+                                               int num_categories,
+                                               t8_forest_calibrate_category_t
+                                               category_fn, double forget);
+
+/** Add a measured step to a calibration and fit the costs.
+ * \param [in,out] calibrate  The calibration.
+ * \param [in]     forest     The committed forest for which the step was measured.
+ * \param [in]     runtime    The runtime of this process in this step.
+ * \note This function is collective.
+ */
+void                t8_forest_calibrate_add_step (t8_forest_calibrate_t
+                                                  calibrate,
+                                                  t8_forest_t forest,
+                                                  double runtime);
+
+/** Return the fitted cost of an element.
+ * \param [in] calibrate  The calibration.
+ * \param [in] eclass     The element class.
+ * \param [in] level      The refinement level.
+ * \param [in] category   The user category.
+ * \return                The fitted cost of an element of class \a eclass,
+ *                        level \a level and category \a category.
+ */
+double              t8_forest_calibrate_get_cost (t8_forest_calibrate_t
+                                                  calibrate,
+                                                  t8_eclass_t eclass,
+                                                  int level, int category);
+
+/** Return the measured capacity of this process.
+ * The capacity is the ratio of the runtime that the fitted costs predict for
+ * this process to its measured runtime, summed over the (damped) steps.
+ * Thus, it is about 1 on a process of average speed, larger on faster
+ * and smaller on slower processes.
+ * \param [in] calibrate  The calibration.
+ * \return                The capacity of this process, 1 if no step was added yet.
+ * \see t8_forest_set_partition_capacity
+ */
+double              t8_forest_calibrate_get_capacity (t8_forest_calibrate_t
+                                                      calibrate);
+
+/** Use the fitted costs as the element weights for partitioning a forest.
+ * \param [in,out] forest     The forest, not committed. It should be
+ *                            partitioned with \ref t8_forest_set_partition.
+ * \param [in]     calibrate  The calibration. It must stay alive until
+ *                            \a forest is committed.
+ * \see t8_forest_set_partition_weight
+ */
+void                t8_forest_calibrate_set_partition_weight (t8_forest_t
+                                                              forest,
+                                                              t8_forest_calibrate_t
+                                                              calibrate);
+
+/** Destroy a calibration.
+ * \param [in,out] pcalibrate  The calibration. Set to NULL on output.
+ */
+void                t8_forest_calibrate_destroy (t8_forest_calibrate_t *
+                                                 pcalibrate);
+
+T8_EXTERN_C_END ();
+
+#endif /* !T8_FOREST_CALIBRATE_H */
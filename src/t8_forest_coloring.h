@@ -0,0 +1,135 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+/** file t8_forest_coloring.h
+ * Color the local elements of a forest, such that elements of the same color
+ * can be processed concurrently by threads without write conflicts.
+ * Elements are adjacent if they share a face, see \ref t8_forest_adjacency.h.
+ * Each color is stored as a list of ranges of consecutive local elements,
+ * thus a loop over the elements of one color traverses contiguous chunks
+ * of the space-filling curve.
+ */
+
+#ifndef T8_FOREST_COLORING_H
+#define T8_FOREST_COLORING_H
+
+#include <t8_forest.h>
+
+/** The conflicts that a coloring avoids. */
+typedef enum
+{
+  T8_COLORING_FACES = 0,        /**< No two elements of the same color share a face. */
+  T8_COLORING_FACE_NEIGHBORS    /**< Additionally, no two elements of the same color have
+                                     a common face neighbor. This is needed if an element
+                                     also writes to the data of its face neighbors. */
+} t8_coloring_type_t;
+
+/** A coloring of the local elements of a forest. */
+typedef struct
+{
+  t8_coloring_type_t  type;     /**< The conflicts that are avoided. */
+  t8_locidx_t         block_size; /**< The number of consecutive local elements that are
+                                       colored as one unit. 1 for an element wise coloring. */
+  t8_locidx_t         num_elements; /**< The number of local elements that are colored. */
+  int                 num_colors; /**< The number of colors. */
+  t8_locidx_t        *color_offsets; /**< Array of length \a num_colors + 1. The ranges of
+                                          color c are at positions color_offsets[c], ...,
+                                          color_offsets[c + 1] - 1 of \a ranges. */
+  t8_locidx_t        *ranges;   /**< For each range the first local element index and one
+                                     past the last local element index. Thus, range r
+                                     contains the elements ranges[2 r], ..., ranges[2 r + 1] - 1.
+                                     The ranges of a color are sorted in ascending order. */
+} t8_forest_coloring_t;
+
+T8_EXTERN_C_BEGIN ();
+
+/** Color the local elements of a forest greedily in the order of the
+ * space-filling curve.
+ * The face neighbors are computed from the local elements and the ghost
+ * elements, such that two local elements that are adjacent to the same ghost
+ * element do not have the same color for \ref T8_COLORING_FACE_NEIGHBORS.
+ * This function is collective over the communicator of \a forest.
+ * \param [in]  forest    A committed and balanced forest. If it is partitioned
+ *                        over more than one process, it must have a ghost layer.
+ * \param [in]  type      The conflicts that the coloring avoids.
+ * \param [in]  block_size If 1, each element is colored individually.
+ *                        If greater than 1, the local elements are divided into blocks of
+ *                        \a block_size consecutive elements and all elements of a block
+ *                        get the same color. Larger blocks preserve cache locality,
+ *                        but usually need more colors.
+ * \param [out] coloring  On output the coloring of the local elements.
+ *                        Must be freed with \ref t8_forest_coloring_reset.
+ */
+void                t8_forest_coloring_compute (t8_forest_t forest,
+                                                t8_coloring_type_t type,
+                                                t8_locidx_t block_size,
+                                                t8_forest_coloring_t *
+                                                coloring);
+
+/** Update a coloring after a forest was adapted.
+ * Elements that were not changed keep their color if this does not
+ * lead to a conflict, and only the other elements are colored anew.
+ * The face neighbors are only computed for the changed elements and, for
+ * \ref T8_COLORING_FACE_NEIGHBORS, for their neighbors and the neighbors of
+ * those. If a forest with a coloring of type \ref T8_COLORING_FACE_NEIGHBORS
+ * is partitioned over more than one process, the whole adjacency graph is
+ * computed, since changed ghost elements can be a new common neighbor of
+ * unchanged local elements.
+ * Blocked colorings are recomputed.
+ * This function is collective over the communicator of \a forest_new.
+ * \param [in]  forest_new A committed and balanced forest that was created from
+ *                        \a forest_old by adaptation and balance, but not by
+ *                        partition. It must have a ghost layer if it is
+ *                        partitioned over more than one process.
+ * \param [in]  forest_old The forest from which \a forest_new was created.
+ * \param [in]  coloring_old A coloring of \a forest_old.
+ * \param [out] coloring_new On output a coloring of \a forest_new of the same
+ *                        type as \a coloring_old.
+ *                        Must be freed with \ref t8_forest_coloring_reset.
+ */
+void                t8_forest_coloring_update (t8_forest_t forest_new,
+                                               t8_forest_t forest_old,
+                                               const t8_forest_coloring_t *
+                                               coloring_old,
+                                               t8_forest_coloring_t *
+                                               coloring_new);
+
+/** Compute the color of each local element.
+ * \param [in]  coloring  A coloring.
+ * \param [out] colors    Array of length \a coloring->num_elements. On output
+ *                        the color of each local element.
+ */
+void                t8_forest_coloring_element_colors (const
+                                                       t8_forest_coloring_t *
+                                                       coloring, int *colors);
+
+/** Free the memory of a coloring.
+ * \param [in,out] coloring A coloring that was filled with \ref t8_forest_coloring_compute
+ *                        or \ref t8_forest_coloring_update.
+ *                        On output all pointers are set to NULL.
+ */
+void                t8_forest_coloring_reset (t8_forest_coloring_t *
+                                              coloring);
+
+T8_EXTERN_C_END ();
+
+#endif /* !T8_FOREST_COLORING_H */
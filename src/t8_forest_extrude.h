@@ -0,0 +1,72 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+/** file t8_forest_extrude.h
+ * Extrude a two dimensional forest into a three dimensional forest of
+ * columns. Triangles are extruded to prisms and quadrilaterals to
+ * hexahedra. The elements of the extruded forest are computed directly
+ * from the two dimensional elements, without adapting a three dimensional
+ * forest.
+ */
+
+#ifndef T8_FOREST_EXTRUDE_H
+#define T8_FOREST_EXTRUDE_H
+
+#include <t8_forest.h>
+
+T8_EXTERN_C_BEGIN ();
+
+/** Extrude a two dimensional forest into layers of prisms and hexahedra.
+ * Each tree of the coarse mesh of \a forest becomes a column of
+ * \a num_layers trees, a triangle a column of prisms and a quadrilateral
+ * a column of hexahedra. The layer \a l of the tree with global id \a g has
+ * the global id \a g * \a num_layers + \a l. The layer trees of a column are
+ * connected to each other and to the layer trees of the neighboring columns.
+ * In each layer tree, an element of \a forest of level L becomes a column of
+ * the 2^L elements of level L that have it as their projection.
+ * The extruded forest is partitioned such that each process owns as many
+ * elements as the columns of its elements of \a forest have. The columns of
+ * the trees that are owned by a single process stay on this process.
+ * Columns of trees that are shared between processes are distributed
+ * along the space filling curve of the extruded trees.
+ * \param [in] forest     A committed two dimensional forest of the default
+ *                        scheme. Its coarse mesh must not be partitioned and
+ *                        consist of triangles and quadrilaterals.
+ *                        \a forest is not modified and keeps its reference.
+ * \param [in] num_layers The number of layers, must be positive.
+ * \param [in] layer_z    If not NULL, an increasing array of \a num_layers + 1
+ *                        z coordinates of the layer interfaces. The vertices
+ *                        of layer \a l are the vertices of the two
+ *                        dimensional tree moved by layer_z[l] and
+ *                        layer_z[l + 1] in z direction.
+ *                        If NULL, the layers divide [0, 1] evenly.
+ * \return                The committed extruded forest. It uses the same
+ *                        scheme and communicator as \a forest.
+ * \note This function is collective.
+ */
+t8_forest_t         t8_forest_new_extrude (t8_forest_t forest,
+                                           int num_layers,
+                                           const double *layer_z);
+
+T8_EXTERN_C_END ();
+
+#endif /* !T8_FOREST_EXTRUDE_H */
@@ -0,0 +1,106 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+/** file t8_forest_indicator.h
+ * Global thresholds for per element error indicators.
+ * Given one indicator value per local element of a forest, the functions in
+ * this file compute global quantiles with a distributed selection algorithm,
+ * without sorting all values. From the quantiles, refine and coarsen markers
+ * are computed that can be passed to \ref t8_forest_indicator_adapt.
+ */
+
+#ifndef T8_FOREST_INDICATOR_H
+#define T8_FOREST_INDICATOR_H
+
+#include <t8_forest.h>
+
+T8_EXTERN_C_BEGIN ();
+
+/** Select the k-th smallest value of a distributed array.
+ * \param [in] comm       The MPI communicator.
+ * \param [in] values     The local values, not modified.
+ * \param [in] num_values The number of local values.
+ * \param [in] k          The zero based global rank of the value to select.
+ *                        Must be smaller than the global number of values.
+ * \return                The value that is at position \a k if all values of
+ *                        all processes were sorted.
+ * \note This function is collective and returns the same value on each process.
+ */
+double              t8_forest_indicator_select (sc_MPI_Comm comm,
+                                                const double *values,
+                                                t8_locidx_t num_values,
+                                                t8_gloidx_t k);
+
+/** Compute a global quantile of an element indicator.
+ * \param [in] forest     A committed forest.
+ * \param [in] indicator  The indicator of each local element of \a forest.
+ * \param [in] fraction   A number in [0, 1].
+ * \return                The smallest indicator value such that at least
+ *                        \a fraction times the global number of elements have
+ *                        a smaller or equal indicator.
+ *                        If \a forest has no elements, 0 is returned.
+ * \note This function is collective.
+ */
+double              t8_forest_indicator_quantile (t8_forest_t forest,
+                                                  const double *indicator,
+                                                  double fraction);
+
+/** Compute refine and coarsen markers from an element indicator.
+ * The elements with the \a refine_fraction largest indicators are marked with 1
+ * for refinement and the elements with the \a coarsen_fraction smallest
+ * indicators with -1 for coarsening. All other elements are marked with 0.
+ * Elements with an indicator equal to a threshold are all marked, such that
+ * more elements than requested may be marked.
+ * If an element is marked for refinement and coarsening, it is refined.
+ * \param [in] forest           A committed forest.
+ * \param [in] indicator        The indicator of each local element of \a forest.
+ * \param [in] refine_fraction  The fraction of elements to refine, in [0, 1].
+ * \param [in] coarsen_fraction The fraction of elements to coarsen, in [0, 1].
+ * \param [out] markers         The marker of each local element of \a forest.
+ * \note This function is collective.
+ */
+void                t8_forest_indicator_markers (t8_forest_t forest,
+                                                 const double *indicator,
+                                                 double refine_fraction,
+                                                 double coarsen_fraction,
+                                                 int *markers);
+
+/** Adapt callback that refines and coarsens elements according to markers.
+ * The markers of the elements of \a forest_from, see
+ * \ref t8_forest_indicator_markers, must be the user data of \a forest.
+ * An element is refined if its marker is positive. A family is coarsened
+ * if all of its members have a negative marker.
+ * Use for example
+ * t8_forest_new_adapt (forest_from, t8_forest_indicator_adapt, 0, 0, markers).
+ * \see t8_forest_adapt_t
+ */
+int                 t8_forest_indicator_adapt (t8_forest_t forest,
+                                               t8_forest_t forest_from,
+                                               t8_locidx_t which_tree,
+                                               t8_locidx_t lelement_id,
+                                               t8_eclass_scheme_c * ts,
+                                               int num_elements,
+                                               t8_element_t * elements[]);
+
+T8_EXTERN_C_END ();
+
+#endif /* !T8_FOREST_INDICATOR_H */
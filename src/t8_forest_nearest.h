@@ -0,0 +1,109 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+/** file t8_forest_nearest.h
+ * Distance based queries on the elements of a forest.
+ * For a batch of query points we find the k nearest elements or all elements
+ * within a radius. The search traverses the trees best-first with the
+ * bounding boxes of subtrees as lower bounds. Candidates on other processes
+ * are found with the bounding boxes of the process partitions.
+ */
+
+#ifndef T8_FOREST_NEAREST_H
+#define T8_FOREST_NEAREST_H
+
+#include <t8_forest.h>
+
+/** An element found by a nearest element query. */
+typedef struct
+{
+  t8_gloidx_t         element_id; /**< The global id of the element. */
+  int                 owner;    /**< The process that owns the element. */
+  double              distance; /**< The distance between the query point and the element. */
+} t8_forest_nearest_t;
+
+/** The results of a batch of nearest element queries. */
+typedef struct
+{
+  size_t              num_points; /**< The number of query points. */
+  size_t             *offsets;  /**< Array of length \a num_points + 1. The elements found
+                                     for point i are at positions offsets[i], ...,
+                                     offsets[i + 1] - 1 of \a elements. */
+  t8_forest_nearest_t *elements; /**< The found elements of each point, sorted by
+                                      increasing distance and then by global id. */
+} t8_forest_nearest_result_t;
+
+T8_EXTERN_C_BEGIN ();
+
+/** Compute the distance between a point and an element.
+ * The element is split into simplices and the distance is the minimum
+ * distance to these simplices. Thus the distance is exact for elements
+ * with linear geometry and zero if the point lies inside the element.
+ * \param [in]      forest     The forest.
+ * \param [in]      ltreeid    The forest local id of the tree in which the element is.
+ * \param [in]      element    The element.
+ * \param [in]      tree_vertices An array storing the vertex coordinates of the tree.
+ * \param [in]      point      3-dimensional coordinates of the point.
+ * \return                     The distance between \a point and \a element.
+ */
+double              t8_forest_element_point_distance (t8_forest_t forest,
+                                                      t8_locidx_t ltreeid,
+                                                      const t8_element_t *
+                                                      element,
+                                                      const double
+                                                      *tree_vertices,
+                                                      const double point[3]);
+
+/** Find the nearest elements of a forest for a batch of points.
+ * Each process passes its own query points and receives the elements of
+ * the whole forest that are nearest to them, including elements of other
+ * processes.
+ * The distance of a point and an element is computed with
+ * \ref t8_forest_element_point_distance.
+ * This function is collective over the communicator of \a forest.
+ * \param [in]  forest    A committed forest.
+ * \param [in]  num_points The number of local query points.
+ * \param [in]  points    Array of 3 * \a num_points coordinates of the points.
+ * \param [in]  k         If positive, at most the \a k nearest elements are
+ *                        found for each point. Elements with the same distance
+ *                        are ordered by their global id.
+ *                        If zero, all elements within \a radius are found.
+ * \param [in]  radius    If not negative, only elements with a distance of at
+ *                        most \a radius are found. If negative, \a k must be positive.
+ * \param [out] result    On output the found elements of each point.
+ *                        Must be freed with \ref t8_forest_nearest_reset.
+ */
+void                t8_forest_nearest (t8_forest_t forest, size_t num_points,
+                                       const double *points, int k,
+                                       double radius,
+                                       t8_forest_nearest_result_t * result);
+
+/** Free the memory of the results of nearest element queries.
+ * \param [in,out] result  Results that were filled with \ref t8_forest_nearest.
+ *                         On output all pointers are set to NULL.
+ */
+void                t8_forest_nearest_reset (t8_forest_nearest_result_t *
+                                             result);
+
+T8_EXTERN_C_END ();
+
+#endif /* !T8_FOREST_NEAREST_H */
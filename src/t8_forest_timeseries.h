@@ -0,0 +1,102 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+/** file t8_forest_timeseries.h
+ * Write a sequence of forests and element data as an XDMF temporal collection.
+ * The geometry and topology of a forest are written only once, no matter
+ * for how many time steps the same forest is used. For each step only the
+ * user defined data fields are written and the step refers to the stored
+ * geometry of its forest.
+ *
+ * Each process writes its heavy data in raw binary files
+ *   fileprefix_geometry_GGGG_RRRR.bin  (points and topology of geometry G)
+ *   fileprefix_step_SSSS_RRRR.bin      (data fields of step S)
+ * and process 0 maintains the light data file fileprefix.xmf that can
+ * be opened with Paraview or Visit. The .xmf file is completed after each
+ * step, such that it can be viewed while the simulation is running.
+ * \see t8_forest_vtk.h
+ */
+
+#ifndef T8_FOREST_TIMESERIES_H
+#define T8_FOREST_TIMESERIES_H
+
+#include <t8_vtk.h>
+#include <t8_forest.h>
+
+/** Opaque pointer to a time series writer. */
+typedef struct t8_forest_timeseries *t8_forest_timeseries_t;
+
+T8_EXTERN_C_BEGIN ();
+
+/** Create a new time series writer.
+ * No file is written until the first step is added.
+ * \param [in] fileprefix  The prefix of all output files.
+ *                         The light data file will be named \a fileprefix.xmf .
+ * \return                 A new time series writer.
+ */
+t8_forest_timeseries_t t8_forest_timeseries_new (const char *fileprefix);
+
+/** Add a time step to a time series.
+ * If \a forest has not changed since the last written step, its
+ * geometry and topology are not written again.
+ * This function is collective over the communicator of \a forest.
+ * All forests passed to the same time series must use communicators
+ * of the same size.
+ * \param [in,out] series The time series.
+ * \param [in]  forest    A committed forest.
+ * \param [in]  time      The time value of this step.
+ * \param [in]  num_data  Number of user defined double valued data fields to write.
+ * \param [in]  data      Array of t8_vtk_data_field_t of length \a num_data
+ *                        providing the user defined per element data.
+ * \return  True if successful, false if not (process local).
+ */
+int                 t8_forest_timeseries_write_step (t8_forest_timeseries_t
+                                                     series,
+                                                     t8_forest_t forest,
+                                                     double time,
+                                                     int num_data,
+                                                     t8_vtk_data_field_t *
+                                                     data);
+
+/** Return the number of steps written to a time series.
+ * \param [in] series The time series.
+ * \return            The number of calls to \ref t8_forest_timeseries_write_step.
+ */
+int                 t8_forest_timeseries_get_num_steps (t8_forest_timeseries_t
+                                                        series);
+
+/** Return the number of distinct geometries written to a time series.
+ * \param [in] series The time series.
+ * \return            The number of times the geometry was written.
+ */
+int                 t8_forest_timeseries_get_num_geometries
+  (t8_forest_timeseries_t series);
+
+/** Close all files of a time series and free its memory.
+ * \param [in,out] pseries Pointer to a time series. Set to NULL on output.
+ */
+void                t8_forest_timeseries_destroy (t8_forest_timeseries_t *
+                                                  pseries);
+
+T8_EXTERN_C_END ();
+
+#endif /* !T8_FOREST_TIMESERIES_H */
@@ -54,7 +54,8 @@ void                t8_forest_write_vtk_via_API (t8_forest_t forest,
  * \param [in]  write_level If true, the refinement level is written for each element.
  * \param [in]  write_element_id If true, the global element id is written for each element.
  * \param [in]  write_ghosts If true, each process additionally writes its ghost elements.
- *                           For ghost element the treeid is -1.
+ *                           For ghost elements the global tree id and global element id
+ *                           are the ones on their owner process.
  * \param [in]  num_data  Number of user defined double valued data fields to write.
  * \param [in]  data      Array of t8_vtk_data_field_t of length \a num_data
  *                        providing the used defined per element data.
@@ -72,6 +73,111 @@ int                 t8_forest_vtk_write_file (t8_forest_t forest,
                                               int num_data,
                                               t8_vtk_data_field_t * data);
 
+/** Write the forest in .pvtu file format into a given number of .vtu files.
+ * The processes are divided into \a num_files groups of consecutive ranks,
+ * for example one group per compute node. The first process of each group
+ * receives the pieces of the other processes of its group and writes them
+ * to one .vtu file with one piece per process.
+ * Thus the number of files does not grow with the number of processes.
+ * The first process of a group needs memory for the largest piece of its group.
+ * \param [in]  forest    The forest.
+ * \param [in]  fileprefix  The prefix of the output files.
+ * \param [in]  num_files The number of .vtu files to write, at least 1.
+ *                        If larger than the number of processes, one file
+ *                        per process is written as in \ref t8_forest_vtk_write_file.
+ * \param [in]  write_treeid If true, the global tree id is written for each element.
+ * \param [in]  write_mpirank If true, the mpirank is written for each element .
+ * \param [in]  write_level If true, the refinement level is written for each element.
+ * \param [in]  write_element_id If true, the global element id is written for each element.
+ * \param [in]  write_ghosts If true, each process additionally writes its ghost elements.
+ * \param [in]  num_data  Number of user defined double valued data fields to write.
+ * \param [in]  data      Array of t8_vtk_data_field_t of length \a num_data
+ *                        providing the used defined per element data.
+ *                        If scalar and vector fields are used, all scalar fields
+ *                        must come first in the array.
+ * \return  True if succesful, false if not (process local).
+ * \note This function is collective over the communicator of \a forest.
+ */
+int                 t8_forest_vtk_write_file_aggregated (t8_forest_t forest,
+                                                         const char
+                                                         *fileprefix,
+                                                         int num_files,
+                                                         int write_treeid,
+                                                         int write_mpirank,
+                                                         int write_level,
+                                                         int
+                                                         write_element_id,
+                                                         int write_ghosts,
+                                                         int num_data,
+                                                         t8_vtk_data_field_t *
+                                                         data);
+
+/** Return the number of nodes of a vtk Lagrange cell.
+ * \param [in]  eclass    The element class. Must not be a pyramid.
+ * \param [in]  order     The polynomial order of the cell, at least 1.
+ * \return                The number of nodes of a Lagrange cell of class
+ *                        \a eclass and order \a order.
+ */
+int                 t8_forest_vtk_lagrange_num_nodes (t8_eclass_t eclass,
+                                                      int order);
+
+/** Compute the coordinates of the nodes of the vtk Lagrange cell
+ * that represents an element.
+ * The nodes are the equidistant points of the element and are given in
+ * vtk node ordering. Use this to evaluate the nodal values of a high order
+ * solution that are passed to \ref t8_forest_vtk_write_file_lagrange.
+ * \param [in]  forest    The forest.
+ * \param [in]  ltreeid   The local id of the tree of \a element.
+ * \param [in]  element   An element of tree \a ltreeid.
+ * \param [in]  order     The polynomial order of the cell, at least 1.
+ * \param [out] coordinates On output the coordinates of the nodes.
+ *                        Must have space for 3 * \ref t8_forest_vtk_lagrange_num_nodes
+ *                        doubles.
+ */
+void                t8_forest_vtk_lagrange_node_coordinates (t8_forest_t
+                                                             forest,
+                                                             t8_locidx_t
+                                                             ltreeid,
+                                                             const
+                                                             t8_element_t *
+                                                             element,
+                                                             int order,
+                                                             double
+                                                             *coordinates);
+
+/** Write the forest in .pvtu file format with each element written as
+ * a vtk Lagrange cell of a given order.
+ * High order fields can thus be visualized without refining the forest.
+ * The coordinates of the nodes are computed from the tree geometry, see
+ * \ref t8_forest_vtk_lagrange_node_coordinates.
+ * The node ordering follows vtk 9. Pyramids and ghost elements are not supported.
+ * \param [in]  forest    The forest.
+ * \param [in]  fileprefix  The prefix of the output files.
+ * \param [in]  order     The polynomial order of the cells, at least 1.
+ * \param [in]  write_treeid If true, the global tree id is written for each element.
+ * \param [in]  write_mpirank If true, the mpirank is written for each element .
+ * \param [in]  write_level If true, the refinement level is written for each element.
+ * \param [in]  write_element_id If true, the global element id is written for each element.
+ * \param [in]  num_data  Number of user defined double valued data fields to write.
+ * \param [in]  data      Array of t8_vtk_data_field_t of length \a num_data
+ *                        providing the user defined nodal values.
+ *                        For each local element in order the values at its
+ *                        \ref t8_forest_vtk_lagrange_num_nodes nodes are stored,
+ *                        one value per node for scalar and 3 for vector fields.
+ *                        The data is written as point data.
+ * \return  True if succesful, false if not (process local).
+ */
+int                 t8_forest_vtk_write_file_lagrange (t8_forest_t forest,
+                                                       const char *fileprefix,
+                                                       int order,
+                                                       int write_treeid,
+                                                       int write_mpirank,
+                                                       int write_level,
+                                                       int write_element_id,
+                                                       int num_data,
+                                                       t8_vtk_data_field_t *
+                                                       data);
+
 T8_EXTERN_C_END ();
 
 #endif /* !T8_FOREST_VTK_H */
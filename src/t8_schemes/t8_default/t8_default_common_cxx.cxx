@@ -114,13 +114,23 @@ t8_element_shape_t
 }
 
 /* Given an element's level and dimension, return the number of leafs it
- * produces at a given uniform refinement level */
+ * produces at a given uniform refinement level.
+ * We abort if this number does not fit into a t8_gloidx_t, which happens
+ * for tetrahedra and prisms of level 0 refined to their maximum level. */
 static inline       t8_gloidx_t
 count_leafs_from_level (int element_level, int refinement_level,
                         int dimension)
 {
-  return element_level > refinement_level ? 0
-    : sc_intpow64 (2, dimension * (refinement_level - element_level));
+  int                 exponent;
+
+  if (element_level > refinement_level) {
+    return 0;
+  }
+  exponent = dimension * (refinement_level - element_level);
+  SC_CHECK_ABORTF (exponent < 8 * (int) sizeof (t8_gloidx_t) - 1,
+                   "The leaf count 2^%i does not fit into t8_gloidx_t.\n",
+                   exponent);
+  return (t8_gloidx_t) 1 << exponent;
 }
 
 t8_gloidx_t
@@ -28,6 +28,8 @@
 #include "t8_default_line_cxx.hxx"
 #include "t8_default_quad_cxx.hxx"
 #include "t8_default_hex_cxx.hxx"
+#include "t8_default_quad_aniso_cxx.hxx"
+#include "t8_default_hex_aniso_cxx.hxx"
 #include "t8_default_tri_cxx.hxx"
 #include "t8_default_tet_cxx.hxx"
 #include "t8_default_prism_cxx.hxx"
@@ -54,6 +56,20 @@ t8_scheme_new_default_cxx (void)
   return s;
 }
 
+t8_scheme_cxx_t    *
+t8_scheme_new_anisotropic_cxx (void)
+{
+  t8_scheme_cxx_t    *s;
+
+  s = t8_scheme_new_default_cxx ();
+  delete              s->eclass_schemes[T8_ECLASS_QUAD];
+  delete              s->eclass_schemes[T8_ECLASS_HEX];
+  s->eclass_schemes[T8_ECLASS_QUAD] = new t8_default_scheme_quad_aniso_c ();
+  s->eclass_schemes[T8_ECLASS_HEX] = new t8_default_scheme_hex_aniso_c ();
+
+  return s;
+}
+
 int
 t8_eclass_scheme_is_default (t8_eclass_scheme_c * ts)
 {
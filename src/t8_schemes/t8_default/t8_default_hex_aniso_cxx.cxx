@@ -0,0 +1,434 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#include <p8est_bits.h>
+#include "t8_default_common_cxx.hxx"
+#include "t8_default_quad_aniso_cxx.hxx"
+#include "t8_default_hex_aniso_cxx.hxx"
+
+/* We want to export the whole implementation to be callable from "C" */
+T8_EXTERN_C_BEGIN ();
+
+/* Copy the per axis levels beyond the patch level of one element to another.
+ * The functions of the hex scheme only modify the p8est_quadrant_t part of
+ * an element, so we may call this function after them even if \a dest
+ * and \a elem are the same element. */
+static void
+t8_element_copy_excess (const t8_element_t * elem, t8_element_t * dest)
+{
+  const t8_phex_aniso_t *q = (const t8_phex_aniso_t *) elem;
+  t8_phex_aniso_t   *r = (t8_phex_aniso_t *) dest;
+  int                 axis;
+
+  for (axis = 0; axis < P8EST_DIM; ++axis) {
+    r->excess[axis] = q->excess[axis];
+  }
+}
+
+/* Make an element isotropic */
+static void
+t8_element_zero_excess (t8_element_t * elem)
+{
+  t8_phex_aniso_t   *q = (t8_phex_aniso_t *) elem;
+  int                 axis;
+
+  for (axis = 0; axis < P8EST_DIM; ++axis) {
+    q->excess[axis] = 0;
+  }
+}
+
+/* Compute the hex axes that are the x and y axis of the quad at a face,
+ * see t8_default_scheme_hex_c::t8_element_boundary_face */
+static void
+t8_element_face_axes (int face, int axes[2])
+{
+  axes[0] = face >> 1 ? 0 : 1;
+  axes[1] = face >> 2 ? 1 : 2;
+}
+
+void
+t8_default_scheme_hex_aniso_c::t8_element_new (int length,
+                                                t8_element_t ** elem)
+{
+  int                 i;
+
+  t8_default_scheme_hex_c::t8_element_new (length, elem);
+  for (i = 0; i < length; i++) {
+    t8_element_zero_excess (elem[i]);
+  }
+}
+
+void
+t8_default_scheme_hex_aniso_c::t8_element_init (int length,
+                                                 t8_element_t * elem,
+                                                 int new_called)
+{
+  t8_phex_aniso_t   *hexs = (t8_phex_aniso_t *) elem;
+  int                 i;
+
+  /* The elements are not contiguous p8est quadrants, so we initialize
+   * them one by one. */
+  for (i = 0; i < length; i++) {
+    t8_default_scheme_hex_c::t8_element_init (1, (t8_element_t *)
+                                               (hexs + i), new_called);
+    t8_element_zero_excess ((t8_element_t *) (hexs + i));
+  }
+}
+
+int
+t8_default_scheme_hex_aniso_c::t8_element_level_axis (const t8_element_t *
+                                                       elem, int axis)
+{
+  const t8_phex_aniso_t *q = (const t8_phex_aniso_t *) elem;
+
+  T8_ASSERT (t8_element_is_valid (elem));
+  T8_ASSERT (0 <= axis && axis < P8EST_DIM);
+
+  return q->hex.level + q->excess[axis];
+}
+
+void
+t8_default_scheme_hex_aniso_c::t8_element_set_level_axes (t8_element_t *
+                                                           elem,
+                                                           const int *levels)
+{
+  t8_phex_aniso_t   *q = (t8_phex_aniso_t *) elem;
+  int                 axis;
+
+  T8_ASSERT (t8_element_is_valid (elem));
+  T8_ASSERT (SC_MIN (SC_MIN (levels[0], levels[1]), levels[2]) == q->hex.level);
+
+  for (axis = 0; axis < P8EST_DIM; ++axis) {
+    T8_ASSERT (levels[axis] <= P8EST_QMAXLEVEL);
+    q->excess[axis] = (int8_t) (levels[axis] - q->hex.level);
+  }
+}
+
+int
+t8_default_scheme_hex_aniso_c::t8_element_is_anisotropic (void)
+{
+  return 1;
+}
+
+void
+t8_default_scheme_hex_aniso_c::t8_element_copy (const t8_element_t * source,
+                                                 t8_element_t * dest)
+{
+  t8_default_scheme_hex_c::t8_element_copy (source, dest);
+  t8_element_copy_excess (source, dest);
+}
+
+int
+t8_default_scheme_hex_aniso_c::t8_element_compare (const t8_element_t *
+                                                   elem1,
+                                                   const t8_element_t *
+                                                   elem2)
+{
+  const t8_phex_aniso_t *q1 = (const t8_phex_aniso_t *) elem1;
+  const t8_phex_aniso_t *q2 = (const t8_phex_aniso_t *) elem2;
+  int                 axis, result;
+
+  result = t8_default_scheme_hex_c::t8_element_compare (elem1, elem2);
+  /* Elements with the same patch are ordered by their per axis levels */
+  for (axis = 0; result == 0 && axis < P8EST_DIM; ++axis) {
+    result = q1->excess[axis] - q2->excess[axis];
+  }
+  return result;
+}
+
+void
+t8_default_scheme_hex_aniso_c::t8_element_parent (const t8_element_t * elem,
+                                                   t8_element_t * parent)
+{
+  t8_default_scheme_hex_c::t8_element_parent (elem, parent);
+  t8_element_copy_excess (elem, parent);
+}
+
+void
+t8_default_scheme_hex_aniso_c::t8_element_sibling (const t8_element_t * elem,
+                                                    int sibid,
+                                                    t8_element_t * sibling)
+{
+  t8_default_scheme_hex_c::t8_element_sibling (elem, sibid, sibling);
+  t8_element_copy_excess (elem, sibling);
+}
+
+void
+t8_default_scheme_hex_aniso_c::t8_element_child (const t8_element_t * elem,
+                                                  int childid,
+                                                  t8_element_t * child)
+{
+  t8_default_scheme_hex_c::t8_element_child (elem, childid, child);
+  t8_element_copy_excess (elem, child);
+}
+
+void
+t8_default_scheme_hex_aniso_c::t8_element_children (const t8_element_t *
+                                                     elem, int length,
+                                                     t8_element_t * c[])
+{
+  int                 i;
+
+  t8_default_scheme_hex_c::t8_element_children (elem, length, c);
+  for (i = 0; i < length; i++) {
+    t8_element_copy_excess (elem, c[i]);
+  }
+}
+
+int
+t8_default_scheme_hex_aniso_c::t8_element_is_family (t8_element_t ** fam)
+{
+  int                 i, axis;
+
+  for (i = 1; i < P8EST_CHILDREN; i++) {
+    for (axis = 0; axis < P8EST_DIM; ++axis) {
+      if (((t8_phex_aniso_t *) fam[i])->excess[axis] !=
+          ((t8_phex_aniso_t *) fam[0])->excess[axis]) {
+        return 0;
+      }
+    }
+  }
+  return t8_default_scheme_hex_c::t8_element_is_family (fam);
+}
+
+void
+t8_default_scheme_hex_aniso_c::t8_element_nca (const t8_element_t * elem1,
+                                                const t8_element_t * elem2,
+                                                t8_element_t * nca)
+{
+  const t8_phex_aniso_t *q1 = (const t8_phex_aniso_t *) elem1;
+  const t8_phex_aniso_t *q2 = (const t8_phex_aniso_t *) elem2;
+  int8_t              excess[P8EST_DIM];
+  int                 axis;
+
+  /* The ancestors of an element inherit its per axis levels.
+   * The common ancestor is refined along the axes along which both
+   * elements are refined. We store the excess first, since nca may
+   * point to elem1 or elem2. */
+  for (axis = 0; axis < P8EST_DIM; ++axis) {
+    excess[axis] = SC_MIN (q1->excess[axis], q2->excess[axis]);
+  }
+  t8_default_scheme_hex_c::t8_element_nca (elem1, elem2, nca);
+  for (axis = 0; axis < P8EST_DIM; ++axis) {
+    ((t8_phex_aniso_t *) nca)->excess[axis] = excess[axis];
+  }
+}
+
+void
+t8_default_scheme_hex_aniso_c::t8_element_children_at_face (const
+                                                             t8_element_t *
+                                                             elem, int face,
+                                                             t8_element_t *
+                                                             children[],
+                                                             int num_children,
+                                                             int
+                                                             *child_indices)
+{
+  int                 i;
+
+  t8_default_scheme_hex_c::t8_element_children_at_face (elem, face,
+                                                         children,
+                                                         num_children,
+                                                         child_indices);
+  for (i = 0; i < num_children; i++) {
+    t8_element_copy_excess (elem, children[i]);
+  }
+}
+
+int
+t8_default_scheme_hex_aniso_c::t8_element_extrude_face (const t8_element_t *
+                                                         face,
+                                                         const
+                                                         t8_eclass_scheme_c *
+                                                         face_scheme,
+                                                         t8_element_t * elem,
+                                                         int root_face)
+{
+  const t8_pquad_aniso_t *b = (const t8_pquad_aniso_t *) face;
+  t8_phex_aniso_t    *q = (t8_phex_aniso_t *) elem;
+  int                 axes[2];
+
+  t8_element_zero_excess (elem);
+  if (T8_COMMON_IS_TYPE
+      (face_scheme, const t8_default_scheme_quad_aniso_c *)) {
+    /* The element has the levels of the face along the face axes */
+    t8_element_face_axes (root_face, axes);
+    q->excess[axes[0]] = b->excess[0];
+    q->excess[axes[1]] = b->excess[1];
+  }
+  return t8_default_scheme_hex_c::t8_element_extrude_face (face,
+                                                            face_scheme,
+                                                            elem, root_face);
+}
+
+void
+t8_default_scheme_hex_aniso_c::t8_element_first_descendant_face (const
+                                                                  t8_element_t
+                                                                  * elem,
+                                                                  int face,
+                                                                  t8_element_t
+                                                                  *
+                                                                  first_desc,
+                                                                  int level)
+{
+  t8_default_scheme_hex_c::t8_element_first_descendant_face (elem, face,
+                                                              first_desc,
+                                                              level);
+  t8_element_copy_excess (elem, first_desc);
+}
+
+void
+t8_default_scheme_hex_aniso_c::t8_element_last_descendant_face (const
+                                                                 t8_element_t
+                                                                 * elem,
+                                                                 int face,
+                                                                 t8_element_t
+                                                                 * last_desc,
+                                                                 int level)
+{
+  t8_default_scheme_hex_c::t8_element_last_descendant_face (elem, face,
+                                                             last_desc,
+                                                             level);
+  t8_element_copy_excess (elem, last_desc);
+}
+
+void
+t8_default_scheme_hex_aniso_c::t8_element_boundary_face (const t8_element_t *
+                                                         elem, int face,
+                                                         t8_element_t *
+                                                         boundary,
+                                                         const
+                                                         t8_eclass_scheme_c *
+                                                         boundary_scheme)
+{
+  const t8_phex_aniso_t *q = (const t8_phex_aniso_t *) elem;
+  t8_pquad_aniso_t   *b = (t8_pquad_aniso_t *) boundary;
+  int                 axes[2];
+
+  t8_default_scheme_hex_c::t8_element_boundary_face (elem, face, boundary,
+                                                     boundary_scheme);
+  if (T8_COMMON_IS_TYPE
+      (boundary_scheme, const t8_default_scheme_quad_aniso_c *)) {
+    /* The boundary has the levels of the element along the face axes.
+     * If the element is refined beyond its patch level along both face axes,
+     * these levels cannot be represented by a quad of the same patch and
+     * the boundary is the isotropic face of the patch. */
+    t8_element_face_axes (face, axes);
+    if (SC_MIN (q->excess[axes[0]], q->excess[axes[1]]) == 0) {
+      b->excess[0] = q->excess[axes[0]];
+      b->excess[1] = q->excess[axes[1]];
+    }
+    else {
+      b->excess[0] = b->excess[1] = 0;
+    }
+  }
+}
+
+int
+t8_default_scheme_hex_aniso_c::t8_element_face_neighbor_inside (const
+                                                                 t8_element_t
+                                                                 * elem,
+                                                                 t8_element_t
+                                                                 * neigh,
+                                                                 int face,
+                                                                 int
+                                                                 *neigh_face)
+{
+  t8_element_copy_excess (elem, neigh);
+  return t8_default_scheme_hex_c::t8_element_face_neighbor_inside (elem,
+                                                                    neigh,
+                                                                    face,
+                                                                    neigh_face);
+}
+
+void
+t8_default_scheme_hex_aniso_c::t8_element_set_linear_id (t8_element_t *
+                                                          elem, int level,
+                                                          t8_linearidx_t id)
+{
+  /* The linear id only determines the patch. The element is isotropic. */
+  t8_default_scheme_hex_c::t8_element_set_linear_id (elem, level, id);
+  t8_element_zero_excess (elem);
+}
+
+void
+t8_default_scheme_hex_aniso_c::t8_element_first_descendant (const
+                                                             t8_element_t *
+                                                             elem,
+                                                             t8_element_t *
+                                                             desc, int level)
+{
+  t8_default_scheme_hex_c::t8_element_first_descendant (elem, desc, level);
+  t8_element_copy_excess (elem, desc);
+}
+
+void
+t8_default_scheme_hex_aniso_c::t8_element_last_descendant (const
+                                                            t8_element_t *
+                                                            elem,
+                                                            t8_element_t *
+                                                            desc, int level)
+{
+  t8_default_scheme_hex_c::t8_element_last_descendant (elem, desc, level);
+  t8_element_copy_excess (elem, desc);
+}
+
+void
+t8_default_scheme_hex_aniso_c::t8_element_successor (const t8_element_t *
+                                                      elem1,
+                                                      t8_element_t * elem2,
+                                                      int level)
+{
+  t8_default_scheme_hex_c::t8_element_successor (elem1, elem2, level);
+  t8_element_copy_excess (elem1, elem2);
+}
+
+#ifdef T8_ENABLE_DEBUG
+/* *INDENT-OFF* */
+/* indent bug, indent adds a second "const" modifier */
+int
+t8_default_scheme_hex_aniso_c::t8_element_is_valid (const t8_element_t * elem) const
+/* *INDENT-ON* */
+{
+  const t8_phex_aniso_t *q = (const t8_phex_aniso_t *) elem;
+
+  return t8_default_scheme_hex_c::t8_element_is_valid (elem)
+    && q->excess[0] >= 0 && q->excess[1] >= 0 && q->excess[2] >= 0
+    && SC_MIN (SC_MIN (q->excess[0], q->excess[1]), q->excess[2]) == 0;
+}
+#endif
+
+/* Constructor */
+t8_default_scheme_hex_aniso_c::t8_default_scheme_hex_aniso_c (void)
+{
+  /* The hex constructor created a mempool for smaller elements */
+  sc_mempool_destroy ((sc_mempool_t *) ts_context);
+  element_size = sizeof (t8_phex_aniso_t);
+  ts_context = sc_mempool_new (element_size);
+}
+
+t8_default_scheme_hex_aniso_c::~t8_default_scheme_hex_aniso_c ()
+{
+  /* The mempool is destroyed by the default_common destructor. */
+}
+
+T8_EXTERN_C_END ();
@@ -0,0 +1,181 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+/** \file t8_default_quad_aniso_cxx.hxx
+ * The anisotropic quadrilateral scheme refines elements along selected axes.
+ * An element stores a p4est_quadrant_t and, for each axis, by how many levels
+ * it is refined beyond the level of the quadrant along this axis.
+ * Thus the element is the quadrant (the isotropic patch) covered by a tensor
+ * grid of 2^(level along axis 0 - level) x 2^(level along axis 1 - level)
+ * anisotropic cells.
+ * The space-filling curve, the linear id, the parent/child relation and the
+ * face neighbors are those of the patches, so that partition, balance and
+ * ghost work unchanged. Elements constructed by the scheme inherit the
+ * per axis levels of the element they are constructed from.
+ * Only elements constructed from a linear id, and faces and extruded elements
+ * whose per axis levels cannot be represented by the other scheme, are
+ * the isotropic patches.
+ */
+
+#ifndef T8_DEFAULT_QUAD_ANISO_CXX_HXX
+#define T8_DEFAULT_QUAD_ANISO_CXX_HXX
+
+#include "t8_default_quad_cxx.hxx"
+
+/** The structure holding an anisotropic quadrilateral element. */
+typedef struct
+{
+  t8_pquad_t          quad;     /**< The isotropic patch of the element. */
+  int8_t              excess[P4EST_DIM];        /**< For each axis the number of levels
+                                                     beyond the level of \a quad. */
+}
+t8_pquad_aniso_t;
+
+struct t8_default_scheme_quad_aniso_c:public t8_default_scheme_quad_c
+{
+public:
+  /** Constructor. */
+  t8_default_scheme_quad_aniso_c ();
+
+  ~t8_default_scheme_quad_aniso_c ();
+
+  /** Allocate memory for a given number of elements. */
+  virtual void        t8_element_new (int length, t8_element_t ** elem);
+
+  /** Initialize an array of allocated elements. */
+  virtual void        t8_element_init (int length, t8_element_t * elem,
+                                       int called_new);
+
+  /** Return the level of an element along one coordinate axis. */
+  virtual int         t8_element_level_axis (const t8_element_t * elem,
+                                             int axis);
+
+  /** Set the levels of an element along all coordinate axes. */
+  virtual void        t8_element_set_level_axes (t8_element_t * elem,
+                                                 const int *levels);
+
+  /** Return true, since this scheme supports anisotropic levels. */
+  virtual int         t8_element_is_anisotropic (void);
+
+  /** Copy one element to another */
+  virtual void        t8_element_copy (const t8_element_t * source,
+                                       t8_element_t * dest);
+
+  /** Compare two elements. Elements with the same patch are ordered
+   * by their levels along the axes. */
+  virtual int         t8_element_compare (const t8_element_t * elem1,
+                                          const t8_element_t * elem2);
+
+  /** Construct the parent of a given element. */
+  virtual void        t8_element_parent (const t8_element_t * elem,
+                                         t8_element_t * parent);
+
+  /** Construct a same-size sibling of a given element. */
+  virtual void        t8_element_sibling (const t8_element_t * elem,
+                                          int sibid, t8_element_t * sibling);
+
+  /** Construct the child element of a given number. */
+  virtual void        t8_element_child (const t8_element_t * elem,
+                                        int childid, t8_element_t * child);
+
+  /** Construct all children of a given element. */
+  virtual void        t8_element_children (const t8_element_t * elem,
+                                           int length, t8_element_t * c[]);
+
+  /** Return nonzero if collection of elements is a family.
+   * The members of a family must have the same levels along all axes. */
+  virtual int         t8_element_is_family (t8_element_t ** fam);
+
+  /** Construct the nearest common ancestor of two elements in the same tree.
+   * Along each axis its excess level is the minimum of those of the elements. */
+  virtual void        t8_element_nca (const t8_element_t * elem1,
+                                      const t8_element_t * elem2,
+                                      t8_element_t * nca);
+
+  /** Compute all children of an element that touch a given face. */
+  virtual void        t8_element_children_at_face (const t8_element_t * elem,
+                                                   int face,
+                                                   t8_element_t * children[],
+                                                   int num_children,
+                                                   int *child_indices);
+
+  /** Transform the coordinates of a quadrilateral considered as boundary element
+   *  in a tree-tree connection. */
+  virtual void        t8_element_transform_face (const t8_element_t * elem1,
+                                                 t8_element_t * elem2,
+                                                 int orientation, int sign,
+                                                 int is_smaller_face);
+
+  /** Construct the element inside the root tree that has a given boundary
+   * face as a face. */
+  virtual int         t8_element_extrude_face (const t8_element_t * face,
+                                               const t8_eclass_scheme_c
+                                               * face_scheme,
+                                               t8_element_t * elem,
+                                               int root_face);
+
+  /** Construct the first descendant of an element that touches a given face. */
+  virtual void        t8_element_first_descendant_face (const t8_element_t *
+                                                        elem, int face,
+                                                        t8_element_t *
+                                                        first_desc,
+                                                        int level);
+
+  /** Construct the last descendant of an element that touches a given face. */
+  virtual void        t8_element_last_descendant_face (const t8_element_t *
+                                                       elem, int face,
+                                                       t8_element_t *
+                                                       last_desc, int level);
+
+  /** Construct the face neighbor of a given element if this face neighbor
+   * is inside the root tree. Return 0 otherwise. */
+  virtual int         t8_element_face_neighbor_inside (const t8_element_t *
+                                                       elem,
+                                                       t8_element_t * neigh,
+                                                       int face,
+                                                       int *neigh_face);
+
+  /** Initialize an element according to a given linear id */
+  virtual void        t8_element_set_linear_id (t8_element_t * elem,
+                                                int level, t8_linearidx_t id);
+
+  /** Calculate the first descendant of a given element. */
+  virtual void        t8_element_first_descendant (const t8_element_t *
+                                                   elem, t8_element_t * desc,
+                                                   int level);
+
+  /** Calculate the last descendant of a given element. */
+  virtual void        t8_element_last_descendant (const t8_element_t *
+                                                  elem, t8_element_t * desc,
+                                                  int level);
+
+  /** Compute s as a successor of t*/
+  virtual void        t8_element_successor (const t8_element_t * t,
+                                            t8_element_t * s, int level);
+
+#ifdef T8_ENABLE_DEBUG
+  /** Query whether an element is valid */
+  virtual int         t8_element_is_valid (const t8_element_t * t) const;
+#endif
+};
+
+#endif /* !T8_DEFAULT_QUAD_ANISO_CXX_HXX */
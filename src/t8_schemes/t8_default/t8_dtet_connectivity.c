@@ -148,3 +148,49 @@ const int           t8_dtet_parent_type_type_to_face[6][6] =
   { {-1, 0, 2, -1, 1, 3}, {0, -1, 3, 1, -1, 2}, {1, 3, -1, 0, 2, -1},
 {-1, 2, 0, -1, 3, 1}, {2, -1, 1, 3, -1, 0}, {3, 1, -1, 2, 0, -1}
 };
+
+/* Line b, row v gives the offset of vertex v of a tet
+ * of type b to its anchor node in units of the tet's length */
+const int           t8_dtet_type_vertex_to_offset[6][4][3] = {
+  {{0, 0, 0}, {1, 0, 0}, {1, 0, 1}, {1, 1, 1}},
+  {{0, 0, 0}, {1, 0, 0}, {1, 1, 0}, {1, 1, 1}},
+  {{0, 0, 0}, {0, 1, 0}, {1, 1, 0}, {1, 1, 1}},
+  {{0, 0, 0}, {0, 1, 0}, {0, 1, 1}, {1, 1, 1}},
+  {{0, 0, 0}, {0, 0, 1}, {0, 1, 1}, {1, 1, 1}},
+  {{0, 0, 0}, {0, 0, 1}, {1, 0, 1}, {1, 1, 1}}
+};
+
+/* Line b, row f gives the type of the face neighbor of
+ * a tet of type b across face f */
+const int           t8_dtet_type_face_to_nb_type[6][4] = {
+  {4, 5, 1, 2},
+  {3, 2, 0, 5},
+  {0, 1, 3, 4},
+  {5, 4, 2, 1},
+  {2, 3, 5, 0},
+  {1, 0, 4, 3}
+};
+
+/* Line b, row f gives the offset of the anchor node of the
+ * face neighbor of a tet of type b across face f
+ * in units of the tet's length */
+const int           t8_dtet_type_face_to_nb_offset[6][4][3] = {
+  {{1, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, -1, 0}},        /* type 0 */
+  {{1, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, -1}},        /* type 1 */
+  {{0, 1, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, -1}},        /* type 2 */
+  {{0, 1, 0}, {0, 0, 0}, {0, 0, 0}, {-1, 0, 0}},        /* type 3 */
+  {{0, 0, 1}, {0, 0, 0}, {0, 0, 0}, {-1, 0, 0}},        /* type 4 */
+  {{0, 0, 1}, {0, 0, 0}, {0, 0, 0}, {0, -1, 0}} /* type 5 */
+};
+
+/* The face number of the face neighbor across face f */
+const int           t8_dtet_face_to_nb_face[4] = { 3, 1, 2, 0 };
+
+/* Bit i is set if a tet of type b lies on the positive side of the plane
+ * x = y (i = 0), x = z (i = 1) resp. y = z (i = 2) */
+const int           t8_dtet_type_to_diff_signs[6] = { 3, 7, 6, 4, 0, 1 };
+
+/* The inverse of t8_dtet_type_to_diff_signs, -1 for sign
+ * combinations that do not occur */
+const int           t8_dtet_diff_signs_to_type[8] =
+  { 4, 5, -1, 0, 3, -1, 2, 1 };
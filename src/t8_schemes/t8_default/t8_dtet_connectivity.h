@@ -107,6 +107,30 @@ extern const int    t8_dtet_face_corner[4][3];
  * \see t8_dtet_face_parent_face
  */
 extern const int    t8_dtet_parent_type_type_to_face[6][6];
+
+/** Store the offset of each vertex to the anchor node for each type. */
+extern const int    t8_dtet_type_vertex_to_offset[6][4][3];
+
+/** Store the type of the face neighbor for each (type,face) combination. */
+extern const int    t8_dtet_type_face_to_nb_type[6][4];
+
+/** Store the offset of the face neighbor's anchor node for each
+ * (type,face) combination. */
+extern const int    t8_dtet_type_face_to_nb_offset[6][4][3];
+
+/** Store the face number of the face neighbor for each face. */
+extern const int    t8_dtet_face_to_nb_face[4];
+
+/** Store for each type on which side of the planes x = y, x = z and y = z
+ * a tet of this type lies. Bit 0, 1 resp. 2 is set for the positive side.
+ * An ancestor's type is determined by these sides, see \ref t8_dtet_ancestor.
+ */
+extern const int    t8_dtet_type_to_diff_signs[6];
+
+/** Store the type for each combination of sides of the planes x = y,
+ * x = z and y = z. The inverse of \ref t8_dtet_type_to_diff_signs. */
+extern const int    t8_dtet_diff_signs_to_type[8];
+
 T8_EXTERN_C_END ();
 
 #endif /* T8_DTET_CONNECTIVITY_H */
@@ -35,22 +35,23 @@ typedef int8_t      t8_dtri_cube_id_t;
 static              t8_dtri_cube_id_t
 compute_cubeid (const t8_dtri_t * t, int level)
 {
-  t8_dtri_cube_id_t   id = 0;
-  t8_dtri_coord_t     h;
+  t8_dtri_cube_id_t   id;
+  int                 shift;
 
   /* TODO: assert that 0 < level? This may simplify code elsewhere */
 
   T8_ASSERT (0 <= level && level <= T8_DTRI_MAXLEVEL);
-  h = T8_DTRI_LEN (level);
 
   if (level == 0) {
     return 0;
   }
 
-  id |= ((t->x & h) ? 0x01 : 0);
-  id |= ((t->y & h) ? 0x02 : 0);
+  /* The cube-id consists of the bits of the coordinates at level */
+  shift = T8_DTRI_MAXLEVEL - level;
+  id = (t->x >> shift) & 1;
+  id |= ((t->y >> shift) & 1) << 1;
 #ifdef T8_DTRI_TO_DTET
-  id |= ((t->z & h) ? 0x04 : 0);
+  id |= ((t->z >> shift) & 1) << 2;
 #endif
 
   return id;
@@ -167,11 +168,7 @@ t8_dtri_ancestor (const t8_dtri_t * t, int level, t8_dtri_t * ancestor)
   t8_dtri_coord_t     delta_x, delta_y, diff_xy;
 #ifdef T8_DTRI_TO_DTET
   t8_dtri_coord_t     delta_z, diff_xz, diff_yz;
-  t8_dtet_type_t      possible_types[6] = { 1, 1, 1, 1, 1, 1 };
-  int                 i;
-#ifdef T8_ENABLE_DEBUG
-  int                 set_type = 0;
-#endif
+  int                 type_signs, signs;
 #endif /* T8_DTRI_TO_DTET */
 
   /* delta_{x,y} = t->{x,y} - ancestor->{x,y}
@@ -193,95 +190,26 @@ t8_dtri_ancestor (const t8_dtri_t * t, int level, t8_dtri_t * ancestor)
 #endif
 
 #ifndef T8_DTRI_TO_DTET
-  /* The type of the ancestor depends on delta_x - delta_y */
+  /* The type of the ancestor depends on delta_x - delta_y.
+   * If it is zero, the ancestor has t's type. */
   diff_xy = delta_x - delta_y;
-  if (diff_xy > 0) {
-    ancestor->type = 0;
-  }
-  else if (diff_xy < 0) {
-    ancestor->type = 1;
-  }
-  else {
-    T8_ASSERT (diff_xy == 0);
-    ancestor->type = t->type;
-  }
+  ancestor->type = 1 - ((diff_xy > 0) | ((diff_xy == 0) & (t->type == 0)));
 
   ancestor->n = t->n;
 #else
-/* The sign of each diff reduces the number of possible types
- * for the ancestor. At the end only one possible type is left,
- * this type's entry in the possible_types array will be positive.
- */
-
+  /* The type of the ancestor depends on the signs of the differences
+   * delta_x - delta_y, delta_x - delta_z and delta_y - delta_z.
+   * If a difference is zero, the ancestor is on the same side of the
+   * corresponding plane as t. */
+  type_signs = t8_dtet_type_to_diff_signs[t->type];
   diff_xy = delta_x - delta_y;
   diff_xz = delta_x - delta_z;
   diff_yz = delta_y - delta_z;
-
-/* delta_x - delta_y */
-  if (diff_xy > 0) {
-    possible_types[2] = possible_types[3] = possible_types[4] = 0;
-  }
-  else if (diff_xy < 0) {
-    possible_types[0] = possible_types[1] = possible_types[5] = 0;
-  }
-  else {
-    T8_ASSERT (diff_xy == 0);
-    if (t->type == 0 || t->type == 1 || t->type == 5) {
-      possible_types[2] = possible_types[3] = possible_types[4] = 0;
-    }
-    else {
-      possible_types[0] = possible_types[1] = possible_types[5] = 0;
-    }
-  }
-
-/* delta_x - delta_z */
-  if (diff_xz > 0) {
-    possible_types[3] = possible_types[4] = possible_types[5] = 0;
-  }
-  else if (diff_xz < 0) {
-    possible_types[0] = possible_types[1] = possible_types[2] = 0;
-  }
-  else {
-    T8_ASSERT (diff_xz == 0);
-    if (t->type == 0 || t->type == 1 || t->type == 2) {
-      possible_types[3] = possible_types[4] = possible_types[5] = 0;
-    }
-    else {
-      possible_types[0] = possible_types[1] = possible_types[2] = 0;
-    }
-  }
-
-/* delta_y - delta_z */
-  if (diff_yz > 0) {
-    possible_types[0] = possible_types[4] = possible_types[5] = 0;
-  }
-  else if (diff_yz < 0) {
-    possible_types[1] = possible_types[2] = possible_types[3] = 0;
-  }
-  else {
-    T8_ASSERT (diff_yz == 0);
-    if (t->type == 1 || t->type == 2 || t->type == 3) {
-      possible_types[0] = possible_types[4] = possible_types[5] = 0;
-    }
-    else {
-      possible_types[1] = possible_types[2] = possible_types[3] = 0;
-    }
-  }
-
-  /* Got through possible_types array and find the only entry
-   * that is nonzero
-   */
-  for (i = 0; i < 6; i++) {
-    T8_ASSERT (possible_types[i] == 0 || possible_types[i] == 1);
-    if (possible_types[i] == 1) {
-      ancestor->type = i;
-#ifdef T8_ENABLE_DEBUG
-      T8_ASSERT (set_type != 1);
-      set_type = 1;
-#endif
-    }
-  }
-  T8_ASSERT (set_type == 1);
+  signs = (diff_xy > 0) | ((diff_xy == 0) & (type_signs & 1));
+  signs |= ((diff_xz > 0) | ((diff_xz == 0) & ((type_signs >> 1) & 1))) << 1;
+  signs |= ((diff_yz > 0) | ((diff_yz == 0) & ((type_signs >> 2) & 1))) << 2;
+  ancestor->type = t8_dtet_diff_signs_to_type[signs];
+  T8_ASSERT (0 <= ancestor->type && ancestor->type < T8_DTET_NUM_TYPES);
 #endif /* T8_DTRI_TO_DTET */
   ancestor->level = level;
 }
@@ -291,48 +219,17 @@ void
 t8_dtri_compute_coords (const t8_dtri_t * t, int vertex,
                         t8_dtri_coord_t coordinates[T8_DTRI_DIM])
 {
-  t8_dtri_type_t      type;
-  int                 ei;
-#ifdef T8_DTRI_TO_DTET
-  int                 ej;
-#endif
+  const int          *offset;
   t8_dtri_coord_t     h;
 
   T8_ASSERT (0 <= vertex && vertex < T8_DTRI_FACES);
 
-  type = t->type;
   h = T8_DTRI_LEN (t->level);
-#ifndef T8_DTRI_TO_DTET
-  ei = type;
-#else
-  ei = type / 2;
-  ej = (ei + ((type % 2 == 0) ? 2 : 1)) % 3;
-#endif
-
-  coordinates[0] = t->x;
-  coordinates[1] = t->y;
+  offset = t8_dtri_type_vertex_to_offset[t->type][vertex];
+  coordinates[0] = t->x + offset[0] * h;
+  coordinates[1] = t->y + offset[1] * h;
 #ifdef T8_DTRI_TO_DTET
-  coordinates[2] = t->z;
-#endif
-  if (vertex == 0) {
-    return;
-  }
-  coordinates[ei] += h;
-#ifndef T8_DTRI_TO_DTET
-  if (vertex == 2) {
-    coordinates[1 - ei] += h;
-    return;
-  }
-#else
-  if (vertex == 2) {
-    coordinates[ej] += h;
-    return;
-  }
-  if (vertex == 3) {
-    coordinates[(ei + 1) % 3] += h;
-    coordinates[(ei + 2) % 3] += h;
-  }
-  /* done 3D */
+  coordinates[2] = t->z + offset[2] * h;
 #endif
 }
 
@@ -342,42 +239,19 @@ t8_dtri_compute_all_coords (const t8_dtri_t * t,
                             t8_dtri_coord_t
                             coordinates[T8_DTRI_FACES][T8_DTRI_DIM])
 {
-  t8_dtri_type_t      type;
-  int                 ei;
-#ifdef T8_DTRI_TO_DTET
-  int                 ej;
-#endif
+  const int         (*offset)[T8_DTRI_DIM];
   int                 i;
   t8_dtri_coord_t     h;
 
-  type = t->type;
   h = T8_DTRI_LEN (t->level);
-#ifndef T8_DTRI_TO_DTET
-  ei = type;
-#else
-  ei = type / 2;
-  ej = (ei + ((type % 2 == 0) ? 2 : 1)) % 3;
-#endif
-
-  coordinates[0][0] = t->x;
-  coordinates[0][1] = t->y;
+  offset = t8_dtri_type_vertex_to_offset[t->type];
+  for (i = 0; i < T8_DTRI_FACES; i++) {
+    coordinates[i][0] = t->x + offset[i][0] * h;
+    coordinates[i][1] = t->y + offset[i][1] * h;
 #ifdef T8_DTRI_TO_DTET
-  coordinates[0][2] = t->z;
-#endif
-  for (i = 0; i < T8_DTRI_DIM; i++) {
-    coordinates[1][i] = coordinates[0][i];
-#ifndef T8_DTRI_TO_DTET
-    coordinates[2][i] = coordinates[0][i] + h;
-#else
-    coordinates[2][i] = coordinates[0][i];
-    coordinates[3][i] = coordinates[0][i] + h;
+    coordinates[i][2] = t->z + offset[i][2] * h;
 #endif
   }
-  coordinates[1][ei] += h;
-#ifdef T8_DTRI_TO_DTET
-  coordinates[2][ei] += h;
-  coordinates[2][ej] += h;
-#endif
 #ifdef T8_ENABLE_DEBUG
   /* We check whether the results are the same as with the
    * t8_dtri_compute_coords function.
@@ -405,39 +279,26 @@ void
 t8_dtri_child (const t8_dtri_t * t, int childid, t8_dtri_t * child)
 {
   t8_dtri_t          *c = (t8_dtri_t *) child;
-  t8_dtri_coord_t     t_coordinates[T8_DTRI_DIM];
-  int                 vertex;
-  int                 Bey_cid;
+  t8_dtri_cube_id_t   cid;
+  t8_dtri_type_t      type;
+  t8_dtri_coord_t     h;
 
   T8_ASSERT (t->level < T8_DTRI_MAXLEVEL);
   T8_ASSERT (0 <= childid && childid < T8_DTRI_CHILDREN);
 
-  Bey_cid = t8_dtri_index_to_bey_number[t->type][childid];
-
-  /* Compute anchor coordinates of child */
-  if (Bey_cid == 0) {
-    /* TODO: would it be better do drop this if and
-     *       capture it with (t->x+t->x)>>1 below? */
-    c->x = t->x;
-    c->y = t->y;
-#ifdef T8_DTRI_TO_DTET
-    c->z = t->z;
-#endif
-  }
-  else {
-    vertex = t8_dtri_beyid_to_vertex[Bey_cid];
-    /* i-th anchor coordinate of child is (X_(0,i)+X_(vertex,i))/2
-     * where X_(i,j) is the j-th coordinate of t's ith node */
-    t8_dtri_compute_coords (t, vertex, t_coordinates);
-    c->x = (t->x + t_coordinates[0]) >> 1;
-    c->y = (t->y + t_coordinates[1]) >> 1;
+  /* The cube-id of the child gives the offset of its anchor node
+   * to t's anchor node in units of the child's length */
+  type = t->type;
+  cid = t8_dtri_parenttype_Iloc_to_cid[type][childid];
+  h = T8_DTRI_LEN (t->level + 1);
+  c->x = t->x + (cid & 1) * h;
+  c->y = t->y + ((cid >> 1) & 1) * h;
 #ifdef T8_DTRI_TO_DTET
-    c->z = (t->z + t_coordinates[2]) >> 1;
+  c->z = t->z + (cid >> 2) * h;
 #endif
-  }
 
   /* Compute type of child */
-  c->type = t8_dtri_type_of_child[t->type][Bey_cid];
+  c->type = t8_dtri_parenttype_Iloc_to_type[type][childid];
 
   c->level = t->level + 1;
 }
@@ -445,36 +306,38 @@ t8_dtri_child (const t8_dtri_t * t, int childid, t8_dtri_t * child)
 void
 t8_dtri_childrenpv (const t8_dtri_t * t, t8_dtri_t * c[T8_DTRI_CHILDREN])
 {
-  t8_dtri_coord_t     t_coordinates[T8_DTRI_FACES][T8_DTRI_DIM];
   const int8_t        level = t->level + 1;
+  const t8_dtri_coord_t h = T8_DTRI_LEN (level);
+  const t8_dtri_coord_t t_x = t->x;
+  const t8_dtri_coord_t t_y = t->y;
+#ifdef T8_DTRI_TO_DTET
+  const t8_dtri_coord_t t_z = t->z;
+#endif
   int                 i;
-  int                 Bey_cid;
-  int                 vertex;
+  t8_dtri_cube_id_t   cid;
   t8_dtri_type_t      t_type = t->type;
 
   T8_ASSERT (t->level < T8_DTRI_MAXLEVEL);
-  t8_dtri_compute_all_coords (t, t_coordinates);
-  /* We use t_coordinates[0] for t->x,y,z to ensure that the function is valid
+  /* We store t's coordinates to ensure that the function is valid
    * if called with t = c[0]. If we would use t->x later it would be the newly
    * computed value c[0]->x. */
-  c[0]->x = t_coordinates[0][0];        /* t->x */
-  c[0]->y = t_coordinates[0][1];        /* t->y */
+  c[0]->x = t_x;
+  c[0]->y = t_y;
 #ifdef T8_DTRI_TO_DTET
-  c[0]->z = t_coordinates[0][2];        /* t->z */
+  c[0]->z = t_z;
 #endif
   c[0]->type = t_type;
   c[0]->level = level;
   for (i = 1; i < T8_DTRI_CHILDREN; i++) {
-    Bey_cid = t8_dtri_index_to_bey_number[t_type][i];
-    vertex = t8_dtri_beyid_to_vertex[Bey_cid];
-    /* i-th anchor coordinate of child is (X_(0,i)+X_(vertex,i))/2
-     * where X_(i,j) is the j-th coordinate of t's ith node */
-    c[i]->x = (t_coordinates[0][0] + t_coordinates[vertex][0]) >> 1;
-    c[i]->y = (t_coordinates[0][1] + t_coordinates[vertex][1]) >> 1;
+    /* The cube-id of the child gives the offset of its anchor node
+     * to t's anchor node in units of the child's length */
+    cid = t8_dtri_parenttype_Iloc_to_cid[t_type][i];
+    c[i]->x = t_x + (cid & 1) * h;
+    c[i]->y = t_y + ((cid >> 1) & 1) * h;
 #ifdef T8_DTRI_TO_DTET
-    c[i]->z = (t_coordinates[0][2] + t_coordinates[vertex][2]) >> 1;
+    c[i]->z = t_z + (cid >> 2) * h;
 #endif
-    c[i]->type = t8_dtri_type_of_child[t_type][Bey_cid];
+    c[i]->type = t8_dtri_parenttype_Iloc_to_type[t_type][i];
     c[i]->level = level;
 #ifdef T8_ENABLE_DEBUG
     {
@@ -536,16 +399,37 @@ t8_dtri_is_familypv (const t8_dtri_t * f[])
 #endif
 
 /* The sibid here is the Morton child id of the parent.
- * TODO: Implement this algorithm directly w/o using
- * parent and child
- * TODO: CB agrees, make this as non-redundant as possible */
+ * We compute the parent's type and then the sibling as a child of the
+ * parent without constructing the parent. */
 void
 t8_dtri_sibling (const t8_dtri_t * elem, int sibid, t8_dtri_t * sibling)
 {
+  t8_dtri_cube_id_t   cid;
+  t8_dtri_type_t      parent_type;
+  t8_dtri_coord_t     h;
+
   T8_ASSERT (0 <= sibid && sibid < T8_DTRI_CHILDREN);
   T8_ASSERT (((const t8_dtri_t *) elem)->level > 0);
-  t8_dtri_parent (elem, sibling);
-  t8_dtri_child (sibling, sibid, sibling);
+
+#ifdef T8_ENABLE_DEBUG
+#ifdef T8_DTRI_TO_DTET
+  sibling->eclass_int8 = elem->eclass_int8;
+#endif
+#endif
+
+  h = T8_DTRI_LEN (elem->level);
+  cid = compute_cubeid (elem, elem->level);
+  parent_type = t8_dtri_cid_type_to_parenttype[cid][elem->type];
+  /* The anchor node of the parent has a zero bit at elem's level,
+   * the sibling's cube-id gives this bit. */
+  cid = t8_dtri_parenttype_Iloc_to_cid[parent_type][sibid];
+  sibling->x = (elem->x & ~h) | ((cid & 1) * h);
+  sibling->y = (elem->y & ~h) | (((cid >> 1) & 1) * h);
+#ifdef T8_DTRI_TO_DTET
+  sibling->z = (elem->z & ~h) | ((cid >> 2) * h);
+#endif
+  sibling->type = t8_dtri_parenttype_Iloc_to_type[parent_type][sibid];
+  sibling->level = elem->level;
 }
 
 /* Saves the neighbour of T along face "face" in N
@@ -554,75 +438,23 @@ int
 t8_dtri_face_neighbour (const t8_dtri_t * t, int face, t8_dtri_t * n)
 {
   /* TODO: document what happens if outside of root tet */
-  int                 type_new, type_old;
-#ifdef T8_DTRI_TO_DTET
-  int                 sign;
-#endif
-  int                 ret = -1;
-  int8_t              level;
-  t8_dtri_coord_t     coords[3];
+  const int          *offset;
+  t8_dtri_type_t      type;
+  t8_dtri_coord_t     h;
 
   T8_ASSERT (0 <= face && face < T8_DTRI_FACES);
 
-  level = t->level;
-  type_old = t->type;
-  type_new = type_old;
-  coords[0] = t->x;
-  coords[1] = t->y;
-#ifdef T8_DTRI_TO_DTET
-  coords[2] = t->z;
-#endif
-
-#ifndef T8_DTRI_TO_DTET
-  /* 2D */
-  ret = 2 - face;
-  type_new = 1 - type_old;
-  if (face == 0) {
-    coords[type_old] += T8_DTRI_LEN (level);
-  }
-  else if (face == 2) {
-    coords[1 - type_old] -= T8_DTRI_LEN (level);
-  }
-  /* 2D end */
-#else
-  /* 3D */
-  type_new += 6;                /* We want to compute modulo six and dont want negative numbers */
-  if (face == 1 || face == 2) {
-    sign = (type_new % 2 == 0 ? 1 : -1);
-    sign *= (face % 2 == 0 ? 1 : -1);
-    type_new += sign;
-    type_new %= 6;
-    ret = face;
-  }
-  else {
-    if (face == 0) {
-      /* type: 0,1 --> x+1
-       *       2,3 --> y+1
-       *       4,5 --> z+1 */
-      coords[type_old / 2] += T8_DTRI_LEN (level);
-      type_new += (type_new % 2 == 0 ? 4 : 2);
-    }
-    else {                      /* face == 3 */
-
-      /* type: 1,2 --> z-1
-       *       3,4 --> x-1
-       *       5,0 --> y-1 */
-      coords[((type_new + 3) % 6) / 2] -= T8_DTRI_LEN (level);
-      type_new += (type_new % 2 == 0 ? 2 : 4);
-    }
-    type_new %= 6;
-    ret = 3 - face;
-  }
-  /* 3D end */
-#endif
-  n->x = coords[0];
-  n->y = coords[1];
+  h = T8_DTRI_LEN (t->level);
+  type = t->type;
+  offset = t8_dtri_type_face_to_nb_offset[type][face];
+  n->x = t->x + offset[0] * h;
+  n->y = t->y + offset[1] * h;
 #ifdef T8_DTRI_TO_DTET
-  n->z = coords[2];
+  n->z = t->z + offset[2] * h;
 #endif
-  n->level = level;
-  n->type = type_new;
-  return ret;
+  n->level = t->level;
+  n->type = t8_dtri_type_face_to_nb_type[type][face];
+  return t8_dtri_face_to_nb_face[face];
 }
 
 void
@@ -1400,65 +1232,70 @@ t8_dtri_init_root (t8_dtri_t * t)
 #endif
 }
 
-/* Stores in s the triangle that is obtained from t by going 'increment' positions
+/* Stores in s the triangle that is obtained from t by going one position
+ * forward (increment = 1) or backward (increment = -1)
  * along the SFC of a uniform refinement of level 'level'.
- * 'increment' must be greater than -4 (-8) and smaller than +4 (+8).
+ * We search the finest ancestor whose local index does not wrap around,
+ * increment its local index and take the first (resp. last) children
+ * of the levels below.
  * Before calling this function s should store the same entries as t. */
 static void
-t8_dtri_succ_pred_recursion (const t8_dtri_t * t, t8_dtri_t * s, int level,
-                             int increment)
+t8_dtri_succ_pred (const t8_dtri_t * t, t8_dtri_t * s, int level,
+                   int increment)
 {
-  t8_dtri_type_t      type_level, type_level_p1;
+  t8_dtri_type_t      type_level, parent_type;
   t8_dtri_cube_id_t   cid;
-  int                 local_index;
-  int                 sign;
+  t8_dtri_coord_t     bit;
+  int                 local_index, wrap_index, desc_index;
+  int                 ilevel;
 
   /* We exclude the case level = 0, because the root triangle does
    * not have a successor. */
   T8_ASSERT (1 <= level && level <= t->level);
-  T8_ASSERT (-T8_DTRI_CHILDREN < increment && increment < T8_DTRI_CHILDREN);
+  T8_ASSERT (increment == 1 || increment == -1);
 
-  if (increment == 0) {
-    t8_dtri_copy (t, s);
-    return;
-  }
-  cid = compute_cubeid (t, level);
+  /* The local index at which a step leaves the parent and the local
+   * index of the descendants of the new ancestor */
+  wrap_index = increment > 0 ? T8_DTRI_CHILDREN - 1 : 0;
+  desc_index = T8_DTRI_CHILDREN - 1 - wrap_index;
+
+  /* Find the finest ancestor that does not wrap around */
+  ilevel = level;
   type_level = compute_type (t, level);
+  cid = compute_cubeid (t, ilevel);
+  parent_type = t8_dtri_cid_type_to_parenttype[cid][type_level];
   local_index = t8_dtri_type_cid_to_Iloc[type_level][cid];
-  local_index =
-    (local_index + T8_DTRI_CHILDREN + increment) % T8_DTRI_CHILDREN;
-  if (local_index == 0) {
-    sign = increment < 0 ? -1 : increment > 0;
-    t8_dtri_succ_pred_recursion (t, s, level - 1, sign);
-    type_level_p1 = s->type;    /* We stored the type of s at level-1 in s->type */
-  }
-  else {
-    type_level_p1 = t8_dtri_cid_type_to_parenttype[cid][type_level];
-  }
-  type_level = t8_dtri_parenttype_Iloc_to_type[type_level_p1][local_index];
-  cid = t8_dtri_parenttype_Iloc_to_cid[type_level_p1][local_index];
-  s->type = type_level;
-  s->level = level;
-  /* Set the x,y(,z) coordinates at level to the cube-id. */
-  /* TODO: check if we set the correct bits here! */
-  s->x =
-    (cid & 1 ? s->x | 1 << (T8_DTRI_MAXLEVEL - level) :
-     s->x & ~(1 << (T8_DTRI_MAXLEVEL - level)));
-  s->y =
-    (cid & 2 ? s->y | 1 << (T8_DTRI_MAXLEVEL - level) :
-     s->y & ~(1 << (T8_DTRI_MAXLEVEL - level)));
+  while (local_index == wrap_index) {
+    ilevel--;
+    T8_ASSERT (ilevel > 0);
+    type_level = parent_type;
+    cid = compute_cubeid (t, ilevel);
+    parent_type = t8_dtri_cid_type_to_parenttype[cid][type_level];
+    local_index = t8_dtri_type_cid_to_Iloc[type_level][cid];
+  }
+  local_index += increment;
+
+  /* Set the type and the coordinate bits from this ancestor down to level */
+  for (; ilevel <= level; ilevel++) {
+    cid = t8_dtri_parenttype_Iloc_to_cid[parent_type][local_index];
+    parent_type = t8_dtri_parenttype_Iloc_to_type[parent_type][local_index];
+    bit = 1 << (T8_DTRI_MAXLEVEL - ilevel);
+    s->x = (s->x & ~bit) | ((cid & 1) * bit);
+    s->y = (s->y & ~bit) | (((cid >> 1) & 1) * bit);
 #ifdef T8_DTRI_TO_DTET
-  s->z =
-    (cid & 4 ? s->z | 1 << (T8_DTRI_MAXLEVEL - level) :
-     s->z & ~(1 << (T8_DTRI_MAXLEVEL - level)));
+    s->z = (s->z & ~bit) | ((cid >> 2) * bit);
 #endif
+    local_index = desc_index;
+  }
+  s->type = parent_type;
+  s->level = level;
 }
 
 void
 t8_dtri_successor (const t8_dtri_t * t, t8_dtri_t * s, int level)
 {
   t8_dtri_copy (t, s);
-  t8_dtri_succ_pred_recursion (t, s, level, 1);
+  t8_dtri_succ_pred (t, s, level, 1);
 }
 
 void
@@ -1520,7 +1357,7 @@ void
 t8_dtri_predecessor (const t8_dtri_t * t, t8_dtri_t * s, int level)
 {
   t8_dtri_copy (t, s);
-  t8_dtri_succ_pred_recursion (t, s, level, -1);
+  t8_dtri_succ_pred (t, s, level, -1);
 }
 
 int
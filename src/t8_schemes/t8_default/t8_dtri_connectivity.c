@@ -98,3 +98,28 @@ const int           t8_dtri_corner_face[3][2] = {
   {0, 2},
   {0, 1}
 };
+
+/* Line b, row v gives the offset of vertex v of a triangle
+ * of type b to its anchor node in units of the triangle's length */
+const int           t8_dtri_type_vertex_to_offset[2][3][2] = {
+  {{0, 0}, {1, 0}, {1, 1}},
+  {{0, 0}, {0, 1}, {1, 1}}
+};
+
+/* Line b, row f gives the type of the face neighbor of
+ * a triangle of type b across face f */
+const int           t8_dtri_type_face_to_nb_type[2][3] = {
+  {1, 1, 1},
+  {0, 0, 0}
+};
+
+/* Line b, row f gives the offset of the anchor node of the
+ * face neighbor of a triangle of type b across face f
+ * in units of the triangle's length */
+const int           t8_dtri_type_face_to_nb_offset[2][3][2] = {
+  {{1, 0}, {0, 0}, {0, -1}},
+  {{0, 1}, {0, 0}, {-1, 0}}
+};
+
+/* The face number of the face neighbor across face f */
+const int           t8_dtri_face_to_nb_face[3] = { 2, 1, 0 };
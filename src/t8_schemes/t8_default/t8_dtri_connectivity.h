@@ -74,6 +74,19 @@ extern const int    t8_dtri_face_corner[3][2];
 /** Store the indices of the faces of each corner of a triangle. */
 extern const int    t8_dtri_corner_face[3][2];
 
+/** Store the offset of each vertex to the anchor node for each type. */
+extern const int    t8_dtri_type_vertex_to_offset[2][3][2];
+
+/** Store the type of the face neighbor for each (type,face) combination. */
+extern const int    t8_dtri_type_face_to_nb_type[2][3];
+
+/** Store the offset of the face neighbor's anchor node for each
+ * (type,face) combination. */
+extern const int    t8_dtri_type_face_to_nb_offset[2][3][2];
+
+/** Store the face number of the face neighbor for each face. */
+extern const int    t8_dtri_face_to_nb_face[3];
+
 T8_EXTERN_C_END ();
 
 #endif /* T8_DTRI_CONNECTIVITY_H */
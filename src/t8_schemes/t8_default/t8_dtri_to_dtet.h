@@ -63,6 +63,10 @@ T8_EXTERN_C_BEGIN ();
 #define t8_dtri_parenttype_Iloc_to_cid t8_dtet_parenttype_Iloc_to_cid
 #define t8_dtri_type_cid_to_Iloc t8_dtet_type_cid_to_Iloc
 #define t8_dtri_face_corner t8_dtet_face_corner
+#define t8_dtri_type_vertex_to_offset t8_dtet_type_vertex_to_offset
+#define t8_dtri_type_face_to_nb_type t8_dtet_type_face_to_nb_type
+#define t8_dtri_type_face_to_nb_offset t8_dtet_type_face_to_nb_offset
+#define t8_dtri_face_to_nb_face t8_dtet_face_to_nb_face
 
 /* functions in d8_dtri_bits.h */
 #define t8_dtri_is_equal t8_dtet_is_equal
@@ -36,6 +36,13 @@ T8_EXTERN_C_BEGIN ();
 /** Return the default element implementation of t8code. */
 t8_scheme_cxx_t    *t8_scheme_new_default_cxx (void);
 
+/** Return the default element implementation of t8code with anisotropic
+ * quadrilaterals and hexahedra.
+ * These elements may be refined along selected coordinate axes,
+ * see \ref T8_ADAPT_REFINE_AXES.
+ */
+t8_scheme_cxx_t    *t8_scheme_new_anisotropic_cxx (void);
+
 /** Check whether a given eclass_scheme is on of the default schemes.
  * \param [in] ts   A (pointer to a) scheme
  * \return          True (non-zero) if \a ts is one of the default schemes,
@@ -23,22 +23,29 @@
 #include <t8_vtk.h>
 
 /* Writes the pvtu header file that links to the processor local files.
+ * If data_at_nodes is true, the user data fields are only point data
+ * and carry their description as name. Otherwise they are written as
+ * cell data and additionally as point data with the suffix "_points".
  * This function should only be called by one process.
  * Return 0 on success. */
-int
-t8_write_pvtu (const char *filename, int num_procs, int write_tree,
-               int write_rank, int write_level, int write_id, int num_data,
-               t8_vtk_data_field_t * data)
+static int
+t8_write_pvtu_internal (const char *filename, int num_procs, int write_tree,
+                        int write_rank, int write_level, int write_id,
+                        int num_data, t8_vtk_data_field_t * data,
+                        int data_at_nodes)
 {
   char                pvtufilename[BUFSIZ], filename_cpy[BUFSIZ];
   FILE               *pvtufile;
   int                 p, idata, num_scalars = 0;
+  int                 num_cell_data;
   int                 write_cell_data, wrote_cell_data = 0;
   int                 printed = 0;
   int                 sreturn;
 
+  /* The number of user data fields that are also written as cell data */
+  num_cell_data = data_at_nodes ? 0 : num_data;
   write_cell_data = write_tree || write_rank || write_level || write_id
-    || num_data > 0;
+    || num_cell_data > 0;
 
   sreturn = snprintf (pvtufilename, BUFSIZ, "%s.pvtu", filename);
 
@@ -79,8 +86,8 @@ t8_write_pvtu (const char *filename, int num_procs, int write_tree,
     for (idata = 0; idata < num_data && data[idata].type == T8_VTK_SCALAR;
          idata++) {
       sreturn =
-        snprintf (description, BUFSIZ, "%s_%s", data[idata].description,
-                  "points");
+        snprintf (description, BUFSIZ, "%s%s", data[idata].description,
+                  data_at_nodes ? "" : "_points");
 
       if (sreturn >= BUFSIZ) {
         /* The output was truncated */
@@ -103,8 +110,8 @@ t8_write_pvtu (const char *filename, int num_procs, int write_tree,
                         "vtk data missmatch. After scalar fields only vector"
                         " fields are allowed.");
         sreturn =
-          snprintf (description, BUFSIZ, "%s_%s", data[idata].description,
-                    "points");
+          snprintf (description, BUFSIZ, "%s%s", data[idata].description,
+                    data_at_nodes ? "" : "_points");
 
         if (sreturn >= BUFSIZ) {
           /* The output was truncated */
@@ -133,8 +140,8 @@ t8_write_pvtu (const char *filename, int num_procs, int write_tree,
       /* Write data fields */
       for (idata = 0; idata < num_scalars; idata++) {
         sreturn =
-          snprintf (description, BUFSIZ, "%s_%s", data[idata].description,
-                    "points");
+          snprintf (description, BUFSIZ, "%s%s", data[idata].description,
+                    data_at_nodes ? "" : "_points");
 
         if (sreturn >= BUFSIZ) {
           /* The output was truncated */
@@ -155,8 +162,8 @@ t8_write_pvtu (const char *filename, int num_procs, int write_tree,
       for (idata = num_scalars; idata < num_data; idata++) {
         T8_ASSERT (data[idata].type == T8_VTK_VECTOR);
         sreturn =
-          snprintf (description, BUFSIZ, "%s_%s", data[idata].description,
-                    "points");
+          snprintf (description, BUFSIZ, "%s%s", data[idata].description,
+                    data_at_nodes ? "" : "_points");
 
         if (sreturn >= BUFSIZ) {
           /* The output was truncated */
@@ -176,8 +183,9 @@ t8_write_pvtu (const char *filename, int num_procs, int write_tree,
       fprintf (pvtufile, "    </PPointData>\n");
     }
   }
-  /* reset counter */
+  /* reset counters */
   printed = 0;
+  num_scalars = 0;
   if (write_cell_data) {
     char                vtkCellDataString[BUFSIZ] = "";
     char                vtkCellVectorString[BUFSIZ] = "";
@@ -201,7 +209,7 @@ t8_write_pvtu (const char *filename, int num_procs, int write_tree,
         snprintf (vtkCellDataString + printed, BUFSIZ - printed, "%s%s",
                   printed > 0 ? "," : "", "element_id");
     }
-    for (idata = 0; idata < num_data && data[idata].type == T8_VTK_SCALAR;
+    for (idata = 0; idata < num_cell_data && data[idata].type == T8_VTK_SCALAR;
          idata++) {
       printed +=
         snprintf (vtkCellDataString + printed, BUFSIZ - printed, "%s%s",
@@ -209,9 +217,9 @@ t8_write_pvtu (const char *filename, int num_procs, int write_tree,
     }
     num_scalars = idata;
     /* Write Vector fields in data */
-    if (num_scalars < num_data) {
+    if (num_scalars < num_cell_data) {
       printed = 0;
-      for (idata = num_scalars; idata < num_data; idata++) {
+      for (idata = num_scalars; idata < num_cell_data; idata++) {
         SC_CHECK_ABORT (data[idata].type == T8_VTK_VECTOR,
                         "vtk data missmatch. After scalar fields only vector"
                         " fields are allowed.");
@@ -222,7 +230,7 @@ t8_write_pvtu (const char *filename, int num_procs, int write_tree,
     }
     if (strcmp (vtkCellDataString, "")) {
       fprintf (pvtufile, "    <PCellData Scalars=\"%s\"", vtkCellDataString);
-      if (num_scalars < num_data) {
+      if (num_scalars < num_cell_data) {
         /* Add Vector strings */
         fprintf (pvtufile, " Vectors=\"%s\">\n", vtkCellVectorString);
       }
@@ -261,7 +269,7 @@ t8_write_pvtu (const char *filename, int num_procs, int write_tree,
   }
 
   /* Write vector data fields */
-  for (idata = num_scalars; idata < num_data; idata++) {
+  for (idata = num_scalars; idata < num_cell_data; idata++) {
     T8_ASSERT (data[idata].type == T8_VTK_VECTOR);
     fprintf (pvtufile, "      "
              "<PDataArray type=\"%s\" Name=\"%s\" NumberOfComponents=\"3\" "
@@ -300,3 +308,21 @@ t8_write_pvtu (const char *filename, int num_procs, int write_tree,
   }
   return 0;
 }
+
+int
+t8_write_pvtu (const char *filename, int num_procs, int write_tree,
+               int write_rank, int write_level, int write_id, int num_data,
+               t8_vtk_data_field_t * data)
+{
+  return t8_write_pvtu_internal (filename, num_procs, write_tree, write_rank,
+                                 write_level, write_id, num_data, data, 0);
+}
+
+int
+t8_write_pvtu_nodal (const char *filename, int num_procs, int write_tree,
+                     int write_rank, int write_level, int write_id,
+                     int num_data, t8_vtk_data_field_t * data)
+{
+  return t8_write_pvtu_internal (filename, num_procs, write_tree, write_rank,
+                                 write_level, write_id, num_data, data, 1);
+}
@@ -85,6 +85,17 @@ int                 t8_write_pvtu (const char *filename, int num_procs,
                                    int write_level, int write_id,
                                    int num_data, t8_vtk_data_field_t * data);
 
+/* Writes the pvtu header file for output in which the user defined data
+ * fields are given at the nodes of the cells, such as the nodal values of
+ * high order Lagrange cells. The data fields are only declared as point data.
+ * This function should only be called by one process.
+ * Return 0 on success. */
+int                 t8_write_pvtu_nodal (const char *filename,
+                                         int num_procs, int write_tree,
+                                         int write_rank, int write_level,
+                                         int write_id, int num_data,
+                                         t8_vtk_data_field_t * data);
+
 T8_EXTERN_C_END ();
 
 #endif /* !T8_VTK_H */
@@ -0,0 +1,191 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+/* In this test we coarsen forests whose families are split across
+ * processes and check that the result does not depend on the partition.
+ * We adapt a replicated forest on each process and compare it to the same
+ * forest partitioned on all processes and adapted with
+ * t8_forest_set_adapt_split_families.
+ */
+
+#include <t8_schemes/t8_default_cxx.hxx>
+#include <t8_cmesh.h>
+#include <t8_forest.h>
+
+/* Refine the first element of the first tree once */
+static int
+t8_test_split_refine_first (t8_forest_t forest, t8_forest_t forest_from,
+                            t8_locidx_t which_tree, t8_locidx_t lelement_id,
+                            t8_eclass_scheme_c * ts, int num_elements,
+                            t8_element_t * elements[])
+{
+  const int           level = ts->t8_element_level (elements[0]);
+
+  return t8_forest_global_tree_id (forest_from, which_tree) == 0
+    && ts->t8_element_get_linear_id (elements[0], level) == 0
+    && level == *(int *) t8_forest_get_user_data (forest);
+}
+
+/* Coarsen all families of the level given as user data.
+ * A single element votes for coarsening its family. */
+static int
+t8_test_split_coarsen (t8_forest_t forest, t8_forest_t forest_from,
+                       t8_locidx_t which_tree, t8_locidx_t lelement_id,
+                       t8_eclass_scheme_c * ts, int num_elements,
+                       t8_element_t * elements[])
+{
+  if (ts->t8_element_level (elements[0]) ==
+      *(int *) t8_forest_get_user_data (forest)) {
+    return -1;
+  }
+  return 0;
+}
+
+/* Count the global number of elements of each level up to maxlevel */
+static void
+t8_test_split_level_count (t8_forest_t forest, int maxlevel,
+                           t8_gloidx_t * count)
+{
+  t8_locidx_t         itree, ielement;
+  t8_eclass_scheme_c *ts;
+  int                 level, mpiret;
+  t8_gloidx_t        *local_count;
+
+  local_count = T8_ALLOC_ZERO (t8_gloidx_t, maxlevel + 1);
+  for (itree = 0; itree < t8_forest_get_num_local_trees (forest); itree++) {
+    ts = t8_forest_get_eclass_scheme (forest,
+                                      t8_forest_get_tree_class (forest,
+                                                                itree));
+    for (ielement = 0;
+         ielement < t8_forest_get_tree_num_elements (forest, itree);
+         ielement++) {
+      level = ts->t8_element_level (t8_forest_get_element_in_tree
+                                    (forest, itree, ielement));
+      SC_CHECK_ABORT (level <= maxlevel, "Element level too large");
+      local_count[level]++;
+    }
+  }
+  mpiret = sc_MPI_Allreduce (local_count, count, maxlevel + 1, T8_MPI_GLOIDX,
+                             sc_MPI_SUM, t8_forest_get_mpicomm (forest));
+  SC_CHECK_MPI (mpiret);
+  T8_FREE (local_count);
+}
+
+/* Create a uniform forest, optionally refine its first element and
+ * coarsen all families of the uniform level. */
+static              t8_forest_t
+t8_test_split_forest (t8_eclass_t eclass, int level, int refine_first,
+                      sc_MPI_Comm comm)
+{
+  t8_forest_t         forest, forest_adapt;
+  t8_cmesh_t          cmesh;
+
+  cmesh = t8_cmesh_new_hypercube (eclass, comm, 0, 0, 0);
+  forest = t8_forest_new_uniform (cmesh, t8_scheme_new_default_cxx (), level,
+                                  0, comm);
+  if (refine_first) {
+    /* Refine and repartition, such that the process boundaries are not
+     * aligned with the families anymore */
+    t8_forest_init (&forest_adapt);
+    t8_forest_set_user_data (forest_adapt, &level);
+    t8_forest_set_adapt (forest_adapt, forest, t8_test_split_refine_first,
+                         0);
+    t8_forest_set_partition (forest_adapt, NULL, 0);
+    t8_forest_commit (forest_adapt);
+    forest = forest_adapt;
+  }
+  t8_forest_init (&forest_adapt);
+  t8_forest_set_user_data (forest_adapt, &level);
+  t8_forest_set_adapt (forest_adapt, forest, t8_test_split_coarsen, 0);
+  t8_forest_set_adapt_split_families (forest_adapt, 1);
+  t8_forest_commit (forest_adapt);
+  return forest_adapt;
+}
+
+static void
+t8_test_split_families (t8_eclass_t eclass, int level, int refine_first)
+{
+  t8_forest_t         forest, forest_serial, forest_partition;
+  t8_gloidx_t         count[4], count_serial[4];
+  int                 ilevel;
+
+  t8_global_productionf ("Testing split families for %s level %i%s\n",
+                         t8_eclass_to_string[eclass], level,
+                         refine_first ? " with refinement" : "");
+  T8_ASSERT (level + 1 < 4);
+
+  /* The reference forest is not partitioned and has no split families */
+  forest_serial = t8_test_split_forest (eclass, level, refine_first,
+                                        sc_MPI_COMM_SELF);
+  t8_test_split_level_count (forest_serial, level + 1, count_serial);
+  forest = t8_test_split_forest (eclass, level, refine_first,
+                                 sc_MPI_COMM_WORLD);
+  t8_test_split_level_count (forest, level + 1, count);
+  for (ilevel = 0; ilevel <= level + 1; ilevel++) {
+    SC_CHECK_ABORTF (count[ilevel] == count_serial[ilevel],
+                     "Wrong number of elements of level %i: %lli instead of %lli",
+                     ilevel, (long long) count[ilevel],
+                     (long long) count_serial[ilevel]);
+  }
+  SC_CHECK_ABORT (t8_forest_get_global_num_elements (forest) ==
+                  t8_forest_get_global_num_elements (forest_serial),
+                  "Wrong global number of elements");
+
+  /* The coarsened forest must be a valid forest that we can repartition */
+  t8_forest_init (&forest_partition);
+  t8_forest_set_partition (forest_partition, forest, 0);
+  t8_forest_commit (forest_partition);
+  SC_CHECK_ABORT (t8_forest_get_global_num_elements (forest_partition) ==
+                  t8_forest_get_global_num_elements (forest_serial),
+                  "Wrong number of elements after partition");
+
+  t8_forest_unref (&forest_partition);
+  t8_forest_unref (&forest_serial);
+}
+
+int
+main (int argc, char **argv)
+{
+  int                 mpiret;
+  int                 eclass, level, refine_first;
+
+  mpiret = sc_MPI_Init (&argc, &argv);
+  SC_CHECK_MPI (mpiret);
+
+  sc_init (sc_MPI_COMM_WORLD, 1, 1, NULL, SC_LP_ESSENTIAL);
+  t8_init (SC_LP_DEFAULT);
+
+  for (eclass = T8_ECLASS_LINE; eclass < T8_ECLASS_PYRAMID; eclass++) {
+    for (level = 1; level <= 2; level++) {
+      for (refine_first = 0; refine_first <= 1; refine_first++) {
+        t8_test_split_families ((t8_eclass_t) eclass, level, refine_first);
+      }
+    }
+  }
+
+  sc_finalize ();
+
+  mpiret = sc_MPI_Finalize ();
+  SC_CHECK_MPI (mpiret);
+
+  return 0;
+}
@@ -0,0 +1,157 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+/* In this test we adapt forests to target levels in one pass and compare
+ * the result with a recursive adaptation that reaches the same levels.
+ */
+
+#include <t8_schemes/t8_default_cxx.hxx>
+#include <t8_cmesh.h>
+#include <t8_forest.h>
+
+/* The target level of the descendants of each child of the root */
+static const int    t8_test_target_levels[8] = { 1, 5, 3, 2, 4, 1, 4, 3 };
+
+/* Compute the target level of an element from its ancestor at level 1 */
+static int
+t8_test_target_level (t8_eclass_scheme_c * ts, const t8_element_t * element)
+{
+  t8_element_t       *ancestor;
+  int                 target;
+
+  T8_ASSERT (ts->t8_element_level (element) >= 1);
+  ts->t8_element_new (1, &ancestor);
+  ts->t8_element_copy (element, ancestor);
+  while (ts->t8_element_level (ancestor) > 1) {
+    ts->t8_element_parent (element, ancestor);
+    element = ancestor;
+  }
+  target = t8_test_target_levels[ts->t8_element_child_id (ancestor)];
+  ts->t8_element_destroy (1, &ancestor);
+  return target;
+}
+
+static int
+t8_test_target_fn (t8_forest_t forest, t8_forest_t forest_from,
+                   t8_locidx_t which_tree, t8_locidx_t lelement_id,
+                   t8_eclass_scheme_c * ts, const t8_element_t * element)
+{
+  return t8_test_target_level (ts, element);
+}
+
+/* Refine and coarsen recursively towards the target levels */
+static int
+t8_test_target_adapt (t8_forest_t forest, t8_forest_t forest_from,
+                      t8_locidx_t which_tree, t8_locidx_t lelement_id,
+                      t8_eclass_scheme_c * ts, int num_elements,
+                      t8_element_t * elements[])
+{
+  const int           level = ts->t8_element_level (elements[0]);
+  const int           target = t8_test_target_level (ts, elements[0]);
+
+  if (level < target) {
+    return 1;
+  }
+  return num_elements > 1 && level > target ? -1 : 0;
+}
+
+static void
+t8_test_adapt_target (t8_eclass_t eclass, int level)
+{
+  t8_cmesh_t          cmesh;
+  t8_forest_t         forest, forest_target, forest_levels, forest_adapt;
+  t8_eclass_scheme_c *ts;
+  t8_locidx_t         itree, ielem, num_elements;
+  int                *levels;
+
+  t8_global_productionf ("Testing target level adaptation for %s level %i\n",
+                         t8_eclass_to_string[eclass], level);
+  cmesh = t8_cmesh_new_hypercube (eclass, sc_MPI_COMM_WORLD, 0, 0, 0);
+  forest = t8_forest_new_uniform (cmesh, t8_scheme_new_default_cxx (),
+                                  level, 0, sc_MPI_COMM_WORLD);
+
+  /* Adapt with the callback */
+  t8_forest_ref (forest);
+  t8_forest_init (&forest_target);
+  t8_forest_set_adapt_target (forest_target, forest, t8_test_target_fn,
+                              NULL);
+  t8_forest_commit (forest_target);
+
+  /* Adapt with precomputed target levels */
+  num_elements = t8_forest_get_local_num_elements (forest);
+  levels = T8_ALLOC (int, num_elements);
+  for (itree = 0; itree < t8_forest_get_num_local_trees (forest); itree++) {
+    ts = t8_forest_get_eclass_scheme (forest,
+                                      t8_forest_get_tree_class (forest,
+                                                                itree));
+    for (ielem = 0; ielem < t8_forest_get_tree_num_elements (forest, itree);
+         ielem++) {
+      levels[t8_forest_get_tree_element_offset (forest, itree) + ielem] =
+        t8_test_target_level (ts,
+                              t8_forest_get_element_in_tree (forest, itree,
+                                                             ielem));
+    }
+  }
+  t8_forest_ref (forest);
+  t8_forest_init (&forest_levels);
+  t8_forest_set_adapt_target (forest_levels, forest, NULL, levels);
+  t8_forest_commit (forest_levels);
+  T8_FREE (levels);
+
+  /* Adapt recursively */
+  t8_forest_init (&forest_adapt);
+  t8_forest_set_adapt (forest_adapt, forest, t8_test_target_adapt, 1);
+  t8_forest_commit (forest_adapt);
+
+  SC_CHECK_ABORT (t8_forest_is_equal (forest_target, forest_adapt),
+                  "Target level adaptation with callback differs");
+  SC_CHECK_ABORT (t8_forest_is_equal (forest_levels, forest_adapt),
+                  "Target level adaptation with array differs");
+  t8_forest_unref (&forest_target);
+  t8_forest_unref (&forest_levels);
+  t8_forest_unref (&forest_adapt);
+}
+
+int
+main (int argc, char **argv)
+{
+  int                 mpiret;
+  int                 eclass;
+
+  mpiret = sc_MPI_Init (&argc, &argv);
+  SC_CHECK_MPI (mpiret);
+
+  sc_init (sc_MPI_COMM_WORLD, 1, 1, NULL, SC_LP_ESSENTIAL);
+  t8_init (SC_LP_DEFAULT);
+
+  for (eclass = T8_ECLASS_LINE; eclass < T8_ECLASS_PYRAMID; eclass++) {
+    t8_test_adapt_target ((t8_eclass_t) eclass,
+                          t8_eclass_to_dimension[eclass] == 3 ? 2 : 3);
+  }
+
+  sc_finalize ();
+
+  mpiret = sc_MPI_Finalize ();
+  SC_CHECK_MPI (mpiret);
+
+  return 0;
+}
@@ -0,0 +1,226 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+/* In this test we compute the face adjacency graph of uniform and adapted
+ * forests and check that it is symmetric and, for uniform hypercubes,
+ * that it has the expected number of entries and face areas.
+ */
+
+#include <t8_schemes/t8_default_cxx.hxx>
+#include <t8_cmesh.h>
+#include <t8_forest.h>
+#include <t8_forest_adjacency.h>
+
+/* Refine the first element of each tree up to the level given as user data */
+static int
+t8_test_csr_adapt (t8_forest_t forest, t8_forest_t forest_from,
+                   t8_locidx_t which_tree, t8_locidx_t lelement_id,
+                   t8_eclass_scheme_c * ts, int num_elements,
+                   t8_element_t * elements[])
+{
+  const int           level = ts->t8_element_level (elements[0]);
+
+  return ts->t8_element_get_linear_id (elements[0], level) == 0
+    && level < *(int *) t8_forest_get_user_data (forest);
+}
+
+/* Gather the complete graph on all processes and check that it is
+ * symmetric, also in the weights. */
+static void
+t8_test_csr_check_symmetric (t8_forest_t forest, t8_forest_csr_t * csr)
+{
+  sc_MPI_Comm         comm = t8_forest_get_mpicomm (forest);
+  t8_gloidx_t         num_rows, row, col, *local_edges, *edges;
+  double             *all_weights;
+  int                *counts, *displs, *weight_counts, *weight_displs;
+  int                 mpisize, mpirank, irank, num_local_edges, num_edges;
+  int                 iedge, jedge, found, mpiret;
+  t8_locidx_t         irow, ientry;
+
+  mpiret = sc_MPI_Comm_size (comm, &mpisize);
+  SC_CHECK_MPI (mpiret);
+  mpiret = sc_MPI_Comm_rank (comm, &mpirank);
+  SC_CHECK_MPI (mpiret);
+  num_rows = csr->row_distribution[mpisize];
+  SC_CHECK_ABORT (num_rows == t8_forest_get_global_num_elements (forest),
+                  "Wrong row distribution");
+  num_local_edges = csr->row_offsets[csr->num_rows];
+  local_edges = T8_ALLOC (t8_gloidx_t, 2 * num_local_edges);
+  for (irow = 0; irow < csr->num_rows; irow++) {
+    for (ientry = csr->row_offsets[irow]; ientry < csr->row_offsets[irow + 1];
+         ientry++) {
+      local_edges[2 * ientry] = csr->row_distribution[mpirank] + irow;
+      local_edges[2 * ientry + 1] = csr->columns[ientry];
+      SC_CHECK_ABORT (0 <= csr->columns[ientry]
+                      && csr->columns[ientry] < num_rows,
+                      "Column out of range");
+      SC_CHECK_ABORT (ientry == csr->row_offsets[irow]
+                      || csr->columns[ientry - 1] < csr->columns[ientry],
+                      "Columns not sorted");
+    }
+  }
+  counts = T8_ALLOC (int, mpisize);
+  displs = T8_ALLOC (int, mpisize);
+  weight_counts = T8_ALLOC (int, mpisize);
+  weight_displs = T8_ALLOC (int, mpisize);
+  mpiret = sc_MPI_Allgather (&num_local_edges, 1, sc_MPI_INT, weight_counts,
+                             1, sc_MPI_INT, comm);
+  SC_CHECK_MPI (mpiret);
+  num_edges = 0;
+  for (irank = 0; irank < mpisize; irank++) {
+    weight_displs[irank] = num_edges;
+    counts[irank] = 2 * weight_counts[irank];
+    displs[irank] = 2 * num_edges;
+    num_edges += weight_counts[irank];
+  }
+  edges = T8_ALLOC (t8_gloidx_t, 2 * num_edges);
+  all_weights = T8_ALLOC (double, num_edges);
+  mpiret = sc_MPI_Allgatherv (local_edges, 2 * num_local_edges, T8_MPI_GLOIDX,
+                              edges, counts, displs, T8_MPI_GLOIDX, comm);
+  SC_CHECK_MPI (mpiret);
+  mpiret = sc_MPI_Allgatherv (csr->weights, num_local_edges, sc_MPI_DOUBLE,
+                              all_weights, weight_counts, weight_displs,
+                              sc_MPI_DOUBLE, comm);
+  SC_CHECK_MPI (mpiret);
+  for (iedge = 0; iedge < num_edges; iedge++) {
+    row = edges[2 * iedge];
+    col = edges[2 * iedge + 1];
+    SC_CHECK_ABORT (row != col, "An element is its own neighbor");
+    for (jedge = 0, found = 0; jedge < num_edges && !found; jedge++) {
+      found = edges[2 * jedge] == col && edges[2 * jedge + 1] == row
+        && fabs (all_weights[iedge] - all_weights[jedge]) < 1e-12;
+    }
+    SC_CHECK_ABORTF (found, "The graph is not symmetric at (%lli, %lli)",
+                     (long long) row, (long long) col);
+  }
+  T8_FREE (local_edges);
+  T8_FREE (edges);
+  T8_FREE (all_weights);
+  T8_FREE (counts);
+  T8_FREE (displs);
+  T8_FREE (weight_counts);
+  T8_FREE (weight_displs);
+}
+
+/* For a uniform forest of the unit square or cube, check the number of
+ * entries and the sum of the face areas. */
+static void
+t8_test_csr_check_uniform (t8_forest_t forest, t8_forest_csr_t * csr,
+                           int dim, int level)
+{
+  t8_gloidx_t         local_count, count, expected_count;
+  double              local_area, area, expected_area;
+  t8_locidx_t         ientry;
+  int                 mpiret;
+  const t8_gloidx_t   n = (t8_gloidx_t) 1 << level;
+
+  local_count = csr->row_offsets[csr->num_rows];
+  local_area = 0;
+  for (ientry = 0; ientry < local_count; ientry++) {
+    local_area += csr->weights[ientry];
+  }
+  mpiret = sc_MPI_Allreduce (&local_count, &count, 1, T8_MPI_GLOIDX,
+                             sc_MPI_SUM, t8_forest_get_mpicomm (forest));
+  SC_CHECK_MPI (mpiret);
+  mpiret = sc_MPI_Allreduce (&local_area, &area, 1, sc_MPI_DOUBLE,
+                             sc_MPI_SUM, t8_forest_get_mpicomm (forest));
+  SC_CHECK_MPI (mpiret);
+  /* Each interior face is counted from both sides */
+  if (dim == 2) {
+    expected_count = 2 * 2 * n * (n - 1);
+    expected_area = 2 * 2 * (n - 1);
+  }
+  else {
+    expected_count = 2 * 3 * n * n * (n - 1);
+    expected_area = 2 * 3 * (n - 1);
+  }
+  SC_CHECK_ABORTF (count == expected_count,
+                   "Wrong number of entries %lli instead of %lli",
+                   (long long) count, (long long) expected_count);
+  SC_CHECK_ABORTF (fabs (area - expected_area) < 1e-10,
+                   "Wrong face area %f instead of %f", area, expected_area);
+}
+
+static void
+t8_test_adjacency_csr (t8_eclass_t eclass, int level)
+{
+  t8_cmesh_t          cmesh;
+  t8_forest_t         forest, forest_adapt;
+  t8_forest_csr_t     csr;
+  int                 maxlevel = level + 2;
+
+  t8_global_productionf ("Testing adjacency graph for %s level %i\n",
+                         t8_eclass_to_string[eclass], level);
+  cmesh = t8_cmesh_new_hypercube (eclass, sc_MPI_COMM_WORLD, 0, 0, 0);
+  forest = t8_forest_new_uniform (cmesh, t8_scheme_new_default_cxx (), level,
+                                  1, sc_MPI_COMM_WORLD);
+  t8_forest_adjacency_csr (forest, 1, &csr);
+  t8_test_csr_check_symmetric (forest, &csr);
+  if (eclass == T8_ECLASS_QUAD || eclass == T8_ECLASS_HEX) {
+    t8_test_csr_check_uniform (forest, &csr, t8_eclass_to_dimension[eclass],
+                               level);
+  }
+  t8_forest_csr_reset (&csr);
+
+  /* Adapt and balance the forest, such that elements have neighbors of
+   * different levels */
+  t8_forest_init (&forest_adapt);
+  t8_forest_set_user_data (forest_adapt, &maxlevel);
+  t8_forest_set_adapt (forest_adapt, forest, t8_test_csr_adapt, 1);
+  t8_forest_set_balance (forest_adapt, NULL, 0);
+  t8_forest_set_ghost (forest_adapt, 1, T8_GHOST_FACES);
+  t8_forest_commit (forest_adapt);
+  t8_forest_adjacency_csr (forest_adapt, 1, &csr);
+  t8_test_csr_check_symmetric (forest_adapt, &csr);
+  t8_forest_csr_reset (&csr);
+  /* Without weights */
+  t8_forest_adjacency_csr (forest_adapt, 0, &csr);
+  SC_CHECK_ABORT (csr.weights == NULL, "Weights computed");
+  t8_forest_csr_reset (&csr);
+  t8_forest_unref (&forest_adapt);
+}
+
+int
+main (int argc, char **argv)
+{
+  int                 mpiret;
+  int                 eclass, level;
+
+  mpiret = sc_MPI_Init (&argc, &argv);
+  SC_CHECK_MPI (mpiret);
+
+  sc_init (sc_MPI_COMM_WORLD, 1, 1, NULL, SC_LP_ESSENTIAL);
+  t8_init (SC_LP_DEFAULT);
+
+  for (eclass = T8_ECLASS_LINE; eclass < T8_ECLASS_PYRAMID; eclass++) {
+    for (level = 1; level <= 2; level++) {
+      t8_test_adjacency_csr ((t8_eclass_t) eclass, level);
+    }
+  }
+
+  sc_finalize ();
+
+  mpiret = sc_MPI_Finalize ();
+  SC_CHECK_MPI (mpiret);
+
+  return 0;
+}
@@ -0,0 +1,474 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+/* In this test we refine and coarsen quad and hex forests of the
+ * anisotropic scheme along single axes. We check the number of elements
+ * and the levels along all axes of the local and ghost elements.
+ * The levels are checked again after a repartition with compact messages.
+ * In forests whose elements have different levels along the axes, we check
+ * that ghost, search, iterate_faces and iterate_replace find the leaves.
+ * We also check that comparing elements, computing the nearest common
+ * ancestor and transforming, taking and extruding faces keeps the levels
+ * along the axes.
+ */
+
+#include <t8_schemes/t8_default_cxx.hxx>
+#include <t8_cmesh.h>
+#include <t8_forest.h>
+#include <t8_forest/t8_forest_ghost.h>
+#include <t8_forest/t8_forest_iterate.h>
+
+/* The axes and the maximum level along them for the adapt callbacks */
+typedef struct
+{
+  int                 axes;
+  int                 level;
+} t8_test_aniso_adapt_t;
+
+/* Refine along the axes of the user data up to its level */
+static int
+t8_test_aniso_refine (t8_forest_t forest, t8_forest_t forest_from,
+                      t8_locidx_t which_tree, t8_locidx_t lelement_id,
+                      t8_eclass_scheme_c * ts, int num_elements,
+                      t8_element_t * elements[])
+{
+  const t8_test_aniso_adapt_t *adapt =
+    (const t8_test_aniso_adapt_t *) t8_forest_get_user_data (forest);
+  int                 axis;
+
+  for (axis = 0; axis < t8_eclass_to_dimension[ts->eclass]; axis++) {
+    if ((adapt->axes & (1 << axis))
+        && ts->t8_element_level_axis (elements[0], axis) >= adapt->level) {
+      return 0;
+    }
+  }
+  return T8_ADAPT_REFINE_AXES (adapt->axes);
+}
+
+/* Coarsen along the axes of the user data */
+static int
+t8_test_aniso_coarsen (t8_forest_t forest, t8_forest_t forest_from,
+                       t8_locidx_t which_tree, t8_locidx_t lelement_id,
+                       t8_eclass_scheme_c * ts, int num_elements,
+                       t8_element_t * elements[])
+{
+  const t8_test_aniso_adapt_t *adapt =
+    (const t8_test_aniso_adapt_t *) t8_forest_get_user_data (forest);
+
+  return T8_ADAPT_COARSEN_AXES (adapt->axes);
+}
+
+/* Check that all local and ghost elements have the given levels along
+ * the axes and that the forest has the given number of elements. */
+static void
+t8_test_aniso_check (t8_forest_t forest, const int *levels,
+                     t8_gloidx_t num_elements)
+{
+  t8_eclass_scheme_c *ts;
+  t8_element_t       *element;
+  t8_locidx_t         itree, ielement;
+  int                 axis, dim;
+
+  SC_CHECK_ABORTF (t8_forest_get_global_num_elements (forest) ==
+                   num_elements, "Wrong number of elements %lli",
+                   (long long) t8_forest_get_global_num_elements (forest));
+  for (itree = 0; itree < t8_forest_get_num_local_trees (forest); itree++) {
+    ts = t8_forest_get_eclass_scheme (forest,
+                                      t8_forest_get_tree_class (forest,
+                                                                itree));
+    dim = t8_eclass_to_dimension[ts->eclass];
+    for (ielement = 0;
+         ielement < t8_forest_get_tree_num_elements (forest, itree);
+         ielement++) {
+      element = t8_forest_get_element_in_tree (forest, itree, ielement);
+      for (axis = 0; axis < dim; axis++) {
+        SC_CHECK_ABORT (ts->t8_element_level_axis (element, axis)
+                        == levels[axis], "Wrong level of element");
+      }
+    }
+  }
+  for (itree = 0; itree < t8_forest_get_num_ghost_trees (forest); itree++) {
+    ts = t8_forest_get_eclass_scheme (forest,
+                                      t8_forest_ghost_get_tree_class (forest,
+                                                                      itree));
+    dim = t8_eclass_to_dimension[ts->eclass];
+    for (ielement = 0;
+         ielement < t8_forest_ghost_tree_num_elements (forest, itree);
+         ielement++) {
+      element = t8_forest_ghost_get_element (forest, itree, ielement);
+      for (axis = 0; axis < dim; axis++) {
+        SC_CHECK_ABORT (ts->t8_element_level_axis (element, axis)
+                        == levels[axis], "Wrong level of ghost element");
+      }
+    }
+  }
+}
+
+/* Adapt, balance, possibly partition and create the ghost layer of a forest.
+ * forest is unreferenced. */
+static t8_forest_t
+t8_test_aniso_adapt (t8_forest_t forest, t8_forest_adapt_t adapt_fn,
+                     int recursive, int partition, int axes, int level)
+{
+  t8_forest_t         forest_adapt;
+  t8_test_aniso_adapt_t adapt;
+
+  adapt.axes = axes;
+  adapt.level = level;
+  t8_forest_init (&forest_adapt);
+  t8_forest_set_user_data (forest_adapt, &adapt);
+  t8_forest_set_adapt (forest_adapt, forest, adapt_fn, recursive);
+  t8_forest_set_balance (forest_adapt, NULL, 0);
+  if (partition) {
+    t8_forest_set_partition (forest_adapt, NULL, 0);
+  }
+  t8_forest_set_ghost (forest_adapt, 1, T8_GHOST_FACES);
+  t8_forest_commit (forest_adapt);
+  return forest_adapt;
+}
+
+/* Check that an element has the given levels along its axes */
+static void
+t8_test_aniso_check_levels (t8_eclass_scheme_c * ts,
+                            const t8_element_t * element, const int *levels,
+                            const char *what)
+{
+  int                 axis;
+
+  for (axis = 0; axis < t8_eclass_to_dimension[ts->eclass]; axis++) {
+    SC_CHECK_ABORTF (ts->t8_element_level_axis (element, axis)
+                     == levels[axis], "Wrong level of %s", what);
+  }
+}
+
+/* Check the element functions of the anisotropic scheme that need to
+ * know the levels along the axes. */
+static void
+t8_test_aniso_scheme (t8_eclass_t eclass)
+{
+  t8_scheme_cxx_t    *scheme;
+  t8_eclass_scheme_c *ts, *face_ts;
+  t8_element_t       *elem, *other, *nca, *face;
+  const int           levels[3] = { 3, 1, 2 };
+  const int           other_levels[3] = { 2, 1, 3 };
+  const int           nca_levels[3] = { 2, 1, 2 };
+  const int           swapped_levels[2] = { 1, 2 };
+  const int           root_levels[3] = { 1, 0, 0 };
+  const int           face_levels[2] = { 1, 0 };
+
+  scheme = t8_scheme_new_anisotropic_cxx ();
+  ts = scheme->eclass_schemes[eclass];
+  ts->t8_element_new (1, &elem);
+  ts->t8_element_new (1, &other);
+  ts->t8_element_new (1, &nca);
+
+  /* Two elements of the same patch that differ in their levels */
+  ts->t8_element_set_linear_id (elem, 1, 0);
+  ts->t8_element_set_level_axes (elem, levels);
+  ts->t8_element_set_linear_id (other, 1, 0);
+  ts->t8_element_set_level_axes (other, other_levels);
+  SC_CHECK_ABORT (ts->t8_element_compare (elem, elem) == 0,
+                  "Element differs from itself");
+  SC_CHECK_ABORT (ts->t8_element_compare (elem, other) != 0
+                  && ts->t8_element_compare (elem, other) ==
+                  -ts->t8_element_compare (other, elem),
+                  "Elements with different levels are equal");
+
+  /* The common ancestor is refined along the axes along which both are */
+  ts->t8_element_nca (elem, other, nca);
+  t8_test_aniso_check_levels (ts, nca, nca_levels, "nca");
+  ts->t8_element_nca (elem, other, elem);
+  t8_test_aniso_check_levels (ts, elem, nca_levels, "nca in place");
+
+  if (eclass == T8_ECLASS_QUAD) {
+    /* Transforming a face with sign swaps the axes */
+    ts->t8_element_transform_face (other, nca, 0, 0, 1);
+    t8_test_aniso_check_levels (ts, nca, other_levels, "transformed element");
+    ts->t8_element_transform_face (other, nca, 0, 1, 1);
+    t8_test_aniso_check_levels (ts, nca, swapped_levels,
+                                "transformed element");
+    ts->t8_element_transform_face (other, nca, 1, 0, 1);
+    t8_test_aniso_check_levels (ts, nca, swapped_levels,
+                                "transformed element");
+    ts->t8_element_transform_face (other, nca, 1, 1, 1);
+    t8_test_aniso_check_levels (ts, nca, other_levels, "transformed element");
+  }
+  else {
+    /* The boundary face at the y = 0 face of the root has the levels
+     * along the x and z axis and extruding it restores the element. */
+    face_ts = scheme->eclass_schemes[T8_ECLASS_QUAD];
+    face_ts->t8_element_new (1, &face);
+    ts->t8_element_set_linear_id (elem, 0, 0);
+    ts->t8_element_set_level_axes (elem, root_levels);
+    ts->t8_element_boundary_face (elem, 2, face, face_ts);
+    t8_test_aniso_check_levels (face_ts, face, face_levels, "boundary face");
+    ts->t8_element_extrude_face (face, face_ts, other, 2);
+    SC_CHECK_ABORT (ts->t8_element_compare (elem, other) == 0,
+                    "Extruded element differs from element");
+    face_ts->t8_element_destroy (1, &face);
+  }
+
+  ts->t8_element_destroy (1, &elem);
+  ts->t8_element_destroy (1, &other);
+  ts->t8_element_destroy (1, &nca);
+  t8_scheme_cxx_unref (&scheme);
+}
+
+/* Repartition a forest with compact messages, such that the process with
+ * rank i gets a share of the elements proportional to i + 1, and create
+ * its ghost layer. forest is unreferenced. */
+static t8_forest_t
+t8_test_aniso_partition (t8_forest_t forest)
+{
+  t8_forest_t         forest_partition;
+  int                 mpirank, mpiret;
+
+  mpiret = sc_MPI_Comm_rank (sc_MPI_COMM_WORLD, &mpirank);
+  SC_CHECK_MPI (mpiret);
+  t8_forest_init (&forest_partition);
+  t8_forest_set_partition (forest_partition, forest, 0);
+  t8_forest_set_partition_capacity (forest_partition, mpirank + 1);
+  t8_forest_set_compact_messages (forest_partition, 1);
+  t8_forest_set_ghost (forest_partition, 1, T8_GHOST_FACES);
+  t8_forest_commit (forest_partition);
+  return forest_partition;
+}
+
+static void
+t8_test_anisotropic (t8_eclass_t eclass, int level)
+{
+  t8_cmesh_t          cmesh;
+  t8_forest_t         forest;
+  t8_gloidx_t         num_elements;
+  const int           dim = t8_eclass_to_dimension[eclass];
+  const int           other_axes = (1 << dim) - 1 - T8_ADAPT_AXIS_X;
+  int                 levels[3];
+
+  t8_global_productionf ("Testing anisotropic refinement for %s level %i\n",
+                         t8_eclass_to_string[eclass], level);
+  cmesh = t8_cmesh_new_hypercube (eclass, sc_MPI_COMM_WORLD, 0, 0, 0);
+  forest = t8_forest_new_uniform (cmesh, t8_scheme_new_anisotropic_cxx (),
+                                  level, 1, sc_MPI_COMM_WORLD);
+  num_elements = t8_forest_get_global_num_elements (forest);
+
+  /* Refine along the x axis twice. The elements stay the same. */
+  forest = t8_test_aniso_adapt (forest, t8_test_aniso_refine, 1, 1,
+                                T8_ADAPT_AXIS_X, level + 2);
+  levels[0] = level + 2;
+  levels[1] = levels[2] = level;
+  t8_test_aniso_check (forest, levels, num_elements);
+
+  /* Repartition with compact messages. The levels are kept. */
+  forest = t8_test_aniso_partition (forest);
+  t8_test_aniso_check (forest, levels, num_elements);
+
+  /* Refine along the other axes. Each element is replaced by its children.
+   * We do not partition the forest, so that the families are coarsened
+   * in the next step. */
+  forest = t8_test_aniso_adapt (forest, t8_test_aniso_refine, 0, 0,
+                                other_axes, level + 1);
+  levels[1] = levels[2] = level + 1;
+  t8_test_aniso_check (forest, levels, num_elements << dim);
+
+  /* Coarsen along the other axes. Each family is replaced by its parent. */
+  forest = t8_test_aniso_adapt (forest, t8_test_aniso_coarsen, 0, 1,
+                                other_axes, 0);
+  levels[1] = levels[2] = level;
+  t8_test_aniso_check (forest, levels, num_elements);
+
+  /* Coarsen along the x axis. The elements stay the same. */
+  forest = t8_test_aniso_adapt (forest, t8_test_aniso_coarsen, 0, 1,
+                                T8_ADAPT_AXIS_X, 0);
+  levels[0] = level + 1;
+  t8_test_aniso_check (forest, levels, num_elements);
+
+  t8_forest_unref (&forest);
+}
+
+/* Refine every third element along the x axis only */
+static int
+t8_test_aniso_refine_third (t8_forest_t forest, t8_forest_t forest_from,
+                            t8_locidx_t which_tree, t8_locidx_t lelement_id,
+                            t8_eclass_scheme_c * ts, int num_elements,
+                            t8_element_t * elements[])
+{
+  return lelement_id % 3 == 0 ? T8_ADAPT_REFINE_AXES (T8_ADAPT_AXIS_X) : 0;
+}
+
+/* Count the leaves that a search finds and check that it passes the
+ * leaves themselves. The count is the user data of the forest. */
+static int
+t8_test_aniso_search (t8_forest_t forest, t8_locidx_t ltreeid,
+                      const t8_element_t * element, const int is_leaf,
+                      t8_element_array_t * leaf_elements,
+                      t8_locidx_t tree_leaf_index, void *query,
+                      size_t query_index)
+{
+  if (is_leaf) {
+    SC_CHECK_ABORT (element ==
+                    t8_forest_get_element_in_tree (forest, ltreeid,
+                                                   tree_leaf_index),
+                    "Search does not pass the leaf");
+    (*(t8_locidx_t *) t8_forest_get_user_data (forest))++;
+  }
+  return 1;
+}
+
+/* Count the leaves that iterate_faces finds */
+static int
+t8_test_aniso_face (t8_forest_t forest, t8_locidx_t ltreeid,
+                    const t8_element_t * element, int face,
+                    void *user_data, t8_locidx_t tree_leaf_index)
+{
+  if (tree_leaf_index >= 0) {
+    SC_CHECK_ABORT (element ==
+                    t8_forest_get_element_in_tree (forest, ltreeid,
+                                                   tree_leaf_index),
+                    "Iterate faces does not pass the leaf");
+    (*(t8_locidx_t *) user_data)++;
+  }
+  return 1;
+}
+
+/* Count the elements whose levels along the axes were changed in place.
+ * The count is the user data of the new forest. */
+static void
+t8_test_aniso_replace (t8_forest_t forest_old, t8_forest_t forest_new,
+                       t8_locidx_t which_tree, t8_eclass_scheme_c * ts,
+                       int num_outgoing, t8_locidx_t first_outgoing,
+                       int num_incoming, t8_locidx_t first_incoming)
+{
+  const t8_element_t *elem_old, *elem_new;
+
+  SC_CHECK_ABORT (num_outgoing == 1 && num_incoming == 1,
+                  "Wrong number of replaced elements");
+  elem_old = t8_forest_get_element_in_tree (forest_old, which_tree,
+                                            first_outgoing);
+  elem_new = t8_forest_get_element_in_tree (forest_new, which_tree,
+                                            first_incoming);
+  SC_CHECK_ABORT (ts->t8_element_level (elem_old)
+                  == ts->t8_element_level (elem_new),
+                  "Replaced elements have different levels");
+  if (ts->t8_element_compare (elem_old, elem_new)) {
+    SC_CHECK_ABORT (ts->t8_element_level_axis (elem_new, 0)
+                    == ts->t8_element_level_axis (elem_old, 0) + 1,
+                    "Wrong level of replaced element");
+    (*(t8_locidx_t *) t8_forest_get_user_data (forest_new))++;
+  }
+}
+
+/* Refine every third element of a uniform forest along the x axis, such that
+ * the elements have different levels along the x axis, and create the ghost
+ * layer, which uses search. Check search and iterate_faces on this forest.
+ * Then refine every third element again along the x axis and check that
+ * iterate_replace reports these elements as changed. */
+static void
+t8_test_aniso_mixed (t8_eclass_t eclass, int level)
+{
+  t8_cmesh_t          cmesh;
+  t8_forest_t         forest, forest_new;
+  t8_eclass_scheme_c *ts;
+  t8_element_t       *root, *element;
+  t8_locidx_t         itree, ielement, num_elements, count, expected;
+
+  t8_global_productionf ("Testing mixed anisotropic levels for %s\n",
+                         t8_eclass_to_string[eclass]);
+  cmesh = t8_cmesh_new_hypercube (eclass, sc_MPI_COMM_WORLD, 0, 0, 0);
+  forest = t8_forest_new_uniform (cmesh, t8_scheme_new_anisotropic_cxx (),
+                                  level, 0, sc_MPI_COMM_WORLD);
+  t8_forest_init (&forest_new);
+  t8_forest_set_adapt (forest_new, forest, t8_test_aniso_refine_third, 0);
+  t8_forest_set_ghost (forest_new, 1, T8_GHOST_FACES);
+  t8_forest_commit (forest_new);
+  forest = forest_new;
+
+  /* The search finds all leaves */
+  count = 0;
+  t8_forest_set_user_data (forest, &count);
+  t8_forest_search (forest, t8_test_aniso_search, NULL, NULL);
+  SC_CHECK_ABORT (count == t8_forest_get_local_num_elements (forest),
+                  "Search does not find all leaves");
+
+  /* Iterating over the first face of the root finds all leaves at it */
+  for (itree = 0; itree < t8_forest_get_num_local_trees (forest); itree++) {
+    ts = t8_forest_get_eclass_scheme (forest,
+                                      t8_forest_get_tree_class (forest,
+                                                                itree));
+    num_elements = t8_forest_get_tree_num_elements (forest, itree);
+    expected = 0;
+    for (ielement = 0; ielement < num_elements; ielement++) {
+      element = t8_forest_get_element_in_tree (forest, itree, ielement);
+      expected += ts->t8_element_is_root_boundary (element, 0);
+    }
+    ts->t8_element_new (1, &root);
+    ts->t8_element_set_linear_id (root, 0, 0);
+    count = 0;
+    t8_forest_iterate_faces (forest, itree, root, 0,
+                             t8_forest_tree_get_leafs (forest, itree),
+                             &count, 0, t8_test_aniso_face);
+    SC_CHECK_ABORT (count == expected,
+                    "Iterate faces does not find all leaves");
+    ts->t8_element_destroy (1, &root);
+  }
+
+  /* Replacing reports the elements that changed in place */
+  expected = 0;
+  for (itree = 0; itree < t8_forest_get_num_local_trees (forest); itree++) {
+    expected += (t8_forest_get_tree_num_elements (forest, itree) + 2) / 3;
+  }
+  t8_forest_ref (forest);
+  forest_new = t8_forest_new_adapt (forest, t8_test_aniso_refine_third, 0, 0,
+                                    NULL);
+  count = 0;
+  t8_forest_set_user_data (forest_new, &count);
+  t8_forest_iterate_replace (forest_new, forest, t8_test_aniso_replace);
+  SC_CHECK_ABORT (count == expected, "Wrong number of changed elements");
+
+  t8_forest_unref (&forest_new);
+  t8_forest_unref (&forest);
+}
+
+int
+main (int argc, char **argv)
+{
+  int                 mpiret;
+
+  mpiret = sc_MPI_Init (&argc, &argv);
+  SC_CHECK_MPI (mpiret);
+
+  sc_init (sc_MPI_COMM_WORLD, 1, 1, NULL, SC_LP_ESSENTIAL);
+  t8_init (SC_LP_DEFAULT);
+
+  t8_test_aniso_scheme (T8_ECLASS_QUAD);
+  t8_test_aniso_scheme (T8_ECLASS_HEX);
+  t8_test_anisotropic (T8_ECLASS_QUAD, 1);
+  t8_test_anisotropic (T8_ECLASS_HEX, 1);
+  t8_test_aniso_mixed (T8_ECLASS_QUAD, 3);
+  t8_test_aniso_mixed (T8_ECLASS_HEX, 2);
+
+  sc_finalize ();
+
+  mpiret = sc_MPI_Finalize ();
+  SC_CHECK_MPI (mpiret);
+
+  return 0;
+}
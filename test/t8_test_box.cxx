@@ -0,0 +1,216 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+/* In this test we decompose boxes into intervals of linear ids on brick
+ * meshes and check that the leaves of the intervals are exactly the leaves
+ * that intersect the box.
+ */
+
+#include <p4est_connectivity.h>
+#include <p8est_connectivity.h>
+#include <t8_schemes/t8_default_cxx.hxx>
+#include <t8_cmesh.h>
+#include <t8_forest.h>
+#include <t8_forest_box.h>
+
+/* Refine the first element of each tree up to the level given as user data */
+static int
+t8_test_box_refine (t8_forest_t forest, t8_forest_t forest_from,
+                    t8_locidx_t which_tree, t8_locidx_t lelement_id,
+                    t8_eclass_scheme_c * ts, int num_elements,
+                    t8_element_t * elements[])
+{
+  const int           level = ts->t8_element_level (elements[0]);
+
+  return ts->t8_element_get_linear_id (elements[0], level) == 0
+    && level < *(int *) t8_forest_get_user_data (forest);
+}
+
+/* Check whether the ancestor of a leaf at a given level intersects a box.
+ * If the leaf is coarser than the level, we check the leaf itself. */
+static int
+t8_test_box_leaf_intersects (t8_forest_t forest, t8_locidx_t ltreeid,
+                             const t8_element_t * leaf, int level,
+                             const double box[6])
+{
+  t8_eclass_scheme_c *ts;
+  t8_element_t       *ancestor;
+  double             *vertices, lower[3], upper[3];
+  int                 idim, intersects = 1;
+
+  ts = t8_forest_get_eclass_scheme (forest,
+                                    t8_forest_get_tree_class (forest,
+                                                              ltreeid));
+  vertices = t8_forest_get_tree_vertices (forest, ltreeid);
+  level = SC_MIN (level, ts->t8_element_level (leaf));
+  ts->t8_element_new (1, &ancestor);
+  ts->t8_element_set_linear_id (ancestor, level,
+                                ts->t8_element_get_linear_id (leaf, level));
+  t8_forest_element_coordinate (forest, ltreeid, ancestor, vertices, 0,
+                                lower);
+  t8_forest_element_coordinate (forest, ltreeid, ancestor, vertices,
+                                ts->t8_element_num_corners (ancestor) - 1,
+                                upper);
+  for (idim = 0; idim < 3; idim++) {
+    intersects = intersects && lower[idim] <= box[3 + idim]
+      && upper[idim] >= box[idim];
+  }
+  ts->t8_element_destroy (1, &ancestor);
+  return intersects;
+}
+
+static void
+t8_test_box_check (t8_forest_t forest, const double box[6], int level)
+{
+  sc_array_t          intervals;
+  t8_eclass_scheme_c *ts;
+  t8_forest_box_interval_t *interval, *prev;
+  t8_locidx_t         ltreeid, first, count, ielem, num_elements;
+  t8_locidx_t         offset;
+  int                *matched, first_owner, last_owner, mpirank, mpiret;
+  size_t              iinterval;
+
+  mpiret = sc_MPI_Comm_rank (t8_forest_get_mpicomm (forest), &mpirank);
+  SC_CHECK_MPI (mpiret);
+  sc_array_init (&intervals, sizeof (t8_forest_box_interval_t));
+  t8_forest_box_intervals_physical (forest, box, level, &intervals);
+
+  num_elements = t8_forest_get_local_num_elements (forest);
+  matched = T8_ALLOC_ZERO (int, num_elements);
+  for (iinterval = 0; iinterval < intervals.elem_count; iinterval++) {
+    interval = (t8_forest_box_interval_t *)
+      sc_array_index (&intervals, iinterval);
+    SC_CHECK_ABORT (interval->level == level
+                    && interval->first < interval->last, "Wrong interval");
+    if (iinterval > 0) {
+      /* The intervals are sorted and adjacent intervals are merged */
+      prev = interval - 1;
+      SC_CHECK_ABORT (prev->gtreeid < interval->gtreeid
+                      || prev->last < interval->first,
+                      "Intervals not sorted or not minimal");
+    }
+    count = t8_forest_box_interval_elements (forest, interval, &ltreeid,
+                                             &first);
+    if (count == 0) {
+      continue;
+    }
+    t8_forest_box_interval_owners (forest, interval, &first_owner,
+                                   &last_owner);
+    SC_CHECK_ABORT (first_owner <= mpirank && mpirank <= last_owner,
+                    "Wrong owners of interval");
+    offset = t8_forest_get_tree_element_offset (forest, ltreeid);
+    ts = t8_forest_get_eclass_scheme (forest,
+                                      t8_forest_get_tree_class (forest,
+                                                                ltreeid));
+    for (ielem = first; ielem < first + count; ielem++) {
+      /* A leaf coarser than the level may overlap several intervals */
+      SC_CHECK_ABORT (!matched[offset + ielem]
+                      || ts->t8_element_level (t8_forest_get_element_in_tree
+                                               (forest, ltreeid,
+                                                ielem)) < level,
+                      "Overlapping intervals");
+      matched[offset + ielem] = 1;
+    }
+  }
+  for (ltreeid = 0; ltreeid < t8_forest_get_num_local_trees (forest);
+       ltreeid++) {
+    offset = t8_forest_get_tree_element_offset (forest, ltreeid);
+    for (ielem = 0; ielem < t8_forest_get_tree_num_elements (forest, ltreeid);
+         ielem++) {
+      SC_CHECK_ABORTF (matched[offset + ielem] ==
+                       t8_test_box_leaf_intersects (forest, ltreeid,
+                                                    t8_forest_get_element_in_tree
+                                                    (forest, ltreeid, ielem),
+                                                    level, box),
+                       "Wrong match of element %i in tree %i", ielem,
+                       ltreeid);
+    }
+  }
+  T8_FREE (matched);
+  sc_array_reset (&intervals);
+}
+
+static void
+t8_test_box (int dim, int level)
+{
+  t8_cmesh_t          cmesh;
+  t8_forest_t         forest, forest_adapt;
+  int                 iforest, ibox, maxlevel = level + 2;
+  const double        boxes[3][6] = {
+    {0.3, 0.45, 0.2, 2.1, 1.6, 0.7},
+    {1.0, 0.0, 0.0, 1.0, 2.0, 1.0},
+    {0.6, 0.6, 0.6, 0.6, 0.6, 0.6}
+  };
+
+  t8_global_productionf ("Testing box intervals for dimension %i level %i\n",
+                         dim, level);
+  if (dim == 2) {
+    cmesh = t8_cmesh_new_from_p4est (p4est_connectivity_new_brick (3, 2, 0,
+                                                                   0),
+                                     sc_MPI_COMM_WORLD, 0);
+  }
+  else {
+    cmesh = t8_cmesh_new_from_p8est (p8est_connectivity_new_brick (2, 2, 1,
+                                                                   0, 0, 0),
+                                     sc_MPI_COMM_WORLD, 0);
+  }
+  forest = t8_forest_new_uniform (cmesh, t8_scheme_new_default_cxx (),
+                                  level, 0, sc_MPI_COMM_WORLD);
+  for (iforest = 0; iforest < 2; iforest++) {
+    if (iforest == 1) {
+      /* Refine and partition the forest */
+      t8_forest_init (&forest_adapt);
+      t8_forest_set_user_data (forest_adapt, &maxlevel);
+      t8_forest_set_adapt (forest_adapt, forest, t8_test_box_refine, 1);
+      t8_forest_set_partition (forest_adapt, NULL, 0);
+      t8_forest_commit (forest_adapt);
+      forest = forest_adapt;
+    }
+    for (ibox = 0; ibox < 3; ibox++) {
+      t8_test_box_check (forest, boxes[ibox], level);
+      t8_test_box_check (forest, boxes[ibox], level + 1);
+    }
+  }
+  t8_forest_unref (&forest);
+}
+
+int
+main (int argc, char **argv)
+{
+  int                 mpiret;
+
+  mpiret = sc_MPI_Init (&argc, &argv);
+  SC_CHECK_MPI (mpiret);
+
+  sc_init (sc_MPI_COMM_WORLD, 1, 1, NULL, SC_LP_ESSENTIAL);
+  t8_init (SC_LP_DEFAULT);
+
+  t8_test_box (2, 2);
+  t8_test_box (3, 2);
+
+  sc_finalize ();
+
+  mpiret = sc_MPI_Finalize ();
+  SC_CHECK_MPI (mpiret);
+
+  return 0;
+}
@@ -42,6 +42,9 @@ t8_test_cmesh_committed (t8_cmesh_t cmesh)
 
 /** The function test_cmesh_copy (int cmesh_id,sc_MPI_Comm comm) runs the cmesh_copy test for one given cmesh,
  * that we get through its id by caling t8_test_create_cmesh (cmesh_id). 
+ * It also checks that the copies share the trees of the original, that
+ * t8_cmesh_trees_unshare gives a copy its own trees and that the copies stay
+ * valid after the original is destroyed.
  * \param [in] cmesh_id The cmesh_id which is used to create a unique cmesh with t8_test_create_cmesh.
  * \param [in] comm The communicator used to commit the cmesh_copy.
  */
@@ -49,7 +52,8 @@ static void
 test_cmesh_copy (int cmesh_id, sc_MPI_Comm comm)
 {
   int                 retval;
-  t8_cmesh_t          cmesh_original, cmesh_copy;
+  t8_cmesh_t          cmesh_original, cmesh_copy, cmesh_unshared;
+  t8_cmesh_trees_t    trees;
   /* Create new cmesh */
   cmesh_original = t8_test_create_cmesh (cmesh_id);
   t8_test_cmesh_committed (cmesh_original);
@@ -64,9 +68,50 @@ test_cmesh_copy (int cmesh_id, sc_MPI_Comm comm)
   /* Check for equality */
   retval = t8_cmesh_is_equal (cmesh_copy, cmesh_original);
   SC_CHECK_ABORT (retval == 1, "Cmesh copy failed.");
+  /* The copy shares the trees of the original */
+  SC_CHECK_ABORT (cmesh_copy->trees == cmesh_original->trees
+                  && t8_cmesh_trees_is_shared (cmesh_copy->trees),
+                  "Cmesh copy does not share the trees.");
+  /* Set up a second copy and give it its own trees */
+  t8_cmesh_init (&cmesh_unshared);
+  t8_cmesh_ref (cmesh_original);
+  t8_cmesh_set_derive (cmesh_unshared, cmesh_original);
+  t8_cmesh_commit (cmesh_unshared, comm);
+  t8_cmesh_trees_unshare (&cmesh_unshared->trees,
+                          cmesh_unshared->num_local_trees,
+                          cmesh_unshared->num_ghosts);
+  SC_CHECK_ABORT (cmesh_unshared->trees != cmesh_original->trees
+                  && !t8_cmesh_trees_is_shared (cmesh_unshared->trees),
+                  "Cmesh trees unshare failed.");
+  SC_CHECK_ABORT (t8_cmesh_trees_is_shared (cmesh_original->trees),
+                  "Cmesh trees unshare released the original trees.");
+  t8_test_cmesh_committed (cmesh_unshared);
+  retval = t8_cmesh_is_equal (cmesh_unshared, cmesh_original);
+  SC_CHECK_ABORT (retval == 1, "Cmesh trees unshare failed.");
+  /* Destroy the original. The copies must still be usable. */
+  t8_cmesh_destroy (&cmesh_original);
+  SC_CHECK_ABORT (!t8_cmesh_trees_is_shared (cmesh_copy->trees),
+                  "Cmesh trees are shared after destroying the original.");
+  t8_test_cmesh_committed (cmesh_copy);
+  retval = t8_cmesh_is_equal (cmesh_copy, cmesh_unshared);
+  SC_CHECK_ABORT (retval == 1, "Cmesh copy changed with the original.");
+  /* Unsharing trees that are not shared does not copy them */
+  trees = cmesh_copy->trees;
+  t8_cmesh_trees_unshare (&cmesh_copy->trees, cmesh_copy->num_local_trees,
+                          cmesh_copy->num_ghosts);
+  SC_CHECK_ABORT (cmesh_copy->trees == trees,
+                  "Cmesh trees unshare copied unshared trees.");
+  /* Check the reference counting of the trees */
+  t8_cmesh_trees_ref (trees);
+  SC_CHECK_ABORT (t8_cmesh_trees_is_shared (trees),
+                  "Cmesh trees are not shared after ref.");
+  t8_cmesh_trees_unref (&trees);
+  SC_CHECK_ABORT (trees == NULL
+                  && !t8_cmesh_trees_is_shared (cmesh_copy->trees),
+                  "Cmesh trees are shared after unref.");
   /* Clean-up */
   t8_cmesh_destroy (&cmesh_copy);
-  t8_cmesh_destroy (&cmesh_original);
+  t8_cmesh_destroy (&cmesh_unshared);
 }
 
 /** The function test_cmesh_copy_all(sc_MPI_Comm comm) runs the cmesh_copy test for all cmeshes we want to test.
@@ -163,6 +163,116 @@ t8_test_cmesh_readmshfile_version2_ascii ()
   t8_global_productionf ("Could successfully read.\n");
 }
 
+/* Read a version 2 ascii file with physical tags and boundary elements.
+ * The mesh is the same as in test_msh_file_vers2_ascii.msh, but the trees
+ * and most of the boundary edges carry physical tags. */
+static void
+t8_test_cmesh_readmshfile_version2_ascii_tags ()
+{
+  int                 retval;
+  t8_cmesh_t          cmesh;
+  t8_locidx_t         ltree_it, lnum_trees;
+  int                 face;
+  const char          fileprefix[BUFSIZ - 4] =
+    "test/testfiles/test_msh_file_vers2_ascii_tags";
+  char                filename[BUFSIZ];
+  /* *INDENT-OFF* */
+  const int           tree_tags[4] = {1, 1, 2, 2};
+  const int           face_tags[4][3] = {
+                                          {0, 12, 10},
+                                          {0, 0, 0},
+                                          {11, 0, 10},
+                                          {0, 12, 0} };
+  /* *INDENT-ON* */
+
+  snprintf (filename, BUFSIZ, "%s.msh", fileprefix);
+
+  t8_global_productionf ("Checking msh file version 2 ascii with tags...\n");
+
+  /* Check if file exists. */
+  SC_CHECK_ABORTF (access (filename, R_OK) == 0, "Could not open file %s.\n",
+                   filename);
+
+  /* Try to read cmesh */
+  cmesh = t8_cmesh_from_msh_file (fileprefix, 1, sc_MPI_COMM_WORLD, 2, 0);
+  SC_CHECK_ABORT (cmesh != NULL,
+                  "Could not read cmesh from ascii version 2 with tags.");
+  /* The tags must not change the mesh itself. */
+  retval = t8_test_supported_msh_file (cmesh);
+  SC_CHECK_ABORT (retval == 1, "Cmesh incorrectly read from file.");
+
+  lnum_trees = t8_cmesh_get_num_local_trees (cmesh);
+  for (ltree_it = 0; ltree_it < lnum_trees; ltree_it++) {
+    SC_CHECK_ABORT (t8_cmesh_msh_get_tree_physical_tag (cmesh, ltree_it)
+                    == tree_tags[ltree_it],
+                    "Physical tag of tree was read incorrectly.");
+    for (face = 0; face < 3; face++) {
+      SC_CHECK_ABORT (t8_cmesh_msh_get_tree_face_boundary_tag
+                      (cmesh, ltree_it, face) == face_tags[ltree_it][face],
+                      "Boundary tag of tree face was read incorrectly.");
+    }
+  }
+
+  t8_cmesh_destroy (&cmesh);
+
+  t8_global_productionf ("Could successfully read.\n");
+}
+
+/* Read the version 2 ascii file with tags, save the cmesh to disk and
+ * load it back. The loaded cmesh must carry the same tags. */
+static void
+t8_test_cmesh_readmshfile_save_load_tags ()
+{
+  int                 retval, mpiret;
+  t8_cmesh_t          cmesh, cmesh_loaded;
+  t8_locidx_t         ltree_it, lnum_trees;
+  int                 face;
+  const char          fileprefix[BUFSIZ - 4] =
+    "test/testfiles/test_msh_file_vers2_ascii_tags";
+  const char          saveprefix[] = "test_msh_file_tags_saved";
+
+  t8_global_productionf ("Checking save and load of msh tags...\n");
+
+  /* Read a replicated cmesh, such that rank 0 writes a single file */
+  cmesh = t8_cmesh_from_msh_file (fileprefix, 0, sc_MPI_COMM_WORLD, 2, 0);
+  SC_CHECK_ABORT (cmesh != NULL,
+                  "Could not read cmesh from ascii version 2 with tags.");
+  retval = t8_cmesh_save (cmesh, saveprefix);
+  SC_CHECK_ABORT (retval, "Could not save cmesh with tags.");
+  /* Wait until the file is written */
+  mpiret = sc_MPI_Barrier (sc_MPI_COMM_WORLD);
+  SC_CHECK_MPI (mpiret);
+
+  cmesh_loaded = t8_cmesh_load_and_distribute (saveprefix, 1,
+                                               sc_MPI_COMM_WORLD,
+                                               T8_LOAD_SIMPLE, -1);
+  SC_CHECK_ABORT (cmesh_loaded != NULL, "Could not load cmesh with tags.");
+  retval = t8_test_supported_msh_file (cmesh_loaded);
+  SC_CHECK_ABORT (retval == 1, "Cmesh incorrectly loaded from file.");
+
+  lnum_trees = t8_cmesh_get_num_local_trees (cmesh_loaded);
+  SC_CHECK_ABORT (lnum_trees == t8_cmesh_get_num_local_trees (cmesh),
+                  "Loaded cmesh has wrong number of trees.");
+  for (ltree_it = 0; ltree_it < lnum_trees; ltree_it++) {
+    SC_CHECK_ABORT (t8_cmesh_msh_get_tree_physical_tag
+                    (cmesh_loaded, ltree_it)
+                    == t8_cmesh_msh_get_tree_physical_tag (cmesh, ltree_it),
+                    "Physical tag of tree was loaded incorrectly.");
+    for (face = 0; face < 3; face++) {
+      SC_CHECK_ABORT (t8_cmesh_msh_get_tree_face_boundary_tag
+                      (cmesh_loaded, ltree_it, face)
+                      == t8_cmesh_msh_get_tree_face_boundary_tag
+                      (cmesh, ltree_it, face),
+                      "Boundary tag of tree face was loaded incorrectly.");
+    }
+  }
+
+  t8_cmesh_destroy (&cmesh_loaded);
+  t8_cmesh_destroy (&cmesh);
+
+  t8_global_productionf ("Could successfully save and load.\n");
+}
+
 /* Read version 2 binary file. We expect this to fail. */
 static void
 t8_test_cmesh_readmshfile_version2_bin ()
@@ -268,6 +378,12 @@ main (int argc, char **argv)
   /* Testing supported msh-file version 2 (as example). */
   t8_test_cmesh_readmshfile_version2_ascii ();
 
+  /* Testing physical and boundary tags of msh-file version 2. */
+  t8_test_cmesh_readmshfile_version2_ascii_tags ();
+
+  /* Testing saving and loading of the physical and boundary tags. */
+  t8_test_cmesh_readmshfile_save_load_tags ();
+
   /* Testing unsupported msh-file version 2 binary. */
   t8_test_cmesh_readmshfile_version2_bin ();
 
@@ -0,0 +1,245 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element types in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#include <t8.h>
+#include <t8_eclass.h>
+#include <t8_cmesh.h>
+#include <t8_cmesh_readvtu.h>
+#include "t8_cmesh/t8_cmesh_trees.h"
+#include "t8_cmesh/t8_cmesh_types.h"
+
+/* In this file we test the vtu/pvtu reader of the cmesh.
+ * We write the trees of a replicated cmesh to one .vtu piece per
+ * process, such that face connections cross pieces, read the .pvtu file
+ * and check whether the partitioned cmesh matches the replicated one.
+ */
+
+/* Write the trees of a replicated cmesh to one .vtu piece per process.
+ * Process p writes its share of the trees to fileprefix_p.vtu and process 0
+ * writes fileprefix.pvtu. Returns the number of trees in the piece. */
+static t8_gloidx_t
+t8_test_readvtu_write_pieces (t8_cmesh_t cmesh, const char *fileprefix,
+                              sc_MPI_Comm comm)
+{
+  int                 mpirank, mpisize, mpiret, ivertex, iproc;
+  t8_gloidx_t         num_trees, first_tree, last_tree, itree;
+  t8_eclass_t         eclass;
+  double             *vertices;
+  long                num_points = 0, offset = 0;
+  char                filename[BUFSIZ];
+  FILE               *file;
+
+  mpiret = sc_MPI_Comm_size (comm, &mpisize);
+  SC_CHECK_MPI (mpiret);
+  mpiret = sc_MPI_Comm_rank (comm, &mpirank);
+  SC_CHECK_MPI (mpiret);
+
+  num_trees = t8_cmesh_get_num_trees (cmesh);
+  first_tree = (mpirank * num_trees) / mpisize;
+  last_tree = ((mpirank + 1) * num_trees) / mpisize - 1;
+  for (itree = first_tree; itree <= last_tree; itree++) {
+    num_points += t8_eclass_num_vertices[t8_cmesh_get_tree_class (cmesh,
+                                                                  itree)];
+  }
+
+  snprintf (filename, BUFSIZ, "%s_%04d.vtu", fileprefix, mpirank);
+  file = fopen (filename, "w");
+  SC_CHECK_ABORTF (file != NULL, "Could not open file %s.\n", filename);
+  fprintf (file, "<?xml version=\"1.0\"?>\n"
+           "<VTKFile type=\"UnstructuredGrid\" version=\"0.1\">\n"
+           "  <UnstructuredGrid>\n"
+           "    <Piece NumberOfPoints=\"%li\" NumberOfCells=\"%li\">\n"
+           "      <Points>\n        <DataArray type=\"Float64\""
+           " NumberOfComponents=\"3\" format=\"ascii\">\n", num_points,
+           (long) (last_tree - first_tree + 1));
+  for (itree = first_tree; itree <= last_tree; itree++) {
+    eclass = t8_cmesh_get_tree_class (cmesh, itree);
+    vertices = t8_cmesh_get_tree_vertices (cmesh, itree);
+    for (ivertex = 0; ivertex < t8_eclass_num_vertices[eclass]; ivertex++) {
+      double             *vertex =
+        vertices + 3 * t8_eclass_vtk_corner_number[eclass][ivertex];
+      fprintf (file, " %.17g %.17g %.17g\n", vertex[0], vertex[1],
+               vertex[2]);
+    }
+  }
+  fprintf (file, "        </DataArray>\n      </Points>\n      <Cells>\n"
+           "        <DataArray type=\"Int32\" Name=\"connectivity\">\n");
+  for (ivertex = 0; ivertex < num_points; ivertex++) {
+    fprintf (file, " %i", ivertex);
+  }
+  fprintf (file, "\n        </DataArray>\n"
+           "        <DataArray type=\"Int32\" Name=\"offsets\">\n");
+  for (itree = first_tree; itree <= last_tree; itree++) {
+    offset += t8_eclass_num_vertices[t8_cmesh_get_tree_class (cmesh, itree)];
+    fprintf (file, " %li", offset);
+  }
+  fprintf (file, "\n        </DataArray>\n"
+           "        <DataArray type=\"UInt8\" Name=\"types\">\n");
+  for (itree = first_tree; itree <= last_tree; itree++) {
+    fprintf (file, " %i",
+             t8_eclass_vtk_type[t8_cmesh_get_tree_class (cmesh, itree)]);
+  }
+  fprintf (file, "\n        </DataArray>\n      </Cells>\n    </Piece>\n"
+           "  </UnstructuredGrid>\n</VTKFile>\n");
+  fclose (file);
+
+  if (mpirank == 0) {
+    snprintf (filename, BUFSIZ, "%s.pvtu", fileprefix);
+    file = fopen (filename, "w");
+    SC_CHECK_ABORTF (file != NULL, "Could not open file %s.\n", filename);
+    fprintf (file, "<?xml version=\"1.0\"?>\n"
+             "<VTKFile type=\"PUnstructuredGrid\" version=\"0.1\">\n"
+             "  <PUnstructuredGrid GhostLevel=\"0\">\n");
+    for (iproc = 0; iproc < mpisize; iproc++) {
+      fprintf (file, "    <Piece Source=\"%s_%04d.vtu\"/>\n", fileprefix,
+               iproc);
+    }
+    fprintf (file, "  </PUnstructuredGrid>\n</VTKFile>\n");
+    fclose (file);
+  }
+  mpiret = sc_MPI_Barrier (comm);
+  SC_CHECK_MPI (mpiret);
+  return last_tree - first_tree + 1;
+}
+
+/* Return the global id of the face neighbor of a tree or -1 if the face
+ * is at the domain boundary. */
+static t8_gloidx_t
+t8_test_readvtu_neighbor (t8_cmesh_t cmesh, t8_locidx_t ltreeid, int face,
+                          int *dual_face, int *orientation)
+{
+  t8_locidx_t         neighbor;
+  t8_gloidx_t         gneighbor;
+
+  neighbor = t8_cmesh_get_face_neighbor (cmesh, ltreeid, face, dual_face,
+                                         orientation);
+  if (neighbor < 0) {
+    return -1;
+  }
+  gneighbor = t8_cmesh_get_global_id (cmesh, neighbor);
+  if (gneighbor == t8_cmesh_get_global_id (cmesh, ltreeid)
+      && *dual_face == face) {
+    /* A face connected to itself is a boundary */
+    return -1;
+  }
+  return gneighbor;
+}
+
+static void
+t8_test_readvtu (t8_cmesh_t cmesh_replicated, const char *fileprefix,
+                 int dim, sc_MPI_Comm comm)
+{
+  t8_cmesh_t          cmesh;
+  char                filename[BUFSIZ];
+  t8_locidx_t         itree;
+  t8_gloidx_t         gtree, num_local_trees;
+  t8_gloidx_t         neighbor, neighbor_replicated;
+  t8_eclass_t         eclass;
+  double             *vertices, *vertices_replicated;
+  int                 iface, ivertex;
+  int                 dual_face, dual_face_replicated;
+  int                 orientation, orientation_replicated;
+
+  num_local_trees =
+    t8_test_readvtu_write_pieces (cmesh_replicated, fileprefix, comm);
+  snprintf (filename, BUFSIZ, "%s.pvtu", fileprefix);
+  cmesh = t8_cmesh_from_pvtu_file (filename, comm, dim);
+  SC_CHECK_ABORT (cmesh != NULL, "Could not read pvtu file.");
+  SC_CHECK_ABORT (t8_cmesh_is_committed (cmesh), "Cmesh commit failed.");
+  SC_CHECK_ABORT (t8_cmesh_trees_is_face_consistend (cmesh, cmesh->trees),
+                  "Cmesh face consistency failed.");
+  SC_CHECK_ABORT (t8_cmesh_get_num_trees (cmesh) ==
+                  t8_cmesh_get_num_trees (cmesh_replicated),
+                  "Wrong number of trees.");
+  /* Each process holds the trees of the piece it wrote */
+  SC_CHECK_ABORT (t8_cmesh_get_num_local_trees (cmesh) == num_local_trees,
+                  "Wrong number of local trees.");
+
+  for (itree = 0; itree < t8_cmesh_get_num_local_trees (cmesh); itree++) {
+    gtree = t8_cmesh_get_global_id (cmesh, itree);
+    eclass = t8_cmesh_get_tree_class (cmesh, itree);
+    SC_CHECK_ABORT (eclass ==
+                    t8_cmesh_get_tree_class (cmesh_replicated, gtree),
+                    "Wrong tree class.");
+    vertices = t8_cmesh_get_tree_vertices (cmesh, itree);
+    vertices_replicated =
+      t8_cmesh_get_tree_vertices (cmesh_replicated, gtree);
+    for (ivertex = 0; ivertex < 3 * t8_eclass_num_vertices[eclass];
+         ivertex++) {
+      SC_CHECK_ABORT (vertices[ivertex] == vertices_replicated[ivertex],
+                      "Wrong tree vertices.");
+    }
+    for (iface = 0; iface < t8_eclass_num_faces[eclass]; iface++) {
+      neighbor = t8_test_readvtu_neighbor (cmesh, itree, iface, &dual_face,
+                                           &orientation);
+      neighbor_replicated =
+        t8_test_readvtu_neighbor (cmesh_replicated, gtree, iface,
+                                  &dual_face_replicated,
+                                  &orientation_replicated);
+      SC_CHECK_ABORT (neighbor == neighbor_replicated,
+                      "Wrong face neighbor.");
+      if (neighbor >= 0) {
+        SC_CHECK_ABORT (dual_face == dual_face_replicated
+                        && orientation == orientation_replicated,
+                        "Wrong face connection.");
+      }
+    }
+  }
+  t8_cmesh_destroy (&cmesh);
+}
+
+int
+main (int argc, char **argv)
+{
+  int                 mpiret, eclass;
+  t8_cmesh_t          cmesh;
+  char                fileprefix[BUFSIZ];
+
+  mpiret = sc_MPI_Init (&argc, &argv);
+  SC_CHECK_MPI (mpiret);
+
+  sc_init (sc_MPI_COMM_WORLD, 1, 1, NULL, SC_LP_ESSENTIAL);
+  t8_init (SC_LP_DEFAULT);
+
+  for (eclass = T8_ECLASS_LINE; eclass < T8_ECLASS_COUNT; eclass++) {
+    t8_global_productionf ("Checking vtu reader for %s.\n",
+                           t8_eclass_to_string[eclass]);
+    cmesh = t8_cmesh_new_hypercube ((t8_eclass_t) eclass, sc_MPI_COMM_WORLD,
+                                    0, 0, 0);
+    snprintf (fileprefix, BUFSIZ, "t8_test_readvtu_%s",
+              t8_eclass_to_string[eclass]);
+    t8_test_readvtu (cmesh, fileprefix, t8_eclass_to_dimension[eclass],
+                     sc_MPI_COMM_WORLD);
+    t8_cmesh_destroy (&cmesh);
+  }
+  t8_global_productionf ("Checking vtu reader for hybrid cmesh.\n");
+  cmesh = t8_cmesh_new_hypercube_hybrid (3, sc_MPI_COMM_WORLD, 0, 0);
+  t8_test_readvtu (cmesh, "t8_test_readvtu_hybrid", 3, sc_MPI_COMM_WORLD);
+  t8_cmesh_destroy (&cmesh);
+
+  sc_finalize ();
+
+  mpiret = sc_MPI_Finalize ();
+  SC_CHECK_MPI (mpiret);
+
+  return 0;
+}
@@ -0,0 +1,273 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+/* In this test we color uniform and adapted forests and check that
+ * no two elements of the same color are in conflict. We also update the
+ * colorings after refining and coarsening the forests.
+ */
+
+#include <t8_schemes/t8_default_cxx.hxx>
+#include <t8_cmesh.h>
+#include <t8_forest.h>
+#include <t8_forest_adjacency.h>
+#include <t8_forest_coloring.h>
+
+/* The global id of a neighbor together with the color and block of a
+ * local element that is adjacent to it */
+typedef struct
+{
+  t8_gloidx_t         neighbor;
+  int                 color;
+  t8_locidx_t         unit;
+} t8_test_coloring_entry_t;
+
+static int
+t8_test_coloring_entry_compare (const void *entry_a, const void *entry_b)
+{
+  const t8_test_coloring_entry_t *A =
+    (const t8_test_coloring_entry_t *) entry_a;
+  const t8_test_coloring_entry_t *B =
+    (const t8_test_coloring_entry_t *) entry_b;
+
+  if (A->neighbor != B->neighbor) {
+    return A->neighbor < B->neighbor ? -1 : 1;
+  }
+  return A->color - B->color;
+}
+
+/* Refine the first element of each tree up to the level given as user data */
+static int
+t8_test_coloring_refine (t8_forest_t forest, t8_forest_t forest_from,
+                         t8_locidx_t which_tree, t8_locidx_t lelement_id,
+                         t8_eclass_scheme_c * ts, int num_elements,
+                         t8_element_t * elements[])
+{
+  const int           level = ts->t8_element_level (elements[0]);
+
+  return ts->t8_element_get_linear_id (elements[0], level) == 0
+    && level < *(int *) t8_forest_get_user_data (forest);
+}
+
+/* Coarsen each family with a level greater than the user data */
+static int
+t8_test_coloring_coarsen (t8_forest_t forest, t8_forest_t forest_from,
+                          t8_locidx_t which_tree, t8_locidx_t lelement_id,
+                          t8_eclass_scheme_c * ts, int num_elements,
+                          t8_element_t * elements[])
+{
+  return num_elements > 1 && ts->t8_element_level (elements[0])
+    > *(int *) t8_forest_get_user_data (forest) ? -1 : 0;
+}
+
+/* Check that each local element has exactly one color and that two
+ * elements of different blocks with the same color are not in conflict. */
+static void
+t8_test_coloring_check (t8_forest_t forest, t8_forest_csr_t * csr,
+                        t8_forest_coloring_t * coloring)
+{
+  t8_test_coloring_entry_t *entries;
+  t8_locidx_t         num_elements, irow, ientry, irange, neighbor;
+  t8_locidx_t         num_colored, block_size = coloring->block_size;
+  t8_gloidx_t         first_element_id;
+  int                *colors, color, mpirank, mpiret;
+
+  mpiret = sc_MPI_Comm_rank (t8_forest_get_mpicomm (forest), &mpirank);
+  SC_CHECK_MPI (mpiret);
+  num_elements = t8_forest_get_local_num_elements (forest);
+  SC_CHECK_ABORT (coloring->num_elements == num_elements,
+                  "Wrong number of elements");
+  num_colored = 0;
+  for (color = 0; color < coloring->num_colors; color++) {
+    SC_CHECK_ABORT (coloring->color_offsets[color] <
+                    coloring->color_offsets[color + 1], "Empty color");
+    for (irange = coloring->color_offsets[color];
+         irange < coloring->color_offsets[color + 1]; irange++) {
+      SC_CHECK_ABORT (coloring->ranges[2 * irange] <
+                      coloring->ranges[2 * irange + 1], "Empty range");
+      SC_CHECK_ABORT (irange == coloring->color_offsets[color]
+                      || coloring->ranges[2 * irange - 1] <
+                      coloring->ranges[2 * irange], "Ranges not sorted");
+      num_colored +=
+        coloring->ranges[2 * irange + 1] - coloring->ranges[2 * irange];
+    }
+  }
+  SC_CHECK_ABORT (num_colored == num_elements, "Wrong number of colored "
+                  "elements");
+  colors = T8_ALLOC (int, num_elements);
+  for (irow = 0; irow < num_elements; irow++) {
+    colors[irow] = -1;
+  }
+  t8_forest_coloring_element_colors (coloring, colors);
+  for (irow = 0; irow < num_elements; irow++) {
+    SC_CHECK_ABORT (0 <= colors[irow] && colors[irow] < coloring->num_colors,
+                    "Element without color");
+  }
+
+  first_element_id = csr->row_distribution[mpirank];
+  entries = T8_ALLOC (t8_test_coloring_entry_t,
+                      csr->row_offsets[num_elements]);
+  for (irow = 0; irow < num_elements; irow++) {
+    for (ientry = csr->row_offsets[irow]; ientry < csr->row_offsets[irow + 1];
+         ientry++) {
+      neighbor = (t8_locidx_t) (csr->columns[ientry] - first_element_id);
+      if (0 <= neighbor && neighbor < num_elements
+          && neighbor / block_size != irow / block_size) {
+        SC_CHECK_ABORTF (colors[neighbor] != colors[irow],
+                         "Face neighbors %i and %i have the same color",
+                         irow, neighbor);
+      }
+      entries[ientry].neighbor = csr->columns[ientry];
+      entries[ientry].color = colors[irow];
+      entries[ientry].unit = irow / block_size;
+    }
+  }
+  if (coloring->type == T8_COLORING_FACE_NEIGHBORS) {
+    /* Elements with a common neighbor, which may be a ghost, must have
+     * different colors. */
+    qsort (entries, csr->row_offsets[num_elements],
+           sizeof (t8_test_coloring_entry_t), t8_test_coloring_entry_compare);
+    for (ientry = 1; ientry < csr->row_offsets[num_elements]; ientry++) {
+      SC_CHECK_ABORTF (t8_test_coloring_entry_compare (entries + ientry - 1,
+                                                       entries + ientry)
+                       || entries[ientry - 1].unit == entries[ientry].unit,
+                       "Two elements with common neighbor %lli have the "
+                       "same color", (long long) entries[ientry].neighbor);
+    }
+  }
+  T8_FREE (entries);
+  T8_FREE (colors);
+}
+
+/* Check that two colorings assign the same colors */
+static void
+t8_test_coloring_same (t8_forest_coloring_t * coloring_a,
+                       t8_forest_coloring_t * coloring_b)
+{
+  t8_locidx_t         num_ranges;
+
+  SC_CHECK_ABORT (coloring_a->num_elements == coloring_b->num_elements
+                  && coloring_a->num_colors == coloring_b->num_colors,
+                  "Colorings of different size");
+  SC_CHECK_ABORT (!memcmp (coloring_a->color_offsets,
+                           coloring_b->color_offsets,
+                           (coloring_a->num_colors + 1)
+                           * sizeof (t8_locidx_t)), "Different colorings");
+  num_ranges = coloring_a->color_offsets[coloring_a->num_colors];
+  SC_CHECK_ABORT (!memcmp (coloring_a->ranges, coloring_b->ranges,
+                           2 * num_ranges * sizeof (t8_locidx_t)),
+                  "Different colorings");
+}
+
+/* Adapt, balance and create the ghost layer of a forest.
+ * forest is not unreferenced. */
+static t8_forest_t
+t8_test_coloring_adapt (t8_forest_t forest, t8_forest_adapt_t adapt_fn,
+                        int recursive, int *level)
+{
+  t8_forest_t         forest_adapt;
+
+  t8_forest_ref (forest);
+  t8_forest_init (&forest_adapt);
+  t8_forest_set_user_data (forest_adapt, level);
+  t8_forest_set_adapt (forest_adapt, forest, adapt_fn, recursive);
+  t8_forest_set_balance (forest_adapt, NULL, 0);
+  t8_forest_set_ghost (forest_adapt, 1, T8_GHOST_FACES);
+  t8_forest_commit (forest_adapt);
+  return forest_adapt;
+}
+
+static void
+t8_test_coloring (t8_eclass_t eclass, int level)
+{
+  t8_cmesh_t          cmesh;
+  t8_forest_t         forest[3];
+  t8_forest_csr_t     csr[3];
+  t8_forest_coloring_t coloring[3];
+  t8_locidx_t         block_size;
+  int                 itype, iforest, maxlevel = level + 2;
+
+  t8_global_productionf ("Testing coloring for %s level %i\n",
+                         t8_eclass_to_string[eclass], level);
+  cmesh = t8_cmesh_new_hypercube (eclass, sc_MPI_COMM_WORLD, 0, 0, 0);
+  forest[0] = t8_forest_new_uniform (cmesh, t8_scheme_new_default_cxx (),
+                                     level, 1, sc_MPI_COMM_WORLD);
+  /* Refine and coarsen the forest again */
+  forest[1] = t8_test_coloring_adapt (forest[0], t8_test_coloring_refine,
+                                      1, &maxlevel);
+  forest[2] = t8_test_coloring_adapt (forest[1], t8_test_coloring_coarsen,
+                                      0, &level);
+  for (iforest = 0; iforest < 3; iforest++) {
+    t8_forest_adjacency_csr (forest[iforest], 0, &csr[iforest]);
+  }
+  for (itype = T8_COLORING_FACES; itype <= T8_COLORING_FACE_NEIGHBORS;
+       itype++) {
+    for (block_size = 1; block_size <= 4; block_size *= 4) {
+      t8_forest_coloring_compute (forest[0], (t8_coloring_type_t) itype,
+                                  block_size, &coloring[0]);
+      if (block_size == 1) {
+        /* If no element changes, all elements keep their colors */
+        t8_forest_coloring_update (forest[0], forest[0], &coloring[0],
+                                   &coloring[1]);
+        t8_test_coloring_same (&coloring[0], &coloring[1]);
+        t8_forest_coloring_reset (&coloring[1]);
+      }
+      for (iforest = 1; iforest < 3; iforest++) {
+        t8_forest_coloring_update (forest[iforest], forest[iforest - 1],
+                                   &coloring[iforest - 1],
+                                   &coloring[iforest]);
+      }
+      for (iforest = 0; iforest < 3; iforest++) {
+        t8_test_coloring_check (forest[iforest], &csr[iforest],
+                                &coloring[iforest]);
+        t8_forest_coloring_reset (&coloring[iforest]);
+      }
+    }
+  }
+  for (iforest = 0; iforest < 3; iforest++) {
+    t8_forest_csr_reset (&csr[iforest]);
+    t8_forest_unref (&forest[iforest]);
+  }
+}
+
+int
+main (int argc, char **argv)
+{
+  int                 mpiret;
+  int                 eclass;
+
+  mpiret = sc_MPI_Init (&argc, &argv);
+  SC_CHECK_MPI (mpiret);
+
+  sc_init (sc_MPI_COMM_WORLD, 1, 1, NULL, SC_LP_ESSENTIAL);
+  t8_init (SC_LP_DEFAULT);
+
+  for (eclass = T8_ECLASS_LINE; eclass < T8_ECLASS_PYRAMID; eclass++) {
+    t8_test_coloring ((t8_eclass_t) eclass, 1);
+  }
+
+  sc_finalize ();
+
+  mpiret = sc_MPI_Finalize ();
+  SC_CHECK_MPI (mpiret);
+
+  return 0;
+}
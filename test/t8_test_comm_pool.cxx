@@ -0,0 +1,112 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+/* In this test we check the pool of duplicated communicators.
+ * A forest that duplicates its communicator and the forests derived from it
+ * share one duplicate, whose reference count drops when the forests are
+ * destroyed. After the last forest is destroyed the pool is empty.
+ */
+
+#include <t8_schemes/t8_default_cxx.hxx>
+#include <t8_cmesh.h>
+#include <t8_forest.h>
+
+/* Derive a partitioned forest from a forest. forest is not unreferenced. */
+static t8_forest_t
+t8_test_comm_pool_derive (t8_forest_t forest)
+{
+  t8_forest_t         forest_partition;
+
+  t8_forest_ref (forest);
+  t8_forest_init (&forest_partition);
+  t8_forest_set_partition (forest_partition, forest, 0);
+  t8_forest_commit (forest_partition);
+  return forest_partition;
+}
+
+static void
+t8_test_comm_pool (sc_MPI_Comm comm)
+{
+  t8_cmesh_t          cmesh;
+  t8_forest_t         forest, forest_derived, forest_other;
+  sc_MPI_Comm         dup;
+
+  SC_CHECK_ABORT (t8_comm_pool_refcount (comm) == 0,
+                  "Communicator is in the pool");
+
+  cmesh = t8_cmesh_new_hypercube (T8_ECLASS_QUAD, comm, 0, 0, 0);
+  t8_forest_init (&forest);
+  t8_forest_set_cmesh (forest, cmesh, comm);
+  t8_forest_set_scheme (forest, t8_scheme_new_default_cxx ());
+  t8_forest_set_level (forest, 2);
+  t8_forest_set_comm_dup (forest, 1);
+  t8_forest_commit (forest);
+  dup = t8_forest_get_mpicomm (forest);
+  SC_CHECK_ABORT (dup != comm, "Communicator was not duplicated");
+  SC_CHECK_ABORT (t8_comm_pool_refcount (comm) == 1
+                  && t8_comm_pool_refcount (dup) == 1,
+                  "Wrong reference count of the duplicate");
+
+  /* The derived forests share the duplicate */
+  forest_derived = t8_test_comm_pool_derive (forest);
+  forest_other = t8_test_comm_pool_derive (forest_derived);
+  SC_CHECK_ABORT (t8_forest_get_mpicomm (forest_derived) == dup
+                  && t8_forest_get_mpicomm (forest_other) == dup,
+                  "Derived forest does not share the duplicate");
+  SC_CHECK_ABORT (t8_comm_pool_refcount (dup) == 3,
+                  "Wrong reference count of the duplicate");
+
+  /* The reference count drops when the forests are destroyed */
+  t8_forest_unref (&forest_derived);
+  SC_CHECK_ABORT (t8_comm_pool_refcount (dup) == 2,
+                  "Wrong reference count of the duplicate");
+  t8_forest_unref (&forest);
+  SC_CHECK_ABORT (t8_comm_pool_refcount (dup) == 1,
+                  "Wrong reference count of the duplicate");
+
+  /* After the last forest the pool is empty */
+  t8_forest_unref (&forest_other);
+  SC_CHECK_ABORT (t8_comm_pool_refcount (comm) == 0
+                  && t8_comm_pool_refcount (dup) == 0,
+                  "Communicator is still in the pool");
+}
+
+int
+main (int argc, char **argv)
+{
+  int                 mpiret;
+
+  mpiret = sc_MPI_Init (&argc, &argv);
+  SC_CHECK_MPI (mpiret);
+
+  sc_init (sc_MPI_COMM_WORLD, 1, 1, NULL, SC_LP_ESSENTIAL);
+  t8_init (SC_LP_DEFAULT);
+
+  t8_test_comm_pool (sc_MPI_COMM_WORLD);
+
+  sc_finalize ();
+
+  mpiret = sc_MPI_Finalize ();
+  SC_CHECK_MPI (mpiret);
+
+  return 0;
+}
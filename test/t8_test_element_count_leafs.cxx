@@ -142,6 +142,11 @@ test_element_count_leafs_root ()
     class_scheme = ts->eclass_schemes[eclass];
     int                 maxlevel = class_scheme->t8_element_maxlevel ();
     t8_gloidx_t         compare_value = 1;
+    /* For tetrahedra and prisms the leaf count at the maximum level is 2^63,
+     * which does not fit into a t8_gloidx_t. We only test the levels with
+     * leaf counts that fit. */
+    maxlevel = SC_MIN (maxlevel, (8 * (int) sizeof (t8_gloidx_t) - 2)
+                       / SC_MAX (1, t8_eclass_to_dimension[eclass]));
     for (level = 0; level <= maxlevel; ++level) {
       t8_gloidx_t         leaf_count =
         class_scheme->t8_element_count_leafs_from_root (level);
@@ -0,0 +1,257 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#include <t8_eclass.h>
+#include <t8_schemes/t8_default_cxx.hxx>
+#include <t8_forest.h>
+#include <t8_forest_boundary.h>
+#include <t8_cmesh.h>
+
+/* In this test we construct the boundary forest of adapted and partitioned
+ * hypercube forests. We check that each boundary face of a volume element
+ * is exactly one boundary element, that the boundary element lies at the
+ * position of this face and that each process keeps the number of boundary
+ * faces of its volume elements.
+ */
+
+static int
+t8_test_boundary_adapt (t8_forest_t forest, t8_forest_t forest_from,
+                        t8_locidx_t which_tree, t8_locidx_t lelement_id,
+                        t8_eclass_scheme_c * ts, int num_elements,
+                        t8_element_t * elements[])
+{
+  return lelement_id % 3 == 0 && ts->t8_element_level (elements[0]) < 3;
+}
+
+static void
+t8_test_boundary (t8_eclass_t eclass, int level)
+{
+  t8_forest_t         forest, forest_adapt, boundary, boundary_partition;
+  t8_cmesh_t          cmesh;
+  t8_locidx_t         itree, ielement, element_id;
+  t8_locidx_t         lctree;
+  t8_gloidx_t         global_num_elements, global_id, *first_ids;
+  t8_gloidx_t         local_num_faces;
+  t8_gloidx_t         first_id, global_num_faces;
+  t8_eclass_scheme_c *ts;
+  t8_element_t       *element;
+  t8_forest_boundary_face_t *volume;
+  sc_array_t          face_to_volume;
+  double             *centroids, *all_centroids, *hits, *all_hits;
+  double             *vertices, centroid[3];
+  size_t              index;
+  int                 iface, i, mpirank, mpisize, mpiret;
+
+  t8_global_productionf ("Testing boundary forest for %s level %i\n",
+                         t8_eclass_to_string[eclass], level);
+  mpiret = sc_MPI_Comm_rank (sc_MPI_COMM_WORLD, &mpirank);
+  SC_CHECK_MPI (mpiret);
+  mpiret = sc_MPI_Comm_size (sc_MPI_COMM_WORLD, &mpisize);
+  SC_CHECK_MPI (mpiret);
+  cmesh = t8_cmesh_new_hypercube (eclass, sc_MPI_COMM_WORLD, 0, 0, 0);
+  forest = t8_forest_new_uniform (cmesh, t8_scheme_new_default_cxx (), level,
+                                  0, sc_MPI_COMM_WORLD);
+  t8_forest_init (&forest_adapt);
+  t8_forest_set_adapt (forest_adapt, forest, t8_test_boundary_adapt, 0);
+  t8_forest_set_partition (forest_adapt, NULL, 0);
+  t8_forest_commit (forest_adapt);
+  forest = forest_adapt;
+  global_num_elements = t8_forest_get_global_num_elements (forest);
+  first_id = t8_forest_get_first_local_element_id (forest);
+  first_ids = T8_ALLOC (t8_gloidx_t, mpisize);
+  mpiret = sc_MPI_Allgather (&first_id, 1, T8_MPI_GLOIDX, first_ids, 1,
+                             T8_MPI_GLOIDX, sc_MPI_COMM_WORLD);
+  SC_CHECK_MPI (mpiret);
+
+  /* Compute the centroid of each boundary face of the volume elements.
+   * Each process fills the entries of its elements. */
+  index = (size_t) global_num_elements * T8_ECLASS_MAX_FACES;
+  centroids = T8_ALLOC_ZERO (double, 3 * index);
+  all_centroids = T8_ALLOC (double, 3 * index);
+  hits = T8_ALLOC_ZERO (double, index);
+  all_hits = T8_ALLOC (double, index);
+  local_num_faces = 0;
+  for (itree = 0, element_id = 0;
+       itree < t8_forest_get_num_local_trees (forest); itree++) {
+    ts = t8_forest_get_eclass_scheme (forest,
+                                      t8_forest_get_tree_class (forest,
+                                                                itree));
+    vertices = t8_forest_get_tree_vertices (forest, itree);
+    lctree = t8_forest_ltreeid_to_cmesh_ltreeid (forest, itree);
+    for (ielement = 0;
+         ielement < t8_forest_get_tree_num_elements (forest, itree);
+         ielement++, element_id++) {
+      element = t8_forest_get_element_in_tree (forest, itree, ielement);
+      for (iface = 0; iface < ts->t8_element_num_faces (element); iface++) {
+        if (!ts->t8_element_is_root_boundary (element, iface)
+            || !t8_cmesh_tree_face_is_boundary (cmesh, lctree,
+                                                ts->t8_element_tree_face
+                                                (element, iface))) {
+          continue;
+        }
+        index = (size_t) (first_id + element_id) * T8_ECLASS_MAX_FACES
+          + iface;
+        t8_forest_element_face_centroid (forest, itree, element, iface,
+                                         vertices, centroids + 3 * index);
+        /* Mark this face as a boundary face */
+        hits[index] = -1;
+        local_num_faces++;
+      }
+    }
+  }
+  index = (size_t) global_num_elements * T8_ECLASS_MAX_FACES;
+  mpiret = sc_MPI_Allreduce (centroids, all_centroids, 3 * index,
+                             sc_MPI_DOUBLE, sc_MPI_SUM, sc_MPI_COMM_WORLD);
+  SC_CHECK_MPI (mpiret);
+
+  /* Construct the boundary forest */
+  sc_array_init (&face_to_volume, sizeof (t8_forest_boundary_face_t));
+  boundary = t8_forest_new_boundary (forest, &face_to_volume);
+  SC_CHECK_ABORT ((t8_gloidx_t) t8_forest_get_local_num_elements (boundary)
+                  == local_num_faces,
+                  "Wrong number of local boundary elements.");
+  SC_CHECK_ABORT (face_to_volume.elem_count == (size_t) local_num_faces,
+                  "Wrong size of the face to volume map.");
+  mpiret = sc_MPI_Allreduce (&local_num_faces, &global_num_faces, 1,
+                             T8_MPI_GLOIDX, sc_MPI_SUM, sc_MPI_COMM_WORLD);
+  SC_CHECK_MPI (mpiret);
+  SC_CHECK_ABORT (t8_forest_get_global_num_elements (boundary) ==
+                  global_num_faces,
+                  "Wrong number of global boundary elements.");
+
+  /* Check the position of each boundary element and count how often
+   * each volume face is hit */
+  for (itree = 0, element_id = 0;
+       itree < t8_forest_get_num_local_trees (boundary); itree++) {
+    SC_CHECK_ABORT (t8_eclass_to_dimension[t8_forest_get_tree_class
+                                           (boundary, itree)]
+                    == t8_eclass_to_dimension[eclass] - 1,
+                    "Wrong dimension of boundary tree.");
+    vertices = t8_forest_get_tree_vertices (boundary, itree);
+    for (ielement = 0;
+         ielement < t8_forest_get_tree_num_elements (boundary, itree);
+         ielement++, element_id++) {
+      element = t8_forest_get_element_in_tree (boundary, itree, ielement);
+      volume = (t8_forest_boundary_face_t *)
+        sc_array_index (&face_to_volume, element_id);
+      SC_CHECK_ABORT (0 <= volume->volume_rank
+                      && volume->volume_rank < mpisize,
+                      "Invalid volume process.");
+      global_id = first_ids[volume->volume_rank] + volume->volume_element;
+      SC_CHECK_ABORT (0 <= global_id && global_id < global_num_elements,
+                      "Invalid volume element.");
+      index = (size_t) global_id * T8_ECLASS_MAX_FACES + volume->volume_face;
+      t8_forest_element_centroid (boundary, itree, element, vertices,
+                                  centroid);
+      for (i = 0; i < 3; i++) {
+        SC_CHECK_ABORT (fabs (centroid[i] - all_centroids[3 * index + i])
+                        < 1e-12, "Wrong position of boundary element.");
+      }
+      hits[index] += 1;
+    }
+  }
+  index = (size_t) global_num_elements * T8_ECLASS_MAX_FACES;
+  mpiret = sc_MPI_Allreduce (hits, all_hits, index, sc_MPI_DOUBLE,
+                             sc_MPI_SUM, sc_MPI_COMM_WORLD);
+  SC_CHECK_MPI (mpiret);
+  for (index = 0; index < (size_t) global_num_elements * T8_ECLASS_MAX_FACES;
+       index++) {
+    /* A boundary face contributes -1 and must be hit once */
+    SC_CHECK_ABORT (all_hits[index] == 0,
+                    "Boundary face is not exactly one boundary element.");
+  }
+
+  /* The boundary forest can be partitioned as any other forest */
+  t8_forest_init (&boundary_partition);
+  t8_forest_set_partition (boundary_partition, boundary, 0);
+  t8_forest_commit (boundary_partition);
+  boundary = boundary_partition;
+  SC_CHECK_ABORT (t8_forest_get_global_num_elements (boundary) ==
+                  global_num_faces,
+                  "Wrong number of boundary elements after partition.");
+
+  t8_forest_unref (&boundary);
+  t8_forest_unref (&forest);
+  sc_array_reset (&face_to_volume);
+  T8_FREE (first_ids);
+  T8_FREE (centroids);
+  T8_FREE (all_centroids);
+  T8_FREE (hits);
+  T8_FREE (all_hits);
+}
+
+/* The boundary forest of a periodic mesh is empty */
+static void
+t8_test_boundary_periodic (int dim, int level)
+{
+  t8_forest_t         forest, boundary;
+  sc_array_t          face_to_volume;
+
+  t8_global_productionf ("Testing boundary forest for periodic dim %i\n",
+                         dim);
+  forest = t8_forest_new_uniform (t8_cmesh_new_periodic (sc_MPI_COMM_WORLD,
+                                                         dim),
+                                  t8_scheme_new_default_cxx (), level, 0,
+                                  sc_MPI_COMM_WORLD);
+  sc_array_init (&face_to_volume, sizeof (t8_forest_boundary_face_t));
+  /* Fill the map to check that it is emptied */
+  sc_array_resize (&face_to_volume, 3);
+  boundary = t8_forest_new_boundary (forest, &face_to_volume);
+  SC_CHECK_ABORT (t8_forest_get_global_num_elements (boundary) == 0,
+                  "Boundary forest of a periodic mesh is not empty.");
+  SC_CHECK_ABORT (t8_forest_get_num_local_trees (boundary) == 0,
+                  "Boundary forest of a periodic mesh has trees.");
+  SC_CHECK_ABORT (face_to_volume.elem_count == 0,
+                  "Face to volume map of a periodic mesh is not empty.");
+
+  t8_forest_unref (&boundary);
+  t8_forest_unref (&forest);
+  sc_array_reset (&face_to_volume);
+}
+
+int
+main (int argc, char **argv)
+{
+  int                 mpiret;
+
+  mpiret = sc_MPI_Init (&argc, &argv);
+  SC_CHECK_MPI (mpiret);
+
+  sc_init (sc_MPI_COMM_WORLD, 1, 1, NULL, SC_LP_ESSENTIAL);
+  p4est_init (NULL, SC_LP_ESSENTIAL);
+  t8_init (SC_LP_DEFAULT);
+
+  t8_test_boundary (T8_ECLASS_QUAD, 2);
+  t8_test_boundary (T8_ECLASS_TRIANGLE, 2);
+  t8_test_boundary (T8_ECLASS_HEX, 1);
+  t8_test_boundary (T8_ECLASS_TET, 1);
+  t8_test_boundary (T8_ECLASS_PRISM, 1);
+  t8_test_boundary_periodic (2, 2);
+  t8_test_boundary_periodic (3, 1);
+
+  sc_finalize ();
+
+  mpiret = sc_MPI_Finalize ();
+  SC_CHECK_MPI (mpiret);
+
+  return 0;
+}
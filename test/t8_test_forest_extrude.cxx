@@ -0,0 +1,217 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#include <t8_eclass.h>
+#include <t8_schemes/t8_default_cxx.hxx>
+#include <t8_forest.h>
+#include <t8_forest_extrude.h>
+#include <t8_cmesh.h>
+
+/* In this test we extrude adapted and partitioned two dimensional forests.
+ * We check that each element of level L of the two dimensional forest is
+ * the projection of exactly 2^L extruded elements of level L in each layer,
+ * that each process keeps the number of extruded elements of its columns
+ * and that the extruded forest can be partitioned and have ghosts. */
+
+static int
+t8_test_extrude_adapt (t8_forest_t forest, t8_forest_t forest_from,
+                       t8_locidx_t which_tree, t8_locidx_t lelement_id,
+                       t8_eclass_scheme_c * ts, int num_elements,
+                       t8_element_t * elements[])
+{
+  return lelement_id % 3 == 0 && ts->t8_element_level (elements[0]) < 3;
+}
+
+/* Find the element with the given centroid in the x-y plane */
+static              t8_gloidx_t
+t8_test_extrude_find (const double *centroids, t8_gloidx_t num_elements,
+                      const double *centroid)
+{
+  t8_gloidx_t         ielement;
+
+  for (ielement = 0; ielement < num_elements; ielement++) {
+    if (fabs (centroids[3 * ielement] - centroid[0]) < 1e-12
+        && fabs (centroids[3 * ielement + 1] - centroid[1]) < 1e-12) {
+      return ielement;
+    }
+  }
+  return -1;
+}
+
+static void
+t8_test_extrude (t8_cmesh_t cmesh, int level, int num_layers,
+                 const double *layer_z, int do_ghost)
+{
+  t8_forest_t         forest, forest_adapt, extruded, extruded_partition;
+  t8_locidx_t         itree, ielement, element_id;
+  t8_gloidx_t         global_num_elements, first_id, global_id;
+  t8_gloidx_t         num_columns, global_num_columns;
+  t8_eclass_scheme_c *ts;
+  t8_element_t       *element;
+  double             *centroids, *all_centroids, *hits, *all_hits;
+  double             *vertices, centroid[3], bottom, top;
+  int                 mpiret, elevel, layer;
+
+  t8_global_productionf ("Testing extrusion of level %i with %i layers\n",
+                         level, num_layers);
+  forest = t8_forest_new_uniform (cmesh, t8_scheme_new_default_cxx (), level,
+                                  0, sc_MPI_COMM_WORLD);
+  t8_forest_init (&forest_adapt);
+  t8_forest_set_adapt (forest_adapt, forest, t8_test_extrude_adapt, 0);
+  t8_forest_set_partition (forest_adapt, NULL, 0);
+  t8_forest_commit (forest_adapt);
+  forest = forest_adapt;
+  global_num_elements = t8_forest_get_global_num_elements (forest);
+  first_id = t8_forest_get_first_local_element_id (forest);
+
+  /* Compute the centroid and the level of each element.
+   * Each process fills the entries of its elements. We store the level
+   * in the third coordinate, since the forest lies in the x-y plane. */
+  centroids = T8_ALLOC_ZERO (double, 3 * global_num_elements);
+  all_centroids = T8_ALLOC (double, 3 * global_num_elements);
+  hits = T8_ALLOC_ZERO (double, global_num_elements);
+  all_hits = T8_ALLOC (double, global_num_elements);
+  num_columns = 0;
+  for (itree = 0, element_id = 0;
+       itree < t8_forest_get_num_local_trees (forest); itree++) {
+    ts = t8_forest_get_eclass_scheme (forest,
+                                      t8_forest_get_tree_class (forest,
+                                                                itree));
+    vertices = t8_forest_get_tree_vertices (forest, itree);
+    for (ielement = 0;
+         ielement < t8_forest_get_tree_num_elements (forest, itree);
+         ielement++, element_id++) {
+      element = t8_forest_get_element_in_tree (forest, itree, ielement);
+      global_id = first_id + element_id;
+      elevel = ts->t8_element_level (element);
+      t8_forest_element_centroid (forest, itree, element, vertices,
+                                  centroids + 3 * global_id);
+      centroids[3 * global_id + 2] = elevel;
+      /* The column of the element must be hit once by each of its
+       * extruded elements */
+      hits[global_id] = -num_layers * (double) (1 << elevel);
+      num_columns += (t8_gloidx_t) 1 << elevel;
+    }
+  }
+  mpiret = sc_MPI_Allreduce (centroids, all_centroids,
+                             3 * global_num_elements, sc_MPI_DOUBLE,
+                             sc_MPI_SUM, sc_MPI_COMM_WORLD);
+  SC_CHECK_MPI (mpiret);
+  mpiret = sc_MPI_Allreduce (&num_columns, &global_num_columns, 1,
+                             T8_MPI_GLOIDX, sc_MPI_SUM, sc_MPI_COMM_WORLD);
+  SC_CHECK_MPI (mpiret);
+
+  /* Extrude the forest */
+  extruded = t8_forest_new_extrude (forest, num_layers, layer_z);
+  SC_CHECK_ABORT ((t8_gloidx_t) t8_forest_get_local_num_elements (extruded)
+                  == num_layers * num_columns,
+                  "Wrong number of local extruded elements.");
+  SC_CHECK_ABORT (t8_forest_get_global_num_elements (extruded) ==
+                  num_layers * global_num_columns,
+                  "Wrong number of global extruded elements.");
+
+  /* Find the column of each extruded element and check its level and
+   * its layer */
+  for (itree = 0; itree < t8_forest_get_num_local_trees (extruded); itree++) {
+    SC_CHECK_ABORT (t8_eclass_to_dimension[t8_forest_get_tree_class
+                                           (extruded, itree)] == 3,
+                    "Wrong dimension of extruded tree.");
+    ts = t8_forest_get_eclass_scheme (extruded,
+                                      t8_forest_get_tree_class (extruded,
+                                                                itree));
+    vertices = t8_forest_get_tree_vertices (extruded, itree);
+    layer = (int) (t8_forest_global_tree_id (extruded, itree) % num_layers);
+    bottom = layer_z != NULL ? layer_z[layer] : (double) layer / num_layers;
+    top = layer_z != NULL ? layer_z[layer + 1]
+      : (double) (layer + 1) / num_layers;
+    for (ielement = 0;
+         ielement < t8_forest_get_tree_num_elements (extruded, itree);
+         ielement++) {
+      element = t8_forest_get_element_in_tree (extruded, itree, ielement);
+      t8_forest_element_centroid (extruded, itree, element, vertices,
+                                  centroid);
+      global_id = t8_test_extrude_find (all_centroids, global_num_elements,
+                                        centroid);
+      SC_CHECK_ABORT (global_id >= 0, "Extruded element has no column.");
+      SC_CHECK_ABORT (all_centroids[3 * global_id + 2] ==
+                      ts->t8_element_level (element),
+                      "Wrong level of extruded element.");
+      SC_CHECK_ABORT (bottom < centroid[2] && centroid[2] < top,
+                      "Extruded element is not in its layer.");
+      hits[global_id] += 1;
+    }
+  }
+  mpiret = sc_MPI_Allreduce (hits, all_hits, global_num_elements,
+                             sc_MPI_DOUBLE, sc_MPI_SUM, sc_MPI_COMM_WORLD);
+  SC_CHECK_MPI (mpiret);
+  for (global_id = 0; global_id < global_num_elements; global_id++) {
+    SC_CHECK_ABORT (all_hits[global_id] == 0,
+                    "Column does not have the right number of elements.");
+  }
+
+  /* The extruded forest can be partitioned as any other forest */
+  t8_forest_init (&extruded_partition);
+  t8_forest_set_partition (extruded_partition, extruded, 0);
+  t8_forest_set_ghost (extruded_partition, do_ghost, T8_GHOST_FACES);
+  t8_forest_commit (extruded_partition);
+  extruded = extruded_partition;
+  SC_CHECK_ABORT (t8_forest_get_global_num_elements (extruded) ==
+                  num_layers * global_num_columns,
+                  "Wrong number of extruded elements after partition.");
+
+  t8_forest_unref (&extruded);
+  t8_forest_unref (&forest);
+  T8_FREE (centroids);
+  T8_FREE (all_centroids);
+  T8_FREE (hits);
+  T8_FREE (all_hits);
+}
+
+int
+main (int argc, char **argv)
+{
+  double              layer_z[4] = { -1, -0.5, 0.25, 2 };
+  t8_cmesh_t          cmesh;
+  int                 mpiret;
+
+  mpiret = sc_MPI_Init (&argc, &argv);
+  SC_CHECK_MPI (mpiret);
+
+  sc_init (sc_MPI_COMM_WORLD, 1, 1, NULL, SC_LP_ESSENTIAL);
+  p4est_init (NULL, SC_LP_ESSENTIAL);
+  t8_init (SC_LP_DEFAULT);
+
+  cmesh = t8_cmesh_new_hypercube (T8_ECLASS_QUAD, sc_MPI_COMM_WORLD, 0, 0, 0);
+  t8_test_extrude (cmesh, 2, 1, NULL, 1);
+  cmesh = t8_cmesh_new_hypercube (T8_ECLASS_TRIANGLE, sc_MPI_COMM_WORLD, 0, 0,
+                                  0);
+  t8_test_extrude (cmesh, 2, 2, NULL, 1);
+  cmesh = t8_cmesh_new_periodic_hybrid (sc_MPI_COMM_WORLD);
+  t8_test_extrude (cmesh, 1, 3, layer_z, 1);
+
+  sc_finalize ();
+
+  mpiret = sc_MPI_Finalize ();
+  SC_CHECK_MPI (mpiret);
+
+  return 0;
+}
@@ -0,0 +1,167 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#include <t8_eclass.h>
+#include <t8_schemes/t8_default_cxx.hxx>
+#include <t8_forest.h>
+#include <t8_forest_indicator.h>
+#include <t8_cmesh.h>
+
+/* In this test we compute global quantiles of an element indicator and
+ * compare them to the values obtained by sorting all indicators.
+ * We then compute refine and coarsen markers and check that adapting
+ * a forest with these markers refines the marked elements.
+ */
+
+/* A pseudo random indicator with many equal values */
+static double
+t8_test_indicator_value (t8_gloidx_t global_id)
+{
+  return (double) ((global_id * 7919 + 13) % 1009);
+}
+
+static int
+t8_test_indicator_compare (const void *a, const void *b)
+{
+  const double        value_a = *(const double *) a;
+  const double        value_b = *(const double *) b;
+
+  return value_a < value_b ? -1 : value_a > value_b;
+}
+
+static void
+t8_test_indicator (t8_eclass_t eclass, int level)
+{
+  t8_forest_t         forest, forest_adapt;
+  t8_locidx_t         num_elements, ielement;
+  t8_gloidx_t         global_num_elements, first_id, k;
+  t8_gloidx_t         local_num_refine, num_refine;
+  double             *indicator, *all_indicators, quantile, threshold;
+  int                *markers;
+  int                 ifraction, mpiret;
+  const double        fractions[5] = { 0, 0.1, 0.5, 0.9, 1 };
+
+  t8_global_productionf ("Testing indicator quantiles for %s level %i\n",
+                         t8_eclass_to_string[eclass], level);
+  forest =
+    t8_forest_new_uniform (t8_cmesh_new_hypercube
+                           (eclass, sc_MPI_COMM_WORLD, 0, 0, 0),
+                           t8_scheme_new_default_cxx (), level, 0,
+                           sc_MPI_COMM_WORLD);
+  num_elements = t8_forest_get_local_num_elements (forest);
+  global_num_elements = t8_forest_get_global_num_elements (forest);
+  first_id = t8_forest_get_first_local_element_id (forest);
+  indicator = T8_ALLOC (double, num_elements);
+  for (ielement = 0; ielement < num_elements; ielement++) {
+    indicator[ielement] = t8_test_indicator_value (first_id + ielement);
+  }
+  /* All indicators, sorted */
+  all_indicators = T8_ALLOC (double, global_num_elements);
+  for (k = 0; k < global_num_elements; k++) {
+    all_indicators[k] = t8_test_indicator_value (k);
+  }
+  qsort (all_indicators, global_num_elements, sizeof (double),
+         t8_test_indicator_compare);
+
+  /* Check the selection */
+  for (k = 0; k < global_num_elements; k += global_num_elements / 7 + 1) {
+    SC_CHECK_ABORT (t8_forest_indicator_select (sc_MPI_COMM_WORLD, indicator,
+                                                num_elements, k)
+                    == all_indicators[k], "Wrong selected value.");
+  }
+  for (ifraction = 0; ifraction < 5; ifraction++) {
+    quantile = t8_forest_indicator_quantile (forest, indicator,
+                                             fractions[ifraction]);
+    k = (t8_gloidx_t) ceil (fractions[ifraction] * global_num_elements) - 1;
+    k = SC_MAX (0, k);
+    SC_CHECK_ABORT (quantile == all_indicators[k], "Wrong quantile.");
+  }
+
+  /* Mark the largest 10% for refinement and check that the marked
+   * elements are refined */
+  markers = T8_ALLOC (int, num_elements);
+  t8_forest_indicator_markers (forest, indicator, 0.1, 0, markers);
+  threshold = all_indicators[global_num_elements
+                             - (t8_gloidx_t) (0.1 * global_num_elements)];
+  local_num_refine = 0;
+  for (ielement = 0; ielement < num_elements; ielement++) {
+    SC_CHECK_ABORT (markers[ielement] == (indicator[ielement] >= threshold),
+                    "Wrong refine marker.");
+    local_num_refine += markers[ielement];
+  }
+  mpiret = sc_MPI_Allreduce (&local_num_refine, &num_refine, 1,
+                             T8_MPI_GLOIDX, sc_MPI_SUM, sc_MPI_COMM_WORLD);
+  SC_CHECK_MPI (mpiret);
+  SC_CHECK_ABORT (num_refine >= (t8_gloidx_t) (0.1 * global_num_elements),
+                  "Too few elements marked for refinement.");
+  t8_forest_ref (forest);
+  forest_adapt = t8_forest_new_adapt (forest, t8_forest_indicator_adapt, 0,
+                                      0, markers);
+  SC_CHECK_ABORT (t8_forest_get_global_num_elements (forest_adapt)
+                  == global_num_elements
+                  + num_refine * ((1 << t8_eclass_to_dimension[eclass]) - 1),
+                  "Wrong number of elements after refinement.");
+  t8_forest_unref (&forest_adapt);
+
+  /* Mark all elements for coarsening. Since the partition is not
+   * aligned with the families, at most the families that are split
+   * across processes are kept. */
+  t8_forest_indicator_markers (forest, indicator, 0, 1, markers);
+  for (ielement = 0; ielement < num_elements; ielement++) {
+    SC_CHECK_ABORT (markers[ielement] == -1, "Wrong coarsen marker.");
+  }
+  forest_adapt = t8_forest_new_adapt (forest, t8_forest_indicator_adapt, 0,
+                                      0, markers);
+  SC_CHECK_ABORT (t8_forest_get_global_num_elements (forest_adapt)
+                  < global_num_elements, "No elements were coarsened.");
+  t8_forest_unref (&forest_adapt);
+
+  T8_FREE (indicator);
+  T8_FREE (all_indicators);
+  T8_FREE (markers);
+}
+
+int
+main (int argc, char **argv)
+{
+  int                 mpiret;
+
+  mpiret = sc_MPI_Init (&argc, &argv);
+  SC_CHECK_MPI (mpiret);
+
+  sc_init (sc_MPI_COMM_WORLD, 1, 1, NULL, SC_LP_ESSENTIAL);
+  p4est_init (NULL, SC_LP_ESSENTIAL);
+  t8_init (SC_LP_DEFAULT);
+
+  /* Small forests are selected by gathering the values,
+   * large forests need several rounds of the distributed selection */
+  t8_test_indicator (T8_ECLASS_QUAD, 3);
+  t8_test_indicator (T8_ECLASS_TRIANGLE, 7);
+  t8_test_indicator (T8_ECLASS_HEX, 5);
+
+  sc_finalize ();
+
+  mpiret = sc_MPI_Finalize ();
+  SC_CHECK_MPI (mpiret);
+
+  return 0;
+}
@@ -0,0 +1,147 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#include <t8_eclass.h>
+#include <t8_schemes/t8_default_cxx.hxx>
+#include <t8_forest.h>
+#include <t8_forest/t8_forest_types.h>
+#include <t8_cmesh.h>
+
+/* In this test we check that forests with the same partition can share
+ * their partition metadata and ghost layer.
+ * We build two uniform forests of the same level on the same cmesh, let the
+ * second share the metadata of the first, destroy the first and check that
+ * the ghost layer of the second one is still usable.
+ * We also check that forests of different levels do not share their
+ * metadata.
+ */
+
+/* Exchange the global ids of the elements and check whether each ghost
+ * received the global id of its element. */
+static void
+t8_test_share_partition_exchange (t8_forest_t forest)
+{
+  sc_array_t          element_data;
+  t8_locidx_t         num_elements, ielem, num_ghosts;
+  t8_gloidx_t         first_element_id, ghost_id;
+
+  num_elements = t8_forest_get_local_num_elements (forest);
+  num_ghosts = t8_forest_get_num_ghosts (forest);
+  sc_array_init_size (&element_data, sizeof (t8_gloidx_t),
+                      num_elements + num_ghosts);
+  first_element_id = t8_forest_get_first_local_element_id (forest);
+  for (ielem = 0; ielem < num_elements; ielem++) {
+    *(t8_gloidx_t *) t8_sc_array_index_locidx (&element_data, ielem) =
+      first_element_id + ielem;
+  }
+  t8_forest_ghost_exchange_data (forest, &element_data);
+  for (ielem = 0; ielem < num_ghosts; ielem++) {
+    ghost_id = *(t8_gloidx_t *) t8_sc_array_index_locidx (&element_data,
+                                                          num_elements +
+                                                          ielem);
+    SC_CHECK_ABORT (0 <= ghost_id
+                    && ghost_id < t8_forest_get_global_num_elements (forest)
+                    && (ghost_id < first_element_id
+                        || ghost_id >= first_element_id + num_elements),
+                    "Received wrong ghost data.");
+  }
+  sc_array_reset (&element_data);
+}
+
+static void
+t8_test_share_partition (t8_eclass_t eclass, int level, int check)
+{
+  t8_cmesh_t          cmesh;
+  t8_scheme_cxx_t    *scheme;
+  t8_forest_t         forest, forest_share, forest_finer;
+  int                 retval;
+
+  t8_global_productionf ("Testing shared partition for %s level %i\n",
+                         t8_eclass_to_string[eclass], level);
+  scheme = t8_scheme_new_default_cxx ();
+  cmesh = t8_cmesh_new_hypercube (eclass, sc_MPI_COMM_WORLD, 0, 0, 0);
+  /* The cmesh and scheme are used by three forests */
+  t8_cmesh_ref (cmesh);
+  t8_cmesh_ref (cmesh);
+  t8_scheme_cxx_ref (scheme);
+  t8_scheme_cxx_ref (scheme);
+  forest = t8_forest_new_uniform (cmesh, scheme, level, 1, sc_MPI_COMM_WORLD);
+  forest_share = t8_forest_new_uniform (cmesh, scheme, level, 1,
+                                        sc_MPI_COMM_WORLD);
+  forest_finer = t8_forest_new_uniform (cmesh, scheme, level + 1, 1,
+                                        sc_MPI_COMM_WORLD);
+
+  SC_CHECK_ABORT (t8_forest_partition_is_equal (forest, forest_share),
+                  "Partitions of equal forests are not equal.");
+  retval = t8_forest_share_partition (forest_share, forest, check);
+  SC_CHECK_ABORT (retval, "Could not share the partition.");
+  SC_CHECK_ABORT (forest_share->element_offsets == forest->element_offsets
+                  && forest_share->tree_offsets == forest->tree_offsets
+                  && forest_share->global_first_desc ==
+                  forest->global_first_desc,
+                  "Partition metadata is not shared.");
+  SC_CHECK_ABORT (forest_share->ghosts == forest->ghosts,
+                  "Ghost layer is not shared.");
+
+  /* A finer forest has a different partition */
+  SC_CHECK_ABORT (!t8_forest_partition_is_equal (forest, forest_finer),
+                  "Partitions of different forests are equal.");
+  if (check) {
+    retval = t8_forest_share_partition (forest_finer, forest, check);
+    SC_CHECK_ABORT (!retval, "Shared the partition of a different forest.");
+    SC_CHECK_ABORT (forest_finer->element_offsets != forest->element_offsets,
+                    "Partition metadata of a different forest is shared.");
+  }
+
+  /* The shared metadata must survive the destruction of its creator */
+  t8_forest_unref (&forest);
+  t8_test_share_partition_exchange (forest_share);
+  t8_test_share_partition_exchange (forest_finer);
+  t8_forest_unref (&forest_share);
+  t8_forest_unref (&forest_finer);
+}
+
+int
+main (int argc, char **argv)
+{
+  int                 mpiret;
+  int                 eclass;
+
+  mpiret = sc_MPI_Init (&argc, &argv);
+  SC_CHECK_MPI (mpiret);
+
+  sc_init (sc_MPI_COMM_WORLD, 1, 1, NULL, SC_LP_ESSENTIAL);
+  p4est_init (NULL, SC_LP_ESSENTIAL);
+  t8_init (SC_LP_DEFAULT);
+
+  for (eclass = T8_ECLASS_LINE; eclass <= T8_ECLASS_HEX; eclass++) {
+    t8_test_share_partition ((t8_eclass_t) eclass, 2, 1);
+    t8_test_share_partition ((t8_eclass_t) eclass, 2, 0);
+  }
+
+  sc_finalize ();
+
+  mpiret = sc_MPI_Finalize ();
+  SC_CHECK_MPI (mpiret);
+
+  return 0;
+}
@@ -0,0 +1,268 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#include <t8_eclass.h>
+#include <t8_schemes/t8_default_cxx.hxx>
+#include <t8_forest.h>
+#include <t8_forest/t8_forest_types.h>
+#include <t8_cmesh.h>
+
+/* In this test we check that an adaptation that does not change any element
+ * is detected. The adapted forest must have the same elements as its source
+ * and reference its partition and ghost layer. Partition and balance must
+ * be skipped for a partitioned and balanced source and must be carried out
+ * for a source that is not partitioned or with element weights.
+ * We also check that a change on a single process is detected by all
+ * processes.
+ */
+
+/* Refine the first element of the first tree on the process given by the
+ * user data of the forest. If the user data is NULL, keep all elements. */
+static int
+t8_test_unchanged_adapt (t8_forest_t forest, t8_forest_t forest_from,
+                         t8_locidx_t which_tree, t8_locidx_t lelement_id,
+                         t8_eclass_scheme_c * ts, int num_elements,
+                         t8_element_t * elements[])
+{
+  int                *refine_rank;
+
+  refine_rank = (int *) t8_forest_get_user_data (forest);
+  if (refine_rank != NULL && forest->mpirank == *refine_rank
+      && which_tree == 0 && lelement_id == 0) {
+    return 1;
+  }
+  return 0;
+}
+
+/* Adapt a forest and possibly partition, balance and create ghosts */
+static              t8_forest_t
+t8_test_unchanged_new_adapt (t8_forest_t forest_from, int *refine_rank,
+                             int recursive, int do_partition, int do_balance)
+{
+  t8_forest_t         forest;
+
+  t8_forest_init (&forest);
+  t8_forest_set_user_data (forest, refine_rank);
+  t8_forest_set_adapt (forest, forest_from, t8_test_unchanged_adapt,
+                       recursive);
+  if (do_partition) {
+    t8_forest_set_partition (forest, NULL, 0);
+  }
+  if (do_balance) {
+    t8_forest_set_balance (forest, NULL, 0);
+  }
+  t8_forest_set_ghost (forest, 1, T8_GHOST_FACES);
+  t8_forest_commit (forest);
+  return forest;
+}
+
+/* Give the first element of each tree a larger weight */
+static double
+t8_test_unchanged_weight (t8_forest_t forest, t8_forest_t forest_from,
+                          t8_locidx_t which_tree, t8_locidx_t lelement_id,
+                          t8_eclass_scheme_c * ts,
+                          const t8_element_t * element)
+{
+  return lelement_id == 0 ? 10 : 1;
+}
+
+/* Exchange the global ids of the elements and check whether each ghost
+ * received the global id of a remote element. */
+static void
+t8_test_unchanged_exchange (t8_forest_t forest)
+{
+  sc_array_t          element_data;
+  t8_locidx_t         num_elements, ielem, num_ghosts;
+  t8_gloidx_t         first_element_id, ghost_id;
+
+  num_elements = t8_forest_get_local_num_elements (forest);
+  num_ghosts = t8_forest_get_num_ghosts (forest);
+  sc_array_init_size (&element_data, sizeof (t8_gloidx_t),
+                      num_elements + num_ghosts);
+  first_element_id = t8_forest_get_first_local_element_id (forest);
+  for (ielem = 0; ielem < num_elements; ielem++) {
+    *(t8_gloidx_t *) t8_sc_array_index_locidx (&element_data, ielem) =
+      first_element_id + ielem;
+  }
+  t8_forest_ghost_exchange_data (forest, &element_data);
+  for (ielem = 0; ielem < num_ghosts; ielem++) {
+    ghost_id = *(t8_gloidx_t *) t8_sc_array_index_locidx (&element_data,
+                                                          num_elements +
+                                                          ielem);
+    SC_CHECK_ABORT (0 <= ghost_id
+                    && ghost_id < t8_forest_get_global_num_elements (forest)
+                    && (ghost_id < first_element_id
+                        || ghost_id >= first_element_id + num_elements),
+                    "Received wrong ghost data.");
+  }
+  sc_array_reset (&element_data);
+}
+
+static void
+t8_test_unchanged (t8_eclass_t eclass, int level)
+{
+  t8_cmesh_t          cmesh;
+  t8_scheme_cxx_t    *scheme;
+  t8_forest_t         forest, forest_compare, forest_adapt;
+  t8_forest_t         forest_partition;
+  int                 recursive, refine_rank, mpisize, mpiret;
+
+  t8_global_productionf ("Testing unchanged adaptation for %s level %i\n",
+                         t8_eclass_to_string[eclass], level);
+  mpiret = sc_MPI_Comm_size (sc_MPI_COMM_WORLD, &mpisize);
+  SC_CHECK_MPI (mpiret);
+  scheme = t8_scheme_new_default_cxx ();
+  cmesh = t8_cmesh_new_hypercube (eclass, sc_MPI_COMM_WORLD, 0, 0, 0);
+  t8_cmesh_ref (cmesh);
+  t8_scheme_cxx_ref (scheme);
+  forest = t8_forest_new_uniform (cmesh, scheme, level, 1, sc_MPI_COMM_WORLD);
+  forest_compare = t8_forest_new_uniform (cmesh, scheme, level, 0,
+                                          sc_MPI_COMM_WORLD);
+
+  for (recursive = 0; recursive < 2; recursive++) {
+    /* Keep all elements of a uniform forest. Partition and balance are
+     * skipped and the partition and ghosts are shared. */
+    t8_forest_ref (forest);
+    forest_adapt = t8_test_unchanged_new_adapt (forest, NULL, recursive,
+                                                1, 1);
+    SC_CHECK_ABORT (t8_forest_is_unchanged (forest_adapt),
+                    "Unchanged adaptation was not detected.");
+    SC_CHECK_ABORT (t8_forest_is_equal (forest_adapt, forest_compare),
+                    "Unchanged adaptation changed the elements.");
+    SC_CHECK_ABORT (forest_adapt->element_offsets == forest->element_offsets
+                    && forest_adapt->tree_offsets == forest->tree_offsets
+                    && forest_adapt->global_first_desc ==
+                    forest->global_first_desc,
+                    "Partition of unchanged adaptation is not shared.");
+    SC_CHECK_ABORT (forest_adapt->ghosts == forest->ghosts,
+                    "Ghosts of unchanged adaptation are not shared.");
+    SC_CHECK_ABORT (forest_adapt->is_partitioned
+                    && forest_adapt->is_balanced,
+                    "Unchanged adaptation is not partitioned and balanced.");
+    t8_test_unchanged_exchange (forest_adapt);
+
+    /* Adapt without keeping the source. Its elements are taken over. */
+    forest_adapt = t8_test_unchanged_new_adapt (forest_adapt, NULL,
+                                                recursive, 0, 0);
+    SC_CHECK_ABORT (t8_forest_is_unchanged (forest_adapt),
+                    "Unchanged adaptation was not detected.");
+    SC_CHECK_ABORT (t8_forest_is_equal (forest_adapt, forest_compare),
+                    "Unchanged adaptation changed the elements.");
+    t8_test_unchanged_exchange (forest_adapt);
+    t8_forest_unref (&forest_adapt);
+  }
+
+  /* Refine one element on the last process. All processes must detect
+   * the change. */
+  refine_rank = mpisize - 1;
+  t8_forest_ref (forest);
+  forest_adapt = t8_test_unchanged_new_adapt (forest, &refine_rank, 0, 0, 0);
+  SC_CHECK_ABORT (!t8_forest_is_unchanged (forest_adapt),
+                  "Change on one process was not detected.");
+  SC_CHECK_ABORT (t8_forest_get_global_num_elements (forest_adapt) >
+                  t8_forest_get_global_num_elements (forest),
+                  "Wrong number of elements after adaptation.");
+  SC_CHECK_ABORT (!forest_adapt->is_partitioned
+                  && !forest_adapt->is_balanced,
+                  "Changed forest is marked as partitioned or balanced.");
+
+  /* An unchanged adaptation of a forest that is not partitioned has to be
+   * partitioned. */
+  t8_forest_ref (forest_adapt);
+  forest_partition = t8_test_unchanged_new_adapt (forest_adapt, NULL, 0,
+                                                  1, 0);
+  SC_CHECK_ABORT (forest_partition->is_partitioned,
+                  "Forest was not partitioned.");
+  SC_CHECK_ABORT (t8_forest_get_global_num_elements (forest_partition) ==
+                  t8_forest_get_global_num_elements (forest_adapt),
+                  "Wrong number of elements after partition.");
+  t8_test_unchanged_exchange (forest_partition);
+  t8_forest_unref (&forest_partition);
+
+  /* Now partition and balance the adapted forest. An unchanged adaptation
+   * of the result is not partitioned or balanced again. */
+  forest_partition = t8_test_unchanged_new_adapt (forest_adapt, NULL, 0,
+                                                  1, 1);
+  SC_CHECK_ABORT (forest_partition->is_partitioned
+                  && forest_partition->is_balanced,
+                  "Forest was not partitioned and balanced.");
+  t8_forest_ref (forest_partition);
+  forest_adapt = t8_test_unchanged_new_adapt (forest_partition, NULL, 1,
+                                              1, 1);
+  SC_CHECK_ABORT (t8_forest_is_unchanged (forest_adapt),
+                  "Unchanged adaptation was not detected.");
+  SC_CHECK_ABORT (t8_forest_is_equal (forest_adapt, forest_partition),
+                  "Unchanged adaptation changed the elements.");
+  SC_CHECK_ABORT (forest_adapt->element_offsets ==
+                  forest_partition->element_offsets,
+                  "Partition of unchanged adaptation is not shared.");
+  t8_forest_unref (&forest_partition);
+  t8_test_unchanged_exchange (forest_adapt);
+
+  /* A partition with element weights is not skipped, since the weights
+   * may have changed. */
+  t8_forest_ref (forest_adapt);
+  t8_forest_init (&forest_partition);
+  t8_forest_set_adapt (forest_partition, forest_adapt,
+                       t8_test_unchanged_adapt, 0);
+  t8_forest_set_partition (forest_partition, NULL, 0);
+  t8_forest_set_partition_weight (forest_partition, t8_test_unchanged_weight,
+                                  NULL);
+  t8_forest_commit (forest_partition);
+  SC_CHECK_ABORT (!forest_partition->is_partitioned
+                  && forest_partition->element_offsets !=
+                  forest_adapt->element_offsets,
+                  "Weighted partition of unchanged adaptation was skipped.");
+  SC_CHECK_ABORT (t8_forest_get_global_num_elements (forest_partition) ==
+                  t8_forest_get_global_num_elements (forest_adapt),
+                  "Wrong number of elements after weighted partition.");
+  t8_forest_unref (&forest_partition);
+
+  t8_forest_unref (&forest_adapt);
+  t8_forest_unref (&forest_compare);
+  t8_forest_unref (&forest);
+}
+
+int
+main (int argc, char **argv)
+{
+  int                 mpiret;
+  int                 eclass;
+
+  mpiret = sc_MPI_Init (&argc, &argv);
+  SC_CHECK_MPI (mpiret);
+
+  sc_init (sc_MPI_COMM_WORLD, 1, 1, NULL, SC_LP_ESSENTIAL);
+  p4est_init (NULL, SC_LP_ESSENTIAL);
+  t8_init (SC_LP_DEFAULT);
+
+  for (eclass = T8_ECLASS_LINE; eclass <= T8_ECLASS_HEX; eclass++) {
+    t8_test_unchanged ((t8_eclass_t) eclass, 2);
+  }
+
+  sc_finalize ();
+
+  mpiret = sc_MPI_Finalize ();
+  SC_CHECK_MPI (mpiret);
+
+  return 0;
+}
@@ -39,6 +39,8 @@
  * coarse meshes.
  * One test is an integer entry '42' for each element,
  * in a second test, we store the element's linear id in the data array.
+ * The linear id test is repeated for a forest whose partition and ghost
+ * elements were sent as compact keys, see t8_forest_set_compact_messages.
  */
 
 static int
@@ -133,6 +135,51 @@ t8_test_ghost_exchange_data_id (t8_forest_t forest)
   sc_array_reset (&element_data);
 }
 
+/* Construct a data array of global ids for all elements and all ghosts,
+ * fill the element's entries with their global id, perform the ghost exchange and
+ * check whether the ghost's entries are the global ids stored in the ghost layer.
+ */
+static void
+t8_test_ghost_exchange_data_global_id (t8_forest_t forest)
+{
+  sc_array_t          element_data;
+  t8_locidx_t         num_elements, ielem, num_ghosts, itree;
+  t8_gloidx_t         first_element_id, ghost_entry;
+  size_t              array_pos;
+
+  num_elements = t8_forest_get_local_num_elements (forest);
+  num_ghosts = t8_forest_get_num_ghosts (forest);
+  /* Allocate a t8_gloidx_t as data for each element and each ghost */
+  sc_array_init_size (&element_data, sizeof (t8_gloidx_t),
+                      num_elements + num_ghosts);
+
+  /* Fill the local element entries with their global id */
+  first_element_id = t8_forest_get_first_local_element_id (forest);
+  for (ielem = 0; ielem < num_elements; ielem++) {
+    *(t8_gloidx_t *) t8_sc_array_index_locidx (&element_data, ielem) =
+      first_element_id + ielem;
+  }
+  /* Perform the ghost data exchange */
+  t8_forest_ghost_exchange_data (forest, &element_data);
+
+  /* Check for the ghosts that we received their global id */
+  array_pos = num_elements;
+  for (itree = 0; itree < t8_forest_get_num_ghost_trees (forest); itree++) {
+    for (ielem = 0; ielem < t8_forest_ghost_tree_num_elements (forest, itree);
+         ielem++) {
+      ghost_entry = *(t8_gloidx_t *) sc_array_index (&element_data,
+                                                     array_pos);
+      SC_CHECK_ABORT (ghost_entry ==
+                      t8_forest_ghost_get_global_element_id (forest, itree,
+                                                             ielem),
+                      "Error when exchanging ghost data. Received wrong global id.\n");
+      array_pos++;
+    }
+  }
+  /* clean-up */
+  sc_array_reset (&element_data);
+}
+
 /* Construct a data array of ints for all elements and all ghosts,
  * fill the element's entries with '42', perform the ghost exchange and
  * check whether the ghost's entries are '42'.
@@ -196,12 +243,28 @@ t8_test_ghost_exchange (int cmesh_id)
     /* exchange ghost data */
     t8_test_ghost_exchange_data_int (forest);
     t8_test_ghost_exchange_data_id (forest);
+    t8_test_ghost_exchange_data_global_id (forest);
     /* Adapt the forest and exchange data again */
     maxlevel = level + 2;
+    /* Keep forest to adapt it a second time */
+    t8_forest_ref (forest);
     forest_adapt =
       t8_forest_new_adapt (forest, t8_test_exchange_adapt, 1, 1, &maxlevel);
     t8_test_ghost_exchange_data_int (forest_adapt);
     t8_test_ghost_exchange_data_id (forest_adapt);
+    t8_test_ghost_exchange_data_global_id (forest_adapt);
+    t8_forest_unref (&forest_adapt);
+    /* Adapt and partition again, this time sending the partition and
+     * ghost elements as compact keys */
+    t8_forest_init (&forest_adapt);
+    t8_forest_set_user_data (forest_adapt, &maxlevel);
+    t8_forest_set_adapt (forest_adapt, forest, t8_test_exchange_adapt, 1);
+    t8_forest_set_partition (forest_adapt, NULL, 0);
+    t8_forest_set_ghost (forest_adapt, 1, T8_GHOST_FACES);
+    t8_forest_set_compact_messages (forest_adapt, 1);
+    t8_forest_commit (forest_adapt);
+    t8_test_ghost_exchange_data_id (forest_adapt);
+    t8_test_ghost_exchange_data_global_id (forest_adapt);
     t8_forest_unref (&forest_adapt);
   }
   t8_cmesh_destroy (&cmesh);
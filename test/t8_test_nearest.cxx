@@ -0,0 +1,216 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+/* In this test we query the nearest elements of points in uniform and
+ * adapted forests and compare the results with the distances of all
+ * elements of the forest.
+ */
+
+#include <t8_schemes/t8_default_cxx.hxx>
+#include <t8_cmesh.h>
+#include <t8_forest.h>
+#include <t8_forest_nearest.h>
+
+#define T8_TEST_NEAREST_NUM_POINTS 5
+
+/* The query points, some of them outside of the unit cube */
+static const double t8_test_nearest_points[T8_TEST_NEAREST_NUM_POINTS][3] = {
+  {0.1, 0.2, 0.3}, {0.5, 0.5, 0.5}, {1.3, -0.2, 0.4}, {0.7, 0.9, -1.0},
+  {0.25, 0.75, 0.125}
+};
+
+/* Refine the first element of each tree up to the level given as user data */
+static int
+t8_test_nearest_refine (t8_forest_t forest, t8_forest_t forest_from,
+                        t8_locidx_t which_tree, t8_locidx_t lelement_id,
+                        t8_eclass_scheme_c * ts, int num_elements,
+                        t8_element_t * elements[])
+{
+  const int           level = ts->t8_element_level (elements[0]);
+
+  return ts->t8_element_get_linear_id (elements[0], level) == 0
+    && level < *(int *) t8_forest_get_user_data (forest);
+}
+
+static int
+t8_test_nearest_compare (const void *found_a, const void *found_b)
+{
+  const t8_forest_nearest_t *A = (const t8_forest_nearest_t *) found_a;
+  const t8_forest_nearest_t *B = (const t8_forest_nearest_t *) found_b;
+
+  if (A->distance != B->distance) {
+    return A->distance < B->distance ? -1 : 1;
+  }
+  return A->element_id < B->element_id ? -1 : A->element_id != B->element_id;
+}
+
+/* Compute the distances of all elements of the forest to a point, sorted
+ * by distance and global id. all has one entry per global element. */
+static void
+t8_test_nearest_all (t8_forest_t forest, const double point[3],
+                     t8_forest_nearest_t * all)
+{
+  t8_gloidx_t         num_global, ielement, element_id;
+  t8_locidx_t         itree, ielem;
+  double             *local_distances, *distances, *tree_vertices;
+  int                 mpiret;
+
+  num_global = t8_forest_get_global_num_elements (forest);
+  local_distances = T8_ALLOC_ZERO (double, num_global);
+  distances = T8_ALLOC (double, num_global);
+  element_id = t8_forest_get_first_local_element_id (forest);
+  for (itree = 0; itree < t8_forest_get_num_local_trees (forest); itree++) {
+    tree_vertices = t8_forest_get_tree_vertices (forest, itree);
+    for (ielem = 0; ielem < t8_forest_get_tree_num_elements (forest, itree);
+         ielem++, element_id++) {
+      local_distances[element_id] =
+        t8_forest_element_point_distance (forest, itree,
+                                          t8_forest_get_element_in_tree
+                                          (forest, itree, ielem),
+                                          tree_vertices, point);
+    }
+  }
+  mpiret = sc_MPI_Allreduce (local_distances, distances, (int) num_global,
+                             sc_MPI_DOUBLE, sc_MPI_SUM,
+                             t8_forest_get_mpicomm (forest));
+  SC_CHECK_MPI (mpiret);
+  for (ielement = 0; ielement < num_global; ielement++) {
+    all[ielement].element_id = ielement;
+    all[ielement].distance = distances[ielement];
+  }
+  qsort (all, num_global, sizeof (t8_forest_nearest_t),
+         t8_test_nearest_compare);
+  T8_FREE (local_distances);
+  T8_FREE (distances);
+}
+
+/* Check the results of a query against the distances of all elements */
+static void
+t8_test_nearest_check (t8_forest_t forest, int k, double radius,
+                       t8_forest_nearest_result_t * result,
+                       t8_forest_nearest_t ** all)
+{
+  t8_gloidx_t         num_global, num_expected, ifound;
+  t8_forest_nearest_t *found;
+  size_t              ipoint;
+  int                 mpisize, mpiret;
+
+  mpiret = sc_MPI_Comm_size (t8_forest_get_mpicomm (forest), &mpisize);
+  SC_CHECK_MPI (mpiret);
+  num_global = t8_forest_get_global_num_elements (forest);
+  SC_CHECK_ABORT (result->num_points == T8_TEST_NEAREST_NUM_POINTS,
+                  "Wrong number of points");
+  for (ipoint = 0; ipoint < T8_TEST_NEAREST_NUM_POINTS; ipoint++) {
+    /* The expected elements are the first ones of all elements */
+    num_expected = 0;
+    while (num_expected < num_global
+           && (k <= 0 || num_expected < k)
+           && (radius < 0 || all[ipoint][num_expected].distance <= radius)) {
+      num_expected++;
+    }
+    SC_CHECK_ABORTF ((t8_gloidx_t) (result->offsets[ipoint + 1]
+                                    - result->offsets[ipoint]) ==
+                     num_expected, "Wrong number of nearest elements for "
+                     "point %zd", ipoint);
+    found = result->elements + result->offsets[ipoint];
+    for (ifound = 0; ifound < num_expected; ifound++) {
+      SC_CHECK_ABORTF (found[ifound].element_id ==
+                       all[ipoint][ifound].element_id
+                       && found[ifound].distance ==
+                       all[ipoint][ifound].distance,
+                       "Wrong nearest element %lli for point %zd",
+                       (long long) ifound, ipoint);
+      SC_CHECK_ABORT (0 <= found[ifound].owner
+                      && found[ifound].owner < mpisize, "Wrong owner");
+    }
+  }
+}
+
+static void
+t8_test_nearest (t8_eclass_t eclass, int level)
+{
+  t8_cmesh_t          cmesh;
+  t8_forest_t         forest, forest_adapt;
+  t8_forest_nearest_result_t result;
+  t8_forest_nearest_t *all[T8_TEST_NEAREST_NUM_POINTS];
+  int                 ipoint, iforest, k, maxlevel = level + 2;
+  const int           ks[3] = { 1, 4, 0 };
+  const double        radii[3] = { -1, 0.3, 0.2 };
+
+  t8_global_productionf ("Testing nearest elements for %s level %i\n",
+                         t8_eclass_to_string[eclass], level);
+  cmesh = t8_cmesh_new_hypercube (eclass, sc_MPI_COMM_WORLD, 0, 0, 0);
+  forest = t8_forest_new_uniform (cmesh, t8_scheme_new_default_cxx (),
+                                  level, 0, sc_MPI_COMM_WORLD);
+  for (iforest = 0; iforest < 2; iforest++) {
+    if (iforest == 1) {
+      /* Refine and partition the forest */
+      t8_forest_init (&forest_adapt);
+      t8_forest_set_user_data (forest_adapt, &maxlevel);
+      t8_forest_set_adapt (forest_adapt, forest, t8_test_nearest_refine, 1);
+      t8_forest_set_partition (forest_adapt, NULL, 0);
+      t8_forest_commit (forest_adapt);
+      forest = forest_adapt;
+    }
+    for (ipoint = 0; ipoint < T8_TEST_NEAREST_NUM_POINTS; ipoint++) {
+      all[ipoint] = T8_ALLOC (t8_forest_nearest_t,
+                              t8_forest_get_global_num_elements (forest));
+      t8_test_nearest_all (forest, t8_test_nearest_points[ipoint],
+                           all[ipoint]);
+    }
+    for (k = 0; k < 3; k++) {
+      t8_forest_nearest (forest, T8_TEST_NEAREST_NUM_POINTS,
+                         &t8_test_nearest_points[0][0], ks[k], radii[k],
+                         &result);
+      t8_test_nearest_check (forest, ks[k], radii[k], &result, all);
+      t8_forest_nearest_reset (&result);
+    }
+    for (ipoint = 0; ipoint < T8_TEST_NEAREST_NUM_POINTS; ipoint++) {
+      T8_FREE (all[ipoint]);
+    }
+  }
+  t8_forest_unref (&forest);
+}
+
+int
+main (int argc, char **argv)
+{
+  int                 mpiret;
+  int                 eclass;
+
+  mpiret = sc_MPI_Init (&argc, &argv);
+  SC_CHECK_MPI (mpiret);
+
+  sc_init (sc_MPI_COMM_WORLD, 1, 1, NULL, SC_LP_ESSENTIAL);
+  t8_init (SC_LP_DEFAULT);
+
+  for (eclass = T8_ECLASS_VERTEX; eclass < T8_ECLASS_PYRAMID; eclass++) {
+    t8_test_nearest ((t8_eclass_t) eclass, 2);
+  }
+
+  sc_finalize ();
+
+  mpiret = sc_MPI_Finalize ();
+  SC_CHECK_MPI (mpiret);
+
+  return 0;
+}
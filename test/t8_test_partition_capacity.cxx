@@ -0,0 +1,313 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#include <t8_eclass.h>
+#include <t8_schemes/t8_default_cxx.hxx>
+#include <t8_forest.h>
+#include <t8_forest_calibrate.h>
+#include <t8_cmesh.h>
+
+/* In this test we check the partition with process capacities.
+ * We check that equal capacities give the same partition as no capacities,
+ * also if they are not exact in floating point, that each process gets a
+ * share of the elements, or of the weights, proportional to its capacity,
+ * rounded to the nearest element, that processes with zero capacity
+ * get no elements, and that the capacities measured by a calibration
+ * balance synthetic runtimes of processes with different speeds.
+ */
+
+/* The cost of a hex element and the overhead per process */
+static const double t8_test_cost_hex = 2;
+static const double t8_test_cost_overhead = 0.5;
+
+/* The weight depends only on the element, such that we can evaluate it
+ * on the partitioned forest as well */
+static double
+t8_test_capacity_weight_level (t8_forest_t forest, t8_forest_t forest_from,
+                               t8_locidx_t which_tree,
+                               t8_locidx_t lelement_id,
+                               t8_eclass_scheme_c * ts,
+                               const t8_element_t * element)
+{
+  return 1 + 4 * ts->t8_element_level (element);
+}
+
+/* Refine every third element */
+static int
+t8_test_capacity_adapt (t8_forest_t forest, t8_forest_t forest_from,
+                        t8_locidx_t which_tree, t8_locidx_t lelement_id,
+                        t8_eclass_scheme_c * ts, int num_elements,
+                        t8_element_t * elements[])
+{
+  return lelement_id % 3 == 0;
+}
+
+/* Return the sum of the weights of the local elements of a forest.
+ * If weight_fn is NULL, each element has weight 1. */
+static double
+t8_test_capacity_weight_sum (t8_forest_t forest,
+                             t8_forest_partition_weight_t weight_fn)
+{
+  t8_eclass_scheme_c *ts;
+  t8_locidx_t         itree, ielement;
+  double              sum = 0;
+
+  if (weight_fn == NULL) {
+    return t8_forest_get_local_num_elements (forest);
+  }
+  for (itree = 0; itree < t8_forest_get_num_local_trees (forest); itree++) {
+    ts = t8_forest_get_eclass_scheme (forest,
+                                      t8_forest_get_tree_class (forest,
+                                                                itree));
+    for (ielement = 0;
+         ielement < t8_forest_get_tree_num_elements (forest, itree);
+         ielement++) {
+      sum += weight_fn (forest, forest, itree, ielement, ts,
+                        t8_forest_get_element_in_tree (forest, itree,
+                                                       ielement));
+    }
+  }
+  return sum;
+}
+
+/* Check that the weight sum of this process differs from its share of
+ * the total weight by at most the maximum weight of an element */
+static void
+t8_test_capacity_check_share (t8_forest_t forest,
+                              t8_forest_partition_weight_t weight_fn,
+                              double capacity, double max_weight)
+{
+  double              local[2], total[2];
+  int                 mpiret;
+
+  local[0] = t8_test_capacity_weight_sum (forest, weight_fn);
+  local[1] = capacity;
+  mpiret = sc_MPI_Allreduce (local, total, 2, sc_MPI_DOUBLE, sc_MPI_SUM,
+                             sc_MPI_COMM_WORLD);
+  SC_CHECK_MPI (mpiret);
+  SC_CHECK_ABORT (fabs (local[0] - total[0] * capacity / total[1])
+                  <= max_weight * (1 + 1e-10),
+                  "The partition does not match the capacities.");
+}
+
+/* Check the partition of a forest with capacity 0.1 * (rank + 1).
+ * The first element of rank p is the exact share of the ranks before p,
+ * N * p * (p + 1) / (P * (P + 1)) for N elements and P processes,
+ * rounded to the nearest element. We check this in integer arithmetic. */
+static void
+t8_test_capacity_check_rounded (t8_forest_t forest)
+{
+  long long           num_elements, first_element, share, total;
+  int                 mpirank, mpisize, mpiret;
+
+  mpiret = sc_MPI_Comm_rank (sc_MPI_COMM_WORLD, &mpirank);
+  SC_CHECK_MPI (mpiret);
+  mpiret = sc_MPI_Comm_size (sc_MPI_COMM_WORLD, &mpisize);
+  SC_CHECK_MPI (mpiret);
+  num_elements = t8_forest_get_global_num_elements (forest);
+  first_element = t8_forest_get_first_local_element_id (forest);
+  if (t8_forest_get_local_num_elements (forest) == 0) {
+    /* Empty processes do not know their first element */
+    return;
+  }
+  share = num_elements * mpirank * (mpirank + 1);
+  total = (long long) mpisize * (mpisize + 1);
+  SC_CHECK_ABORT (2 * llabs (first_element * total - share) <= total,
+                  "The partition is not the rounded share of the capacities.");
+}
+
+/* Partition a forest with a weight function and a capacity */
+static t8_forest_t
+t8_test_capacity_partition (t8_forest_t forest_from,
+                            t8_forest_partition_weight_t weight_fn,
+                            double capacity)
+{
+  t8_forest_t         forest;
+
+  t8_forest_init (&forest);
+  t8_forest_set_partition (forest, forest_from, 0);
+  t8_forest_set_partition_weight (forest, weight_fn, NULL);
+  t8_forest_set_partition_capacity (forest, capacity);
+  t8_forest_commit (forest);
+  return forest;
+}
+
+static void
+t8_test_partition_capacity (t8_eclass_t eclass, int level)
+{
+  t8_cmesh_t          cmesh;
+  t8_forest_t         forest, forest_adapt, forest_plain, forest_equal;
+  t8_forest_t         forest_capacity;
+  int                 mpirank, mpiret, iweight, icapacity;
+  t8_forest_partition_weight_t weight_fns[2] =
+    { NULL, t8_test_capacity_weight_level };
+  double              max_weights[2] = { 1, 1 + 4 * (level + 1.) };
+  double              equal_capacities[2] = { 3, 0.1 };
+  double              capacity;
+
+  t8_global_productionf ("Testing partition with capacities for %s level %i\n",
+                         t8_eclass_to_string[eclass], level);
+  mpiret = sc_MPI_Comm_rank (sc_MPI_COMM_WORLD, &mpirank);
+  SC_CHECK_MPI (mpiret);
+  cmesh = t8_cmesh_new_hypercube (eclass, sc_MPI_COMM_WORLD, 0, 0, 0);
+  forest = t8_forest_new_uniform (cmesh, t8_scheme_new_default_cxx (), level,
+                                  0, sc_MPI_COMM_WORLD);
+  forest_adapt = t8_forest_new_adapt (forest, t8_test_capacity_adapt, 0, 0,
+                                      NULL);
+
+  for (iweight = 0; iweight < 2; iweight++) {
+    /* Equal capacities give the same partition as no capacities,
+     * also if their sums are not exact */
+    for (icapacity = 0; icapacity < 2; icapacity++) {
+      t8_forest_ref (forest_adapt);
+      t8_forest_ref (forest_adapt);
+      forest_plain = t8_test_capacity_partition (forest_adapt,
+                                                 weight_fns[iweight], -1);
+      forest_equal = t8_test_capacity_partition (forest_adapt,
+                                                 weight_fns[iweight],
+                                                 equal_capacities[icapacity]);
+      SC_CHECK_ABORT (t8_forest_partition_is_equal
+                      (forest_plain, forest_equal),
+                      "Equal capacities give a different partition.");
+      t8_forest_unref (&forest_plain);
+      t8_forest_unref (&forest_equal);
+    }
+
+    /* The capacity grows with the rank */
+    capacity = 1 + mpirank;
+    t8_forest_ref (forest_adapt);
+    forest_capacity = t8_test_capacity_partition (forest_adapt,
+                                                  weight_fns[iweight],
+                                                  capacity);
+    t8_test_capacity_check_share (forest_capacity, weight_fns[iweight],
+                                  capacity, max_weights[iweight]);
+    t8_forest_unref (&forest_capacity);
+
+    /* The second and every third process get no elements */
+    capacity = mpirank % 3 == 1 ? 0 : 0.5;
+    t8_forest_ref (forest_adapt);
+    forest_capacity = t8_test_capacity_partition (forest_adapt,
+                                                  weight_fns[iweight],
+                                                  capacity);
+    if (capacity == 0) {
+      SC_CHECK_ABORT (t8_forest_get_local_num_elements (forest_capacity) == 0,
+                      "A process with capacity zero has elements.");
+    }
+    t8_test_capacity_check_share (forest_capacity, weight_fns[iweight],
+                                  capacity, max_weights[iweight]);
+    t8_forest_unref (&forest_capacity);
+  }
+
+  /* Capacities that are not exact in floating point give the exact shares
+   * rounded to the nearest element */
+  capacity = 0.1 * (mpirank + 1);
+  t8_forest_ref (forest_adapt);
+  forest_capacity = t8_test_capacity_partition (forest_adapt, NULL, capacity);
+  t8_test_capacity_check_rounded (forest_capacity);
+  t8_forest_unref (&forest_capacity);
+  t8_forest_unref (&forest_adapt);
+}
+
+/* Return the synthetic runtime of this process for a hex forest.
+ * Every second process is slower by a factor of 2. */
+static double
+t8_test_capacity_runtime (t8_forest_t forest)
+{
+  int                 mpirank, mpiret;
+
+  mpiret = sc_MPI_Comm_rank (sc_MPI_COMM_WORLD, &mpirank);
+  SC_CHECK_MPI (mpiret);
+  return (mpirank % 2 + 1) * (t8_test_cost_overhead + t8_test_cost_hex *
+                              t8_forest_get_local_num_elements (forest));
+}
+
+/* Measure the capacities of processes with different speeds with a
+ * calibration and check that a partition with the measured capacities
+ * balances the runtimes. */
+static void
+t8_test_capacity_calibrate ()
+{
+  t8_cmesh_t          cmesh;
+  t8_forest_t         forest, forest_partition;
+  t8_forest_calibrate_t calibrate;
+  double              runtime, max_runtime, min_runtime;
+  int                 mpiret;
+
+  t8_global_productionf ("Testing calibration of partition capacities\n");
+  calibrate = t8_forest_calibrate_new (sc_MPI_COMM_WORLD, 0, 1, NULL, 1);
+  SC_CHECK_ABORT (t8_forest_calibrate_get_capacity (calibrate) == 1,
+                  "Wrong capacity without measurements.");
+  cmesh = t8_cmesh_new_hypercube (T8_ECLASS_HEX, sc_MPI_COMM_WORLD, 0, 0, 0);
+  forest = t8_forest_new_uniform (cmesh, t8_scheme_new_default_cxx (), 3,
+                                  0, sc_MPI_COMM_WORLD);
+  t8_forest_calibrate_add_step (calibrate, forest,
+                                t8_test_capacity_runtime (forest));
+
+  /* Partition with the calibrated costs and capacities */
+  t8_forest_init (&forest_partition);
+  t8_forest_set_partition (forest_partition, forest, 0);
+  t8_forest_calibrate_set_partition_weight (forest_partition, calibrate);
+  t8_forest_set_partition_capacity (forest_partition,
+                                    t8_forest_calibrate_get_capacity
+                                    (calibrate));
+  t8_forest_commit (forest_partition);
+
+  /* The runtimes of the fast and slow processes are balanced */
+  runtime = t8_test_capacity_runtime (forest_partition);
+  mpiret = sc_MPI_Allreduce (&runtime, &max_runtime, 1, sc_MPI_DOUBLE,
+                             sc_MPI_MAX, sc_MPI_COMM_WORLD);
+  SC_CHECK_MPI (mpiret);
+  mpiret = sc_MPI_Allreduce (&runtime, &min_runtime, 1, sc_MPI_DOUBLE,
+                             sc_MPI_MIN, sc_MPI_COMM_WORLD);
+  SC_CHECK_MPI (mpiret);
+  SC_CHECK_ABORT (max_runtime <= 1.05 * min_runtime,
+                  "The measured capacities do not balance the runtimes.");
+
+  t8_forest_unref (&forest_partition);
+  t8_forest_calibrate_destroy (&calibrate);
+}
+
+int
+main (int argc, char **argv)
+{
+  int                 mpiret;
+  int                 eclass;
+
+  mpiret = sc_MPI_Init (&argc, &argv);
+  SC_CHECK_MPI (mpiret);
+
+  sc_init (sc_MPI_COMM_WORLD, 1, 1, NULL, SC_LP_ESSENTIAL);
+  p4est_init (NULL, SC_LP_ESSENTIAL);
+  t8_init (SC_LP_DEFAULT);
+
+  for (eclass = T8_ECLASS_LINE; eclass <= T8_ECLASS_HEX; eclass++) {
+    t8_test_partition_capacity ((t8_eclass_t) eclass, 2);
+  }
+  t8_test_capacity_calibrate ();
+
+  sc_finalize ();
+
+  mpiret = sc_MPI_Finalize ();
+  SC_CHECK_MPI (mpiret);
+
+  return 0;
+}
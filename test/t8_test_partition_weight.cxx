@@ -0,0 +1,298 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#include <t8_eclass.h>
+#include <t8_schemes/t8_default_cxx.hxx>
+#include <t8_forest.h>
+#include <t8_forest_calibrate.h>
+#include <t8_cmesh.h>
+
+/* In this test we check the partition with element weights.
+ * We check that equal weights give the same partition as no weights,
+ * that the sums of the weights of all processes differ by at most
+ * the maximum weight of an element, and that a calibration recovers
+ * known element costs from synthetic runtimes.
+ */
+
+/* The known costs of tets, prisms and hexes and the overhead per process */
+static const double t8_test_cost_tet = 1;
+static const double t8_test_cost_prism = 2;
+static const double t8_test_cost_hex = 5;
+static const double t8_test_cost_overhead = 0.5;
+
+static double
+t8_test_weight_one (t8_forest_t forest, t8_forest_t forest_from,
+                    t8_locidx_t which_tree, t8_locidx_t lelement_id,
+                    t8_eclass_scheme_c * ts, const t8_element_t * element)
+{
+  return 1;
+}
+
+/* The weight depends only on the element, such that we can evaluate it
+ * on the partitioned forest as well */
+static double
+t8_test_weight_level (t8_forest_t forest, t8_forest_t forest_from,
+                      t8_locidx_t which_tree, t8_locidx_t lelement_id,
+                      t8_eclass_scheme_c * ts, const t8_element_t * element)
+{
+  return 1 + 4 * ts->t8_element_level (element);
+}
+
+/* Refine every third element */
+static int
+t8_test_adapt_some (t8_forest_t forest, t8_forest_t forest_from,
+                    t8_locidx_t which_tree, t8_locidx_t lelement_id,
+                    t8_eclass_scheme_c * ts, int num_elements,
+                    t8_element_t * elements[])
+{
+  return lelement_id % 3 == 0;
+}
+
+/* Refine the elements of the class given in the user data */
+static int
+t8_test_adapt_eclass (t8_forest_t forest, t8_forest_t forest_from,
+                      t8_locidx_t which_tree, t8_locidx_t lelement_id,
+                      t8_eclass_scheme_c * ts, int num_elements,
+                      t8_element_t * elements[])
+{
+  t8_eclass_t         eclass;
+
+  eclass = *(t8_eclass_t *) t8_forest_get_user_data (forest);
+  return ts->eclass == eclass;
+}
+
+/* Return the sum of the weights of the local elements of a forest */
+static double
+t8_test_weight_sum (t8_forest_t forest, t8_forest_partition_weight_t weight_fn)
+{
+  t8_eclass_scheme_c *ts;
+  t8_locidx_t         itree, ielement;
+  double              sum = 0;
+
+  for (itree = 0; itree < t8_forest_get_num_local_trees (forest); itree++) {
+    ts = t8_forest_get_eclass_scheme (forest,
+                                      t8_forest_get_tree_class (forest,
+                                                                itree));
+    for (ielement = 0;
+         ielement < t8_forest_get_tree_num_elements (forest, itree);
+         ielement++) {
+      sum += weight_fn (forest, forest, itree, ielement, ts,
+                        t8_forest_get_element_in_tree (forest, itree,
+                                                       ielement));
+    }
+  }
+  return sum;
+}
+
+/* Check that the weight sum of this process differs from the average by at
+ * most the maximum weight of an element */
+static void
+t8_test_weight_check_balance (t8_forest_t forest,
+                              t8_forest_partition_weight_t weight_fn,
+                              double max_weight)
+{
+  double              local_sum, total_sum;
+  int                 mpiret, mpisize;
+
+  mpiret = sc_MPI_Comm_size (sc_MPI_COMM_WORLD, &mpisize);
+  SC_CHECK_MPI (mpiret);
+  local_sum = t8_test_weight_sum (forest, weight_fn);
+  mpiret = sc_MPI_Allreduce (&local_sum, &total_sum, 1, sc_MPI_DOUBLE,
+                             sc_MPI_SUM, sc_MPI_COMM_WORLD);
+  SC_CHECK_MPI (mpiret);
+  SC_CHECK_ABORT (fabs (local_sum - total_sum / mpisize)
+                  <= max_weight * (1 + 1e-10),
+                  "The weighted partition is not balanced.");
+}
+
+/* Partition a forest with a weight function */
+static t8_forest_t
+t8_test_weight_partition (t8_forest_t forest_from,
+                          t8_forest_partition_weight_t weight_fn)
+{
+  t8_forest_t         forest;
+
+  t8_forest_init (&forest);
+  t8_forest_set_partition (forest, forest_from, 0);
+  t8_forest_set_partition_weight (forest, weight_fn, NULL);
+  t8_forest_commit (forest);
+  return forest;
+}
+
+static void
+t8_test_partition_weight (t8_eclass_t eclass, int level)
+{
+  t8_cmesh_t          cmesh;
+  t8_forest_t         forest, forest_adapt, forest_plain, forest_one;
+  t8_forest_t         forest_level;
+
+  t8_global_productionf ("Testing weighted partition for %s level %i\n",
+                         t8_eclass_to_string[eclass], level);
+  cmesh = t8_cmesh_new_hypercube (eclass, sc_MPI_COMM_WORLD, 0, 0, 0);
+  forest = t8_forest_new_uniform (cmesh, t8_scheme_new_default_cxx (), level,
+                                  0, sc_MPI_COMM_WORLD);
+  forest_adapt = t8_forest_new_adapt (forest, t8_test_adapt_some, 0, 0,
+                                      NULL);
+  /* forest_adapt is the source of three partitions */
+  t8_forest_ref (forest_adapt);
+  t8_forest_ref (forest_adapt);
+  forest_plain = t8_test_weight_partition (forest_adapt, NULL);
+  forest_one = t8_test_weight_partition (forest_adapt, t8_test_weight_one);
+  forest_level = t8_test_weight_partition (forest_adapt,
+                                           t8_test_weight_level);
+
+  SC_CHECK_ABORT (t8_forest_partition_is_equal (forest_plain, forest_one),
+                  "Equal weights give a different partition.");
+  t8_test_weight_check_balance (forest_level, t8_test_weight_level,
+                                1 + 4 * (level + 1));
+
+  t8_forest_unref (&forest_plain);
+  t8_forest_unref (&forest_one);
+  t8_forest_unref (&forest_level);
+}
+
+/* Return the synthetic runtime of this process for a forest */
+static double
+t8_test_calibrate_runtime (t8_forest_t forest)
+{
+  t8_locidx_t         itree;
+  double              runtime = t8_test_cost_overhead;
+  double              cost;
+
+  for (itree = 0; itree < t8_forest_get_num_local_trees (forest); itree++) {
+    switch (t8_forest_get_tree_class (forest, itree)) {
+    case T8_ECLASS_TET:
+      cost = t8_test_cost_tet;
+      break;
+    case T8_ECLASS_PRISM:
+      cost = t8_test_cost_prism;
+      break;
+    case T8_ECLASS_HEX:
+      cost = t8_test_cost_hex;
+      break;
+    default:
+      SC_ABORT_NOT_REACHED ();
+    }
+    runtime += cost * t8_forest_get_tree_num_elements (forest, itree);
+  }
+  return runtime;
+}
+
+/* The weight of an element is its known cost */
+static double
+t8_test_weight_cost (t8_forest_t forest, t8_forest_t forest_from,
+                     t8_locidx_t which_tree, t8_locidx_t lelement_id,
+                     t8_eclass_scheme_c * ts, const t8_element_t * element)
+{
+  switch (ts->eclass) {
+  case T8_ECLASS_TET:
+    return t8_test_cost_tet;
+  case T8_ECLASS_PRISM:
+    return t8_test_cost_prism;
+  case T8_ECLASS_HEX:
+    return t8_test_cost_hex;
+  default:
+    SC_ABORT_NOT_REACHED ();
+  }
+  return 0;
+}
+
+/* Calibrate the costs on differently refined hybrid forests and use them
+ * to partition a forest. */
+static void
+t8_test_partition_calibrate ()
+{
+  t8_cmesh_t          cmesh;
+  t8_forest_t         forest, forest_adapt, forest_partition;
+  t8_forest_calibrate_t calibrate;
+  t8_eclass_t         refine_classes[3] =
+    { T8_ECLASS_TET, T8_ECLASS_PRISM, T8_ECLASS_HEX };
+  int                 iclass;
+
+  t8_global_productionf ("Testing calibration of partition weights\n");
+  calibrate = t8_forest_calibrate_new (sc_MPI_COMM_WORLD, 0, 1, NULL, 1);
+  cmesh = t8_cmesh_new_hypercube_hybrid (3, sc_MPI_COMM_WORLD, 0, 0);
+  forest = t8_forest_new_uniform (cmesh, t8_scheme_new_default_cxx (), 1,
+                                  0, sc_MPI_COMM_WORLD);
+  t8_forest_calibrate_add_step (calibrate, forest,
+                                t8_test_calibrate_runtime (forest));
+  /* Refining the elements of one class at a time changes the ratios of the
+   * element counts, such that all costs can be identified */
+  for (iclass = 0; iclass < 3; iclass++) {
+    t8_forest_ref (forest);
+    forest_adapt = t8_forest_new_adapt (forest, t8_test_adapt_eclass, 0, 0,
+                                        &refine_classes[iclass]);
+    t8_forest_calibrate_add_step (calibrate, forest_adapt,
+                                  t8_test_calibrate_runtime (forest_adapt));
+    t8_forest_unref (&forest_adapt);
+  }
+  SC_CHECK_ABORT (fabs (t8_forest_calibrate_get_cost
+                        (calibrate, T8_ECLASS_TET, 0, 0)
+                        - t8_test_cost_tet) < 1e-3 * t8_test_cost_tet,
+                  "Wrong calibrated tet cost.");
+  SC_CHECK_ABORT (fabs (t8_forest_calibrate_get_cost
+                        (calibrate, T8_ECLASS_PRISM, 0, 0)
+                        - t8_test_cost_prism) < 1e-3 * t8_test_cost_prism,
+                  "Wrong calibrated prism cost.");
+  /* Levels above the maximum level share the costs of the maximum level */
+  SC_CHECK_ABORT (fabs (t8_forest_calibrate_get_cost
+                        (calibrate, T8_ECLASS_HEX, 2, 0)
+                        - t8_test_cost_hex) < 1e-3 * t8_test_cost_hex,
+                  "Wrong calibrated hex cost.");
+
+  /* Partition with the calibrated costs */
+  t8_forest_init (&forest_partition);
+  t8_forest_set_partition (forest_partition, forest, 0);
+  t8_forest_calibrate_set_partition_weight (forest_partition, calibrate);
+  t8_forest_commit (forest_partition);
+  t8_test_weight_check_balance (forest_partition, t8_test_weight_cost,
+                                t8_test_cost_hex * (1 + 1e-3));
+
+  t8_forest_unref (&forest_partition);
+  t8_forest_calibrate_destroy (&calibrate);
+}
+
+int
+main (int argc, char **argv)
+{
+  int                 mpiret;
+  int                 eclass;
+
+  mpiret = sc_MPI_Init (&argc, &argv);
+  SC_CHECK_MPI (mpiret);
+
+  sc_init (sc_MPI_COMM_WORLD, 1, 1, NULL, SC_LP_ESSENTIAL);
+  p4est_init (NULL, SC_LP_ESSENTIAL);
+  t8_init (SC_LP_DEFAULT);
+
+  for (eclass = T8_ECLASS_LINE; eclass <= T8_ECLASS_HEX; eclass++) {
+    t8_test_partition_weight ((t8_eclass_t) eclass, 2);
+  }
+  t8_test_partition_calibrate ();
+
+  sc_finalize ();
+
+  mpiret = sc_MPI_Finalize ();
+  SC_CHECK_MPI (mpiret);
+
+  return 0;
+}
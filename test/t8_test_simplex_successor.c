@@ -0,0 +1,126 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element types in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#include <t8.h>
+#include <t8_schemes/t8_default/t8_dtri_bits.h>
+#include <t8_schemes/t8_default/t8_dtet_bits.h>
+
+/* In this file we test the successor and predecessor computation of
+ * triangles and tetrahedra.
+ * For each element of a uniform refinement up to a given level, we
+ * compare its successor and predecessor with the elements constructed
+ * from the next and previous linear id.
+ * The first element has no predecessor and the last element has no
+ * successor, all other elements are checked in both directions.
+ */
+
+static void
+t8_test_dtri_successor (int maxlevel)
+{
+  t8_dtri_t           t, s, compare;
+  t8_linearidx_t      id, num_elements;
+  int                 level;
+
+  for (level = 1; level <= maxlevel; level++) {
+    num_elements = (t8_linearidx_t) 1 << (2 * level);
+    for (id = 0; id < num_elements; id++) {
+      t8_dtri_init_linear_id (&t, id, level);
+      SC_CHECK_ABORTF (t8_dtri_linear_id (&t, level) == id,
+                       "Wrong linear id of triangle %llu at level %i.\n",
+                       (unsigned long long) id, level);
+      if (id > 0) {
+        t8_dtri_predecessor (&t, &s, level);
+        t8_dtri_init_linear_id (&compare, id - 1, level);
+        SC_CHECK_ABORTF (t8_dtri_is_equal (&s, &compare),
+                         "Wrong predecessor of triangle %llu at level %i.\n",
+                         (unsigned long long) id, level);
+      }
+      if (id < num_elements - 1) {
+        t8_dtri_successor (&t, &s, level);
+        t8_dtri_init_linear_id (&compare, id + 1, level);
+        SC_CHECK_ABORTF (t8_dtri_is_equal (&s, &compare),
+                         "Wrong successor of triangle %llu at level %i.\n",
+                         (unsigned long long) id, level);
+      }
+    }
+  }
+}
+
+static void
+t8_test_dtet_successor (int maxlevel)
+{
+  t8_dtet_t           t, s, compare;
+  t8_linearidx_t      id, num_elements;
+  int                 level;
+
+  for (level = 1; level <= maxlevel; level++) {
+    num_elements = (t8_linearidx_t) 1 << (3 * level);
+    for (id = 0; id < num_elements; id++) {
+      t8_dtet_init_linear_id (&t, id, level);
+      SC_CHECK_ABORTF (t8_dtet_linear_id (&t, level) == id,
+                       "Wrong linear id of tetrahedron %llu at level %i.\n",
+                       (unsigned long long) id, level);
+      if (id > 0) {
+        t8_dtet_predecessor (&t, &s, level);
+        t8_dtet_init_linear_id (&compare, id - 1, level);
+        SC_CHECK_ABORTF (t8_dtet_is_equal (&s, &compare),
+                         "Wrong predecessor of tetrahedron %llu at level"
+                         " %i.\n",
+                         (unsigned long long) id, level);
+      }
+      if (id < num_elements - 1) {
+        t8_dtet_successor (&t, &s, level);
+        t8_dtet_init_linear_id (&compare, id + 1, level);
+        SC_CHECK_ABORTF (t8_dtet_is_equal (&s, &compare),
+                         "Wrong successor of tetrahedron %llu at level %i.\n",
+                         (unsigned long long) id, level);
+      }
+    }
+  }
+}
+
+int
+main (int argc, char **argv)
+{
+  int                 mpiret;
+  const int           maxlevel = 4;
+
+  mpiret = sc_MPI_Init (&argc, &argv);
+  SC_CHECK_MPI (mpiret);
+
+  sc_init (sc_MPI_COMM_WORLD, 1, 1, NULL, SC_LP_ESSENTIAL);
+  p4est_init (NULL, SC_LP_ESSENTIAL);
+  t8_init (SC_LP_DEFAULT);
+
+  t8_global_productionf ("Testing triangle successor and predecessor.\n");
+  t8_test_dtri_successor (maxlevel);
+  t8_global_productionf ("Testing tetrahedron successor and predecessor.\n");
+  t8_test_dtet_successor (maxlevel);
+  t8_global_productionf ("Done testing successor and predecessor.\n");
+
+  sc_finalize ();
+
+  mpiret = sc_MPI_Finalize ();
+  SC_CHECK_MPI (mpiret);
+
+  return 0;
+}
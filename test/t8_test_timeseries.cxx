@@ -0,0 +1,181 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+/* In this test we write a time series of forests and check that
+ * the geometry of a forest is only written once, no matter how many
+ * time steps use it.
+ */
+
+#include <sys/stat.h>
+#include <t8_schemes/t8_default_cxx.hxx>
+#include <t8_cmesh.h>
+#include <t8_forest.h>
+#include <t8_forest_timeseries.h>
+
+/* Refine the first element of each tree */
+static int
+t8_test_timeseries_adapt (t8_forest_t forest, t8_forest_t forest_from,
+                          t8_locidx_t which_tree, t8_locidx_t lelement_id,
+                          t8_eclass_scheme_c * ts, int num_elements,
+                          t8_element_t * elements[])
+{
+  return lelement_id == 0;
+}
+
+/* Return the size of a file in bytes or -1 if it does not exist */
+static long
+t8_test_timeseries_file_size (const char *prefix, const char *kind,
+                              int index, int rank)
+{
+  char                filename[BUFSIZ];
+  struct stat         file_stat;
+
+  snprintf (filename, BUFSIZ, "%s_%s_%04d_%04d.bin", prefix, kind, index,
+            rank);
+  if (stat (filename, &file_stat) != 0) {
+    return -1;
+  }
+  return (long) file_stat.st_size;
+}
+
+/* Check the size of the geometry file and the size of the file of a step */
+static void
+t8_test_timeseries_check_files (t8_forest_t forest, const char *prefix,
+                                int geometry, int step)
+{
+  t8_locidx_t         num_elements;
+  int                 mpirank, mpiret;
+  long                geometry_size, step_size;
+
+  mpiret = sc_MPI_Comm_rank (t8_forest_get_mpicomm (forest), &mpirank);
+  SC_CHECK_MPI (mpiret);
+  num_elements = t8_forest_get_local_num_elements (forest);
+  geometry_size = t8_test_timeseries_file_size (prefix, "geometry",
+                                                geometry, mpirank);
+  step_size = t8_test_timeseries_file_size (prefix, "step", step, mpirank);
+  if (num_elements == 0) {
+    SC_CHECK_ABORT (geometry_size < 0 && step_size < 0,
+                    "Empty process wrote time series files.");
+    return;
+  }
+  /* Quadrilaterals: 4 points with 3 doubles and 5 topology entries each. */
+  SC_CHECK_ABORTF (geometry_size == num_elements *
+                   (long) (4 * 3 * sizeof (double) +
+                           5 * sizeof (t8_locidx_t)),
+                   "Wrong size %li of geometry %i.", geometry_size,
+                   geometry);
+  /* One scalar and one vector field */
+  SC_CHECK_ABORTF (step_size == num_elements * (long) (4 * sizeof (double)),
+                   "Wrong size %li of step %i.", step_size, step);
+}
+
+static void
+t8_test_timeseries (sc_MPI_Comm comm)
+{
+  t8_cmesh_t          cmesh;
+  t8_forest_t         forest, forest_adapt;
+  t8_forest_timeseries_t series;
+  t8_vtk_data_field_t data[2];
+  t8_locidx_t         num_elements, ielement;
+  const char         *prefix = "test_timeseries";
+  int                 istep, geometry;
+  int                 mpirank, mpiret;
+  double             *scalars, *vectors;
+
+  cmesh = t8_cmesh_new_hypercube (T8_ECLASS_QUAD, comm, 0, 0, 0);
+  forest = t8_forest_new_uniform (cmesh, t8_scheme_new_default_cxx (), 2, 0,
+                                  comm);
+  series = t8_forest_timeseries_new (prefix);
+
+  for (istep = 0; istep < 6; istep++) {
+    if (istep == 3) {
+      /* Change the forest. This must trigger a new geometry. */
+      t8_forest_init (&forest_adapt);
+      t8_forest_set_adapt (forest_adapt, forest, t8_test_timeseries_adapt,
+                           0);
+      t8_forest_commit (forest_adapt);
+      forest = forest_adapt;
+    }
+    num_elements = t8_forest_get_local_num_elements (forest);
+    scalars = T8_ALLOC (double, num_elements);
+    vectors = T8_ALLOC (double, 3 * num_elements);
+    for (ielement = 0; ielement < num_elements; ielement++) {
+      scalars[ielement] = istep;
+      vectors[3 * ielement] = vectors[3 * ielement + 1] =
+        vectors[3 * ielement + 2] = ielement;
+    }
+    data[0].type = T8_VTK_SCALAR;
+    snprintf (data[0].description, BUFSIZ, "scalar");
+    data[0].data = scalars;
+    data[1].type = T8_VTK_VECTOR;
+    snprintf (data[1].description, BUFSIZ, "vector");
+    data[1].data = vectors;
+    SC_CHECK_ABORT (t8_forest_timeseries_write_step
+                    (series, forest, 0.1 * istep, 2, data),
+                    "Writing time series step failed.");
+    geometry = istep < 3 ? 0 : 1;
+    SC_CHECK_ABORT (t8_forest_timeseries_get_num_geometries (series) ==
+                    geometry + 1, "Wrong number of geometries.");
+    t8_test_timeseries_check_files (forest, prefix, geometry, istep);
+    T8_FREE (scalars);
+    T8_FREE (vectors);
+  }
+  SC_CHECK_ABORT (t8_forest_timeseries_get_num_steps (series) == 6,
+                  "Wrong number of steps.");
+  /* Writing the same forest without data does not write files */
+  SC_CHECK_ABORT (t8_forest_timeseries_write_step (series, forest, 1, 0,
+                                                   NULL),
+                  "Writing time series step failed.");
+  SC_CHECK_ABORT (t8_forest_timeseries_get_num_geometries (series) == 2,
+                  "Wrong number of geometries.");
+  mpiret = sc_MPI_Comm_rank (comm, &mpirank);
+  SC_CHECK_MPI (mpiret);
+  SC_CHECK_ABORT (t8_test_timeseries_file_size (prefix, "step", 6,
+                                                mpirank) < 0,
+                  "Wrote step file without data.");
+  t8_forest_timeseries_destroy (&series);
+  t8_forest_unref (&forest);
+}
+
+int
+main (int argc, char **argv)
+{
+  int                 mpiret;
+  sc_MPI_Comm         mpic;
+
+  mpiret = sc_MPI_Init (&argc, &argv);
+  SC_CHECK_MPI (mpiret);
+
+  mpic = sc_MPI_COMM_WORLD;
+  sc_init (mpic, 1, 1, NULL, SC_LP_PRODUCTION);
+  p4est_init (NULL, SC_LP_ESSENTIAL);
+  t8_init (SC_LP_DEFAULT);
+
+  t8_test_timeseries (mpic);
+
+  sc_finalize ();
+
+  mpiret = sc_MPI_Finalize ();
+  SC_CHECK_MPI (mpiret);
+
+  return 0;
+}
@@ -0,0 +1,162 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+/* In this test we write a forest to vtk files with the processes
+ * aggregated into different numbers of files.
+ * We check that the .pvtu file references each file, that each file
+ * contains one piece for each process of its group and that all
+ * elements are written exactly once.
+ */
+
+#include <t8_schemes/t8_default_cxx.hxx>
+#include <t8_cmesh.h>
+#include <t8_forest.h>
+#include <t8_forest_vtk.h>
+
+/* Count the lines of a file that contain a given string and sum the
+ * number of cells of the lines that start a piece.
+ * Returns -1 if the file cannot be opened. */
+static int
+t8_test_vtk_aggregated_count (const char *filename, const char *tag,
+                              long long *num_cells)
+{
+  FILE               *file;
+  char                line[BUFSIZ];
+  const char         *position;
+  long long           cells, points;
+  int                 count = 0;
+
+  file = fopen (filename, "r");
+  if (file == NULL) {
+    return -1;
+  }
+  while (fgets (line, BUFSIZ, file) != NULL) {
+    position = strstr (line, tag);
+    if (position != NULL) {
+      count++;
+      if (num_cells != NULL
+          && sscanf (position,
+                     "<Piece NumberOfPoints=\"%lld\" NumberOfCells=\"%lld\"",
+                     &points, &cells) == 2) {
+        *num_cells += cells;
+      }
+    }
+  }
+  fclose (file);
+  return count;
+}
+
+static void
+t8_test_vtk_aggregated (t8_forest_t forest, int num_files)
+{
+  char                fileprefix[BUFSIZ], filename[BUFSIZ + 16];
+  long long           num_cells = 0, local_num_cells, global_num_cells;
+  int                 mpisize, mpirank, mpiret;
+  int                 files_written, ifile, group_size;
+
+  mpiret = sc_MPI_Comm_size (t8_forest_get_mpicomm (forest), &mpisize);
+  SC_CHECK_MPI (mpiret);
+  mpiret = sc_MPI_Comm_rank (t8_forest_get_mpicomm (forest), &mpirank);
+  SC_CHECK_MPI (mpiret);
+  /* No more files than processes are written */
+  files_written = SC_MIN (num_files, mpisize);
+
+  snprintf (fileprefix, BUFSIZ, "test_vtk_aggregated_%i", files_written);
+  SC_CHECK_ABORT (t8_forest_vtk_write_file_aggregated
+                  (forest, fileprefix, num_files, 1, 1, 1, 1, 1, 0, NULL),
+                  "Writing aggregated vtk file failed.");
+  /* Each process writes its elements and its ghosts */
+  local_num_cells = t8_forest_get_local_num_elements (forest)
+    + t8_forest_get_num_ghosts (forest);
+  mpiret = sc_MPI_Allreduce (&local_num_cells, &global_num_cells, 1,
+                             sc_MPI_LONG_LONG_INT, sc_MPI_SUM,
+                             t8_forest_get_mpicomm (forest));
+  SC_CHECK_MPI (mpiret);
+  /* Wait until all files are written */
+  mpiret = sc_MPI_Barrier (t8_forest_get_mpicomm (forest));
+  SC_CHECK_MPI (mpiret);
+
+  if (mpirank == 0) {
+    snprintf (filename, BUFSIZ + 16, "%s.pvtu", fileprefix);
+    SC_CHECK_ABORT (t8_test_vtk_aggregated_count
+                    (filename, "<Piece Source", NULL) == files_written,
+                    "The pvtu file does not reference each vtu file.");
+    for (ifile = 0; ifile < files_written; ifile++) {
+      /* The files are written by groups of consecutive ranks with
+       * sizes that differ by at most one */
+      group_size = (int) (((long long) (ifile + 1) * mpisize) / files_written
+                          - ((long long) ifile * mpisize) / files_written);
+      snprintf (filename, BUFSIZ + 16, "%s_%04d.vtu", fileprefix, ifile);
+      SC_CHECK_ABORT (t8_test_vtk_aggregated_count
+                      (filename, "<Piece ", &num_cells) == group_size,
+                      "Wrong number of pieces in aggregated vtu file.");
+      SC_CHECK_ABORT (t8_test_vtk_aggregated_count
+                      (filename, "</VTKFile>", NULL) == 1,
+                      "Aggregated vtu file is not complete.");
+    }
+    SC_CHECK_ABORT (num_cells == global_num_cells,
+                    "Wrong number of cells in aggregated vtu files.");
+    snprintf (filename, BUFSIZ + 16, "%s_%04d.vtu", fileprefix,
+              files_written);
+    SC_CHECK_ABORT (t8_test_vtk_aggregated_count (filename, "<Piece ", NULL)
+                    == -1, "Too many vtu files written.");
+  }
+  /* Do not overwrite the files in the next test before they are checked */
+  mpiret = sc_MPI_Barrier (t8_forest_get_mpicomm (forest));
+  SC_CHECK_MPI (mpiret);
+}
+
+int
+main (int argc, char **argv)
+{
+  int                 mpiret, mpisize;
+  sc_MPI_Comm         mpic;
+  t8_cmesh_t          cmesh;
+  t8_forest_t         forest;
+
+  mpiret = sc_MPI_Init (&argc, &argv);
+  SC_CHECK_MPI (mpiret);
+
+  mpic = sc_MPI_COMM_WORLD;
+  sc_init (mpic, 1, 1, NULL, SC_LP_PRODUCTION);
+  p4est_init (NULL, SC_LP_ESSENTIAL);
+  t8_init (SC_LP_DEFAULT);
+
+  mpiret = sc_MPI_Comm_size (mpic, &mpisize);
+  SC_CHECK_MPI (mpiret);
+
+  cmesh = t8_cmesh_new_hypercube_hybrid (3, mpic, 0, 0);
+  forest = t8_forest_new_uniform (cmesh, t8_scheme_new_default_cxx (), 1, 1,
+                                  mpic);
+  t8_test_vtk_aggregated (forest, 1);
+  t8_test_vtk_aggregated (forest, 2);
+  t8_test_vtk_aggregated (forest, mpisize);
+  t8_test_vtk_aggregated (forest, mpisize + 3);
+  t8_forest_unref (&forest);
+
+  sc_finalize ();
+
+  mpiret = sc_MPI_Finalize ();
+  SC_CHECK_MPI (mpiret);
+
+  return 0;
+}
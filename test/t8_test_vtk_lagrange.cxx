@@ -0,0 +1,151 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+/* In this test we compute the nodes of vtk Lagrange cells for each
+ * element class and several orders and write them to vtk files.
+ * We check that the nodes are distinct, that the first nodes are the
+ * corners of the element and that the nodes are centered in the element.
+ */
+
+#include <t8_schemes/t8_default_cxx.hxx>
+#include <t8_cmesh.h>
+#include <t8_forest.h>
+#include <t8_forest_vtk.h>
+
+/* Check the Lagrange nodes of each element of a forest and
+ * store the x coordinate of each node in values */
+static void
+t8_test_vtk_lagrange_check_nodes (t8_forest_t forest, int order,
+                                  double *values)
+{
+  t8_locidx_t         itree, ielement, num_elements;
+  t8_element_t       *element;
+  t8_eclass_t         eclass;
+  double             *coordinates, corner[3], centroid[3], mean[3];
+  int                 num_nodes, num_corners, inode, jnode, idim;
+
+  for (itree = 0; itree < t8_forest_get_num_local_trees (forest); itree++) {
+    eclass = t8_forest_get_tree_class (forest, itree);
+    num_nodes = t8_forest_vtk_lagrange_num_nodes (eclass, order);
+    num_corners = t8_eclass_num_vertices[eclass];
+    coordinates = T8_ALLOC (double, 3 * num_nodes);
+    num_elements = t8_forest_get_tree_num_elements (forest, itree);
+    for (ielement = 0; ielement < num_elements; ielement++) {
+      element = t8_forest_get_element_in_tree (forest, itree, ielement);
+      t8_forest_vtk_lagrange_node_coordinates (forest, itree, element,
+                                               order, coordinates);
+      /* The first nodes are the corners in vtk ordering */
+      centroid[0] = centroid[1] = centroid[2] = 0;
+      for (inode = 0; inode < num_corners; inode++) {
+        t8_forest_element_coordinate (forest, itree, element,
+                                      t8_forest_get_tree_vertices (forest,
+                                                                   itree),
+                                      t8_eclass_vtk_corner_number[eclass]
+                                      [inode], corner);
+        for (idim = 0; idim < 3; idim++) {
+          SC_CHECK_ABORT (fabs (corner[idim] - coordinates[3 * inode + idim])
+                          < 1e-12, "Lagrange node is not a corner.");
+          centroid[idim] += corner[idim] / num_corners;
+        }
+      }
+      /* All nodes are distinct and their mean is the centroid */
+      mean[0] = mean[1] = mean[2] = 0;
+      for (inode = 0; inode < num_nodes; inode++) {
+        for (jnode = 0; jnode < inode; jnode++) {
+          SC_CHECK_ABORT (fabs (coordinates[3 * inode] -
+                                coordinates[3 * jnode]) +
+                          fabs (coordinates[3 * inode + 1] -
+                                coordinates[3 * jnode + 1]) +
+                          fabs (coordinates[3 * inode + 2] -
+                                coordinates[3 * jnode + 2]) > 1e-12,
+                          "Duplicate Lagrange node.");
+        }
+        for (idim = 0; idim < 3; idim++) {
+          mean[idim] += coordinates[3 * inode + idim] / num_nodes;
+        }
+        *values++ = coordinates[3 * inode];
+      }
+      for (idim = 0; idim < 3; idim++) {
+        SC_CHECK_ABORT (fabs (mean[idim] - centroid[idim]) < 1e-12,
+                        "Lagrange nodes are not centered.");
+      }
+    }
+    T8_FREE (coordinates);
+  }
+}
+
+static void
+t8_test_vtk_lagrange (sc_MPI_Comm comm, t8_eclass_t eclass)
+{
+  t8_cmesh_t          cmesh;
+  t8_forest_t         forest;
+  t8_vtk_data_field_t data;
+  char                fileprefix[BUFSIZ];
+  int                 order;
+
+  cmesh = t8_cmesh_new_from_class (eclass, comm);
+  forest = t8_forest_new_uniform (cmesh, t8_scheme_new_default_cxx (), 1, 0,
+                                  comm);
+  for (order = 1; order <= 5; order++) {
+    data.type = T8_VTK_SCALAR;
+    snprintf (data.description, BUFSIZ, "x");
+    data.data = T8_ALLOC (double,
+                          t8_forest_get_local_num_elements (forest) *
+                          t8_forest_vtk_lagrange_num_nodes (eclass, order));
+    t8_test_vtk_lagrange_check_nodes (forest, order, data.data);
+    snprintf (fileprefix, BUFSIZ, "test_vtk_lagrange_%s_%i",
+              t8_eclass_to_string[eclass], order);
+    SC_CHECK_ABORT (t8_forest_vtk_write_file_lagrange
+                    (forest, fileprefix, order, 1, 1, 1, 1, 1, &data),
+                    "Writing Lagrange vtk file failed.");
+    T8_FREE (data.data);
+  }
+  t8_forest_unref (&forest);
+}
+
+int
+main (int argc, char **argv)
+{
+  int                 mpiret;
+  sc_MPI_Comm         mpic;
+  int                 eclass;
+
+  mpiret = sc_MPI_Init (&argc, &argv);
+  SC_CHECK_MPI (mpiret);
+
+  mpic = sc_MPI_COMM_WORLD;
+  sc_init (mpic, 1, 1, NULL, SC_LP_PRODUCTION);
+  p4est_init (NULL, SC_LP_ESSENTIAL);
+  t8_init (SC_LP_DEFAULT);
+
+  /* Vertices have only one node, pyramids are not supported */
+  for (eclass = T8_ECLASS_LINE; eclass < T8_ECLASS_PYRAMID; eclass++) {
+    t8_test_vtk_lagrange (mpic, (t8_eclass_t) eclass);
+  }
+
+  sc_finalize ();
+
+  mpiret = sc_MPI_Finalize ();
+  SC_CHECK_MPI (mpiret);
+
+  return 0;
+}